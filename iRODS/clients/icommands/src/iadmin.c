@@ -1828,6 +1828,9 @@ usage(char *subOpt)
 " cu (calulate usage (for quotas))",
 "Calculate (via DBMS SQL) the usage on resources for each user and",
 "determine if users are over quota.",
+"Once quotas are set, the changes in usage as files are added, removed",
+"or changed are also recorded, and are brought into the usage by this",
+"and by each setting of a quota (suq and sgq).",
 "Also see suq, sgq, and lq.",
 ""};
 
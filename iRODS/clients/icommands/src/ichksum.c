@@ -89,6 +89,8 @@ usage ()
    "Usage : ichksum [-harvV] [-K|f] [-n replNum] [-R resource] [--silent]",
 "           dataObj|collection ... ",
 "Checksum one or more data-object or collection from iRODS space.",
+"A new checksum uses the scheme set on the server (md5, sha2 or sha2tree);",
+"an existing one is verified with its own scheme, shown before the ':'.",
 "Options are:",
 " -f  force - checksum data-objects even if a checksum already exists in iCAT",
 " -a  checksum all replicas. ils -L should be used to list the values of all replicas",
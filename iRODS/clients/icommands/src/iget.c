@@ -95,7 +95,8 @@ usage () {
    char *msgs[]={
 "Usage: iget [-fIKPQrUvVT] [-n replNumber] [-N numThreads] [-X restartFile]",
 "[-R resource] [--lfrestart lfRestartFile] [--retries count] [--purgec]",
-"[--rlock]  srcDataObj|srcCollection ... destLocalFile|destLocalDir",
+"[--rlock] [--conns numConns] [--stats]",
+"           srcDataObj|srcCollection ... destLocalFile|destLocalDir",
 "Usage : iget [-fIKPQUvVT] [-n replNumber] [-N numThreads] [-X restartFile]",
 "[-R resource] [--lfrestart lfRestartFile] [--retries count] [--purgec]",
 "[--rlock]  srcDataObj|srcCollection",
@@ -128,6 +129,24 @@ usage () {
 "The --lfrestart option can be used together with the -X option to do large",
 "file transfer restart as part of the overall collection download restart.",
 " ",
+"The --conns option specifies the number of connections used to download",
+"the data objects of a collection (-r) concurrently. The collection is read",
+"ahead of the downloads and the local directories are created as it is",
+"read. Large objects still use the parallel transfer of the -N option on",
+"each connection. The environment variable collTranRate caps the number of",
+"downloads started per second. A restart file written with --conns may",
+"mark a point behind files already downloaded, so when it is restarted the",
+"next few files are overwritten as if -f was used. --conns is not used with",
+"the --lfrestart option.",
+" ",
+"The --stats option prints the statistics of each stream of a parallel",
+"transfer: the bytes moved, the time blocked on the socket and on the local",
+"file, the stalls (waits of 0.1 sec or more) and, where available, the",
+"TCP_INFO round trip time, congestion window and retransmits of the socket.",
+"The lines of the client side have side=client. The server sends the same",
+"statistics for its side back, printed with side=server. It also logs them",
+"when portalStat is set in irodsctl.",
+" ",
 "The -Q option specifies the use of the RBUDP transfer mechanism which uses",
 "the UDP protocol for data transfer. The UDP protocol is very efficient",
 "if the network is very robust with few packet losses. Two environment",
@@ -172,6 +191,9 @@ usage () {
 "      the restart info.",
 " -t  ticket - ticket (string) to use for ticket-based access.",
 " --rlock - use advisory read lock for the download",
+" --conns numConns - the number of connections used to download the data",
+"      objects of a collection concurrently. The default is 1.",
+" --stats - print the statistics of each stream of a parallel transfer",
 " -h  this help",
 ""};
    int i;
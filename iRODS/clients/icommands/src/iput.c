@@ -95,6 +95,7 @@ usage ()
 "Usage : iput [-abfIkKPQrtTUvV] [-D dataType] [-N numThreads] [-n replNum]",
 "             [-p physicalPath] [-R resource] [-X restartFile] [--link]", 
 "             [--lfrestart lfRestartFile] [--retries count] [--wlock]",
+"             [--conns numConns] [--stats]",
 "		localSrcFile|localSrcDir ...  destDataObj|destColl",
 "Usage : iput [-abfIkKPQtTUvV] [-D dataType] [-N numThreads] [-n replNum] ",
 "             [-p physicalPath] [-R resource] [-X restartFile] [--link]",
@@ -150,6 +151,23 @@ usage ()
 "server after 10 minutes of connection. This gets around the problem of",
 "sockets getting timed out by the firewall as reported by some users.",
 " ",
+"The --conns option specifies the number of connections used to upload",
+"the files of a directory (-r) concurrently. The collections are created",
+"ahead of the files and large files still use the parallel transfer of",
+"the -N option on each connection. The environment variable collTranRate",
+"caps the number of uploads started per second. A restart file written",
+"with --conns may mark a point behind files already uploaded, so when it",
+"is restarted the next few files are overwritten as if -f was used.",
+"--conns is not used with the -b and --lfrestart options.",
+" ",
+"The --stats option prints the statistics of each stream of a parallel",
+"transfer: the bytes moved, the time blocked on the socket and on the local",
+"file, the stalls (waits of 0.1 sec or more) and, where available, the",
+"TCP_INFO round trip time, congestion window and retransmits of the socket.",
+"The lines of the client side have side=client. The server sends the same",
+"statistics for its side back, printed with side=server. It also logs them",
+"when portalStat is set in irodsctl.",
+" ",
 "The -b option specifies bulk upload operation which can do up to 50 uploads",
 "at a time to reduce overhead. If the -b is specified with the -f option ",
 "to overwrite existing files, the operation will work only if there is no",
@@ -194,6 +212,9 @@ usage ()
 "      on and the lfRestartFile input specifies a local file that contains",
 "      the restart info.",
 " --wlock - use advisory write (exclusive) lock for the upload",
+" --conns numConns - the number of connections used to upload the files of",
+"      a directory concurrently. The default is 1.",
+" --stats - print the statistics of each stream of a parallel transfer",
 " -h  this help",
 ""};
    int i;
@@ -21,6 +21,7 @@ usage () {
 " -z Zonename  the zone to query (default or invalid uses the local zone)",
 " --no-page    do not prompt asking whether to continue or not",
 "              (by default, prompt after a large number of results (500)",
+"              The results are then streamed by the server in large pages.",
 "format is C format restricted to character strings.",
 "selectConditionString is of the form: SELECT <attribute> [, <attribute>]* [WHERE <condition> [ AND <condition>]*]",
 "attribute can be found using 'iquest attrs' command",
@@ -163,8 +164,30 @@ queryAndShowStrCond(rcComm_t *conn, char *hint, char *format,
      printf("Zone is %s\n",zoneArgument);
   }
 
-  genQueryInp.maxRows= MAX_SQL_ROWS;
   genQueryInp.continueInx=0;
+
+  if (noPageFlag) {
+     /* without the prompt, stream the pages in large ones */
+     genQueryStream_t genQueryStream;
+     int pageCnt = 0;
+
+     genQueryInp.maxRows= MAX_COMPACT_SQL_ROWS;
+     i = rcGenQueryStreamOpen (conn, &genQueryInp, 0, &genQueryStream);
+     if (i < 0)
+	return(i);
+     while ((i = rcGenQueryStreamNext (&genQueryStream, &genQueryOut)) >= 0) {
+	pageCnt++;
+	i = printGenQueryOut(stdout, format,hint,  genQueryOut);
+	freeGenQueryOut (&genQueryOut);
+	if (i < 0) break;
+     }
+     rcGenQueryStreamClose (&genQueryStream);
+     if (i == CAT_NO_ROWS_FOUND && pageCnt > 0)
+	return(0);
+     return(i);
+  }
+
+  genQueryInp.maxRows= MAX_SQL_ROWS;
   i = rcGenQuery (conn, &genQueryInp, &genQueryOut);
   if (i < 0)
     return(i);
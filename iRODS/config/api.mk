@@ -408,6 +408,9 @@ LIB_API_OBJS += $(libApiObjDir)/rcTicketAdmin.o
 SVR_API_OBJS += $(svrApiObjDir)/rsGetTempPasswordForOther.o
 LIB_API_OBJS += $(libApiObjDir)/rcGetTempPasswordForOther.o
 
+SVR_API_OBJS += $(svrApiObjDir)/rsGenQueryStream.o
+LIB_API_OBJS += $(libApiObjDir)/rcGenQueryStream.o
+
 ifdef NETCDF_API
 SVR_API_OBJS += $(svrApiObjDir)/rsNcOpen.o
 LIB_API_OBJS += $(libApiObjDir)/rcNcOpen.o
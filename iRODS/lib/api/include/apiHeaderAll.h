@@ -141,6 +141,7 @@
 #include "dataObjLock.h"
 #include "ticketAdmin.h"
 #include "getTempPasswordForOther.h"
+#include "genQueryStream.h"
 #include "ncOpen.h"
 #include "ncCreate.h"
 #include "ncClose.h"
@@ -153,6 +153,8 @@
 #define TICKET_ADMIN_AN 			723
 #define GET_TEMP_PASSWORD_FOR_OTHER_AN		724
 #define PAM_AUTH_REQUEST_AN 			725
+#define GEN_QUERY_COMPACT_AN 			726
+#define GEN_QUERY_STREAM_AN 			727
 
 #define EXEC_CMD241_AN 			634
 #ifdef COMPAT_201
@@ -174,6 +174,10 @@ apidef_t RcApiTable[] = {
     {PAM_AUTH_REQUEST_AN, RODS_API_VERSION,
        NO_USER_AUTH|XMSG_SVR_ALSO, NO_USER_AUTH|XMSG_SVR_ALSO, 
        "pamAuthRequestInp_PI", 0,  "pamAuthRequestOut_PI", 0, (funcPtr) RS_PAM_AUTH_REQUEST},
+    {GEN_QUERY_COMPACT_AN, RODS_API_VERSION, REMOTE_USER_AUTH, REMOTE_USER_AUTH, 
+      "GenQueryInp_PI", 0, "GenQueryCompactOut_PI", 0, (funcPtr) RS_GEN_QUERY_COMPACT},
+    {GEN_QUERY_STREAM_AN, RODS_API_VERSION, REMOTE_USER_AUTH, REMOTE_USER_AUTH, 
+      "GenQueryInp_PI", 0, "GenQueryCompactOut_PI", 0, (funcPtr) RS_GEN_QUERY_STREAM},
     {OPEN_COLLECTION_AN, RODS_API_VERSION, REMOTE_USER_AUTH, REMOTE_USER_AUTH, 
       "CollInpNew_PI", 0, NULL, 0, (funcPtr) RS_OPEN_COLLECTION},
 #ifdef COMPAT_201
@@ -17,6 +17,13 @@
 #include "dataObjClose.h"
 #include "dataCopy.h"
 
+/* env variable (set in irodsctl) giving the min size in MB of an object
+ * which is replicated to several resources at once (ALL_KW) through a
+ * replication chain. 0 turns the chain off */
+#define REPL_CHAIN_MIN_SIZE_KW	"replChainMinSize"
+#define DEF_REPL_CHAIN_MIN_SIZE	32
+#define MAX_REPL_CHAIN_LEN	16
+
 #if defined(RODS_SERVER)
 #define RS_DATA_OBJ_REPL250 rsDataObjRepl250
 #define RS_DATA_OBJ_REPL rsDataObjRepl
@@ -47,6 +54,13 @@ dataObjInfo_t *srcDataObjInfoHead, rescGrpInfo_t *destRescGrpInfo,
 transferStat_t *transStat, dataObjInfo_t *oldDataObjInfo,
 dataObjInfo_t *outDataObjInfo);
 int
+_rsDataObjReplChain (rsComm_t *rsComm, dataObjInp_t *dataObjInp,
+dataObjInfo_t *srcDataObjInfo, rescGrpInfo_t *destRescGrpInfo,
+rescInfo_t *skipRescInfo, transferStat_t *transStat, 
+rescInfo_t **doneRescInfo);
+rodsLong_t
+getReplChainMinSize ();
+int
 _rsDataObjReplS (rsComm_t *rsComm, dataObjInp_t *dataObjInp,
 dataObjInfo_t *srcDataObjInfo, rescInfo_t *destRescInfo, 
 char *rescGroupName, dataObjInfo_t *destDataObjInfo, int updateFlag);
@@ -20,7 +20,7 @@ typedef struct FileChksumInp {
     fileDriverType_t fileType;
     rodsHostAddr_t addr;
     char fileName[MAX_NAME_LEN];
-    int flag;	/* not used for now */
+    int flag;	/* the chksum scheme. 0 means the server default */
 } fileChksumInp_t;
     
 #define fileChksumInp_PI "int fileType; struct RHostAddr_PI; str fileName[MAX_NAME_LEN]; int flags;"
@@ -40,7 +40,8 @@ int
 remoteFileChksum (rsComm_t *rsComm, fileChksumInp_t *fileChksumInp,
 char **chksumStr, rodsServerHost_t *rodsServerHost);
 int
-fileChksum (int fileType, rsComm_t *rsComm, char *fileName, char *chksumStr);
+fileChksum (int fileType, rsComm_t *rsComm, char *fileName, int chksumScheme,
+char *chksumStr);
 #else
 #define RS_FILE_CHKSUM NULL
 #endif
@@ -29,8 +29,13 @@ genQueryOut_t **genQueryOut);
 int
 _rsGenQuery (rsComm_t *rsComm, genQueryInp_t *genQueryInp,
 genQueryOut_t **genQueryOut);
+#define RS_GEN_QUERY_COMPACT rsGenQueryCompact
+int
+rsGenQueryCompact (rsComm_t *rsComm, genQueryInp_t *genQueryInp,
+genQueryCompactOut_t **genQueryCompactOut);
 #else
 #define RS_GEN_QUERY NULL
+#define RS_GEN_QUERY_COMPACT NULL
 #endif
 
 #ifdef  __cplusplus
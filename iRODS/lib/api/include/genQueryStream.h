@@ -0,0 +1,90 @@
+/*** Copyright (c), The Regents of the University of California            ***
+ *** For more information please refer to files in the COPYRIGHT directory ***/
+/* genQueryStream.h
+ */
+
+/* This client/server call streams the pages of a general query. The
+ * agent keeps sending pages (as genQueryCompactOut_t replies with the
+ * status SYS_SVR_TO_CLI_GEN_QUERY_PAGE) until the statement is done,
+ * with no continueInx round trips. The last page goes in the final reply.
+ *
+ * Flow control is by credit. The client gives a window of bytes in
+ * GEN_QUERY_WINDOW_KW. The size of a page is the size of its values and
+ * offsets. The agent stops sending when the pages not acked add up to
+ * the window. The client acks each page with a 4 byte int when it is
+ * done with it. The ack is the size of the page, which is given back to
+ * the window, or GEN_QUERY_STREAM_CANCEL. On a cancel the agent closes
+ * the statement and ends the call with an empty page. The agent reads
+ * the acks of all the pages it sent before the final reply, so the
+ * client must ack every page, also the ones it gets after a cancel.
+ *
+ * While a stream is open, no other call can be made on the conn.
+ */
+
+#ifndef GEN_QUERY_STREAM_H
+#define GEN_QUERY_STREAM_H
+
+/* This is a Metadata type API call */
+
+#include "rods.h"
+#include "rcMisc.h"
+#include "procApiRequest.h"
+#include "apiNumber.h"
+#include "initServer.h"
+#include "icatDefines.h"
+
+#include "rodsGenQuery.h"
+
+#define DEF_GEN_QUERY_WINDOW	(8*1024*1024)
+#define MIN_GEN_QUERY_WINDOW	(64*1024)
+#define GEN_QUERY_STREAM_CANCEL	0	/* the ack of a cancel */
+
+/* definition for genQueryStream in rcComm_t */
+#define GEN_QUERY_STREAM_ON	1
+#define GEN_QUERY_STREAM_OFF	-1	/* the server does not have it */
+
+/* definition for state in genQueryStream_t */
+#define GEN_QUERY_STREAM_INIT	0	/* nothing sent yet */
+#define GEN_QUERY_STREAM_BUSY	1	/* the agent is sending pages */
+#define GEN_QUERY_STREAM_PAGED	2	/* old server. use rcGenQuery */
+#define GEN_QUERY_STREAM_DONE	3
+
+/* the client side of a stream */
+typedef struct GenQueryStream {
+    rcComm_t *conn;
+    genQueryInp_t *genQueryInp;	/* of the caller */
+    int window;
+    int state;
+    int ackLen;		/* the ack of the page given out last. 0 if none */
+    int continueInx;	/* the continueInx of the last page in PAGED */
+} genQueryStream_t;
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+#if defined(RODS_SERVER)
+#define RS_GEN_QUERY_STREAM rsGenQueryStream
+/* prototype for the server handler */
+int
+rsGenQueryStream (rsComm_t *rsComm, genQueryInp_t *genQueryInp,
+genQueryCompactOut_t **genQueryCompactOut);
+#else
+#define RS_GEN_QUERY_STREAM NULL
+#endif
+
+/* prototype for the client call */
+int
+rcGenQueryStreamOpen (rcComm_t *conn, genQueryInp_t *genQueryInp,
+int window, genQueryStream_t *genQueryStream);
+int
+rcGenQueryStreamNext (genQueryStream_t *genQueryStream,
+genQueryOut_t **genQueryOut);
+int
+rcGenQueryStreamClose (genQueryStream_t *genQueryStream);
+
+#ifdef  __cplusplus
+}
+#endif
+
+#endif	/* GEN_QUERY_STREAM_H */
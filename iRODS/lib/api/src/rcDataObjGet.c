@@ -60,6 +60,9 @@
  *    \n FORCE_FLAG_KW - overwrite existing local copy. This keyWd has no value.
  *    \n VERIFY_CHKSUM_KW - verify the checksum value of the local file after 
  *	     the download. This keyWd has no value.
+ *    \n CHKSUM_AT_CLOSE_KW - set by rcDataObjGet with VERIFY_CHKSUM_KW.
+ *	     The server may send the checksum with the reply to 
+ *	     rcOprComplete. This keyWd has no value.
  *    \n RBUDP_TRANSFER_KW - use RBUDP for data transfer. This keyWd has no
  *             value
  *    \n RBUDP_SEND_RATE_KW - the number of RBUDP packet to send per second
@@ -107,6 +110,11 @@ rcDataObjGet (rcComm_t *conn, dataObjInp_t *dataObjInp, char *locFilePath)
 		}
     }
 
+    if (getValByKey (&dataObjInp->condInput, VERIFY_CHKSUM_KW) != NULL) {
+	/* the server can chksum the data on the way out instead of
+	 * reading the file first. It sends the chksum at the end */
+	addKeyVal (&dataObjInp->condInput, CHKSUM_AT_CLOSE_KW, "");
+    }
     status = _rcDataObjGet (conn, dataObjInp, &portalOprOut, &dataObjOutBBuf);
 
     if (status < 0) {
@@ -183,6 +191,8 @@ rcDataObjGet (rcComm_t *conn, dataObjInp_t *dataObjInp, char *locFilePath)
         } else {
             status = rcOprComplete (conn, portalOprOut->l1descInx);
         }
+        if (portalOprOut->numThreads > 0 && isPortalStatOn ())
+            printSvrPortalStat (conn);
     }
 
     if (status >= 0 && conn->fileRestart.info.numSeg > 0) {   /* file restart */
@@ -190,13 +200,19 @@ rcDataObjGet (rcComm_t *conn, dataObjInp_t *dataObjInp, char *locFilePath)
     }
 
     if (getValByKey (&dataObjInp->condInput, VERIFY_CHKSUM_KW) != NULL) {
+	if (status >= 0 && portalOprOut != NULL && 
+	  strlen (portalOprOut->chksum) == 0) {
+	    /* sent with the reply to rcOprComplete */
+	    getPortalChksum (conn, portalOprOut->chksum);
+	}
 	if (portalOprOut == NULL || strlen (portalOprOut->chksum) == 0) {
 	    rodsLog (LOG_ERROR, 
 	      "rcDataObjGet: VERIFY_CHKSUM_KW set but no chksum from server");
 	} else {
 	    char chksumStr[NAME_LEN];
 
-            status = chksumLocFile (locFilePath, chksumStr);
+            status = chksumLocFileByScheme (locFilePath, chksumStr,
+              getChksumScheme (portalOprOut->chksum));
 
             if (status < 0) {
                 rodsLogError (LOG_ERROR, status,
@@ -241,7 +257,13 @@ portalOprOut_t **portalOprOut, bytesBuf_t *dataObjOutBBuf)
 
 #ifndef PARA_OPR
     addKeyVal (&dataObjInp->condInput, NO_PARA_OP_KW, "");
+#else
+    /* rcPartialData keeps the restart info per contiguous run, so the 
+     * server can hand out the chunks in any order */
+    addKeyVal (&dataObjInp->condInput, DYN_PORTAL_CHUNK_KW, "");
 #endif
+    if (isPortalStatOn ())
+        addKeyVal (&dataObjInp->condInput, PORTAL_STAT_KW, "");
 
     status = procApiRequest (conn, DATA_OBJ_GET_AN,  dataObjInp, NULL,
         (void **) portalOprOut, dataObjOutBBuf);
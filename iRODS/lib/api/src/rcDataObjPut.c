@@ -136,7 +136,13 @@ rcDataObjPut (rcComm_t *conn, dataObjInp_t *dataObjInp, char *locFilePath)
 
 #ifndef PARA_OPR
     addKeyVal (&dataObjInp->condInput, NO_PARA_OP_KW, "");
+#else
+    /* rcPartialData keeps the restart info per contiguous run, so the 
+     * server can hand out the chunks in any order */
+    addKeyVal (&dataObjInp->condInput, DYN_PORTAL_CHUNK_KW, "");
 #endif
+    if (isPortalStatOn ())
+        addKeyVal (&dataObjInp->condInput, PORTAL_STAT_KW, "");
 
     status = _rcDataObjPut (conn, dataObjInp, &dataObjInpBBuf, &portalOprOut);
 
@@ -197,6 +203,8 @@ rcDataObjPut (rcComm_t *conn, dataObjInp_t *dataObjInp, char *locFilePath)
     } else {
         status = rcOprComplete (conn, portalOprOut->l1descInx);
     }
+    if (portalOprOut->numThreads > 0 && isPortalStatOn ())
+        printSvrPortalStat (conn);
     free (portalOprOut);
 
     if (status >= 0 && conn->fileRestart.info.numSeg > 0) {   /* file restart */
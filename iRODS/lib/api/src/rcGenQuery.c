@@ -8,6 +8,7 @@
 /* See genQuery.h for a description of this API call.*/
 
 #include "genQuery.h"
+#include "rcMisc.h"
 
 /* this is a debug routine; it just prints the genQueryInp
    structure */
@@ -68,6 +69,9 @@ printGenQI( genQueryInp_t *genQueryInp) {
  * \n SQL-like queries but without the caller needing to know the structure
  * \n of the database (schema).  SQL is generated for each call on the 
  * \n server-side (in the ICAT code).
+ * \n The result is sent with the compact encoding (GEN_QUERY_COMPACT_AN)
+ * \n if the server has it, and maxRows may then be up to 
+ * \n MAX_COMPACT_SQL_ROWS. Pages of older servers are capped at MAX_SQL_ROWS.
  *
  * \note none
  *
@@ -90,8 +94,37 @@ int
 rcGenQuery (rcComm_t *conn, genQueryInp_t *genQueryInp, 
 genQueryOut_t **genQueryOut)
 {
-    int status;
+    int status, status1;
+    genQueryCompactOut_t *genQueryCompactOut = NULL;
+    genQueryInp_t myGenQueryInp;
+
     /*    printGenQI(genQueryInp); */
+    if (conn->genQueryCompact != GEN_QUERY_COMPACT_OFF) {
+        /* try the compact encoding. Once per conn if the server
+         * does not have it */
+        status = procApiRequest (conn, GEN_QUERY_COMPACT_AN, genQueryInp, 
+          NULL, (void **) &genQueryCompactOut, NULL);
+        if (status != SYS_UNMATCHED_API_NUM) {
+            conn->genQueryCompact = GEN_QUERY_COMPACT_ON;
+            if (genQueryCompactOut != NULL) {
+                if (status >= 0) {
+                    status1 = compactToGenQueryOut (genQueryCompactOut,
+                      genQueryOut);
+                    if (status1 < 0) status = status1;
+                }
+                freeGenQueryCompactOut (&genQueryCompactOut);
+            }
+            return (status);
+        }
+        conn->genQueryCompact = GEN_QUERY_COMPACT_OFF;
+    }
+
+    /* an old server pads all the rows of a page. Keep the page small */
+    if (genQueryInp->maxRows > MAX_SQL_ROWS) {
+        myGenQueryInp = *genQueryInp;
+        myGenQueryInp.maxRows = MAX_SQL_ROWS;
+        genQueryInp = &myGenQueryInp;
+    }
     status = procApiRequest (conn, GEN_QUERY_AN,  genQueryInp, NULL, 
         (void **)genQueryOut, NULL);
 
@@ -0,0 +1,255 @@
+/*** Copyright (c), The Regents of the University of California            ***
+ *** For more information please refer to files in the COPYRIGHT directory ***/
+
+/* See genQueryStream.h for a description of this API call.*/
+
+#include "genQueryStream.h"
+#include "genQuery.h"
+#include "sockComm.h"
+
+/* rcGenQueryStreamOpen - set up a stream of the pages of genQueryInp.
+ * Nothing is sent until the first rcGenQueryStreamNext. window is the
+ * number of bytes of pages the agent may send ahead; 0 means
+ * DEF_GEN_QUERY_WINDOW. genQueryInp->maxRows is the size of a page.
+ */
+int
+rcGenQueryStreamOpen (rcComm_t *conn, genQueryInp_t *genQueryInp,
+int window, genQueryStream_t *genQueryStream)
+{
+    if (conn == NULL || genQueryInp == NULL || genQueryStream == NULL)
+        return (USER__NULL_INPUT_ERR);
+
+    memset (genQueryStream, 0, sizeof (genQueryStream_t));
+    genQueryStream->conn = conn;
+    genQueryStream->genQueryInp = genQueryInp;
+    if (window <= 0)
+        window = DEF_GEN_QUERY_WINDOW;
+    else if (window < MIN_GEN_QUERY_WINDOW)
+        window = MIN_GEN_QUERY_WINDOW;
+    genQueryStream->window = window;
+    genQueryStream->state = GEN_QUERY_STREAM_INIT;
+
+    return (0);
+}
+
+static int
+ackGenQueryPage (genQueryStream_t *genQueryStream, int ack)
+{
+    int myBuf;
+    int nbytes;
+
+    genQueryStream->ackLen = 0;
+    myBuf = htonl (ack);
+    nbytes = myWrite (genQueryStream->conn->sock, (void *) &myBuf,
+      sizeof (myBuf), SOCK_TYPE, NULL);
+    if (nbytes != sizeof (myBuf)) {
+        rodsLog (LOG_ERROR,
+          "ackGenQueryPage: wrote %d bytes, errno = %d", nbytes, errno);
+        genQueryStream->state = GEN_QUERY_STREAM_DONE;
+        return (SYS_HEADER_WRITE_LEN_ERR - errno);
+    }
+    return (0);
+}
+
+/* procGenQueryPage - turn a reply of the stream into genQueryOut. Returns
+ * CAT_NO_ROWS_FOUND after the last page */
+static int
+procGenQueryPage (genQueryStream_t *genQueryStream, int status,
+genQueryCompactOut_t *genQueryCompactOut, genQueryOut_t **genQueryOut)
+{
+    int status1;
+
+    if (status == SYS_SVR_TO_CLI_GEN_QUERY_PAGE) {
+        /* more to come. acked in the next call */
+        genQueryStream->ackLen = getGenQueryCompactSize (genQueryCompactOut);
+        if (genQueryStream->ackLen <= 0) genQueryStream->ackLen = 1;
+        if (genQueryCompactOut == NULL) return (SYS_INTERNAL_NULL_INPUT_ERR);
+        status = compactToGenQueryOut (genQueryCompactOut, genQueryOut);
+        freeGenQueryCompactOut (&genQueryCompactOut);
+        return (status);
+    }
+
+    /* the final reply */
+    genQueryStream->state = GEN_QUERY_STREAM_DONE;
+    if (status < 0) {
+        freeGenQueryCompactOut (&genQueryCompactOut);
+        return (status);
+    }
+    if (genQueryCompactOut == NULL || genQueryCompactOut->rowCnt <= 0) {
+        freeGenQueryCompactOut (&genQueryCompactOut);
+        return (CAT_NO_ROWS_FOUND);
+    }
+    status1 = compactToGenQueryOut (genQueryCompactOut, genQueryOut);
+    freeGenQueryCompactOut (&genQueryCompactOut);
+    if (status1 < 0) return (status1);
+    (*genQueryOut)->continueInx = 0;
+    return (status);
+}
+
+/* nextGenQueryPaged - rcGenQueryStreamNext for a server without streams */
+static int
+nextGenQueryPaged (genQueryStream_t *genQueryStream,
+genQueryOut_t **genQueryOut)
+{
+    genQueryInp_t *genQueryInp = genQueryStream->genQueryInp;
+    int status;
+
+    genQueryInp->continueInx = genQueryStream->continueInx;
+    status = rcGenQuery (genQueryStream->conn, genQueryInp, genQueryOut);
+    if (status < 0) {
+        genQueryStream->state = GEN_QUERY_STREAM_DONE;
+        return (status);
+    }
+    genQueryStream->continueInx = (*genQueryOut)->continueInx;
+    if (genQueryStream->continueInx <= 0)
+        genQueryStream->state = GEN_QUERY_STREAM_DONE;
+    return (status);
+}
+
+static int
+sendGenQueryStreamReq (genQueryStream_t *genQueryStream)
+{
+    rcComm_t *conn = genQueryStream->conn;
+    genQueryInp_t myGenQueryInp;
+    keyValPair_t *condInput = &genQueryStream->genQueryInp->condInput;
+    char tmpStr[NAME_LEN];
+    int i, apiInx, status;
+
+    /* the same query with the window added */
+    myGenQueryInp = *genQueryStream->genQueryInp;
+    memset (&myGenQueryInp.condInput, 0, sizeof (keyValPair_t));
+    for (i = 0; i < condInput->len; i++) {
+        if (strcmp (condInput->keyWord[i], GEN_QUERY_WINDOW_KW) == 0) continue;
+        addKeyVal (&myGenQueryInp.condInput, condInput->keyWord[i],
+          condInput->value[i]);
+    }
+    snprintf (tmpStr, NAME_LEN, "%d", genQueryStream->window);
+    addKeyVal (&myGenQueryInp.condInput, GEN_QUERY_WINDOW_KW, tmpStr);
+
+    freeRError (conn->rError);
+    conn->rError = NULL;
+
+    apiInx = apiTableLookup (GEN_QUERY_STREAM_AN);
+    if (apiInx < 0) {
+        clearKeyVal (&myGenQueryInp.condInput);
+        return (apiInx);
+    }
+    status = sendApiRequest (conn, apiInx, (void *) &myGenQueryInp, NULL);
+    clearKeyVal (&myGenQueryInp.condInput);
+    if (status < 0) return (status);
+    conn->apiInx = apiInx;
+
+    return (0);
+}
+
+/* rcGenQueryStreamNext - get the next page of the stream. Returns
+ * CAT_NO_ROWS_FOUND after the last page. The pages of a server without
+ * streams are read with rcGenQuery.
+ */
+int
+rcGenQueryStreamNext (genQueryStream_t *genQueryStream,
+genQueryOut_t **genQueryOut)
+{
+    rcComm_t *conn;
+    genQueryCompactOut_t *genQueryCompactOut = NULL;
+    int status;
+
+    if (genQueryStream == NULL || genQueryOut == NULL)
+        return (USER__NULL_INPUT_ERR);
+    conn = genQueryStream->conn;
+    *genQueryOut = NULL;
+
+    switch (genQueryStream->state) {
+      case GEN_QUERY_STREAM_INIT:
+#ifdef USE_SSL
+        /* the acks are not sent through SSL */
+        if (conn->ssl_on) {
+            genQueryStream->state = GEN_QUERY_STREAM_PAGED;
+            return (nextGenQueryPaged (genQueryStream, genQueryOut));
+        }
+#endif
+        if (conn->genQueryStream == GEN_QUERY_STREAM_OFF) {
+            genQueryStream->state = GEN_QUERY_STREAM_PAGED;
+            return (nextGenQueryPaged (genQueryStream, genQueryOut));
+        }
+        status = sendGenQueryStreamReq (genQueryStream);
+        if (status < 0) {
+            genQueryStream->state = GEN_QUERY_STREAM_DONE;
+            return (status);
+        }
+        status = readAndProcApiReply (conn, conn->apiInx,
+          (void **) &genQueryCompactOut, NULL);
+        if (status == SYS_UNMATCHED_API_NUM) {
+            /* an old server */
+            freeGenQueryCompactOut (&genQueryCompactOut);
+            conn->genQueryStream = GEN_QUERY_STREAM_OFF;
+            genQueryStream->state = GEN_QUERY_STREAM_PAGED;
+            return (nextGenQueryPaged (genQueryStream, genQueryOut));
+        }
+        conn->genQueryStream = GEN_QUERY_STREAM_ON;
+        genQueryStream->state = GEN_QUERY_STREAM_BUSY;
+        return (procGenQueryPage (genQueryStream, status,
+          genQueryCompactOut, genQueryOut));
+      case GEN_QUERY_STREAM_BUSY:
+        if (genQueryStream->ackLen > 0) {
+            status = ackGenQueryPage (genQueryStream, genQueryStream->ackLen);
+            if (status < 0) return (status);
+        }
+        status = readAndProcApiReply (conn, conn->apiInx,
+          (void **) &genQueryCompactOut, NULL);
+        return (procGenQueryPage (genQueryStream, status,
+          genQueryCompactOut, genQueryOut));
+      case GEN_QUERY_STREAM_PAGED:
+        return (nextGenQueryPaged (genQueryStream, genQueryOut));
+      default:
+        return (CAT_NO_ROWS_FOUND);
+    }
+}
+
+/* rcGenQueryStreamClose - end the stream. If the agent is still sending,
+ * cancel it and read the rest of the pages. This must be called before
+ * the conn is used for anything else.
+ */
+int
+rcGenQueryStreamClose (genQueryStream_t *genQueryStream)
+{
+    rcComm_t *conn;
+    genQueryCompactOut_t *genQueryCompactOut = NULL;
+    genQueryOut_t *genQueryOut = NULL;
+    genQueryInp_t *genQueryInp;
+    int status = 0;
+    int savedMaxRows;
+
+    if (genQueryStream == NULL || genQueryStream->conn == NULL)
+        return (0);
+    conn = genQueryStream->conn;
+    genQueryInp = genQueryStream->genQueryInp;
+
+    if (genQueryStream->state == GEN_QUERY_STREAM_BUSY) {
+        status = ackGenQueryPage (genQueryStream, GEN_QUERY_STREAM_CANCEL);
+        while (status >= 0) {
+            status = readAndProcApiReply (conn, conn->apiInx,
+              (void **) &genQueryCompactOut, NULL);
+            freeGenQueryCompactOut (&genQueryCompactOut);
+            if (status != SYS_SVR_TO_CLI_GEN_QUERY_PAGE) break;
+            /* sent before the cancel got there */
+            status = ackGenQueryPage (genQueryStream, GEN_QUERY_STREAM_CANCEL);
+        }
+    } else if (genQueryStream->state == GEN_QUERY_STREAM_PAGED &&
+      genQueryStream->continueInx > 0) {
+        /* close out the statement */
+        savedMaxRows = genQueryInp->maxRows;
+        genQueryInp->maxRows = 0;
+        genQueryInp->continueInx = genQueryStream->continueInx;
+        status = rcGenQuery (conn, genQueryInp, &genQueryOut);
+        freeGenQueryOut (&genQueryOut);
+        genQueryInp->maxRows = savedMaxRows;
+        genQueryInp->continueInx = 0;
+    }
+    genQueryStream->state = GEN_QUERY_STREAM_DONE;
+
+    if (status < 0 && status != CAT_NO_ROWS_FOUND)
+        return (status);
+    else
+        return (0);
+}
@@ -0,0 +1,83 @@
+/*** Copyright (c), The Regents of the University of California            ***
+ *** For more information please refer to files in the COPYRIGHT directory ***/
+/* chksumEngine.h - header file for chksumEngine.c */
+
+#ifndef CHKSUM_ENGINE_H
+#define CHKSUM_ENGINE_H
+
+#include "rodsDef.h"
+#include "rodsType.h"
+#include "global.h"
+#include "md5.h"
+#include "sha256.h"
+
+/* env variable giving the scheme of the chksums computed by this client
+ * or server (set in irodsctl for the server). One of the CHKSUM_NAMEs
+ * below. md5 is used if it is not set. */
+#define CHKSUM_SCHEME_KW	"irodsChksumScheme"
+/* env variable giving the number of threads used to chksum a local file
+ * with the sha2tree scheme */
+#define TREE_CHKSUM_THREADS_KW	"irodsTreeChksumThreads"
+#define DEF_TREE_CHKSUM_THREADS	4
+#define MAX_TREE_CHKSUM_THREADS	16
+
+/* definition for the chksum scheme */
+#define DEF_CHKSUM_SCHEME		0	/* whatever CHKSUM_SCHEME_KW says */
+#define MD5_CHKSUM_SCHEME		1
+#define SHA256_CHKSUM_SCHEME		2
+#define SHA256_TREE_CHKSUM_SCHEME	3
+
+#define MD5_CHKSUM_NAME		"md5"
+#define SHA256_CHKSUM_NAME	"sha2"
+#define SHA256_TREE_CHKSUM_NAME	"sha2tree"
+
+/* A md5 chksum is stored as 32 hex digits as it always was. Other chksums
+ * are stored as the scheme name, CHKSUM_SCHEME_SEP and the base64 encoded
+ * digest, e.g. "sha2:ungWv48Bz+pBQUDeXa4iI7ADYaOWF3qctBD/YfIAFa0=". */
+#define CHKSUM_SCHEME_SEP	':'
+
+/* A sha2tree chksum is the sha256 of the sha256 digests of each
+ * TREE_CHKSUM_CHUNK_SZ chunk of the data in order. An empty file has one
+ * empty chunk. The chunks can be hashed in parallel. */
+#define TREE_CHKSUM_CHUNK_SZ	(64 * 1024 * 1024)
+#define TREE_CHKSUM_BUF_SZ	(1024 * 1024)
+
+typedef struct ChksumEngine {
+    int scheme;
+    int chunkCnt;		/* sha2tree - number of chunks done */
+    rodsLong_t chunkLen;	/* sha2tree - bytes in the current chunk */
+    MD5_CTX md5Context;
+    SHA256_CTX shaContext;	/* sha2 or the current sha2tree chunk */
+    SHA256_CTX treeContext;	/* sha2tree - the chunk digests */
+} chksumEngine_t;
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+int
+getDefChksumScheme ();
+int
+getChksumSchemeByName (char *schemeName);
+int
+getChksumScheme (char *chksumStr);
+int
+initChksumEngine (chksumEngine_t *chksumEngine, int scheme);
+int
+updateChksumEngine (chksumEngine_t *chksumEngine, unsigned char *buf,
+int len);
+int
+finalChksumEngine (chksumEngine_t *chksumEngine, char *chksumStr);
+int
+treeDigestsToChksum (unsigned char *chunkDigest, int chunkCnt,
+char *chksumStr);
+int
+getTreeChksumThreads ();
+int
+treeChksumLocFile (char *fileName, char *chksumStr, int numThreads);
+
+#ifdef  __cplusplus
+}
+#endif
+
+#endif	/* CHKSUM_ENGINE_H */
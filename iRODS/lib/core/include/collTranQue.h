@@ -0,0 +1,116 @@
+/*** Copyright (c), The Regents of the University of California            ***
+ *** For more information please refer to files in the COPYRIGHT directory ***/
+
+/* collTranQue.h - header file for collTranQue.c
+ */
+
+#ifndef COLL_TRAN_QUE_H
+#define COLL_TRAN_QUE_H
+
+#include "rodsClient.h"
+#include "parseCommandLine.h"
+
+#ifdef USE_BOOST
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition.hpp>
+#else
+#ifdef PARA_OPR
+#include <pthread.h>
+#endif
+#endif
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+#define MAX_COLL_TRAN_CONNS	16	/* max value of the --conns option */
+/* the max number of files queued or in flight. Files complete out of
+ * order, so this is also the max number of files past the restart point
+ * that may already be done when a -X run is restarted */
+#define COLL_TRAN_QUE_SZ	64
+/* env variable giving the max number of files started per second by all
+ * the workers. 0 or not set means no cap */
+#define COLL_TRAN_RATE_KW	"collTranRate"
+
+/* definition for state in collTranJob_t */
+#define COLL_TRAN_JOB_QUED	0
+#define COLL_TRAN_JOB_BUSY	1
+#define COLL_TRAN_JOB_DONE	2
+
+typedef struct {
+    char srcPath[MAX_NAME_LEN];
+    char targPath[MAX_NAME_LEN];
+    rodsLong_t dataSize;
+    int createMode;
+    int forceFlag;	/* may have been done out of order before a restart */
+    specColl_t specColl;	/* collClass is NO_SPEC_COLL if not a spec coll */
+    int state;
+    int status;
+} collTranJob_t;
+
+typedef struct CollTranQue collTranQue_t;
+
+/* the function doing one file on a worker connection. dataObjInp is the
+ * private copy of the worker */
+typedef int (collTranFunc_t) (collTranQue_t *collTranQue, rcComm_t *conn,
+dataObjInp_t *dataObjInp, collTranJob_t *collTranJob);
+
+typedef struct {
+    collTranQue_t *collTranQue;
+    rcComm_t *conn;
+    dataObjInp_t dataObjInp;
+#ifdef USE_BOOST
+    boost::thread*	workerThr;
+#else
+#ifndef windows_platform
+    pthread_t workerThr;
+#endif
+#endif
+} collTranWorker_t;
+
+struct CollTranQue {
+    rcComm_t *conn;		/* the main conn */
+    rodsEnv *rodsEnv;
+    rodsArguments_t *rodsArgs;
+    rodsRestart_t *rodsRestart;
+    collTranFunc_t *tranFunc;
+    int numWorkers;
+    collTranWorker_t worker[MAX_COLL_TRAN_CONNS];
+    collTranJob_t job[COLL_TRAN_QUE_SZ];
+    int doneSeq;	/* jobs before doneSeq are done in walk order */
+    int startSeq;	/* the next job to hand to a worker */
+    int queSeq;		/* the next job to queue */
+    int forceCnt;	/* the number of next jobs to queue with forceFlag */
+    int maxRate;	/* the COLL_TRAN_RATE_KW cap */
+    rodsLong_t nextStartTime;	/* in microsec. The next start under maxRate */
+    int status;		/* the first error */
+    int stopFlag;	/* a -X run stops at the first error */
+    int exitFlag;
+#ifdef USE_BOOST
+    boost::mutex*		lock;
+    boost::condition_variable_any* cond;
+#else
+#ifndef windows_platform
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+#endif
+#endif
+};
+
+int
+initCollTranQue (collTranQue_t *collTranQue, rcComm_t *conn,
+rodsEnv *myRodsEnv, rodsArguments_t *rodsArgs, dataObjInp_t *dataObjInp,
+rodsRestart_t *rodsRestart, int numConns, collTranFunc_t *tranFunc);
+int
+queCollTranJob (collTranQue_t *collTranQue, char *srcPath, char *targPath,
+rodsLong_t dataSize, int createMode, specColl_t *specColl);
+int
+setCollTranQueForResume (collTranQue_t *collTranQue);
+int
+endCollTranQue (collTranQue_t *collTranQue);
+#ifdef  __cplusplus
+}
+#endif
+
+#endif	/* COLL_TRAN_QUE_H */
@@ -8,6 +8,7 @@
 #include "rodsClient.h"
 #include "parseCommandLine.h"
 #include "rodsPath.h"
+#include "collTranQue.h"
 
 #ifdef  __cplusplus
 extern "C" {
@@ -28,6 +29,13 @@ dataObjInp_t *dataObjOprInp, rodsRestart_t *rodsRestart);
 int
 getCollUtil (rcComm_t **myConn, char *srcColl, char *targDir,
 rodsEnv *myRodsEnv, rodsArguments_t *rodsArgs, dataObjInp_t *dataObjOprInp,
+rodsRestart_t *rodsRestart, collTranQue_t *collTranQue);
+int
+getCollTranFile (collTranQue_t *collTranQue, rcComm_t *conn,
+dataObjInp_t *dataObjOprInp, collTranJob_t *collTranJob);
+int
+parallelGetCollUtil (rcComm_t **myConn, char *srcColl, char *targDir,
+rodsEnv *myRodsEnv, rodsArguments_t *rodsArgs, dataObjInp_t *dataObjOprInp,
 rodsRestart_t *rodsRestart);
 
 #ifdef  __cplusplus
@@ -11,6 +11,7 @@
 #include "rods.h"
 #include "global.h"
 #include "md5.h"
+#include "chksumEngine.h"
 
 #ifdef  __cplusplus
 extern "C" {
@@ -19,9 +20,14 @@ extern "C" {
 int
 chksumLocFile (char *fileName, char *chksumStr);
 int
+chksumLocFileByScheme (char *fileName, char *chksumStr, int chksumScheme);
+int
 md5ToStr (unsigned char *digest, char *chksumStr);
 int
 rcChksumLocFile (char *fileName, char *chksumFlag, keyValPair_t *condInput);
+int
+rcChksumLocFileByScheme (char *fileName, char *chksumFlag,
+keyValPair_t *condInput, int chksumScheme);
 
 #ifdef  __cplusplus
 }
@@ -189,6 +189,8 @@ queryCollInColl (queryHandle_t *queryHandle, char *collection,
 int flags, genQueryInp_t *genQueryInp,
 genQueryOut_t **genQueryOut);
 int
+getCollQueryMaxRows (queryHandle_t *queryHandle);
+int
 queryDataObjInColl (queryHandle_t *queryHandle, char *collection,
 int flags, genQueryInp_t *genQueryInp,
 genQueryOut_t **genQueryOut, keyValPair_t *condInput);
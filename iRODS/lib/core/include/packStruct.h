@@ -92,11 +92,25 @@ typedef struct packItem {
     int dimSize[MAX_PACK_DIM];	/* the size of each dimension */
     int hintDim;		/* the Hint dimension */
     int hintDimSize[MAX_PACK_DIM];	/* the size of each Hint dimension */
+    int staticDim;	/* dim and hintDim already resolved when compiled */
     struct packItem *parent;
     struct packItem *prev;
     struct packItem *next;
 } packItem_t;
 
+/* a pack instruction parsed once and cached by name. Items with
+ * constant dimensions have them resolved (staticDim set). packItem
+ * lists handed to the pack routines are copies of itemHead */
+#define PACK_INST_HASH_SZ	512
+
+typedef struct packInstCache {
+    char *name;
+    packInstructArray_t *myPackTable;	/* the user table it was found with */
+    char *packInstruct;
+    packItem_t *itemHead;
+    struct packInstCache *next;
+} packInstCache_t;
+
 typedef struct {
     int numBuf;
     bytesBuf_t *bBufArray;	/* pointer to an array of bytesBuf_t */
@@ -118,6 +132,13 @@ packInstructArray_t *myPackTable, irodsProt_t irodsProt);
 int
 parsePackInstruct (char *packInstruct, packItem_t **packItemHead);
 int
+getCompiledPackInstruct (char *name, packInstructArray_t *myPackTable,
+packInstCache_t **outCache);
+packItem_t *
+dupPackItemList (packItem_t *packItemHead);
+int
+resolveStaticDims (packItem_t *packItemHead);
+int
 copyStrFromPiBuf (char **inBuf, char *outBuf, int dependentFlag);
 int
 packTypeLookup (char *typeName);
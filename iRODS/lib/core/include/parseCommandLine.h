@@ -103,6 +103,9 @@ typedef struct {
    int version;
    int retries;
    int retriesValue;
+   int conns;
+   int connsValue;
+   int portalStat;
    int regRepl;
 
    int parallel;
@@ -8,6 +8,7 @@
 #include "rodsClient.h"
 #include "parseCommandLine.h"
 #include "rodsPath.h"
+#include "collTranQue.h"
 
 #ifdef  __cplusplus
 extern "C" {
@@ -20,6 +21,32 @@ extern "C" {
 
 #define DEF_PHY_BUN_ROOT_DIR	"/tmp"
 
+/* a bulk put batch sent by a helper thread while the next one is filled */
+typedef struct {
+    rcComm_t *conn;
+    rodsRestart_t *rodsRestart;
+    bulkOprInp_t bulkOprInp;
+    bytesBuf_t bytesBuf;
+    int count;
+    int size;
+    char lastTargPath[MAX_NAME_LEN];
+    struct timeval startTime;
+    int busy;		/* the batch is being sent */
+    int status;
+    int exitFlag;
+#ifdef USE_BOOST
+    boost::thread*		sendThr;
+    boost::mutex*		lock;
+    boost::condition_variable_any* cond;
+#else
+#ifndef windows_platform
+    pthread_t sendThr;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+#endif
+#endif
+} bulkPutSend_t;
+
 typedef struct {
     int flags;
     int count;
@@ -31,6 +58,7 @@ typedef struct {
     char cachedSubPhyBunDir[MAX_NAME_LEN];
     char phyBunPath[MAX_NUM_BULK_OPR_FILES][MAX_NAME_LEN];
     bytesBuf_t bytesBuf;
+    bulkPutSend_t *bulkPutSend;	/* NULL if the batches are sent inline */
 } bulkOprInfo_t;
 
 int
@@ -47,7 +75,15 @@ rodsRestart_t *rodsRestart);
 int
 putDirUtil (rcComm_t **myConn, char *srcDir, char *targColl,
 rodsEnv *myRodsEnv, rodsArguments_t *rodsArgs, dataObjInp_t *dataObjOprInp,
-bulkOprInp_t *bulkOprInp, rodsRestart_t *rodsRestart, bulkOprInfo_t *bulkOprInfo);
+bulkOprInp_t *bulkOprInp, rodsRestart_t *rodsRestart, bulkOprInfo_t *bulkOprInfo,
+collTranQue_t *collTranQue);
+int
+putCollTranFile (collTranQue_t *collTranQue, rcComm_t *conn,
+dataObjInp_t *dataObjOprInp, collTranJob_t *collTranJob);
+int
+parallelPutDirUtil (rcComm_t **myConn, char *srcDir, char *targColl,
+rodsEnv *myRodsEnv, rodsArguments_t *rodsArgs, dataObjInp_t *dataObjOprInp,
+rodsRestart_t *rodsRestart);
 int
 bulkPutDirUtil (rcComm_t **myConn, char *srcDir, char *targColl,
 rodsEnv *myRodsEnv, rodsArguments_t *rodsArgs, dataObjInp_t *dataObjOprInp,
@@ -66,6 +102,16 @@ int
 sendBulkPut (rcComm_t *conn, bulkOprInp_t *bulkOprInp,
 bulkOprInfo_t *bulkOprInfo, rodsArguments_t *rodsArgs);
 int
+initBulkPutSend (rcComm_t *conn, bulkOprInp_t *bulkOprInp, 
+rodsRestart_t *rodsRestart, bulkOprInfo_t *bulkOprInfo);
+int
+queBulkPut (rcComm_t *conn, bulkOprInp_t *bulkOprInp,
+bulkOprInfo_t *bulkOprInfo, rodsArguments_t *rodsArgs);
+int
+finishBulkPut (bulkOprInfo_t *bulkOprInfo, rodsArguments_t *rodsArgs);
+int
+endBulkPutSend (bulkOprInfo_t *bulkOprInfo);
+int
 clearBulkOprInfo (bulkOprInfo_t *bulkOprInfo);
 int
 setForceFlagForRestart (bulkOprInp_t *bulkOprInp, bulkOprInfo_t *bulkOprInfo);
@@ -132,6 +132,8 @@ typedef struct {
     procState_t reconnThrState;
     operProgress_t operProgress;
     fileRestart_t fileRestart;
+    int genQueryCompact;	/* GEN_QUERY_COMPACT_ON/OFF. 0 if not known */
+    int genQueryStream;		/* GEN_QUERY_STREAM_ON/OFF. 0 if not known */
 #ifdef USE_SSL
     int ssl_on;
     SSL_CTX *ssl_ctx;
@@ -111,6 +111,18 @@ int
 catGenQueryOut (genQueryOut_t *targGenQueryOut, genQueryOut_t *genQueryOut,
 int maxRowCnt);
 int
+genQueryOutToCompact (genQueryOut_t *genQueryOut, 
+genQueryCompactOut_t **genQueryCompactOut);
+int
+compactToGenQueryOut (genQueryCompactOut_t *genQueryCompactOut,
+genQueryOut_t **genQueryOut);
+int
+freeGenQueryCompactOut (genQueryCompactOut_t **genQueryCompactOut);
+int
+clearGenQueryCompactOut (genQueryCompactOut_t *genQueryCompactOut);
+int
+getGenQueryCompactSize (genQueryCompactOut_t *genQueryCompactOut);
+int
 clearBulkOprInp (bulkOprInp_t *bulkOprInp);
 int
 getUnixUid (char *userName);
@@ -24,6 +24,41 @@ extern "C" {
 
 #define MAX_PROGRESS_CNT	8
 
+/* env variable turning on the statistics of each portal stream. The
+ * server (set in irodsctl) logs them and the --stats option of iput and
+ * iget prints both sides. Clients also read this variable. As a keyword
+ * of the request, it asks the server to send its side back: one message
+ * per stream, starting with PORTAL_STAT_MSG, in the rError of the reply
+ * to rcOprComplete */
+#define PORTAL_STAT_KW		"portalStat"
+#define PORTAL_STAT_MSG		"portalStat:"
+/* the start of the message carrying the chksum of a get done with
+ * CHKSUM_AT_CLOSE_KW, in the rError of the reply to rcOprComplete */
+#define PORTAL_CHKSUM_MSG	"portalChksum:"
+#define PORTAL_STALL_USEC	100000	/* a wait this long is a stall */
+
+/* definition for statType of addPortalStatUsec */
+#define PORTAL_STAT_SOCK	0	/* blocked on the socket */
+#define PORTAL_STAT_DISK	1	/* blocked on the file */
+
+/* the statistics of a portal stream. With a portal pipe, the wait for a
+ * free buf counts as blocked on the write side */
+typedef struct PortalStat {
+    int threadNum;
+    rodsLong_t bytes;
+    rodsLong_t startUsec;
+    rodsLong_t elapsedUsec;
+    rodsLong_t sockUsec;
+    rodsLong_t diskUsec;
+    rodsLong_t stallUsec;	/* in the waits of PORTAL_STALL_USEC or more */
+    int stallCnt;
+    int tcpInfoFlag;		/* the TCP_INFO values below are set */
+    unsigned int rttUsec;
+    unsigned int rttVarUsec;
+    unsigned int sndCwnd;	/* in segments */
+    unsigned int totalRetrans;
+} portalStat_t;
+
 typedef struct RcPortalTransferInp {
     rcComm_t *conn;
     int destFd;
@@ -31,8 +66,45 @@ typedef struct RcPortalTransferInp {
     int threadNum;
     int status;
     rodsLong_t	bytesWritten;
+    portalStat_t *portalStat;	/* non NULL to keep the statistics */
 } rcPortalTransferInp_t;
     
+/* env variable giving the number of rotating buffers of a portal stream.
+ * With 2 or more, a helper thread writes out one buffer while the stream
+ * reads the next one into another. 0 or 1 turns the pipelined mode off */
+#define PORTAL_PIPE_BUF_CNT_KW	"portalPipeBufCnt"
+#define DEF_PORTAL_PIPE_BUF_CNT	2
+#define MAX_PORTAL_PIPE_BUF_CNT	8
+
+/* the write side of a portal pipe. Returns the bytes written or an error */
+typedef int (portalPipeWriteFunc_t) (void *writeArg, char *buf, int len);
+
+/* the rotating buffers of a pipelined portal stream. The stream fills
+ * buf[head], the helper thread writes out buf[tail] */
+typedef struct PortalPipe {
+    int bufCnt;
+    char *buf[MAX_PORTAL_PIPE_BUF_CNT];
+    int len[MAX_PORTAL_PIPE_BUF_CNT];
+    int head;
+    int tail;
+    int filledCnt;	/* number of bufs waiting to be written */
+    int status;		/* the first write error */
+    int exitFlag;
+    portalPipeWriteFunc_t *writeFunc;
+    void *writeArg;
+#ifdef USE_BOOST
+    boost::thread*		writeThr;
+    boost::mutex*		lock;
+    boost::condition_variable_any* cond;
+#else
+#ifndef windows_platform
+    pthread_t writeThr;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+#endif
+#endif
+} portalPipe_t;
+
 typedef enum {
     RBUDP_CLIENT,
     RBUDP_SERVER
@@ -58,6 +130,43 @@ int
 sendTranHeader (int sock, int oprType, int flags, rodsLong_t offset,
 rodsLong_t length);
 int
+getPortalPipeBufCnt ();
+int
+initPortalPipe (portalPipe_t *portalPipe, int bufCnt,
+portalPipeWriteFunc_t *writeFunc, void *writeArg);
+char *
+getPortalPipeBuf (portalPipe_t *portalPipe);
+int
+queuePortalPipeBuf (portalPipe_t *portalPipe, int len);
+int
+drainPortalPipe (portalPipe_t *portalPipe);
+int
+endPortalPipe (portalPipe_t *portalPipe);
+int
+isPortalStatOn ();
+void
+setPortalStatOn ();
+rodsLong_t
+getPortalStatUsec (portalStat_t *portalStat);
+void
+beginPortalStat (portalStat_t *portalStat, int threadNum);
+void
+addPortalStatUsec (portalStat_t *portalStat, int statType,
+rodsLong_t startUsec);
+void
+endPortalStat (portalStat_t *portalStat, int sock, rodsLong_t bytes);
+int
+isPortalStatMsg (char *msg);
+int
+printSvrPortalStat (rcComm_t *conn);
+int
+isPortalChksumMsg (char *msg);
+int
+getPortalChksum (rcComm_t *conn, char *chksumStr);
+int
+fmtPortalStat (portalStat_t *portalStat, int numThreads, char *outStr,
+int maxLen);
+int
 fillBBufWithFile (rcComm_t *conn, bytesBuf_t *myBBuf, char *locFilePath, 
 rodsLong_t dataSize);
 int
@@ -133,6 +133,8 @@
 #define SYS_SVR_TO_CLI_PUT_ACTION 99999990
 #define SYS_SVR_TO_CLI_GET_ACTION 99999991
 #define SYS_RSYNC_TARGET_MODIFIED 99999992	/* target modified */
+#define SYS_SVR_TO_CLI_GEN_QUERY_PAGE 99999993	/* a page of a GenQuery 
+						 * stream. more to come */
 
 /* definition for iRODS server to client action request from a microservice. 
  * these definitions are put in the "label" field of MsParam */  
@@ -154,6 +154,10 @@
 #define PATH_REG_NOT_ALLOWED		-129000
 #define SYS_INVALID_INPUT_PARAM		-130000
 #define SYS_GROUP_RETRIEVE_ERR          -131000
+#define SYS_AGENT_POOL_ERR		-132000
+#define SYS_SVR_CFG_SNAP_ERR		-133000
+#define SYS_THREAD_RESOURCE_ERR		-134000
+#define SYS_TRAN_THR_TUNE_ERR		-135000
 
 /* 300,000 - 499,000 - user input type error */
 #define USER_AUTH_SCHEME_ERR		-300000
@@ -206,6 +210,7 @@
 #define BULK_OPR_MISMATCH_FOR_RESTART	-357000
 #define OBJ_PATH_DOES_NOT_EXIST		-358000
 #define SYMLINKED_BUNFILE_NOT_ALLOWED	-359000
+#define USER_CHKSUM_SCHEME_ERR		-360000
 
 
 /* 500,000 to 800,000 - file driver error */
@@ -14,6 +14,9 @@
 
 #define MAX_SQL_ATTR    50
 #define MAX_SQL_ROWS   256
+/* the max maxRows of a query sent with the compact encoding below. Pages
+ * of old servers are kept to MAX_SQL_ROWS */
+#define MAX_COMPACT_SQL_ROWS   4096
 
 /* In genQueryInp_t, selectInp is a int index, int value pair. The index
  * represents the attribute index. 
@@ -70,6 +73,26 @@ typedef struct GenQueryOut {
     sqlResult_t sqlResult[MAX_SQL_ATTR]; 
 } genQueryOut_t; 
 
+/* genQueryCompactOut_t is the compact encoding of genQueryOut_t used by
+ * GEN_QUERY_COMPACT_AN. The values are not padded. The value of row i of
+ * attribute j is the NULL terminated string at value + offset[j*rowCnt+i].
+ */
+typedef struct GenQueryCompactOut {
+    int rowCnt;
+    int attriCnt;
+    int continueInx;
+    int totalRowCount;
+    int *attriInx;	/* array of attriCnt */
+    int offsetCnt;	/* rowCnt * attriCnt */
+    int *offset;
+    int valueLen;
+    char *value;
+} genQueryCompactOut_t;
+
+/* definition for genQueryCompact in rcComm_t */
+#define GEN_QUERY_COMPACT_ON	1
+#define GEN_QUERY_COMPACT_OFF	-1	/* the server does not have it */
+
 /* 
 Bits to set in the value array (genQueryInp.selectInp.value[i]) to
 order the results by that column, either ascending or decending.  This
@@ -50,6 +50,22 @@
 #define STATUS_STRING_KW     "statusString"
 #define DATA_MAP_ID_KW    "dataMapId"
 #define NO_PARA_OP_KW    "noParaOpr"
+#define DYN_PORTAL_CHUNK_KW    "dynPortalChunk" /* the client can take 
+					       * portal chunks in any order */
+#define STREAM_CHKSUM_KW    "streamChksum" /* chksum the data while it
+					      * streams through the portal.
+					      * value is the chksum scheme */
+#define CHKSUM_AT_CLOSE_KW    "chksumAtClose" /* the client of a get with
+					      * VERIFY_CHKSUM_KW takes the
+					      * chksum with the reply to 
+					      * rcOprComplete */
+#define CHAIN_PORTAL_KW    "chainPortal" /* forward the data to the portal
+					      * of the next replica of a
+					      * replication chain. value is
+					      * "portNum:cookie:hostAddr" */
+#define GEN_QUERY_WINDOW_KW    "genQueryWindow" /* bytes of result pages
+					      * a GenQuery stream may send
+					      * before the client acks them */
 #define LOCAL_PATH_KW    "localPath"
 #define RSYNC_MODE_KW    "rsyncMode"
 #define RSYNC_DEST_PATH_KW    "rsyncDestPath"
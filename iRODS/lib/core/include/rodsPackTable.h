@@ -83,6 +83,7 @@ packInstructArray_t RodsPackTable[] = {
 	{"GenQueryInp_PI", GenQueryInp_PI},
 	{"SqlResult_PI", SqlResult_PI},
 	{"GenQueryOut_PI", GenQueryOut_PI},
+	{"GenQueryCompactOut_PI", GenQueryCompactOut_PI},
 	{"DataObjInfo_PI", DataObjInfo_PI},
 	{"TransStat_PI", TransStat_PI},
 	{"TransferStat_PI", TransferStat_PI},
@@ -39,6 +39,24 @@
 						 * RECONN_TIMEOUT if this
 						 * env is set */
 
+/* binary msg header. The client asks for it by appending 
+ * BIN_MSG_HEADER_OPT to the option of the startupPack. A server that 
+ * supports it answers with a binary header, and from then on each side 
+ * sends a binary header on a socket once it has received one on it. 
+ * In place of the XML header length, a binary header starts with 
+ * BIN_MSG_HEADER_MARK, followed by binMsgHeader_t in network order. */
+#define BIN_MSG_HEADER_OPT	"%binHdr"
+#define BIN_MSG_HEADER_MARK	(-0x4248)
+#define MAX_BIN_MSG_HEADER_SOCK	1024	/* sock >= this always use XML */
+
+typedef struct binMsgHeader {
+    int typeInx;	/* index into BinMsgHeaderType */
+    int msgLen;
+    int errorLen;
+    int bsLen;
+    int intInfo;
+} binMsgHeader_t;
+
 /* definition for socket close function */
 #define READING_FROM_CLI	0
 #define PROCESSING_API		1
@@ -57,6 +75,9 @@ int sockOpenForInConn (rsComm_t *rsComm, int *portNum, char **addr, int proto);
 int rodsSetSockOpt (int sock, int windowSize);
 int readMsgHeader (int sock, msgHeader_t *myHeader, struct timeval *tv);
 int writeMsgHeader (int sock, msgHeader_t *myHeader);
+int setSockBinMsgHeader (int sock, int flag);
+int getSockBinMsgHeader (int sock);
+int stripBinMsgHeaderOpt (char *option);
 int readVersion (int sock, version_t **myVersion);
 int myRead (int sock, void *buf, int len, irodsDescType_t irodsDescType,
 int *bytesRead, struct timeval *tv);
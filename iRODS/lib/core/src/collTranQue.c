@@ -0,0 +1,403 @@
+/*** Copyright (c), The Regents of the University of California            ***
+ *** For more information please refer to files in the COPYRIGHT directory ***/
+/* collTranQue.c - a bounded queue of the files of a recursive transfer,
+ * done by a pool of worker threads each with its own connection.
+ * The collection walker queues the files in walk order. A file may
+ * still use a parallel transfer of its own on the worker connection.
+ */
+
+#include "collTranQue.h"
+#include "rodsErrorTable.h"
+#include "rodsLog.h"
+#include "rcGlobalExtern.h"
+#ifndef windows_platform
+#include <sys/time.h>
+#endif
+
+#if defined(USE_BOOST) || defined(PARA_OPR)
+static void
+lockCollTranQue (collTranQue_t *collTranQue)
+{
+#ifdef USE_BOOST
+    collTranQue->lock->lock ();
+#else
+    pthread_mutex_lock (&collTranQue->lock);
+#endif
+}
+
+static void
+unlockCollTranQue (collTranQue_t *collTranQue)
+{
+#ifdef USE_BOOST
+    collTranQue->lock->unlock ();
+#else
+    pthread_mutex_unlock (&collTranQue->lock);
+#endif
+}
+
+/* waitCollTranQue - wait for a state change with the lock held */
+static void
+waitCollTranQue (collTranQue_t *collTranQue)
+{
+#ifdef USE_BOOST
+    collTranQue->cond->wait (*collTranQue->lock);
+#else
+    pthread_cond_wait (&collTranQue->cond, &collTranQue->lock);
+#endif
+}
+
+static void
+wakeCollTranQue (collTranQue_t *collTranQue)
+{
+#ifdef USE_BOOST
+    collTranQue->cond->notify_all ();
+#else
+    pthread_cond_broadcast (&collTranQue->cond);
+#endif
+}
+
+/* retireCollTranJobs - move doneSeq past the jobs done in walk order and
+ * record each of them in the restart file the way a serial walk does.
+ * With restart on, doneSeq stays at a failed job. Called with the lock held.
+ */
+static void
+retireCollTranJobs (collTranQue_t *collTranQue)
+{
+    rodsRestart_t *rodsRestart = collTranQue->rodsRestart;
+    collTranJob_t *job;
+    int status;
+
+    while (collTranQue->doneSeq < collTranQue->startSeq) {
+	job = &collTranQue->job[collTranQue->doneSeq % COLL_TRAN_QUE_SZ];
+	if (job->state != COLL_TRAN_JOB_DONE) break;
+	if (rodsRestart->fd > 0) {
+	    if (job->status < 0) break;
+	    rodsRestart->curCnt ++;
+	    status = writeRestartFile (rodsRestart, job->targPath);
+	    if (status < 0) {
+		if (collTranQue->status >= 0) collTranQue->status = status;
+		collTranQue->stopFlag = 1;
+		break;
+	    }
+	}
+	collTranQue->doneSeq++;
+    }
+}
+
+/* getCollTranStartDelay - take the next start slot under maxRate and 
+ * return the microsec to wait for it. Called with the lock held.
+ */
+static rodsLong_t
+getCollTranStartDelay (collTranQue_t *collTranQue)
+{
+    struct timeval tv;
+    rodsLong_t now, startTime;
+
+    if (collTranQue->maxRate <= 0) return 0;
+
+    (void) gettimeofday (&tv, NULL);
+    now = (rodsLong_t) tv.tv_sec * 1000000 + tv.tv_usec;
+    if (collTranQue->nextStartTime > now) {
+	startTime = collTranQue->nextStartTime;
+    } else {
+	startTime = now;
+    }
+    collTranQue->nextStartTime = startTime + 1000000 / collTranQue->maxRate;
+    return startTime - now;
+}
+
+static void
+collTranWorker (collTranWorker_t *worker)
+{
+    collTranQue_t *collTranQue = worker->collTranQue;
+    operProgress_t *operProgress = &worker->conn->operProgress;
+    operProgress_t *totalProgress = &collTranQue->conn->operProgress;
+    collTranJob_t *job;
+    rodsLong_t numFilesDone = 0;
+    rodsLong_t fileSizeDone = 0;
+    rodsLong_t startDelay;
+    int status;
+
+    lockCollTranQue (collTranQue);
+    while (1) {
+	while (collTranQue->startSeq == collTranQue->queSeq &&
+	  collTranQue->exitFlag == 0 && collTranQue->stopFlag == 0)
+	    waitCollTranQue (collTranQue);
+	if (collTranQue->stopFlag != 0 ||
+	  collTranQue->startSeq == collTranQue->queSeq) break;
+
+	job = &collTranQue->job[collTranQue->startSeq % COLL_TRAN_QUE_SZ];
+	collTranQue->startSeq++;
+	job->state = COLL_TRAN_JOB_BUSY;
+	if (gGuiProgressCB != NULL) {
+	    /* report the totals of all workers */
+	    operProgress->totalNumFiles = totalProgress->totalNumFiles;
+	    operProgress->totalFileSize = totalProgress->totalFileSize;
+	    operProgress->totalNumFilesDone = numFilesDone =
+	      totalProgress->totalNumFilesDone;
+	    operProgress->totalFileSizeDone = fileSizeDone =
+	      totalProgress->totalFileSizeDone;
+	}
+	startDelay = getCollTranStartDelay (collTranQue);
+	unlockCollTranQue (collTranQue);
+
+	if (startDelay > 0) usleep ((useconds_t) startDelay);
+
+	status = collTranQue->tranFunc (collTranQue, worker->conn,
+	  &worker->dataObjInp, job);
+	if (status < 0) {
+	    rodsLogError (LOG_ERROR, status,
+	      "collTranWorker: transfer of %s failed. status = %d",
+	      job->srcPath, status);
+	}
+
+	lockCollTranQue (collTranQue);
+	if (gGuiProgressCB != NULL) {
+	    totalProgress->totalNumFilesDone +=
+	      operProgress->totalNumFilesDone - numFilesDone;
+	    totalProgress->totalFileSizeDone +=
+	      operProgress->totalFileSizeDone - fileSizeDone;
+	}
+	job->status = status;
+	job->state = COLL_TRAN_JOB_DONE;
+	if (status < 0) {
+	    if (collTranQue->status >= 0) collTranQue->status = status;
+	    /* a restart resumes from the first failed file */
+	    if (collTranQue->rodsRestart->fd > 0) collTranQue->stopFlag = 1;
+	}
+	retireCollTranJobs (collTranQue);
+	wakeCollTranQue (collTranQue);
+    }
+    unlockCollTranQue (collTranQue);
+}
+
+static void
+setCollTranTicket (rcComm_t *conn, char *ticket)
+{
+    ticketAdminInp_t ticketAdminInp;
+    int status;
+
+    ticketAdminInp.arg1 = "session";
+    ticketAdminInp.arg2 = ticket;
+    ticketAdminInp.arg3 = "";
+    ticketAdminInp.arg4 = "";
+    ticketAdminInp.arg5 = "";
+    ticketAdminInp.arg6 = "";
+    status = rcTicketAdmin (conn, &ticketAdminInp);
+    if (status != 0) {
+        rodsLogError (LOG_NOTICE, status,
+          "setCollTranTicket: rcTicketAdmin error, status = %d", status);
+    }
+}
+
+static void
+freeCollTranWorker (collTranWorker_t *worker)
+{
+    rcDisconnect (worker->conn);
+    worker->conn = NULL;
+    clearKeyVal (&worker->dataObjInp.condInput);
+}
+#endif	/* USE_BOOST || PARA_OPR */
+
+/* initCollTranQue - connect numConns workers to the server of conn and
+ * start their threads. numConns is capped at MAX_COLL_TRAN_CONNS. Each
+ * worker gets a copy of dataObjInp. Returns the number of workers started.
+ * On error, the caller should do the files one at a time on conn.
+ */
+int
+initCollTranQue (collTranQue_t *collTranQue, rcComm_t *conn,
+rodsEnv *myRodsEnv, rodsArguments_t *rodsArgs, dataObjInp_t *dataObjInp,
+rodsRestart_t *rodsRestart, int numConns, collTranFunc_t *tranFunc)
+{
+#if defined(USE_BOOST) || defined(PARA_OPR)
+    collTranWorker_t *worker;
+    rErrMsg_t errMsg;
+    char *tmpStr;
+    int reconnFlag;
+    int status = 0;
+    int i;
+
+    memset (collTranQue, 0, sizeof (collTranQue_t));
+    if (numConns <= 0) return USER_INPUT_OPTION_ERR;
+    if (numConns > MAX_COLL_TRAN_CONNS) numConns = MAX_COLL_TRAN_CONNS;
+
+    collTranQue->conn = conn;
+    collTranQue->rodsEnv = myRodsEnv;
+    collTranQue->rodsArgs = rodsArgs;
+    collTranQue->rodsRestart = rodsRestart;
+    collTranQue->tranFunc = tranFunc;
+    if ((tmpStr = getenv (COLL_TRAN_RATE_KW)) != NULL) {
+	collTranQue->maxRate = atoi (tmpStr);
+    }
+#ifdef USE_BOOST
+    collTranQue->lock = new boost::mutex;
+    collTranQue->cond = new boost::condition_variable_any;
+#else
+    pthread_mutex_init (&collTranQue->lock, NULL);
+    pthread_cond_init (&collTranQue->cond, NULL);
+#endif
+
+    if (rodsArgs->reconnect == True) {
+        reconnFlag = RECONN_TIMEOUT;
+    } else {
+        reconnFlag = NO_RECONN;
+    }
+    for (i = 0; i < numConns; i++) {
+	worker = &collTranQue->worker[collTranQue->numWorkers];
+	memset (&errMsg, 0, sizeof (errMsg));
+	worker->conn = rcConnect (conn->host, conn->portNum,
+	  myRodsEnv->rodsUserName, myRodsEnv->rodsZone, reconnFlag, &errMsg);
+	if (worker->conn == NULL) {
+	    status = errMsg.status;
+	    rodsLogError (LOG_NOTICE, status,
+	      "initCollTranQue: rcConnect to %s error, status = %d",
+	      conn->host, status);
+	    break;
+	}
+	status = clientLogin (worker->conn);
+	if (status != 0) {
+	    rodsLogError (LOG_NOTICE, status,
+	      "initCollTranQue: clientLogin to %s error, status = %d",
+	      conn->host, status);
+	    rcDisconnect (worker->conn);
+	    worker->conn = NULL;
+	    break;
+	}
+	if (rodsArgs->ticket == True && rodsArgs->ticketString != NULL)
+	    setCollTranTicket (worker->conn, rodsArgs->ticketString);
+
+	worker->collTranQue = collTranQue;
+	worker->dataObjInp = *dataObjInp;
+	memset (&worker->dataObjInp.condInput, 0, sizeof (keyValPair_t));
+	replKeyVal (&dataObjInp->condInput, &worker->dataObjInp.condInput);
+#ifdef USE_BOOST
+	worker->workerThr = new boost::thread (collTranWorker, worker);
+#else
+	if (pthread_create (&worker->workerThr, pthread_attr_default,
+	  (void *(*)(void *)) collTranWorker, (void *) worker) != 0) {
+	    status = SYS_THREAD_RESOURCE_ERR;
+	    freeCollTranWorker (worker);
+	    break;
+	}
+#endif
+	collTranQue->numWorkers++;
+    }
+
+    if (collTranQue->numWorkers == 0) {
+#ifdef USE_BOOST
+	delete collTranQue->lock;
+	delete collTranQue->cond;
+#else
+	pthread_mutex_destroy (&collTranQue->lock);
+	pthread_cond_destroy (&collTranQue->cond);
+#endif
+	if (status >= 0) status = SYS_THREAD_RESOURCE_ERR;
+	return status;
+    }
+    return collTranQue->numWorkers;
+#else
+    return SYS_PARA_OPR_NO_SUPPORT;
+#endif
+}
+
+/* queCollTranJob - queue a file for the workers. Blocks while
+ * COLL_TRAN_QUE_SZ files are queued or in flight. Returns the error that
+ * stopped the queue if a -X run has failed.
+ */
+int
+queCollTranJob (collTranQue_t *collTranQue, char *srcPath, char *targPath,
+rodsLong_t dataSize, int createMode, specColl_t *specColl)
+{
+#if defined(USE_BOOST) || defined(PARA_OPR)
+    collTranJob_t *job;
+    int status = 0;
+
+    lockCollTranQue (collTranQue);
+    while (collTranQue->queSeq - collTranQue->doneSeq >= COLL_TRAN_QUE_SZ &&
+      collTranQue->stopFlag == 0)
+	waitCollTranQue (collTranQue);
+    if (collTranQue->stopFlag != 0) {
+	status = collTranQue->status;
+    } else {
+	job = &collTranQue->job[collTranQue->queSeq % COLL_TRAN_QUE_SZ];
+	rstrcpy (job->srcPath, srcPath, MAX_NAME_LEN);
+	rstrcpy (job->targPath, targPath, MAX_NAME_LEN);
+	job->dataSize = dataSize;
+	job->createMode = createMode;
+	if (specColl != NULL) {
+	    job->specColl = *specColl;
+	} else {
+	    memset (&job->specColl, 0, sizeof (specColl_t));
+	    job->specColl.collClass = NO_SPEC_COLL;
+	}
+	if (collTranQue->forceCnt > 0) {
+	    job->forceFlag = 1;
+	    collTranQue->forceCnt--;
+	} else {
+	    job->forceFlag = 0;
+	}
+	job->state = COLL_TRAN_JOB_QUED;
+	job->status = 0;
+	collTranQue->queSeq++;
+	wakeCollTranQue (collTranQue);
+    }
+    unlockCollTranQue (collTranQue);
+    return status;
+#else
+    return SYS_PARA_OPR_NO_SUPPORT;
+#endif
+}
+
+/* setCollTranQueForResume - called when a -X run resumes. The files after
+ * the restart point may have been done out of order by the failed run,
+ * so the next COLL_TRAN_QUE_SZ files are queued with forceFlag.
+ */
+int
+setCollTranQueForResume (collTranQue_t *collTranQue)
+{
+#if defined(USE_BOOST) || defined(PARA_OPR)
+    lockCollTranQue (collTranQue);
+    collTranQue->forceCnt = COLL_TRAN_QUE_SZ;
+    unlockCollTranQue (collTranQue);
+    return 0;
+#else
+    return SYS_PARA_OPR_NO_SUPPORT;
+#endif
+}
+
+/* endCollTranQue - wait for the queued files, stop the workers and
+ * disconnect them. Returns the first error of the workers.
+ */
+int
+endCollTranQue (collTranQue_t *collTranQue)
+{
+#if defined(USE_BOOST) || defined(PARA_OPR)
+    int i;
+
+    lockCollTranQue (collTranQue);
+    collTranQue->exitFlag = 1;
+    wakeCollTranQue (collTranQue);
+    unlockCollTranQue (collTranQue);
+
+    for (i = 0; i < collTranQue->numWorkers; i++) {
+#ifdef USE_BOOST
+	collTranQue->worker[i].workerThr->join ();
+	delete collTranQue->worker[i].workerThr;
+#else
+	pthread_join (collTranQue->worker[i].workerThr, NULL);
+#endif
+	freeCollTranWorker (&collTranQue->worker[i]);
+    }
+    collTranQue->numWorkers = 0;
+#ifdef USE_BOOST
+    delete collTranQue->lock;
+    delete collTranQue->cond;
+#else
+    pthread_mutex_destroy (&collTranQue->lock);
+    pthread_cond_destroy (&collTranQue->cond);
+#endif
+    return collTranQue->status;
+#else
+    return SYS_PARA_OPR_NO_SUPPORT;
+#endif
+}
@@ -180,7 +180,8 @@ chkObjConsistency (rcComm_t *conn, rodsArguments_t *myRodsArgs, char *inpPath, c
 		if ( srcSize == objSize ) {
 			if ( myRodsArgs->verifyChecksum == True ) {
 				if ( strcmp(objChksum,"") != 0 ) {
-					status = chksumLocFile(inpPath, locChksum);
+					status = chksumLocFileByScheme(inpPath, locChksum,
+					  getChksumScheme(objChksum));
 					if ( status == 0 ) {
 						if ( strcmp(locChksum, objChksum) != 0 ) {
 							printf ("CORRUPTION: local file %s checksum not consistent with \
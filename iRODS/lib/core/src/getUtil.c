@@ -125,9 +125,16 @@ rodsPathInp_t *rodsPathInp)
 	} else if (targPath->objType ==  LOCAL_DIR_T) {
             setStateForRestart (conn, &rodsRestart, targPath, myRodsArgs);
 	    addKeyVal (&dataObjOprInp.condInput, TRANSLATED_PATH_KW, "");
-	    status = getCollUtil (myConn, rodsPathInp->srcPath[i].outPath,
-              targPath->outPath, myRodsEnv, myRodsArgs, &dataObjOprInp,
-	      &rodsRestart);
+	    if (myRodsArgs->conns == True && myRodsArgs->connsValue > 1 &&
+	      conn->fileRestart.flags != FILE_RESTART_ON) {
+	        status = parallelGetCollUtil (myConn, 
+		  rodsPathInp->srcPath[i].outPath, targPath->outPath, 
+		  myRodsEnv, myRodsArgs, &dataObjOprInp, &rodsRestart);
+	    } else {
+	        status = getCollUtil (myConn, rodsPathInp->srcPath[i].outPath,
+                  targPath->outPath, myRodsEnv, myRodsArgs, &dataObjOprInp,
+	          &rodsRestart, NULL);
+	    }
 #if 0
             if (rodsRestart.fd > 0 && status < 0) {
                 close (rodsRestart.fd);
@@ -282,6 +289,10 @@ dataObjInp_t *dataObjOprInp, rodsRestart_t *rodsRestart)
         addKeyVal (&dataObjOprInp->condInput, FORCE_FLAG_KW, "");
     }
 
+    if (rodsArgs->portalStat == True) {
+        setPortalStatOn ();
+    }
+
     if (rodsArgs->verifyChecksum == True) {
         addKeyVal (&dataObjOprInp->condInput, VERIFY_CHKSUM_KW, "");
     }
@@ -398,7 +409,7 @@ dataObjInp_t *dataObjOprInp, rodsRestart_t *rodsRestart)
 int
 getCollUtil (rcComm_t **myConn, char *srcColl, char *targDir, 
 rodsEnv *myRodsEnv, rodsArguments_t *rodsArgs, dataObjInp_t *dataObjOprInp,
-rodsRestart_t *rodsRestart)
+rodsRestart_t *rodsRestart, collTranQue_t *collTranQue)
 {
     int status = 0; 
     int savedStatus = 0;
@@ -412,6 +423,7 @@ rodsRestart_t *rodsRestart)
     collEnt_t collEnt;
     dataObjInp_t childDataObjInp;
     rcComm_t *conn;
+    int restartState;
 
     if (srcColl == NULL || targDir == NULL) {
        rodsLog (LOG_ERROR,
@@ -475,9 +487,16 @@ rodsRestart_t *rodsRestart)
             snprintf (srcChildPath, MAX_NAME_LEN, "%s/%s",
               collEnt.collName, collEnt.dataName);
 
+            restartState = rodsRestart->restartState;
             status = chkStateForResume (conn, rodsRestart, targChildPath,
               rodsArgs, LOCAL_FILE_T, &dataObjOprInp->condInput, 1);
 
+            if (status > 0 && collTranQue != NULL &&
+              (restartState & LAST_PATH_MATCHED) != 0 &&
+              rodsRestart->restartState == OPR_RESUMED) {
+                setCollTranQueForResume (collTranQue);
+            }
+
             if (status < 0) {
                 /* restart failed */
                 break;
@@ -485,6 +504,17 @@ rodsRestart_t *rodsRestart)
                 continue;
             }
 
+            if (collTranQue != NULL) {
+                /* the workers write the restart file in walk order */
+                status = queCollTranJob (collTranQue, srcChildPath,
+                  targChildPath, mySize, collEnt.dataMode,
+                  dataObjOprInp->specColl);
+                if (status < 0) {
+                    savedStatus = status;
+                    if (rodsRestart->fd > 0) break;
+                }
+                continue;
+            }
             status = getDataObjUtil (conn, srcChildPath,
              targChildPath, mySize, collEnt.dataMode, myRodsEnv, rodsArgs, 
 	     dataObjOprInp);
@@ -517,7 +547,7 @@ rodsRestart_t *rodsRestart)
 	    else 
 	        childDataObjInp.specColl = NULL;
             status = getCollUtil (myConn, collEnt.collName, targChildPath,
-              myRodsEnv, rodsArgs, &childDataObjInp, rodsRestart);
+              myRodsEnv, rodsArgs, &childDataObjInp, rodsRestart, collTranQue);
 	    if (status < 0 && status != CAT_NO_ROWS_FOUND) {
                 rodsLogError (LOG_ERROR, status,
                   "getCollUtil: getCollUtil failed for %s. status = %d",
@@ -539,3 +569,86 @@ rodsRestart_t *rodsRestart)
     }
 }
 
+/* getCollTranFile - the collTranFunc_t of parallelGetCollUtil */
+int
+getCollTranFile (collTranQue_t *collTranQue, rcComm_t *conn,
+dataObjInp_t *dataObjOprInp, collTranJob_t *collTranJob)
+{
+    int status;
+    int forceAdded = 0;
+
+    if (collTranJob->specColl.collClass != NO_SPEC_COLL) {
+	dataObjOprInp->specColl = &collTranJob->specColl;
+    } else {
+	dataObjOprInp->specColl = NULL;
+    }
+    if (collTranJob->forceFlag > 0 &&
+      getValByKey (&dataObjOprInp->condInput, FORCE_FLAG_KW) == NULL) {
+	addKeyVal (&dataObjOprInp->condInput, FORCE_FLAG_KW, "");
+	forceAdded = 1;
+    }
+    status = getDataObjUtil (conn, collTranJob->srcPath, 
+      collTranJob->targPath, collTranJob->dataSize, collTranJob->createMode,
+      collTranQue->rodsEnv, collTranQue->rodsArgs, dataObjOprInp);
+    if (forceAdded > 0) rmKeyVal (&dataObjOprInp->condInput, FORCE_FLAG_KW);
+    dataObjOprInp->specColl = NULL;
+
+    return status;
+}
+
+/* parallelGetCollUtil - get a collection with rodsArgs->connsValue
+ * connections. The walk reads the collection ahead of the downloads,
+ * makes the local directories and queues the data objects in getCollUtil
+ * order. Each object is downloaded on a worker connection.
+ */
+int
+parallelGetCollUtil (rcComm_t **myConn, char *srcColl, char *targDir,
+rodsEnv *myRodsEnv, rodsArguments_t *rodsArgs, dataObjInp_t *dataObjOprInp,
+rodsRestart_t *rodsRestart)
+{
+    int status, queStatus;
+    collTranQue_t *collTranQue;
+
+    if (rodsArgs->recursive != True) {
+        rodsLog (LOG_ERROR,
+        "parallelGetCollUtil: -r option must be used for getting %s collection",
+         targDir);
+        return (USER_INPUT_OPTION_ERR);
+    }
+
+    if (rodsArgs->redirectConn == True) {
+        int reconnFlag;
+        if (rodsArgs->reconnect == True) {
+            reconnFlag = RECONN_TIMEOUT;
+        } else {
+            reconnFlag = NO_RECONN;
+        }
+        /* reconnect to the resource server before the workers connect */
+        rstrcpy (dataObjOprInp->objPath, srcColl, MAX_NAME_LEN);
+        redirectConnToRescSvr (myConn, dataObjOprInp, myRodsEnv, reconnFlag);
+        rodsArgs->redirectConn = 0;    /* only do it once */
+    }
+
+    collTranQue = (collTranQue_t *) malloc (sizeof (collTranQue_t));
+    status = initCollTranQue (collTranQue, *myConn, myRodsEnv, rodsArgs,
+      dataObjOprInp, rodsRestart, rodsArgs->connsValue, getCollTranFile);
+    if (status < 0) {
+        rodsLogError (LOG_NOTICE, status,
+          "parallelGetCollUtil: initCollTranQue error, getting %s serially",
+          srcColl);
+        free (collTranQue);
+        return getCollUtil (myConn, srcColl, targDir, myRodsEnv, rodsArgs,
+          dataObjOprInp, rodsRestart, NULL);
+    }
+
+    status = getCollUtil (myConn, srcColl, targDir, myRodsEnv, rodsArgs,
+      dataObjOprInp, rodsRestart, collTranQue);
+
+    queStatus = endCollTranQue (collTranQue);
+    free (collTranQue);
+    if (queStatus < 0) {
+        return queStatus;
+    } else {
+        return status;
+    }
+}
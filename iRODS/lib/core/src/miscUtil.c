@@ -302,6 +302,8 @@ int inx, int rowCnt)
 /* genAllInCollQCond - Generate a sqlCondInp for querying every thing under  
  * a collection. 
  * The server will handle special char such as "-" and "%".
+ * A 3.2 server runs this condition on COL_COLL_NAME or COL_COLL_PARENT_NAME
+ * as "descendant_of" (the collection tree) instead of a LIKE scan.
  */
 
 int
@@ -321,6 +323,18 @@ genAllInCollQCond (char *collection, char *collQCond)
     return (0);
 }
 
+/* getCollQueryMaxRows - the page size of the collection queries. A client
+ * reads large pages (see rcGenQuery). A server keeps to MAX_SQL_ROWS.
+ */
+int
+getCollQueryMaxRows (queryHandle_t *queryHandle)
+{
+    if (queryHandle->connType == RC_COMM) 
+        return MAX_COMPACT_SQL_ROWS;
+    else
+        return MAX_SQL_ROWS;
+}
+
 /* queryCollInColl - query the subCollections in a collection.
  */
 
@@ -353,7 +367,7 @@ genQueryOut_t **genQueryOut)
     addInxIval (&genQueryInp->selectInp, COL_COLL_INFO1, 1);
     addInxIval (&genQueryInp->selectInp, COL_COLL_INFO2, 1);
 
-    genQueryInp->maxRows = MAX_SQL_ROWS;
+    genQueryInp->maxRows = getCollQueryMaxRows (queryHandle);
 
     status = (*queryHandle->genQuery) (
       (rcComm_t *) queryHandle->conn, genQueryInp, genQueryOut);
@@ -402,7 +416,7 @@ genQueryOut_t **genQueryOut, keyValPair_t *condInput)
 
     setQueryInpForData (flags, genQueryInp);
 
-    genQueryInp->maxRows = MAX_SQL_ROWS;
+    genQueryInp->maxRows = getCollQueryMaxRows (queryHandle);
     genQueryInp->options = RETURN_TOTAL_ROW_COUNT;
 
     status = (*queryHandle->genQuery) (
@@ -10,6 +10,34 @@
 #include "rcGlobalExtern.h"
 #include "base64.h"
 #include "rcMisc.h"
+#ifndef windows_platform
+#ifdef USE_BOOST
+#include <boost/thread/mutex.hpp>
+#else
+#ifdef PARA_OPR
+#include <pthread.h>
+#endif
+#endif
+#endif
+
+/* the compiled pack instructions. Entries live for the life of the
+ * process. Portal and bulk threads may pack at the same time */
+static packInstCache_t *PackInstCache[PACK_INST_HASH_SZ];
+#if !defined(windows_platform) && defined(USE_BOOST)
+static boost::mutex PackInstCacheLock;
+#define LOCK_PACK_INST_CACHE()	PackInstCacheLock.lock ()
+#define UNLOCK_PACK_INST_CACHE()	PackInstCacheLock.unlock ()
+#elif !defined(windows_platform) && defined(PARA_OPR)
+static pthread_mutex_t PackInstCacheLock = PTHREAD_MUTEX_INITIALIZER;
+#define LOCK_PACK_INST_CACHE()	pthread_mutex_lock (&PackInstCacheLock)
+#define UNLOCK_PACK_INST_CACHE()	pthread_mutex_unlock (&PackInstCacheLock)
+#else
+#define LOCK_PACK_INST_CACHE()
+#define UNLOCK_PACK_INST_CACHE()
+#endif
+
+static int
+isStaticDimStr (char *dimStr, packItem_t *packItemHead);
 
 int 
 packStruct (void *inStruct, bytesBuf_t **packedResult, char *packInstName,
@@ -408,10 +436,11 @@ packInstructArray_t *myPackTable, packOpr_t packOpr)
         return status;
     }
 
-    status = resolveDepInArray (myPackedItem, myPackTable);
-
-    if (status < 0) {
-        return status;
+    if (myPackedItem->staticDim == 0) {
+        status = resolveDepInArray (myPackedItem, myPackTable);
+        if (status < 0) {
+            return status;
+        }
     }
 
     /* set up the pointer */
@@ -737,6 +766,194 @@ matchPackInstruct (char *name, packInstructArray_t *myPackTable)
     return (NULL);
 }
 
+/* getCompiledPackInstruct - get the parsed packItem list of the pack
+ * instruction name from the cache, parsing and adding it on the first
+ * call. The itemHead of the output must not be modified. Use
+ * dupPackItemList to get a working copy.
+ */
+int
+getCompiledPackInstruct (char *name, packInstructArray_t *myPackTable,
+packInstCache_t **outCache)
+{
+    packInstCache_t *tmpCache;
+    char *packInstruct;
+    packItem_t *packItemHead = NULL;
+    unsigned int hashVal = 5381;
+    char *tmpPtr;
+    int status;
+
+    *outCache = NULL;
+    for (tmpPtr = name; *tmpPtr != '\0'; tmpPtr++) {
+	hashVal = ((hashVal << 5) + hashVal) + (unsigned char) *tmpPtr;
+    }
+    hashVal = hashVal % PACK_INST_HASH_SZ;
+
+    LOCK_PACK_INST_CACHE ();
+    tmpCache = PackInstCache[hashVal];
+    while (tmpCache != NULL) {
+	if (tmpCache->myPackTable == myPackTable && 
+	  strcmp (tmpCache->name, name) == 0) {
+	    *outCache = tmpCache;
+	    UNLOCK_PACK_INST_CACHE ();
+	    return 0;
+	}
+	tmpCache = tmpCache->next;
+    }
+    UNLOCK_PACK_INST_CACHE ();
+
+    packInstruct = (char *) matchPackInstruct (name, myPackTable);
+    if (packInstruct == NULL) {
+	return (SYS_UNMATCH_PACK_INSTRUCTI_NAME);
+    }
+
+    status = parsePackInstruct (packInstruct, &packItemHead);
+    if (status < 0) {
+	freePackedItem (packItemHead);
+	return (status);
+    }
+    resolveStaticDims (packItemHead);
+
+    tmpCache = (packInstCache_t *) malloc (sizeof (packInstCache_t));
+    memset (tmpCache, 0, sizeof (packInstCache_t));
+    tmpCache->name = strdup (name);
+    tmpCache->myPackTable = myPackTable;
+    tmpCache->packInstruct = packInstruct;
+    tmpCache->itemHead = packItemHead;
+
+    /* another thread may have added it in the meantime. Just add ours
+     * in front - both are the same */
+    LOCK_PACK_INST_CACHE ();
+    tmpCache->next = PackInstCache[hashVal];
+    PackInstCache[hashVal] = tmpCache;
+    UNLOCK_PACK_INST_CACHE ();
+
+    *outCache = tmpCache;
+    return 0;
+}
+
+/* dupPackItemList - make a working copy of a compiled packItem list */
+
+packItem_t *
+dupPackItemList (packItem_t *packItemHead)
+{
+    packItem_t *tmpItem, *newItem;
+    packItem_t *newHead = NULL;
+    packItem_t *prevItem = NULL;
+
+    tmpItem = packItemHead;
+    while (tmpItem != NULL) {
+	newItem = (packItem_t *) malloc (sizeof (packItem_t));
+	*newItem = *tmpItem;
+	if (tmpItem->name != NULL) newItem->name = strdup (tmpItem->name);
+	newItem->parent = NULL;
+	newItem->prev = prevItem;
+	newItem->next = NULL;
+	if (prevItem == NULL) {
+	    newHead = newItem;
+	} else {
+	    prevItem->next = newItem;
+	}
+	prevItem = newItem;
+	tmpItem = tmpItem->next;
+    }
+    return (newHead);
+}
+
+/* resolveStaticDims - resolve the array and hint dimensions of items
+ * that only use numbers and PackConstantTable values, so they don't
+ * have to be resolved each time the item is packed. Dims that depend
+ * on an int item (e.g. value(rowCnt)) are left for resolveDepInArray
+ * at pack time.
+ */
+int
+resolveStaticDims (packItem_t *packItemHead)
+{
+    packItem_t *tmpItem, tmpCopy;
+    char dimStr[MAX_PI_LEN];
+    char *inPtr, *bufPtr;
+    int isStatic;
+    int status;
+
+    for (tmpItem = packItemHead; tmpItem != NULL; tmpItem = tmpItem->next) {
+	if (tmpItem->typeInx == PACK_DEPENDENT_TYPE ||
+	  tmpItem->typeInx == PACK_INT_DEPENDENT_TYPE ||
+	  tmpItem->name == NULL) {
+	    continue;
+	}
+
+	/* check every string inside [] and () */
+	isStatic = 1;
+	bufPtr = NULL;
+	for (inPtr = tmpItem->name; *inPtr != '\0' && isStatic; inPtr++) {
+	    if (*inPtr == '[' || *inPtr == '(') {
+		bufPtr = dimStr;
+	    } else if (*inPtr == ']' || *inPtr == ')') {
+		if (bufPtr == NULL) {
+		    isStatic = 0;
+		    break;
+		}
+		*bufPtr = '\0';
+		isStatic = isStaticDimStr (dimStr, packItemHead);
+		bufPtr = NULL;
+	    } else if (bufPtr != NULL) {
+		if (bufPtr - dimStr >= MAX_PI_LEN - 1) {
+		    isStatic = 0;
+		    break;
+		}
+		*bufPtr = *inPtr;
+		bufPtr++;
+	    }
+	}
+	if (isStatic == 0 || bufPtr != NULL) continue;
+
+	/* resolve a detached copy so a format error is still reported 
+	 * at pack time */
+	tmpCopy = *tmpItem;
+	tmpCopy.name = strdup (tmpItem->name);
+	tmpCopy.prev = tmpCopy.next = tmpCopy.parent = NULL;
+	status = resolveDepInArray (&tmpCopy, NULL);
+	if (status < 0) {
+	    free (tmpCopy.name);
+	    continue;
+	}
+	free (tmpItem->name);
+	tmpCopy.prev = tmpItem->prev;
+	tmpCopy.next = tmpItem->next;
+	tmpCopy.parent = tmpItem->parent;
+	*tmpItem = tmpCopy;
+	tmpItem->staticDim = 1;
+    }
+    return (0);
+}
+
+/* isStaticDimStr - a dimension is static if it is a number or a
+ * PackConstantTable name that is not also an int item of the struct */
+
+static int
+isStaticDimStr (char *dimStr, packItem_t *packItemHead)
+{
+    packItem_t *tmpItem;
+    int i, len;
+    char c;
+
+    if (isAllDigit (dimStr)) return 1;
+
+    len = strlen (dimStr);
+    for (tmpItem = packItemHead; tmpItem != NULL; tmpItem = tmpItem->next) {
+	if (tmpItem->name == NULL || strncmp (tmpItem->name, dimStr, len) != 0)
+	    continue;
+	c = tmpItem->name[len];
+	if (c == '\0' || c == '[' || c == '(') return 0;
+    }
+
+    i = 0;
+    while (strcmp (PackConstantTable[i].name, PACK_TABLE_END_PI) != 0) {
+	if (strcmp (PackConstantTable[i].name, dimStr) == 0) return 1;
+	i++;
+    }
+    return 0;
+}
+
 int 
 resolveDepInArray (packItem_t *myPackedItem, packInstructArray_t *myPackTable)
 {
@@ -1712,13 +1929,20 @@ int packFlag, irodsProt_t irodsProt, char *packInstructInp)
     void *packInstruct;
     int i, status;
     packItem_t *packItemHead, *tmpItem;
+    packInstCache_t *packInstCache = NULL;
 
     if (numElement == 0) {
 	return 0;
     }
 
     if (packInstructInp == NULL) {
-        packInstruct = matchPackInstruct (myPackedItem->name, myPackTable);
+        status = getCompiledPackInstruct (myPackedItem->name, myPackTable,
+	  &packInstCache);
+	if (status < 0 && status != SYS_UNMATCH_PACK_INSTRUCTI_NAME) {
+	    return (status);
+	}
+	packInstruct = packInstCache != NULL ? 
+	  packInstCache->packInstruct : NULL;
     } else {
 	packInstruct = packInstructInp;
     }
@@ -1734,10 +1958,14 @@ int packFlag, irodsProt_t irodsProt, char *packInstructInp)
 	int doubleInStruct;
 	packItemHead = NULL;
 
-	status = parsePackInstruct ((char*)packInstruct, &packItemHead);
-        if (status < 0) {
-            return (status);
-        }
+	if (packInstCache != NULL) {
+	    packItemHead = dupPackItemList (packInstCache->itemHead);
+	} else {
+	    status = parsePackInstruct ((char*)packInstruct, &packItemHead);
+            if (status < 0) {
+                return (status);
+            }
+	}
 	/* link it */
 	if (packItemHead != NULL) {
 	    packItemHead->parent = myPackedItem;
@@ -2468,6 +2696,7 @@ irodsProt_t irodsProt, char *packInstructInp)
     void *packInstruct;
     int i, status;
     packItem_t *unpackItemHead, *tmpItem;
+    packInstCache_t *packInstCache = NULL;
     int skipLen;
     int doubleInStruct;
 #if defined(solaris_platform)
@@ -2479,7 +2708,13 @@ irodsProt_t irodsProt, char *packInstructInp)
     }
 
     if (packInstructInp == NULL) {
-        packInstruct = matchPackInstruct (myPackedItem->name, myPackTable);
+        status = getCompiledPackInstruct (myPackedItem->name, myPackTable,
+          &packInstCache);
+        if (status < 0 && status != SYS_UNMATCH_PACK_INSTRUCTI_NAME) {
+            return (status);
+        }
+        packInstruct = packInstCache != NULL ?
+          packInstCache->packInstruct : NULL;
     } else {
         packInstruct = packInstructInp;
     }
@@ -2494,9 +2729,13 @@ irodsProt_t irodsProt, char *packInstructInp)
     for (i = 0; i < numElement; i++) {
         unpackItemHead = NULL;
 
-        status = parsePackInstruct ((char*)packInstruct, &unpackItemHead);
-        if (status < 0) {
-            return (status);
+        if (packInstCache != NULL) {
+            unpackItemHead = dupPackItemList (packInstCache->itemHead);
+        } else {
+            status = parsePackInstruct ((char*)packInstruct, &unpackItemHead);
+            if (status < 0) {
+                return (status);
+            }
         }
         /* link it */
         if (unpackItemHead != NULL) {
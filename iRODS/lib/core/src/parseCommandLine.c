@@ -171,6 +171,23 @@ parseCmdLineOpt (int argc, char **argv, char *optString, int includeLong,
             rodsArgs->wlock=True;
             argv[i]="-Z";
          }
+         if (strcmp("--conns", argv[i])==0) {
+            rodsArgs->conns=True;
+            argv[i]="-Z";
+            if (i + 2 <= argc) {
+               if (*argv[i+1] == '-') {
+                   rodsLog (LOG_ERROR,
+                    "--conns option needs an input number");
+                    return USER_INPUT_OPTION_ERR;
+               }
+               rodsArgs->connsValue=atoi(argv[i+1]);
+               argv[i+1]="-Z";
+            }
+         }
+         if (strcmp("--stats", argv[i])==0) {
+            rodsArgs->portalStat=True;
+            argv[i]="-Z";
+         }
          if (strcmp("--add", argv[i])==0) {
             rodsArgs->add=True;
             argv[i]="-Z";
@@ -126,10 +126,16 @@ rodsArguments_t *myRodsArgs, rodsPathInp_t *rodsPathInp)
 		  rodsPathInp->srcPath[i].outPath, targPath->outPath, 
 		  myRodsEnv, myRodsArgs, &dataObjOprInp, &bulkOprInp,
 		  &rodsRestart);
+	    } else if (myRodsArgs->conns == True && 
+	      myRodsArgs->connsValue > 1 &&
+	      conn->fileRestart.flags != FILE_RESTART_ON) {
+		status = parallelPutDirUtil (myConn, 
+		  rodsPathInp->srcPath[i].outPath, targPath->outPath, 
+		  myRodsEnv, myRodsArgs, &dataObjOprInp, &rodsRestart);
 	    } else {
 	        status = putDirUtil (myConn, rodsPathInp->srcPath[i].outPath,
                   targPath->outPath, myRodsEnv, myRodsArgs, &dataObjOprInp,
-	          &bulkOprInp, &rodsRestart, NULL);
+	          &bulkOprInp, &rodsRestart, NULL, NULL);
 	    }
 	} else {
 	    /* should not be here */
@@ -280,6 +286,10 @@ rodsRestart_t *rodsRestart)
 
     memset (dataObjOprInp, 0, sizeof (dataObjInp_t));
 
+    if (rodsArgs->portalStat == True) {
+        setPortalStatOn ();
+    }
+
     if (rodsArgs->bulk == True) {
         if (bulkOprInp == NULL) {
            rodsLog (LOG_ERROR,
@@ -486,7 +496,7 @@ int
 putDirUtil (rcComm_t **myConn, char *srcDir, char *targColl, 
 rodsEnv *myRodsEnv, rodsArguments_t *rodsArgs, dataObjInp_t *dataObjOprInp,
 bulkOprInp_t *bulkOprInp, rodsRestart_t *rodsRestart, 
-bulkOprInfo_t *bulkOprInfo)
+bulkOprInfo_t *bulkOprInfo, collTranQue_t *collTranQue)
 {
     int status = 0;
     int savedStatus = 0;
@@ -503,6 +513,7 @@ bulkOprInfo_t *bulkOprInfo)
     objType_t childObjType;
     rcComm_t *conn;
     int bulkFlag;
+    int restartState;
     rodsLong_t dataSize;
 
     if (srcDir == NULL || targColl == NULL) {
@@ -666,9 +677,16 @@ bulkOprInfo_t *bulkOprInfo)
 #endif	/* USE_BOOST_FS */
 	}
 
+	restartState = rodsRestart->restartState;
 	status = chkStateForResume (conn, rodsRestart, targChildPath,
 	  rodsArgs, childObjType, &dataObjOprInp->condInput, 1);
 
+	if (status > 0 && collTranQue != NULL && 
+	  (restartState & LAST_PATH_MATCHED) != 0 &&
+	  rodsRestart->restartState == OPR_RESUMED) {
+	    setCollTranQueForResume (collTranQue);
+	}
+
 	if (status < 0) {
 	    /* restart failed */
 #ifndef USE_BOOST_FS
@@ -689,12 +707,16 @@ bulkOprInfo_t *bulkOprInfo)
                 status = bulkPutFileUtil (conn, srcChildPath, targChildPath,
                   dataSize,  dataObjOprInp->createMode, myRodsEnv, rodsArgs,
                   bulkOprInp, bulkOprInfo);
+	    } else if (collTranQue != NULL) {
+		/* the workers write the restart file in walk order */
+		status = queCollTranJob (collTranQue, srcChildPath, 
+		  targChildPath, dataSize, dataObjOprInp->createMode, NULL);
 	    } else {
 		/* normal put */
                 status = putFileUtil (conn, srcChildPath, targChildPath,
                   dataSize, myRodsEnv, rodsArgs, dataObjOprInp);
 	    }
-	    if (rodsRestart->fd > 0) {
+	    if (rodsRestart->fd > 0 && collTranQue == NULL) {
 		if (status >= 0) {
 		    if (bulkFlag == BULK_OPR_SMALL_FILES) {
 			if (status > 0) {
@@ -710,6 +732,12 @@ bulkOprInfo_t *bulkOprInfo)
 		    }
 		}
 	    }
+        } else if (bulkFlag == BULK_OPR_SMALL_FILES) {
+	    /* the large files pass made the collection. conn may be busy
+	     * sending a bulk put */
+            status = putDirUtil (myConn, srcChildPath, targChildPath, 
+              myRodsEnv, rodsArgs, dataObjOprInp, bulkOprInp,
+	      rodsRestart, bulkOprInfo, collTranQue);
         } else {      /* a directory */
 #ifdef FILESYSTEM_META
             status = mkCollWithDirMeta (conn, targChildPath, srcChildPath);
@@ -722,7 +750,7 @@ bulkOprInfo_t *bulkOprInfo)
 	    }
             status = putDirUtil (myConn, srcChildPath, targChildPath, 
               myRodsEnv, rodsArgs, dataObjOprInp, bulkOprInp,
-	      rodsRestart, bulkOprInfo);
+	      rodsRestart, bulkOprInfo, collTranQue);
 
         }
 
@@ -748,6 +776,90 @@ bulkOprInfo_t *bulkOprInfo)
     }
 }
 
+/* putCollTranFile - the collTranFunc_t of parallelPutDirUtil */
+int
+putCollTranFile (collTranQue_t *collTranQue, rcComm_t *conn,
+dataObjInp_t *dataObjOprInp, collTranJob_t *collTranJob)
+{
+    int status;
+    int forceAdded = 0;
+
+    dataObjOprInp->createMode = collTranJob->createMode;
+#ifdef FILESYSTEM_META
+    getFileMetaFromPath (collTranJob->srcPath, &dataObjOprInp->condInput);
+#endif
+    if (collTranJob->forceFlag > 0 &&
+      getValByKey (&dataObjOprInp->condInput, FORCE_FLAG_KW) == NULL) {
+	addKeyVal (&dataObjOprInp->condInput, FORCE_FLAG_KW, "");
+	forceAdded = 1;
+    }
+    status = putFileUtil (conn, collTranJob->srcPath, collTranJob->targPath,
+      collTranJob->dataSize, collTranQue->rodsEnv, collTranQue->rodsArgs,
+      dataObjOprInp);
+    if (forceAdded > 0) rmKeyVal (&dataObjOprInp->condInput, FORCE_FLAG_KW);
+
+    return status;
+}
+
+/* parallelPutDirUtil - put a directory with rodsArgs->connsValue 
+ * connections. The walk makes the collections and queues the files in
+ * putDirUtil order. Each file is put on a worker connection and a large
+ * file still uses a parallel transfer of its own.
+ */
+int
+parallelPutDirUtil (rcComm_t **myConn, char *srcDir, char *targColl,
+rodsEnv *myRodsEnv, rodsArguments_t *rodsArgs, dataObjInp_t *dataObjOprInp,
+rodsRestart_t *rodsRestart)
+{
+    int status, queStatus;
+    collTranQue_t *collTranQue;
+
+    if (isPathSymlink (rodsArgs, srcDir) > 0) return 0;
+
+    if (rodsArgs->recursive != True) {
+        rodsLog (LOG_ERROR,
+        "parallelPutDirUtil: -r option must be used for putting %s directory",
+         srcDir);
+        return (USER_INPUT_OPTION_ERR);
+    }
+
+    if (rodsArgs->redirectConn == True && rodsArgs->force != True) {
+        int reconnFlag;
+        if (rodsArgs->reconnect == True) {
+            reconnFlag = RECONN_TIMEOUT;
+        } else {
+            reconnFlag = NO_RECONN;
+        }
+	/* reconnect to the resource server before the workers connect */
+	rstrcpy (dataObjOprInp->objPath, targColl, MAX_NAME_LEN);
+	redirectConnToRescSvr (myConn, dataObjOprInp, myRodsEnv, reconnFlag);
+	rodsArgs->redirectConn = 0;    /* only do it once */
+    }
+
+    collTranQue = (collTranQue_t *) malloc (sizeof (collTranQue_t));
+    status = initCollTranQue (collTranQue, *myConn, myRodsEnv, rodsArgs,
+      dataObjOprInp, rodsRestart, rodsArgs->connsValue, putCollTranFile);
+    if (status < 0) {
+        rodsLogError (LOG_NOTICE, status,
+          "parallelPutDirUtil: initCollTranQue error, putting %s serially",
+	  srcDir);
+	free (collTranQue);
+	return putDirUtil (myConn, srcDir, targColl, myRodsEnv, rodsArgs,
+	  dataObjOprInp, NULL, rodsRestart, NULL, NULL);
+    }
+
+    status = putDirUtil (myConn, srcDir, targColl, myRodsEnv, rodsArgs,
+      dataObjOprInp, NULL, rodsRestart, NULL, collTranQue);
+
+    queStatus = endCollTranQue (collTranQue);
+    free (collTranQue);
+    if (queStatus < 0) {
+	return queStatus;
+    } else {
+	return status;
+    }
+}
+
 int
 bulkPutDirUtil (rcComm_t **myConn, char *srcDir, char *targColl,
 rodsEnv *myRodsEnv, rodsArguments_t *rodsArgs, dataObjInp_t *dataObjOprInp,
@@ -761,7 +873,7 @@ bulkOprInp_t *bulkOprInp, rodsRestart_t *rodsRestart)
     bulkOprInfo.flags = BULK_OPR_LARGE_FILES;
 
     status = putDirUtil (myConn, srcDir, targColl, myRodsEnv, rodsArgs,
-      dataObjOprInp, bulkOprInp, rodsRestart, &bulkOprInfo);
+      dataObjOprInp, bulkOprInp, rodsRestart, &bulkOprInfo, NULL);
 
     if (status < 0) {
         rodsLogError (LOG_ERROR, status,
@@ -799,10 +911,18 @@ bulkOprInp_t *bulkOprInp, rodsRestart_t *rodsRestart)
 #else
     bulkOprInfo.bytesBuf.len = 0;
     bulkOprInfo.bytesBuf.buf = malloc (BULK_OPR_BUF_SIZE);
+    /* fill the next batch while one is sent. Inline sends on error */
+    initBulkPutSend (*myConn, bulkOprInp, rodsRestart, &bulkOprInfo);
 #endif
 
     status = putDirUtil (myConn, srcDir, targColl, myRodsEnv, rodsArgs, 
-      dataObjOprInp, bulkOprInp, rodsRestart, &bulkOprInfo);
+      dataObjOprInp, bulkOprInp, rodsRestart, &bulkOprInfo, NULL);
+
+    if (bulkOprInfo.bulkPutSend != NULL) {
+	int status1 = finishBulkPut (&bulkOprInfo, rodsArgs);
+	endBulkPutSend (&bulkOprInfo);
+	if (status >= 0 && status1 < 0) status = status1;
+    }
 
     if (status < 0) {
         rodsLogError (LOG_ERROR, status,
@@ -979,6 +1099,12 @@ bulkOprInfo_t *bulkOprInfo)
 #ifdef BULK_OPR_WITH_TAR
 	status = tarAndBulkPut (conn, bulkOprInp, bulkOprInfo, rodsArgs);
 #else
+	if (bulkOprInfo->bulkPutSend != NULL) {
+	    /* finishBulkPut writes the restart file when it is sent */
+	    status = queBulkPut (conn, bulkOprInp, bulkOprInfo, rodsArgs);
+	    clearBulkOprInfo (bulkOprInfo);
+	    return status;
+	}
 	status = sendBulkPut (conn, bulkOprInp, bulkOprInfo, rodsArgs);
 #endif
 	if (status >= 0) {
@@ -1016,11 +1142,31 @@ bulkOprInfo_t *bulkOprInfo, rodsArguments_t *rodsArgs)
 }
 #endif
 
+static void
+reportBulkPut (rcComm_t *conn, int count, int size, char *lastTargPath,
+struct timeval *startTime, rodsArguments_t *rodsArgs)
+{
+    struct timeval endTime;
+
+    if (rodsArgs->verbose == True) {
+        printf ("Bulk upload %d files.\n", count);
+        (void) gettimeofday(&endTime, (struct timezone *)0);
+        printTiming (conn, lastTargPath, size, lastTargPath,
+         startTime, &endTime);
+    }
+    if (gGuiProgressCB != NULL) {
+        rstrcpy (conn->operProgress.curFileName, lastTargPath, MAX_NAME_LEN);
+        conn->operProgress.totalNumFilesDone += count;
+        conn->operProgress.totalFileSizeDone += size;
+        gGuiProgressCB (&conn->operProgress);
+    }
+}
+
 int 
 sendBulkPut (rcComm_t *conn, bulkOprInp_t *bulkOprInp,
 bulkOprInfo_t *bulkOprInfo, rodsArguments_t *rodsArgs)
 {
-    struct timeval startTime, endTime;
+    struct timeval startTime;
     int status = 0;
 
     if (bulkOprInfo == NULL || bulkOprInfo->count <= 0) return 0;
@@ -1040,25 +1186,267 @@ bulkOprInfo_t *bulkOprInfo, rodsArguments_t *rodsArgs)
 	bulkOprInfo->forceFlagAdded = 0;
     }
     if (status >= 0) {
-        if (rodsArgs->verbose == True) {
-            printf ("Bulk upload %d files.\n", bulkOprInfo->count);
-            (void) gettimeofday(&endTime, (struct timezone *)0);
-            printTiming (conn, bulkOprInfo->cachedTargPath,
-              bulkOprInfo->size, bulkOprInfo->cachedTargPath,
-             &startTime, &endTime);
-        }
-        if (gGuiProgressCB != NULL) {
-            rstrcpy (conn->operProgress.curFileName, 
-	      bulkOprInfo->cachedTargPath, MAX_NAME_LEN);
-            conn->operProgress.totalNumFilesDone +=  bulkOprInfo->count;
-            conn->operProgress.totalFileSizeDone += bulkOprInfo->size;
-            gGuiProgressCB (&conn->operProgress);
-	}
+	reportBulkPut (conn, bulkOprInfo->count, bulkOprInfo->size,
+	  bulkOprInfo->cachedTargPath, &startTime, rodsArgs);
     }
 
     return (status);
 }
 
+#if defined(USE_BOOST) || defined(PARA_OPR)
+static void
+lockBulkPutSend (bulkPutSend_t *bulkPutSend)
+{
+#ifdef USE_BOOST
+    bulkPutSend->lock->lock ();
+#else
+    pthread_mutex_lock (&bulkPutSend->lock);
+#endif
+}
+
+static void
+unlockBulkPutSend (bulkPutSend_t *bulkPutSend)
+{
+#ifdef USE_BOOST
+    bulkPutSend->lock->unlock ();
+#else
+    pthread_mutex_unlock (&bulkPutSend->lock);
+#endif
+}
+
+static void
+waitBulkPutSend (bulkPutSend_t *bulkPutSend)
+{
+#ifdef USE_BOOST
+    bulkPutSend->cond->wait (*bulkPutSend->lock);
+#else
+    pthread_cond_wait (&bulkPutSend->cond, &bulkPutSend->lock);
+#endif
+}
+
+static void
+wakeBulkPutSend (bulkPutSend_t *bulkPutSend)
+{
+#ifdef USE_BOOST
+    bulkPutSend->cond->notify_all ();
+#else
+    pthread_cond_broadcast (&bulkPutSend->cond);
+#endif
+}
+
+static void
+bulkPutSender (bulkPutSend_t *bulkPutSend)
+{
+    int status;
+
+    lockBulkPutSend (bulkPutSend);
+    while (1) {
+	while (bulkPutSend->busy == 0 && bulkPutSend->exitFlag == 0)
+	    waitBulkPutSend (bulkPutSend);
+	if (bulkPutSend->busy == 0) break;
+	unlockBulkPutSend (bulkPutSend);
+
+	status = rcBulkDataObjPut (bulkPutSend->conn, 
+	  &bulkPutSend->bulkOprInp, &bulkPutSend->bytesBuf);
+
+	lockBulkPutSend (bulkPutSend);
+	bulkPutSend->status = status;
+	bulkPutSend->busy = 0;
+	wakeBulkPutSend (bulkPutSend);
+    }
+    unlockBulkPutSend (bulkPutSend);
+}
+
+static void
+freeBulkPutSend (bulkPutSend_t *bulkPutSend)
+{
+    int i;
+
+    for (i = 0; i < bulkPutSend->bulkOprInp.attriArray.attriCnt; i++) {
+	if (bulkPutSend->bulkOprInp.attriArray.sqlResult[i].value != NULL)
+	    free (bulkPutSend->bulkOprInp.attriArray.sqlResult[i].value);
+    }
+    clearKeyVal (&bulkPutSend->bulkOprInp.condInput);
+    if (bulkPutSend->bytesBuf.buf != NULL) free (bulkPutSend->bytesBuf.buf);
+    free (bulkPutSend);
+}
+#endif	/* USE_BOOST || PARA_OPR */
+
+/* initBulkPutSend - set up the spare batch and the thread sending a 
+ * batch on conn while bulkPutFileUtil fills the next one. On error,
+ * bulkOprInfo->bulkPutSend stays NULL and the batches are sent inline.
+ */
+int
+initBulkPutSend (rcComm_t *conn, bulkOprInp_t *bulkOprInp, 
+rodsRestart_t *rodsRestart, bulkOprInfo_t *bulkOprInfo)
+{
+#if defined(USE_BOOST) || defined(PARA_OPR)
+    bulkPutSend_t *bulkPutSend;
+
+    bulkOprInfo->bulkPutSend = NULL;
+    if (bulkOprInfo->bytesBuf.buf == NULL) return SYS_MALLOC_ERR;
+
+    bulkPutSend = (bulkPutSend_t *) calloc (1, sizeof (bulkPutSend_t));
+    if (bulkPutSend == NULL) return SYS_MALLOC_ERR;
+    bulkPutSend->conn = conn;
+    bulkPutSend->rodsRestart = rodsRestart;
+    replKeyVal (&bulkOprInp->condInput, &bulkPutSend->bulkOprInp.condInput);
+    initAttriArrayOfBulkOprInp (&bulkPutSend->bulkOprInp);
+    bulkPutSend->bytesBuf.buf = malloc (BULK_OPR_BUF_SIZE);
+    if (bulkPutSend->bytesBuf.buf == NULL) {
+	freeBulkPutSend (bulkPutSend);
+	return SYS_MALLOC_ERR;
+    }
+#ifdef USE_BOOST
+    bulkPutSend->lock = new boost::mutex;
+    bulkPutSend->cond = new boost::condition_variable_any;
+    bulkPutSend->sendThr = new boost::thread (bulkPutSender, bulkPutSend);
+#else
+    pthread_mutex_init (&bulkPutSend->lock, NULL);
+    pthread_cond_init (&bulkPutSend->cond, NULL);
+    if (pthread_create (&bulkPutSend->sendThr, pthread_attr_default,
+      (void *(*)(void *)) bulkPutSender, (void *) bulkPutSend) != 0) {
+	pthread_mutex_destroy (&bulkPutSend->lock);
+	pthread_cond_destroy (&bulkPutSend->cond);
+	freeBulkPutSend (bulkPutSend);
+	return SYS_THREAD_RESOURCE_ERR;
+    }
+#endif
+    bulkOprInfo->bulkPutSend = bulkPutSend;
+    return 0;
+#else
+    bulkOprInfo->bulkPutSend = NULL;
+    return SYS_PARA_OPR_NO_SUPPORT;
+#endif
+}
+
+/* queBulkPut - wait for the batch being sent and hand the batch just 
+ * filled in bulkOprInp and bulkOprInfo to the send thread. The spare
+ * buffers become the ones to fill. The batch is sent even if the previous
+ * one failed (as each batch is when sent inline). Returns the status of
+ * the previous batch.
+ */
+int
+queBulkPut (rcComm_t *conn, bulkOprInp_t *bulkOprInp,
+bulkOprInfo_t *bulkOprInfo, rodsArguments_t *rodsArgs)
+{
+#if defined(USE_BOOST) || defined(PARA_OPR)
+    bulkPutSend_t *bulkPutSend = bulkOprInfo->bulkPutSend;
+    genQueryOut_t tmpAttriArray;
+    void *tmpBuf;
+    int status;
+
+    if (bulkOprInfo->count <= 0) return 0;
+
+    status = finishBulkPut (bulkOprInfo, rodsArgs);
+
+    tmpAttriArray = bulkOprInp->attriArray;
+    bulkOprInp->attriArray = bulkPutSend->bulkOprInp.attriArray;
+    bulkPutSend->bulkOprInp.attriArray = tmpAttriArray;
+    tmpBuf = bulkOprInfo->bytesBuf.buf;
+    bulkOprInfo->bytesBuf.buf = bulkPutSend->bytesBuf.buf;
+    bulkPutSend->bytesBuf.buf = tmpBuf;
+    bulkPutSend->bytesBuf.len = bulkOprInfo->bytesBuf.len;
+
+    rstrcpy (bulkPutSend->bulkOprInp.objPath, bulkOprInp->objPath, 
+      MAX_NAME_LEN);
+    clearKeyVal (&bulkPutSend->bulkOprInp.condInput);
+    replKeyVal (&bulkOprInp->condInput, 
+      &bulkPutSend->bulkOprInp.condInput);
+    bulkPutSend->count = bulkOprInfo->count;
+    bulkPutSend->size = bulkOprInfo->size;
+    rstrcpy (bulkPutSend->lastTargPath, bulkOprInfo->cachedTargPath,
+      MAX_NAME_LEN);
+    (void) gettimeofday (&bulkPutSend->startTime, (struct timezone *)0);
+
+    lockBulkPutSend (bulkPutSend);
+    bulkPutSend->busy = 1;
+    wakeBulkPutSend (bulkPutSend);
+    unlockBulkPutSend (bulkPutSend);
+
+    /* reset the row count */
+    bulkOprInp->attriArray.rowCnt = 0;
+    if (bulkOprInfo->forceFlagAdded == 1) {
+	rmKeyVal (&bulkOprInp->condInput, FORCE_FLAG_KW);
+	bulkOprInfo->forceFlagAdded = 0;
+    }
+    return status;
+#else
+    return SYS_PARA_OPR_NO_SUPPORT;
+#endif
+}
+
+/* finishBulkPut - wait for the batch being sent and record it in the
+ * restart file. Returns the status of the send.
+ */
+int
+finishBulkPut (bulkOprInfo_t *bulkOprInfo, rodsArguments_t *rodsArgs)
+{
+#if defined(USE_BOOST) || defined(PARA_OPR)
+    bulkPutSend_t *bulkPutSend = bulkOprInfo->bulkPutSend;
+    rodsRestart_t *rodsRestart;
+    int status;
+
+    if (bulkPutSend == NULL || bulkPutSend->count <= 0) return 0;
+
+    lockBulkPutSend (bulkPutSend);
+    while (bulkPutSend->busy != 0) waitBulkPutSend (bulkPutSend);
+    status = bulkPutSend->status;
+    unlockBulkPutSend (bulkPutSend);
+
+    bulkPutSend->bulkOprInp.attriArray.rowCnt = 0;
+    if (status >= 0) {
+	reportBulkPut (bulkPutSend->conn, bulkPutSend->count, 
+	  bulkPutSend->size, bulkPutSend->lastTargPath, 
+	  &bulkPutSend->startTime, rodsArgs);
+	rodsRestart = bulkPutSend->rodsRestart;
+	if (rodsRestart->fd > 0) {
+	    rodsRestart->curCnt += bulkPutSend->count;
+	    status = writeRestartFile (rodsRestart, bulkPutSend->lastTargPath);
+	}
+    } else {
+	rodsLogError (LOG_ERROR, status,
+	  "finishBulkPut: rcBulkDataObjPut error for batch ending with %s",
+	  bulkPutSend->lastTargPath);
+    }
+    bulkPutSend->count = 0;
+    return status;
+#else
+    return 0;
+#endif
+}
+
+/* endBulkPutSend - stop the send thread. finishBulkPut must be called
+ * first.
+ */
+int
+endBulkPutSend (bulkOprInfo_t *bulkOprInfo)
+{
+#if defined(USE_BOOST) || defined(PARA_OPR)
+    bulkPutSend_t *bulkPutSend = bulkOprInfo->bulkPutSend;
+
+    if (bulkPutSend == NULL) return 0;
+
+    lockBulkPutSend (bulkPutSend);
+    bulkPutSend->exitFlag = 1;
+    wakeBulkPutSend (bulkPutSend);
+    unlockBulkPutSend (bulkPutSend);
+#ifdef USE_BOOST
+    bulkPutSend->sendThr->join ();
+    delete bulkPutSend->sendThr;
+    delete bulkPutSend->lock;
+    delete bulkPutSend->cond;
+#else
+    pthread_join (bulkPutSend->sendThr, NULL);
+    pthread_mutex_destroy (&bulkPutSend->lock);
+    pthread_cond_destroy (&bulkPutSend->cond);
+#endif
+    freeBulkPutSend (bulkPutSend);
+    bulkOprInfo->bulkPutSend = NULL;
+#endif
+    return 0;
+}
+
 int
 clearBulkOprInfo (bulkOprInfo_t *bulkOprInfo)
 {
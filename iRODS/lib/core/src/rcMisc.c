@@ -1215,6 +1215,181 @@ clearGenQueryOut (genQueryOut_t *genQueryOut)
     return (0);
 }
 
+/* genQueryOutToCompact - pack the values of genQueryOut without the
+ * padding into a genQueryCompactOut_t (GEN_QUERY_COMPACT_AN).
+ */
+int
+genQueryOutToCompact (genQueryOut_t *genQueryOut, 
+genQueryCompactOut_t **genQueryCompactOut)
+{
+    genQueryCompactOut_t *myOut;
+    int i, j, len;
+    int valueLen = 0;
+    char *inPtr, *outPtr;
+
+    if (genQueryOut == NULL || genQueryCompactOut == NULL)
+        return USER__NULL_INPUT_ERR;
+
+    if (genQueryOut->rowCnt < 0 || genQueryOut->attriCnt < 0 ||
+      genQueryOut->attriCnt > MAX_SQL_ATTR) 
+        return SYS_INVALID_INPUT_PARAM;
+
+    myOut = (genQueryCompactOut_t *) malloc (sizeof (genQueryCompactOut_t));
+    memset (myOut, 0, sizeof (genQueryCompactOut_t));
+    myOut->rowCnt = genQueryOut->rowCnt;
+    myOut->attriCnt = genQueryOut->attriCnt;
+    myOut->continueInx = genQueryOut->continueInx;
+    myOut->totalRowCount = genQueryOut->totalRowCount;
+    *genQueryCompactOut = myOut;
+
+    if (myOut->attriCnt == 0) return 0;
+
+    myOut->attriInx = (int *) malloc (myOut->attriCnt * sizeof (int));
+    for (j = 0; j < myOut->attriCnt; j++) {
+        sqlResult_t *sqlResult = &genQueryOut->sqlResult[j];
+        myOut->attriInx[j] = sqlResult->attriInx;
+        if (myOut->rowCnt > 0 && 
+          (sqlResult->value == NULL || sqlResult->len <= 0)) {
+            return SYS_INVALID_INPUT_PARAM;
+        }
+        for (i = 0; i < myOut->rowCnt; i++) {
+            inPtr = sqlResult->value + i * sqlResult->len;
+            for (len = 0; len < sqlResult->len - 1 && inPtr[len] != '\0';
+              len++);
+            valueLen += len + 1;
+        }
+    }
+    if (myOut->rowCnt == 0) return 0;
+
+    myOut->offsetCnt = myOut->rowCnt * myOut->attriCnt;
+    myOut->offset = (int *) malloc (myOut->offsetCnt * sizeof (int));
+    myOut->valueLen = valueLen;
+    myOut->value = (char *) malloc (valueLen);
+    outPtr = myOut->value;
+    for (j = 0; j < myOut->attriCnt; j++) {
+        sqlResult_t *sqlResult = &genQueryOut->sqlResult[j];
+        for (i = 0; i < myOut->rowCnt; i++) {
+            inPtr = sqlResult->value + i * sqlResult->len;
+            for (len = 0; len < sqlResult->len - 1 && inPtr[len] != '\0';
+              len++);
+            myOut->offset[j * myOut->rowCnt + i] = outPtr - myOut->value;
+            memcpy (outPtr, inPtr, len);
+            outPtr[len] = '\0';
+            outPtr += len + 1;
+        }
+    }
+    return 0;
+}
+
+/* compactToGenQueryOut - the reverse of genQueryOutToCompact. Each
+ * attribute is padded to its own longest value.
+ */
+int
+compactToGenQueryOut (genQueryCompactOut_t *genQueryCompactOut,
+genQueryOut_t **genQueryOut)
+{
+    genQueryOut_t *myOut;
+    int i, j, len, offset;
+    int rowCnt, attriCnt;
+
+    if (genQueryCompactOut == NULL || genQueryOut == NULL)
+        return USER__NULL_INPUT_ERR;
+
+    rowCnt = genQueryCompactOut->rowCnt;
+    attriCnt = genQueryCompactOut->attriCnt;
+    if (rowCnt < 0 || attriCnt < 0 || attriCnt > MAX_SQL_ATTR ||
+      (attriCnt > 0 && genQueryCompactOut->attriInx == NULL) ||
+      (rowCnt > 0 && attriCnt > 0 && 
+      (genQueryCompactOut->offsetCnt != rowCnt * attriCnt ||
+      genQueryCompactOut->offset == NULL ||
+      genQueryCompactOut->value == NULL ||
+      genQueryCompactOut->valueLen <= 0 ||
+      genQueryCompactOut->value[genQueryCompactOut->valueLen - 1] != '\0'))) {
+        rodsLog (LOG_ERROR,
+          "compactToGenQueryOut: bad result, rowCnt %d attriCnt %d",
+          rowCnt, attriCnt);
+        return SYS_INVALID_INPUT_PARAM;
+    }
+    for (i = 0; i < rowCnt * attriCnt; i++) {
+        offset = genQueryCompactOut->offset[i];
+        if (offset < 0 || offset >= genQueryCompactOut->valueLen) {
+            rodsLog (LOG_ERROR,
+              "compactToGenQueryOut: offset %d out of range", offset);
+            return SYS_INVALID_INPUT_PARAM;
+        }
+    }
+
+    myOut = (genQueryOut_t *) malloc (sizeof (genQueryOut_t));
+    memset (myOut, 0, sizeof (genQueryOut_t));
+    myOut->rowCnt = rowCnt;
+    myOut->attriCnt = attriCnt;
+    myOut->continueInx = genQueryCompactOut->continueInx;
+    myOut->totalRowCount = genQueryCompactOut->totalRowCount;
+
+    for (j = 0; j < attriCnt; j++) {
+        sqlResult_t *sqlResult = &myOut->sqlResult[j];
+        int *offsetArray = &genQueryCompactOut->offset[j * rowCnt];
+        sqlResult->attriInx = genQueryCompactOut->attriInx[j];
+        if (rowCnt == 0) continue;
+        sqlResult->len = 1;
+        for (i = 0; i < rowCnt; i++) {
+            len = strlen (genQueryCompactOut->value + offsetArray[i]) + 1;
+            if (len > sqlResult->len) sqlResult->len = len;
+        }
+        sqlResult->value = (char *) malloc (rowCnt * sqlResult->len);
+        memset (sqlResult->value, 0, rowCnt * sqlResult->len);
+        for (i = 0; i < rowCnt; i++) {
+            strcpy (sqlResult->value + i * sqlResult->len, 
+              genQueryCompactOut->value + offsetArray[i]);
+        }
+    }
+    *genQueryOut = myOut;
+    return 0;
+}
+
+int
+freeGenQueryCompactOut (genQueryCompactOut_t **genQueryCompactOut)
+{
+    if (genQueryCompactOut == NULL || *genQueryCompactOut == NULL)
+        return 0;
+
+    clearGenQueryCompactOut (*genQueryCompactOut);
+    free (*genQueryCompactOut);
+    *genQueryCompactOut = NULL;
+
+    return 0;
+}
+
+int
+clearGenQueryCompactOut (genQueryCompactOut_t *genQueryCompactOut)
+{
+    if (genQueryCompactOut == NULL)
+        return 0;
+
+    if (genQueryCompactOut->attriInx != NULL) 
+        free (genQueryCompactOut->attriInx);
+    if (genQueryCompactOut->offset != NULL) 
+        free (genQueryCompactOut->offset);
+    if (genQueryCompactOut->value != NULL) 
+        free (genQueryCompactOut->value);
+    memset (genQueryCompactOut, 0, sizeof (genQueryCompactOut_t));
+
+    return 0;
+}
+
+/* getGenQueryCompactSize - the size of the values and offsets of a page.
+ * The window of a GenQuery stream is counted in this.
+ */
+int
+getGenQueryCompactSize (genQueryCompactOut_t *genQueryCompactOut)
+{
+    if (genQueryCompactOut == NULL)
+        return 0;
+
+    return (genQueryCompactOut->valueLen + 
+      genQueryCompactOut->offsetCnt * (int) sizeof (int));
+}
+
 /* catGenQueryOut - Concatenate genQueryOut to targGenQueryOut up to maxRowCnt.
  * It is assumed that the two genQueryOut have the same attriInx and
  * len for each attri.
@@ -4205,6 +4380,8 @@ unbunBulkBuf (char *phyBunDir, bulkOprInp_t *bulkOprInp, bytesBuf_t *bulkBBuf)
     genQueryOut_t *attriArray = &bulkOprInp->attriArray;
     int intOffset[MAX_NUM_BULK_OPR_FILES];
     char phyBunPath[MAX_NAME_LEN];
+    char subPhyBunDir[MAX_NAME_LEN], lastSubPhyBunDir[MAX_NAME_LEN];
+    char subFileName[MAX_NAME_LEN];
 
     if (phyBunDir == NULL || bulkOprInp == NULL) return USER__NULL_INPUT_ERR;
 
@@ -4231,6 +4408,7 @@ unbunBulkBuf (char *phyBunDir, bulkOprInp_t *bulkOprInp, bytesBuf_t *bulkBBuf)
     for (i = 0; i < attriArray->rowCnt; i++) {
         intOffset[i] = atoi (&offset->value[offset->len * i]);
     }
+    *lastSubPhyBunDir = '\0';
 
     for (i = 0; i < attriArray->rowCnt; i++) {
 	int size;
@@ -4248,7 +4426,17 @@ unbunBulkBuf (char *phyBunDir, bulkOprInp_t *bulkOprInp, bytesBuf_t *bulkBBuf)
 	  phyBunPath);
 	if (status < 0) return status;
 
-        mkdirForFilePath (phyBunPath);
+        /* the subfiles are in walk order. Most share the dir of the last */
+        if ((status = splitPathByKey (phyBunPath, subPhyBunDir, subFileName,
+          '/')) < 0) {
+            rodsLogError (LOG_ERROR, status,
+              "unbunBulkBuf: splitPathByKey for %s error", phyBunPath);
+            return status;
+        }
+        if (strcmp (subPhyBunDir, lastSubPhyBunDir) != 0) {
+            mkdirR ("/", subPhyBunDir, DEFAULT_DIR_MODE);
+            rstrcpy (lastSubPhyBunDir, subPhyBunDir, MAX_NAME_LEN);
+        }
 
 #ifdef windows_platform
         out_fd = iRODSNt_bopen(phyBunPath, O_WRONLY | O_CREAT | O_TRUNC, 0640);
@@ -19,6 +19,11 @@
 #include <pthread.h>
 #endif
 #endif // BOOST
+#ifdef linux_platform
+#include <netinet/tcp.h>
+#endif
+
+static int PortalStatFlag = 0;
 
 int
 sendTranHeader (int sock, int oprType, int flags, rodsLong_t offset,
@@ -75,6 +80,409 @@ rcvTranHeader (int sock, transferHeader_t *myHeader)
     return (0);
 }
 
+int
+getPortalPipeBufCnt ()
+{
+    char *tmpStr;
+    int bufCnt;
+
+    if ((tmpStr = getenv (PORTAL_PIPE_BUF_CNT_KW)) == NULL)
+        return DEF_PORTAL_PIPE_BUF_CNT;
+    bufCnt = atoi (tmpStr);
+    if (bufCnt < 2) return 0;
+    if (bufCnt > MAX_PORTAL_PIPE_BUF_CNT) bufCnt = MAX_PORTAL_PIPE_BUF_CNT;
+    return bufCnt;
+}
+
+int
+isPortalStatOn ()
+{
+    char *tmpStr;
+
+    if (PortalStatFlag > 0) return 1;
+    if ((tmpStr = getenv (PORTAL_STAT_KW)) != NULL && atoi (tmpStr) > 0)
+        return 1;
+    return 0;
+}
+
+/* setPortalStatOn - for the --stats option of the clients */
+void
+setPortalStatOn ()
+{
+    PortalStatFlag = 1;
+}
+
+/* getPortalStatUsec - the time in microsec to start a timed wait with.
+ * Returns 0 without calling gettimeofday if the statistics are off */
+rodsLong_t
+getPortalStatUsec (portalStat_t *portalStat)
+{
+    struct timeval tv;
+
+    if (portalStat == NULL) return 0;
+    gettimeofday (&tv, NULL);
+    return (rodsLong_t) tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+void
+beginPortalStat (portalStat_t *portalStat, int threadNum)
+{
+    if (portalStat == NULL) return;
+    memset (portalStat, 0, sizeof (portalStat_t));
+    portalStat->threadNum = threadNum;
+    portalStat->startUsec = getPortalStatUsec (portalStat);
+}
+
+/* addPortalStatUsec - account the wait started at startUsec */
+void
+addPortalStatUsec (portalStat_t *portalStat, int statType,
+rodsLong_t startUsec)
+{
+    rodsLong_t waitUsec;
+
+    if (portalStat == NULL) return;
+    waitUsec = getPortalStatUsec (portalStat) - startUsec;
+    if (statType == PORTAL_STAT_DISK)
+        portalStat->diskUsec += waitUsec;
+    else
+        portalStat->sockUsec += waitUsec;
+    if (waitUsec >= PORTAL_STALL_USEC) {
+        portalStat->stallUsec += waitUsec;
+        portalStat->stallCnt++;
+    }
+}
+
+/* endPortalStat - set the bytes, the elapsed time and the TCP_INFO of
+ * sock. Must be called before sock is closed */
+void
+endPortalStat (portalStat_t *portalStat, int sock, rodsLong_t bytes)
+{
+#if defined(linux_platform) && defined(TCP_INFO)
+    struct tcp_info tcpInfo;
+    socklen_t len = sizeof (tcpInfo);
+#endif
+
+    if (portalStat == NULL) return;
+    portalStat->bytes = bytes;
+    portalStat->elapsedUsec = getPortalStatUsec (portalStat) -
+      portalStat->startUsec;
+#if defined(linux_platform) && defined(TCP_INFO)
+    memset (&tcpInfo, 0, sizeof (tcpInfo));
+    if (getsockopt (sock, IPPROTO_TCP, TCP_INFO, &tcpInfo, &len) == 0) {
+        portalStat->tcpInfoFlag = 1;
+        portalStat->rttUsec = tcpInfo.tcpi_rtt;
+        portalStat->rttVarUsec = tcpInfo.tcpi_rttvar;
+        portalStat->sndCwnd = tcpInfo.tcpi_snd_cwnd;
+        portalStat->totalRetrans = tcpInfo.tcpi_total_retrans;
+    }
+#endif
+}
+
+/* fmtPortalStat - format the statistics of a stream as key=value pairs
+ * for the log */
+int
+fmtPortalStat (portalStat_t *portalStat, int numThreads, char *outStr,
+int maxLen)
+{
+    int len;
+
+    len = snprintf (outStr, maxLen,
+      "thr=%d/%d bytes=%lld elapsedMs=%lld sockMs=%lld diskMs=%lld "
+      "stallMs=%lld stalls=%d", portalStat->threadNum, numThreads,
+      portalStat->bytes, portalStat->elapsedUsec / 1000,
+      portalStat->sockUsec / 1000, portalStat->diskUsec / 1000,
+      portalStat->stallUsec / 1000, portalStat->stallCnt);
+    if (portalStat->tcpInfoFlag > 0 && len >= 0 && len < maxLen) {
+        len += snprintf (outStr + len, maxLen - len,
+          " rttUs=%u rttVarUs=%u cwnd=%u retrans=%u",
+          portalStat->rttUsec, portalStat->rttVarUsec, portalStat->sndCwnd,
+          portalStat->totalRetrans);
+    }
+    return len;
+}
+
+/* isPortalStatMsg - whether msg of an rError is the statistics of a
+ * stream sent back by the server */
+int
+isPortalStatMsg (char *msg)
+{
+    if (msg == NULL) return 0;
+    return (strncmp (msg, PORTAL_STAT_MSG, strlen (PORTAL_STAT_MSG)) == 0);
+}
+
+/* printSvrPortalStat - print the statistics of the server side of the
+ * streams, sent back with the reply to rcOprComplete */
+int
+printSvrPortalStat (rcComm_t *conn)
+{
+    rError_t *rError = conn->rError;
+    int i, cnt = 0;
+
+    if (rError == NULL) return 0;
+    for (i = 0; i < rError->len; i++) {
+        if (isPortalStatMsg (rError->errMsg[i]->msg) == 0) continue;
+        printf ("%s\n", rError->errMsg[i]->msg);
+        cnt++;
+    }
+    return cnt;
+}
+
+/* isPortalChksumMsg - whether msg of an rError is the chksum of a get
+ * sent back by the server */
+int
+isPortalChksumMsg (char *msg)
+{
+    if (msg == NULL) return 0;
+    return (strncmp (msg, PORTAL_CHKSUM_MSG, strlen (PORTAL_CHKSUM_MSG)) == 0);
+}
+
+/* getPortalChksum - get the chksum of a get done with CHKSUM_AT_CLOSE_KW
+ * from the reply to rcOprComplete. Returns 0 and fills in chksumStr if
+ * the server sent one.
+ */
+int
+getPortalChksum (rcComm_t *conn, char *chksumStr)
+{
+    rError_t *rError = conn->rError;
+    int i;
+
+    if (rError == NULL) return SYS_INTERNAL_NULL_INPUT_ERR;
+    for (i = 0; i < rError->len; i++) {
+        if (isPortalChksumMsg (rError->errMsg[i]->msg) == 0) continue;
+        rstrcpy (chksumStr, rError->errMsg[i]->msg + 
+          strlen (PORTAL_CHKSUM_MSG), NAME_LEN);
+        return 0;
+    }
+    return SYS_INTERNAL_NULL_INPUT_ERR;
+}
+
+#if defined(USE_BOOST) || defined(PARA_OPR)
+static void
+lockPortalPipe (portalPipe_t *portalPipe)
+{
+#ifdef USE_BOOST
+    portalPipe->lock->lock ();
+#else
+    pthread_mutex_lock (&portalPipe->lock);
+#endif
+}
+
+static void
+unlockPortalPipe (portalPipe_t *portalPipe)
+{
+#ifdef USE_BOOST
+    portalPipe->lock->unlock ();
+#else
+    pthread_mutex_unlock (&portalPipe->lock);
+#endif
+}
+
+/* waitPortalPipe - wait for the other side with the lock held */
+static void
+waitPortalPipe (portalPipe_t *portalPipe)
+{
+#ifdef USE_BOOST
+    portalPipe->cond->wait (*portalPipe->lock);
+#else
+    pthread_cond_wait (&portalPipe->cond, &portalPipe->lock);
+#endif
+}
+
+static void
+wakePortalPipe (portalPipe_t *portalPipe)
+{
+#ifdef USE_BOOST
+    portalPipe->cond->notify_all ();
+#else
+    pthread_cond_broadcast (&portalPipe->cond);
+#endif
+}
+
+/* portalPipeWriter - the helper thread of a portal pipe. Writes out the
+ * queued bufs in order until endPortalPipe. After a write error, the
+ * remaining bufs are dropped.
+ */
+static void
+portalPipeWriter (portalPipe_t *portalPipe)
+{
+    int inx, len, bytesWritten;
+
+    lockPortalPipe (portalPipe);
+    while (1) {
+        while (portalPipe->filledCnt == 0 && portalPipe->exitFlag == 0)
+            waitPortalPipe (portalPipe);
+        if (portalPipe->filledCnt == 0) break;
+
+        inx = portalPipe->tail;
+        len = portalPipe->len[inx];
+        if (portalPipe->status >= 0) {
+            unlockPortalPipe (portalPipe);
+            bytesWritten = portalPipe->writeFunc (portalPipe->writeArg,
+              portalPipe->buf[inx], len);
+            lockPortalPipe (portalPipe);
+            if (bytesWritten != len && portalPipe->status >= 0) {
+                rodsLog (LOG_NOTICE,
+                  "portalPipeWriter: toWrite %d, bytesWritten %d",
+                  len, bytesWritten);
+                if (bytesWritten < 0)
+                    portalPipe->status = bytesWritten;
+                else
+                    portalPipe->status = SYS_COPY_LEN_ERR;
+            }
+        }
+        portalPipe->tail = (inx + 1) % portalPipe->bufCnt;
+        portalPipe->filledCnt--;
+        wakePortalPipe (portalPipe);
+    }
+    unlockPortalPipe (portalPipe);
+}
+#endif	/* USE_BOOST || PARA_OPR */
+
+/* initPortalPipe - set up bufCnt TRANS_BUF_SZ bufs and the helper thread
+ * writing them out with writeFunc. On error, the caller should do the
+ * transfer with a single buffer.
+ */
+int
+initPortalPipe (portalPipe_t *portalPipe, int bufCnt,
+portalPipeWriteFunc_t *writeFunc, void *writeArg)
+{
+#if defined(USE_BOOST) || defined(PARA_OPR)
+    int i;
+
+    memset (portalPipe, 0, sizeof (portalPipe_t));
+    if (bufCnt < 2 || bufCnt > MAX_PORTAL_PIPE_BUF_CNT)
+        return SYS_INVALID_INPUT_PARAM;
+
+    for (i = 0; i < bufCnt; i++) {
+        if ((portalPipe->buf[i] = (char *) malloc (TRANS_BUF_SZ)) == NULL) {
+            while (--i >= 0) free (portalPipe->buf[i]);
+            return SYS_MALLOC_ERR;
+        }
+    }
+    portalPipe->bufCnt = bufCnt;
+    portalPipe->writeFunc = writeFunc;
+    portalPipe->writeArg = writeArg;
+#ifdef USE_BOOST
+    portalPipe->lock = new boost::mutex;
+    portalPipe->cond = new boost::condition_variable_any;
+    portalPipe->writeThr = new boost::thread (portalPipeWriter, portalPipe);
+#else
+    pthread_mutex_init (&portalPipe->lock, NULL);
+    pthread_cond_init (&portalPipe->cond, NULL);
+    if (pthread_create (&portalPipe->writeThr, pthread_attr_default,
+      (void *(*)(void *)) portalPipeWriter, (void *) portalPipe) != 0) {
+        pthread_mutex_destroy (&portalPipe->lock);
+        pthread_cond_destroy (&portalPipe->cond);
+        for (i = 0; i < bufCnt; i++) free (portalPipe->buf[i]);
+        portalPipe->bufCnt = 0;
+        return SYS_THREAD_RESOURCE_ERR;
+    }
+#endif
+    return 0;
+#else
+    return SYS_PARA_OPR_NO_SUPPORT;
+#endif
+}
+
+/* getPortalPipeBuf - wait for a free buf to read the next slice into.
+ * Returns NULL if the helper thread has failed.
+ */
+char *
+getPortalPipeBuf (portalPipe_t *portalPipe)
+{
+#if defined(USE_BOOST) || defined(PARA_OPR)
+    char *buf;
+
+    lockPortalPipe (portalPipe);
+    while (portalPipe->filledCnt >= portalPipe->bufCnt && 
+      portalPipe->status >= 0)
+        waitPortalPipe (portalPipe);
+    if (portalPipe->status < 0)
+        buf = NULL;
+    else
+        buf = portalPipe->buf[portalPipe->head];
+    unlockPortalPipe (portalPipe);
+    return buf;
+#else
+    return NULL;
+#endif
+}
+
+/* queuePortalPipeBuf - hand the buf from getPortalPipeBuf, now holding
+ * len bytes, to the helper thread. Returns the status of the writes so far.
+ */
+int
+queuePortalPipeBuf (portalPipe_t *portalPipe, int len)
+{
+#if defined(USE_BOOST) || defined(PARA_OPR)
+    int status;
+
+    lockPortalPipe (portalPipe);
+    portalPipe->len[portalPipe->head] = len;
+    portalPipe->head = (portalPipe->head + 1) % portalPipe->bufCnt;
+    portalPipe->filledCnt++;
+    status = portalPipe->status;
+    wakePortalPipe (portalPipe);
+    unlockPortalPipe (portalPipe);
+    return status;
+#else
+    return SYS_PARA_OPR_NO_SUPPORT;
+#endif
+}
+
+/* drainPortalPipe - wait until all queued bufs are written out. Needed
+ * before the write side fd is seeked or written directly.
+ */
+int
+drainPortalPipe (portalPipe_t *portalPipe)
+{
+#if defined(USE_BOOST) || defined(PARA_OPR)
+    int status;
+
+    lockPortalPipe (portalPipe);
+    while (portalPipe->filledCnt > 0)
+        waitPortalPipe (portalPipe);
+    status = portalPipe->status;
+    unlockPortalPipe (portalPipe);
+    return status;
+#else
+    return SYS_PARA_OPR_NO_SUPPORT;
+#endif
+}
+
+/* endPortalPipe - drain the pipe, stop the helper thread and free the
+ * bufs. Returns the status of the writes.
+ */
+int
+endPortalPipe (portalPipe_t *portalPipe)
+{
+#if defined(USE_BOOST) || defined(PARA_OPR)
+    int i, status;
+
+    if (portalPipe->bufCnt == 0) return 0;
+    lockPortalPipe (portalPipe);
+    portalPipe->exitFlag = 1;
+    wakePortalPipe (portalPipe);
+    unlockPortalPipe (portalPipe);
+#ifdef USE_BOOST
+    portalPipe->writeThr->join ();
+    delete portalPipe->writeThr;
+    delete portalPipe->lock;
+    delete portalPipe->cond;
+#else
+    pthread_join (portalPipe->writeThr, NULL);
+    pthread_mutex_destroy (&portalPipe->lock);
+    pthread_cond_destroy (&portalPipe->cond);
+#endif
+    status = portalPipe->status;
+    for (i = 0; i < portalPipe->bufCnt; i++) free (portalPipe->buf[i]);
+    portalPipe->bufCnt = 0;
+    return status;
+#else
+    return 0;
+#endif
+}
+
 int
 fillBBufWithFile (rcComm_t *conn, bytesBuf_t *myBBuf, char *locFilePath, 
 rodsLong_t dataSize)
@@ -115,6 +523,24 @@ rodsLong_t dataSize)
     return (status); 
 }
 
+/* printPortalStat - print the statistics of the streams of a transfer
+ * for the --stats option */
+static void
+printPortalStat (char *oprStr, char *objPath, rcPortalTransferInp_t *myInput,
+int numThreads)
+{
+    char statStr[MAX_NAME_LEN];
+    int i;
+
+    for (i = 0; i < numThreads; i++) {
+        if (myInput[i].portalStat == NULL) continue;
+        fmtPortalStat (myInput[i].portalStat, numThreads, statStr,
+          MAX_NAME_LEN);
+        printf ("%s side=client opr=%s obj=%s %s\n", PORTAL_STAT_MSG, oprStr,
+          objPath, statStr);
+    }
+}
+
 int
 putFileToPortal (rcComm_t *conn, portalOprOut_t *portalOprOut, 
 char *locFilePath, char *objPath, rodsLong_t dataSize)
@@ -123,6 +549,8 @@ char *locFilePath, char *objPath, rodsLong_t dataSize)
     int i, sock, in_fd;
     int numThreads; 
     rcPortalTransferInp_t myInput[MAX_NUM_CONFIG_TRAN_THR];
+    portalStat_t portalStat[MAX_NUM_CONFIG_TRAN_THR];
+    int statFlag = isPortalStatOn ();
 #ifdef PARA_OPR
 #ifdef USE_BOOST
     boost::thread* tid[MAX_NUM_CONFIG_TRAN_THR];
@@ -181,7 +609,9 @@ char *locFilePath, char *objPath, rodsLong_t dataSize)
             return (retVal);
         }
 	fillRcPortalTransferInp (conn, &myInput[0], sock, in_fd, 0);
+	if (statFlag > 0) myInput[0].portalStat = &portalStat[0];
 	rcPartialDataPut (&myInput[0]);
+	printPortalStat ("put", objPath, myInput, 1);
 	if (myInput[0].status < 0) {
 	    return (myInput[0].status);
 	} else {
@@ -217,6 +647,7 @@ char *locFilePath, char *objPath, rodsLong_t dataSize)
 		continue;
             }
             fillRcPortalTransferInp (conn, &myInput[i], sock, in_fd, i);
+	    if (statFlag > 0) myInput[i].portalStat = &portalStat[i];
 #ifdef USE_BOOST
             tid[i] = new boost::thread( rcPartialDataPut, &myInput[i] );
 #else
@@ -241,6 +672,7 @@ char *locFilePath, char *objPath, rodsLong_t dataSize)
                 retVal = myInput[i].status;
 	    }
         }
+	printPortalStat ("put", objPath, myInput, numThreads);
         if (retVal < 0) {
 	    return (retVal);
         } else {
@@ -281,6 +713,57 @@ int destFd, int srcFd, int threadNum)
     return (0);
 }
 
+/* addLfRestartLen - account len bytes written by thread threadNum of a
+ * restartable transfer and update the restart file now and then */
+static void
+addLfRestartLen (rcPortalTransferInp_t *myInput, int len)
+{
+    rcComm_t *conn = myInput->conn;
+    fileRestartInfo_t *info = &conn->fileRestart.info;
+    int status;
+
+    if (info->numSeg <= 0) return;	/* not a file restart */
+
+    info->dataSeg[myInput->threadNum].len += len;
+    conn->fileRestart.writtenSinceUpdated += len;
+    if (myInput->threadNum == 0 && conn->fileRestart.writtenSinceUpdated >= 
+      RESTART_FILE_UPDATE_SIZE) {
+        /* time to write to the restart file */
+        status = writeLfRestartFile (conn->fileRestart.infoFile,
+          &conn->fileRestart.info);
+        if (status < 0) {
+            rodsLog (LOG_ERROR,
+             "addLfRestartLen: writeLfRestartFile for %s, status = %d",
+             conn->fileRestart.info.fileName, status);
+        }
+        conn->fileRestart.writtenSinceUpdated = 0;
+    }
+}
+
+/* rcPortalPipeSockWrite and rcPortalPipeFileWrite - the write side of
+ * the portal pipe of rcPartialDataPut and rcPartialDataGet */
+static int
+rcPortalPipeSockWrite (void *writeArg, char *buf, int len)
+{
+    rcPortalTransferInp_t *myInput = (rcPortalTransferInp_t *) writeArg;
+    int bytesWritten;
+
+    bytesWritten = myWrite (myInput->destFd, buf, len, SOCK_TYPE, NULL);
+    if (bytesWritten == len) addLfRestartLen (myInput, len);
+    return bytesWritten;
+}
+
+static int
+rcPortalPipeFileWrite (void *writeArg, char *buf, int len)
+{
+    rcPortalTransferInp_t *myInput = (rcPortalTransferInp_t *) writeArg;
+    int bytesWritten;
+
+    bytesWritten = myWrite (myInput->destFd, buf, len, FILE_DESC_TYPE, NULL);
+    if (bytesWritten == len) addLfRestartLen (myInput, len);
+    return bytesWritten;
+}
+
 void
 rcPartialDataPut (rcPortalTransferInp_t *myInput)
 {
@@ -293,6 +776,10 @@ rcPartialDataPut (rcPortalTransferInp_t *myInput)
     rcComm_t *conn;
     fileRestartInfo_t *info;
     int threadNum;
+    portalPipe_t portalPipe;
+    int pipeBufCnt;
+    portalStat_t *portalStat;
+    rodsLong_t waitStart;
 
 #ifdef PARA_DEBUG
     printf ("rcPartialDataPut: thread %d at start\n", myInput->threadNum);
@@ -310,8 +797,17 @@ rcPartialDataPut (rcPortalTransferInp_t *myInput)
 
     destFd = myInput->destFd;
     srcFd = myInput->srcFd;
-
-    buf = malloc (TRANS_BUF_SZ);
+    portalStat = myInput->portalStat;
+    beginPortalStat (portalStat, threadNum);
+
+    /* with a portal pipe, the bufs come from getPortalPipeBuf */
+    buf = NULL;
+    if ((pipeBufCnt = getPortalPipeBufCnt ()) > 0 &&
+      initPortalPipe (&portalPipe, pipeBufCnt, rcPortalPipeSockWrite, 
+      myInput) < 0) {
+        pipeBufCnt = 0;
+    }
+    if (pipeBufCnt == 0) buf = malloc (TRANS_BUF_SZ);
 
     myInput->bytesWritten = 0;
 
@@ -322,7 +818,9 @@ rcPartialDataPut (rcPortalTransferInp_t *myInput)
     while (myInput->status >= 0) {
 	rodsLong_t toPut;
 
+        waitStart = getPortalStatUsec (portalStat);
         myInput->status = rcvTranHeader (destFd, &myHeader);
+        addPortalStatUsec (portalStat, PORTAL_STAT_SOCK, waitStart);
 
 #ifdef PARA_DEBUG
         printf ("rcPartialDataPut: thread %d after rcvTranHeader\n", 
@@ -338,6 +836,13 @@ rcPartialDataPut (rcPortalTransferInp_t *myInput)
         }
 	if (myHeader.offset != curOffset) {
 	    curOffset = myHeader.offset;
+	    /* the restart info of the last run must be complete */
+	    waitStart = getPortalStatUsec (portalStat);
+	    if (pipeBufCnt > 0 && 
+	      (myInput->status = drainPortalPipe (&portalPipe)) < 0) {
+		break;
+	    }
+	    addPortalStatUsec (portalStat, PORTAL_STAT_SOCK, waitStart);
 	    if (lseek (srcFd, curOffset, SEEK_SET) < 0) {
 		myInput->status = UNIX_FILE_LSEEK_ERR - errno;
 		rodsLogError (LOG_ERROR, myInput->status,
@@ -345,8 +850,11 @@ rcPartialDataPut (rcPortalTransferInp_t *myInput)
 		  curOffset, myInput->status);
 		break;
 	    }
-	    if (info->numSeg > 0)       /* file restart */
+	    if (info->numSeg > 0) {     /* file restart */
+		/* start a new run. A dynamic transfer can skip chunks */
                 info->dataSeg[threadNum].offset = curOffset;
+                info->dataSeg[threadNum].len = 0;
+	    }
 	}
 
 	toPut = myHeader.length;
@@ -359,8 +867,17 @@ rcPartialDataPut (rcPortalTransferInp_t *myInput)
 		toRead = toPut;
 	    } 
 
+	    waitStart = getPortalStatUsec (portalStat);
+	    if (pipeBufCnt > 0 && 
+	      (buf = getPortalPipeBuf (&portalPipe)) == NULL) {
+		myInput->status = drainPortalPipe (&portalPipe);
+		break;
+	    }
+	    addPortalStatUsec (portalStat, PORTAL_STAT_SOCK, waitStart);
+	    waitStart = getPortalStatUsec (portalStat);
 	    bytesRead = myRead (srcFd, buf, toRead, FILE_DESC_TYPE, 
 	      &bytesRead, NULL);
+	    addPortalStatUsec (portalStat, PORTAL_STAT_DISK, waitStart);
 	    if (bytesRead != toRead) {
 		myInput->status = SYS_COPY_LEN_ERR - errno;
 		rodsLogError (LOG_ERROR, myInput->status,
@@ -368,8 +885,19 @@ rcPartialDataPut (rcPortalTransferInp_t *myInput)
 		  toPut, bytesRead);   
 		break;
 	    }
+	    if (pipeBufCnt > 0) {
+		/* the helper thread sends it while we read the next slice */
+		if ((myInput->status = queuePortalPipeBuf (&portalPipe, 
+		  bytesRead)) < 0) {
+		    break;
+		}
+		toPut -= bytesRead;
+		continue;
+	    }
+	    waitStart = getPortalStatUsec (portalStat);
 	    bytesWritten = myWrite (destFd, buf, bytesRead, SOCK_TYPE,
 	      &bytesWritten);
+	    addPortalStatUsec (portalStat, PORTAL_STAT_SOCK, waitStart);
 
 	    if (bytesWritten != bytesRead) {
                 myInput->status = SYS_COPY_LEN_ERR - errno;
@@ -379,23 +907,7 @@ rcPartialDataPut (rcPortalTransferInp_t *myInput)
                 break;
 	    }
 	    toPut -= bytesWritten;
-	    if (info->numSeg > 0) {     /* file restart */
-		info->dataSeg[threadNum].len += bytesWritten;
-		conn->fileRestart.writtenSinceUpdated += bytesWritten;
-                if (threadNum == 0 && conn->fileRestart.writtenSinceUpdated >= 
-		  RESTART_FILE_UPDATE_SIZE) {
-		    int status;
-                    /* time to write to the restart file */
-                    status = writeLfRestartFile (conn->fileRestart.infoFile,
-                      &conn->fileRestart.info);
-                    if (status < 0) {
-                        rodsLog (LOG_ERROR,
-                         "putFile: writeLfRestartFile for %s, status = %d",
-                         conn->fileRestart.info.fileName, status);
-                    }
-                    conn->fileRestart.writtenSinceUpdated = 0;
-                }
-	    }
+	    addLfRestartLen (myInput, bytesWritten);
 	}
 	curOffset += myHeader.length;
 	myInput->bytesWritten += myHeader.length;
@@ -408,7 +920,15 @@ rcPartialDataPut (rcPortalTransferInp_t *myInput)
         }
     }
 
-    free (buf);
+    waitStart = getPortalStatUsec (portalStat);
+    if (pipeBufCnt > 0) {
+	int status = endPortalPipe (&portalPipe);
+	if (status < 0 && myInput->status >= 0) myInput->status = status;
+    } else {
+        free (buf);
+    }
+    addPortalStatUsec (portalStat, PORTAL_STAT_SOCK, waitStart);
+    endPortalStat (portalStat, destFd, myInput->bytesWritten);
     close (srcFd);
     mySockClose (destFd);
 }
@@ -698,6 +1218,8 @@ char *locFilePath, char *objPath, rodsLong_t dataSize)
     int i, sock, out_fd;
     int numThreads;
     rcPortalTransferInp_t myInput[MAX_NUM_CONFIG_TRAN_THR];
+    portalStat_t portalStat[MAX_NUM_CONFIG_TRAN_THR];
+    int statFlag = isPortalStatOn ();
 #ifdef USE_BOOST
     boost::thread* tid[MAX_NUM_CONFIG_TRAN_THR];
 #else
@@ -756,8 +1278,10 @@ char *locFilePath, char *objPath, rodsLong_t dataSize)
             "cannot open file %s, status = %d", locFilePath, retVal);
             return (retVal);
         }
-        fillRcPortalTransferInp (conn, &myInput[0], out_fd, sock, 0640);
+        fillRcPortalTransferInp (conn, &myInput[0], out_fd, sock, 0);
+        if (statFlag > 0) myInput[0].portalStat = &portalStat[0];
         rcPartialDataGet (&myInput[0]);
+        printPortalStat ("get", objPath, myInput, 1);
         if (myInput[0].status < 0) {
             return (myInput[0].status);
         } else {
@@ -798,6 +1322,7 @@ char *locFilePath, char *objPath, rodsLong_t dataSize)
 		continue;
             }
             fillRcPortalTransferInp (conn, &myInput[i], out_fd, sock, i);
+            if (statFlag > 0) myInput[i].portalStat = &portalStat[i];
 #ifdef USE_BOOST
 	    tid[i] = new boost::thread( rcPartialDataGet, &myInput[i] );
 #else
@@ -823,6 +1348,7 @@ char *locFilePath, char *objPath, rodsLong_t dataSize)
                 retVal = myInput[i].status;
             }
         }
+        printPortalStat ("get", objPath, myInput, numThreads);
         if (retVal < 0) {
             return (retVal);
         } else {
@@ -860,6 +1386,10 @@ rcPartialDataGet (rcPortalTransferInp_t *myInput)
     rcComm_t *conn;
     fileRestartInfo_t *info;
     int threadNum;
+    portalPipe_t portalPipe;
+    int pipeBufCnt;
+    portalStat_t *portalStat;
+    rodsLong_t waitStart;
 
 #ifdef PARA_DEBUG
     printf ("rcPartialDataGet: thread %d at start\n", myInput->threadNum);
@@ -877,8 +1407,17 @@ rcPartialDataGet (rcPortalTransferInp_t *myInput)
 
     destFd = myInput->destFd;
     srcFd = myInput->srcFd;
-
-    buf = malloc (TRANS_BUF_SZ);
+    portalStat = myInput->portalStat;
+    beginPortalStat (portalStat, threadNum);
+
+    /* with a portal pipe, the bufs come from getPortalPipeBuf */
+    buf = NULL;
+    if ((pipeBufCnt = getPortalPipeBufCnt ()) > 0 &&
+      initPortalPipe (&portalPipe, pipeBufCnt, rcPortalPipeFileWrite, 
+      myInput) < 0) {
+        pipeBufCnt = 0;
+    }
+    if (pipeBufCnt == 0) buf = malloc (TRANS_BUF_SZ);
 
     myInput->bytesWritten = 0;
 
@@ -890,7 +1429,9 @@ rcPartialDataGet (rcPortalTransferInp_t *myInput)
     while (myInput->status >= 0) {
         rodsLong_t toGet;
 
+        waitStart = getPortalStatUsec (portalStat);
         myInput->status = rcvTranHeader (srcFd, &myHeader);
+        addPortalStatUsec (portalStat, PORTAL_STAT_SOCK, waitStart);
 
 #ifdef PARA_DEBUG
         printf ("rcPartialDataGet: thread %d after rcvTranHeader\n",
@@ -906,6 +1447,13 @@ rcPartialDataGet (rcPortalTransferInp_t *myInput)
         }
         if (myHeader.offset != curOffset) {
             curOffset = myHeader.offset;
+            /* the queued bufs go to the old offset */
+            waitStart = getPortalStatUsec (portalStat);
+            if (pipeBufCnt > 0 &&
+              (myInput->status = drainPortalPipe (&portalPipe)) < 0) {
+                break;
+            }
+            addPortalStatUsec (portalStat, PORTAL_STAT_DISK, waitStart);
             if (lseek (destFd, curOffset, SEEK_SET) < 0) {
                 myInput->status = UNIX_FILE_LSEEK_ERR - errno;
                 rodsLogError (LOG_ERROR, myInput->status,
@@ -913,8 +1461,11 @@ rcPartialDataGet (rcPortalTransferInp_t *myInput)
                   curOffset, myInput->status);
                 break;
             }
-            if (info->numSeg > 0)       /* file restart */
+            if (info->numSeg > 0) {     /* file restart */
+                /* start a new run. A dynamic transfer can skip chunks */
                 info->dataSeg[threadNum].offset = curOffset;
+                info->dataSeg[threadNum].len = 0;
+            }
         }
 
         toGet = myHeader.length;
@@ -927,8 +1478,17 @@ rcPartialDataGet (rcPortalTransferInp_t *myInput)
                 toRead = toGet;
             }
 
+            waitStart = getPortalStatUsec (portalStat);
+            if (pipeBufCnt > 0 &&
+              (buf = getPortalPipeBuf (&portalPipe)) == NULL) {
+                myInput->status = drainPortalPipe (&portalPipe);
+                break;
+            }
+            addPortalStatUsec (portalStat, PORTAL_STAT_DISK, waitStart);
+            waitStart = getPortalStatUsec (portalStat);
             bytesRead = myRead (srcFd, buf, toRead, SOCK_TYPE, &bytesRead, 
 	      NULL);
+            addPortalStatUsec (portalStat, PORTAL_STAT_SOCK, waitStart);
             if (bytesRead != toRead) {
                 myInput->status = SYS_COPY_LEN_ERR - errno;
                 rodsLogError (LOG_ERROR, myInput->status,
@@ -936,8 +1496,19 @@ rcPartialDataGet (rcPortalTransferInp_t *myInput)
                   toGet, bytesRead);
                 break;
             }
+            if (pipeBufCnt > 0) {
+                /* the helper thread writes it while we read the next slice */
+                if ((myInput->status = queuePortalPipeBuf (&portalPipe,
+                  bytesRead)) < 0) {
+                    break;
+                }
+                toGet -= bytesRead;
+                continue;
+            }
+            waitStart = getPortalStatUsec (portalStat);
             bytesWritten = myWrite (destFd, buf, bytesRead, FILE_DESC_TYPE,
 	      &bytesWritten);
+            addPortalStatUsec (portalStat, PORTAL_STAT_DISK, waitStart);
 
             if (bytesWritten != bytesRead) {
                 myInput->status = SYS_COPY_LEN_ERR - errno;
@@ -947,23 +1518,7 @@ rcPartialDataGet (rcPortalTransferInp_t *myInput)
                 break;
             }
             toGet -= bytesWritten;
-            if (info->numSeg > 0) {     /* file restart */
-                info->dataSeg[threadNum].len += bytesWritten;
-                conn->fileRestart.writtenSinceUpdated += bytesWritten;
-                if (threadNum == 0 && conn->fileRestart.writtenSinceUpdated >=
-                  RESTART_FILE_UPDATE_SIZE) {
-                    int status;
-                    /* time to write to the restart file */
-                    status = writeLfRestartFile (conn->fileRestart.infoFile,
-                      &conn->fileRestart.info);
-                    if (status < 0) {
-                        rodsLog (LOG_ERROR,
-                         "putFile: writeLfRestartFile for %s, status = %d",
-                         conn->fileRestart.info.fileName, status);
-                    }
-                    conn->fileRestart.writtenSinceUpdated = 0;
-                }
-            }
+            addLfRestartLen (myInput, bytesWritten);
         }
         curOffset += myHeader.length;
         myInput->bytesWritten += myHeader.length;
@@ -976,7 +1531,15 @@ rcPartialDataGet (rcPortalTransferInp_t *myInput)
 	}
     }
 
-    free (buf);
+    waitStart = getPortalStatUsec (portalStat);
+    if (pipeBufCnt > 0) {
+        int status = endPortalPipe (&portalPipe);
+        if (status < 0 && myInput->status >= 0) myInput->status = status;
+    } else {
+        free (buf);
+    }
+    addPortalStatUsec (portalStat, PORTAL_STAT_DISK, waitStart);
+    endPortalStat (portalStat, srcFd, myInput->bytesWritten);
     close (destFd);
     CLOSE_SOCK (srcFd);
 }
@@ -1334,6 +1897,25 @@ clearLfRestartFile (fileRestart_t *fileRestart)
     return 0;
 }
 
+/* sortDataSeg - sort the dataSeg by offset. With a dynamic portal
+ * transfer, the runs of the threads are not in thread order */
+
+static void
+sortDataSeg (fileRestartInfo_t *info)
+{
+    dataSeg_t tmpSeg;
+    int i, j;
+
+    for (i = 1; i < info->numSeg; i++) {
+	tmpSeg = info->dataSeg[i];
+	for (j = i; j > 0 && info->dataSeg[j - 1].offset > tmpSeg.offset; 
+	  j--) {
+	    info->dataSeg[j] = info->dataSeg[j - 1];
+	}
+	info->dataSeg[j] = tmpSeg;
+    }
+}
+
 int
 lfRestartPutWithInfo (rcComm_t *conn, fileRestartInfo_t *info)
 {
@@ -1381,6 +1963,7 @@ lfRestartPutWithInfo (rcComm_t *conn, fileRestartInfo_t *info)
 
     memset (&dataObjLseekInp, 0, sizeof (dataObjLseekInp));
     dataObjLseekInp.whence = SEEK_SET;
+    sortDataSeg (info);
     for (i = 0; i < info->numSeg; i++) {
 	gap = info->dataSeg[i].offset - curOffset;
 	if (gap < 0) {
@@ -1533,6 +2116,7 @@ lfRestartGetWithInfo (rcComm_t *conn, fileRestartInfo_t *info)
     dataObjLseekInp.whence = SEEK_SET;
     dataObjLseekInp.l1descInx = irodsFd;
 
+    sortDataSeg (info);
     for (i = 0; i < info->numSeg; i++) {
         gap = info->dataSeg[i].offset - curOffset;
         if (gap < 0) {
@@ -159,6 +159,10 @@
     PATH_REG_NOT_ALLOWED, 
     SYS_INVALID_INPUT_PARAM, 
     SYS_GROUP_RETRIEVE_ERR, 
+    SYS_AGENT_POOL_ERR, 
+    SYS_SVR_CFG_SNAP_ERR, 
+    SYS_THREAD_RESOURCE_ERR, 
+    SYS_TRAN_THR_TUNE_ERR, 
     USER_AUTH_SCHEME_ERR, 
     USER_AUTH_STRING_EMPTY, 
     USER_RODS_HOST_EMPTY, 
@@ -209,6 +213,7 @@
     BULK_OPR_MISMATCH_FOR_RESTART, 
     OBJ_PATH_DOES_NOT_EXIST, 
     SYMLINKED_BUNFILE_NOT_ALLOWED, 
+    USER_CHKSUM_SCHEME_ERR, 
     FILE_INDEX_LOOKUP_ERR, 
     UNIX_FILE_OPEN_ERR, 
     UNIX_FILE_CREATE_ERR, 
@@ -725,6 +730,10 @@
     "PATH_REG_NOT_ALLOWED", 
     "SYS_INVALID_INPUT_PARAM", 
     "SYS_GROUP_RETRIEVE_ERR", 
+    "SYS_AGENT_POOL_ERR", 
+    "SYS_SVR_CFG_SNAP_ERR", 
+    "SYS_THREAD_RESOURCE_ERR", 
+    "SYS_TRAN_THR_TUNE_ERR", 
     "USER_AUTH_SCHEME_ERR", 
     "USER_AUTH_STRING_EMPTY", 
     "USER_RODS_HOST_EMPTY", 
@@ -775,6 +784,7 @@
     "BULK_OPR_MISMATCH_FOR_RESTART", 
     "OBJ_PATH_DOES_NOT_EXIST", 
     "SYMLINKED_BUNFILE_NOT_ALLOWED", 
+    "USER_CHKSUM_SCHEME_ERR", 
     "FILE_INDEX_LOOKUP_ERR", 
     "UNIX_FILE_OPEN_ERR", 
     "UNIX_FILE_CREATE_ERR", 
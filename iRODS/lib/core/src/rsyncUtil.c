@@ -178,8 +178,8 @@ dataObjInp_t *dataObjOprInp)
 	}
     } else if (strlen (srcPath->chksum) > 0) {
 	/* src has a checksum value */
-        status = rcChksumLocFile (targPath->outPath, RSYNC_CHKSUM_KW,
-          &dataObjOprInp->condInput);
+        status = rcChksumLocFileByScheme (targPath->outPath, RSYNC_CHKSUM_KW,
+          &dataObjOprInp->condInput, getChksumScheme (srcPath->chksum));
         if (status < 0) {
             rodsLogError (LOG_ERROR, status,
               "rsyncDataToFileUtil: rcChksumLocFile error for %s, status = %d",
@@ -297,8 +297,8 @@ dataObjInp_t *dataObjOprInp)
 	}
     } else if (strlen (targPath->chksum) > 0) {
 	/* src has a checksum value */
-        status = rcChksumLocFile (srcPath->outPath, RSYNC_CHKSUM_KW,
-          &dataObjOprInp->condInput);
+        status = rcChksumLocFileByScheme (srcPath->outPath, RSYNC_CHKSUM_KW,
+          &dataObjOprInp->condInput, getChksumScheme (targPath->chksum));
         if (status < 0) {
             rodsLogError (LOG_ERROR, status,
               "rsyncFileToDataUtil: rcChksumLocFile error for %s, status = %d",
@@ -293,10 +293,148 @@ rsAcceptConn (rsComm_t *svrComm)
 	 svrComm->sock, status);
     }
     rodsSetSockOpt (newSock, svrComm->windowSize);
+    setSockBinMsgHeader (newSock, 0);
 
     return (newSock);
 }
 
+/* the msg types that can be sent with a binary header. Only append
+ * to the list - the index goes over the wire */
+static char *BinMsgHeaderType[] = {
+    RODS_CONNECT_T,
+    RODS_VERSION_T,
+    RODS_API_REQ_T,
+    RODS_DISCONNECT_T,
+    RODS_RECONNECT_T,
+    RODS_REAUTH_T,
+    RODS_API_REPLY_T,
+    NULL
+};
+
+/* whether a binary header is sent on a socket. Set in 
+ * initRsCommWithStartupPack on the server and when a binary header is 
+ * received. Reset when a socket is connected or accepted. */
+static unsigned char BinMsgHeaderSock[MAX_BIN_MSG_HEADER_SOCK];
+
+int
+setSockBinMsgHeader (int sock, int flag)
+{
+    if (sock < 0 || sock >= MAX_BIN_MSG_HEADER_SOCK) return 0;
+    BinMsgHeaderSock[sock] = (flag > 0);
+    return 0;
+}
+
+int
+getSockBinMsgHeader (int sock)
+{
+    if (sock < 0 || sock >= MAX_BIN_MSG_HEADER_SOCK) return 0;
+    return (BinMsgHeaderSock[sock]);
+}
+
+/* stripBinMsgHeaderOpt - remove BIN_MSG_HEADER_OPT from the option of
+ * a startupPack. Returns 1 if the client asked for a binary header */
+
+int
+stripBinMsgHeaderOpt (char *option)
+{
+    char *tmpPtr;
+
+    if (option == NULL || 
+      (tmpPtr = strstr (option, BIN_MSG_HEADER_OPT)) == NULL) {
+	return 0;
+    }
+    ovStrcpy (tmpPtr, tmpPtr + strlen (BIN_MSG_HEADER_OPT));
+    return 1;
+}
+
+static int
+readBinMsgHeader (int sock, msgHeader_t *myHeader, struct timeval *tv)
+{
+    binMsgHeader_t binHeader;
+    int nbytes, status;
+
+    nbytes = myRead (sock, (void *) &binHeader, sizeof (binHeader),
+      SOCK_TYPE, NULL, tv);
+
+    if (nbytes != sizeof (binHeader)) {
+        if (nbytes < 0) {
+            status = nbytes - errno;
+        } else {
+            status = SYS_HEADER_READ_LEN_ERR - errno;
+        }
+        rodsLog (LOG_ERROR,
+         "readBinMsgHeader: read %d bytes, expect %d, status = %d",
+         nbytes, sizeof (binHeader), status);
+        return (status);
+    }
+
+    binHeader.typeInx = ntohl (binHeader.typeInx);
+    if (binHeader.typeInx < 0 || binHeader.typeInx >= 
+      (int) (sizeof (BinMsgHeaderType) / sizeof (char *)) - 1) {
+        rodsLog (LOG_ERROR,
+         "readBinMsgHeader: unknown msg type index %d", binHeader.typeInx);
+        return (SYS_HEADER_TPYE_LEN_ERR);
+    }
+
+    memset (myHeader, 0, sizeof (msgHeader_t));
+    rstrcpy (myHeader->type, BinMsgHeaderType[binHeader.typeInx], 
+      HEADER_TYPE_LEN);
+    myHeader->msgLen = ntohl (binHeader.msgLen);
+    myHeader->errorLen = ntohl (binHeader.errorLen);
+    myHeader->bsLen = ntohl (binHeader.bsLen);
+    myHeader->intInfo = ntohl (binHeader.intInfo);
+
+    if (getRodsLogLevel () >= LOG_DEBUG3) {
+        printf ("received binary header: type = %s, msgLen = %d\n", 
+	  myHeader->type, myHeader->msgLen);
+    }
+
+    /* the other side reads binary headers too */
+    setSockBinMsgHeader (sock, 1);
+
+    return (0);
+}
+
+/* writeBinMsgHeader - send the mark and the binary header with a 
+ * single write. Returns SYS_UNMATCHED_API_NUM if the type has no
+ * binary index */
+static int
+writeBinMsgHeader (int sock, msgHeader_t *myHeader)
+{
+    int outBuf[1 + sizeof (binMsgHeader_t) / sizeof (int)];
+    binMsgHeader_t *binHeader;
+    int i, nbytes;
+
+    for (i = 0; BinMsgHeaderType[i] != NULL; i++) {
+	if (strcmp (BinMsgHeaderType[i], myHeader->type) == 0) break;
+    }
+    if (BinMsgHeaderType[i] == NULL) return SYS_UNMATCHED_API_NUM;
+
+    outBuf[0] = htonl (BIN_MSG_HEADER_MARK);
+    binHeader = (binMsgHeader_t *) &outBuf[1];
+    binHeader->typeInx = htonl (i);
+    binHeader->msgLen = htonl (myHeader->msgLen);
+    binHeader->errorLen = htonl (myHeader->errorLen);
+    binHeader->bsLen = htonl (myHeader->bsLen);
+    binHeader->intInfo = htonl (myHeader->intInfo);
+
+    if (getRodsLogLevel () >= LOG_DEBUG3) {
+        printf ("sending binary header: type = %s, msgLen = %d\n", 
+	  myHeader->type, myHeader->msgLen);
+    }
+
+    nbytes = myWrite (sock, (void *) outBuf, sizeof (outBuf), SOCK_TYPE, 
+      NULL);
+
+    if (nbytes != (int) sizeof (outBuf)) {
+        rodsLog (LOG_ERROR,
+         "writeBinMsgHeader: wrote %d bytes, expect %d, status = %d",
+         nbytes, sizeof (outBuf), SYS_HEADER_WRITE_LEN_ERR - errno);
+        return (SYS_HEADER_WRITE_LEN_ERR - errno);
+    }
+    return (0);
+}
+
 int
 readMsgHeader (int sock, msgHeader_t *myHeader, struct timeval *tv)
 {
@@ -325,6 +463,10 @@ readMsgHeader (int sock, msgHeader_t *myHeader, struct timeval *tv)
 
     myLen =  ntohl (myLen);
 
+    if (myLen == BIN_MSG_HEADER_MARK) {
+	return (readBinMsgHeader (sock, myHeader, tv));
+    }
+
     if (myLen > MAX_NAME_LEN || myLen <= 0) {
         rodsLog (LOG_ERROR,
          "readMsgHeader: header length %d out of range",
@@ -376,6 +518,12 @@ writeMsgHeader (int sock, msgHeader_t *myHeader)
     int myLen;
     bytesBuf_t *headerBBuf = NULL;
 
+    if (getSockBinMsgHeader (sock) > 0) {
+	status = writeBinMsgHeader (sock, myHeader);
+	if (status != SYS_UNMATCHED_API_NUM) return status;
+	/* not a known type. send it as XML */
+    }
+
     /* always use XML_PROT for the Header */
     status = packStruct ((void *) myHeader, &headerBBuf,
       "MsgHeader_PI", RodsPackTable, 0, XML_PROT);
@@ -811,6 +959,7 @@ int timeoutFlag)
     }
 
     rodsSetSockOpt (sock, windowSize);
+    setSockBinMsgHeader (sock, 0);
 
 #ifdef PORTNAME_solaris
     flag = fcntl (sock, F_GETFL);
@@ -1082,6 +1231,11 @@ sendStartupPack (rcComm_t *conn, int connectCnt, int reconnFlag)
     } else {
         startupPack.option[0] = '\0';
     }
+    /* ask for the binary msg header */
+    stripBinMsgHeaderOpt (startupPack.option);
+    if (strlen (startupPack.option) + strlen (BIN_MSG_HEADER_OPT) < NAME_LEN) {
+	strcat (startupPack.option, BIN_MSG_HEADER_OPT);
+    }
 
     /* always use XML_PROT for the startupPack */
     status = packStruct ((void *) &startupPack, &startupPackBBuf,
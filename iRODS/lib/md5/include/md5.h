@@ -33,6 +33,9 @@ Removed PROTO_LIST macro for C++ compatability.
 		is undefined.
 */
 
+#ifndef MD5_H
+#define MD5_H
+
 #ifdef  __cplusplus
 extern "C" {
 #endif
@@ -67,3 +70,4 @@ void MD5Final PROTO_LIST ((unsigned char [16], MD5_CTX *));
 }
 #endif
 
+#endif	/* MD5_H */
@@ -0,0 +1,36 @@
+/* SHA256.H - header file for SHA256C.C
+ */
+
+/* The SHA-256 secure hash of FIPS 180-2. The generic code is plain C.
+ * On x86 hosts with the SHA extensions the block function is switched
+ * at run time to one using the sha256rnds2 instructions. Define
+ * SHA256_NO_HW_ACCEL to always use the generic code.
+ */
+
+#ifndef SHA256_H
+#define SHA256_H
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+#define SHA256_DIGEST_LEN	32
+#define SHA256_BLOCK_LEN	64
+
+/* SHA256 context. */
+typedef struct {
+  unsigned int state[8];                        /* state (ABCDEFGH) */
+  unsigned long long count;                  /* number of bytes in */
+  unsigned char buffer[SHA256_BLOCK_LEN];               /* input buffer */
+} SHA256_CTX;
+
+void SHA256Init (SHA256_CTX *);
+void SHA256Update (SHA256_CTX *, unsigned char *, unsigned int);
+void SHA256Final (unsigned char [SHA256_DIGEST_LEN], SHA256_CTX *);
+int SHA256HwAccel ();
+
+#ifdef  __cplusplus
+}
+#endif
+
+#endif	/* SHA256_H */
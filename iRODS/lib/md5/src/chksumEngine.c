@@ -0,0 +1,389 @@
+/*** Copyright (c), The Regents of the University of California            ***
+ *** For more information please refer to files in the COPYRIGHT directory ***/
+
+/* chksumEngine.c - the chksum schemes. md5 is the original one. sha2 is
+ * sha256 and sha2tree is a sha256 hash tree which can be computed with
+ * several threads.
+ */
+
+#include "md5Checksum.h"
+#include "chksumEngine.h"
+#include "base64.h"
+
+#ifndef windows_platform
+#ifdef USE_BOOST
+#include <boost/thread/thread.hpp>
+#else
+#ifdef PARA_OPR
+#include <pthread.h>
+#endif
+#endif
+#endif
+
+#if !defined(windows_platform) && (defined(USE_BOOST) || defined(PARA_OPR))
+#define TREE_CHKSUM_THREADS
+#endif
+
+typedef struct TreeChksumInp {
+    int fd;
+    int threadNum;
+    int numThreads;
+    int chunkCnt;
+    rodsLong_t fileSize;
+    unsigned char *digest;	/* chunkCnt SHA256_DIGEST_LEN digests */
+    int status;
+} treeChksumInp_t;
+
+static int
+endTreeChunk (chksumEngine_t *chksumEngine);
+static int
+shaDigestToStr (char *schemeName, unsigned char *digest, char *chksumStr);
+
+int
+getDefChksumScheme ()
+{
+    char *tmpStr;
+    int scheme;
+
+    if ((tmpStr = getenv (CHKSUM_SCHEME_KW)) == NULL)
+        return MD5_CHKSUM_SCHEME;
+    scheme = getChksumSchemeByName (tmpStr);
+    if (scheme < 0) {
+        rodsLog (LOG_NOTICE,
+          "getDefChksumScheme: unknown %s %s, md5 is used",
+          CHKSUM_SCHEME_KW, tmpStr);
+        return MD5_CHKSUM_SCHEME;
+    }
+    return scheme;
+}
+
+int
+getChksumSchemeByName (char *schemeName)
+{
+    if (schemeName == NULL) return USER__NULL_INPUT_ERR;
+
+    if (strcmp (schemeName, MD5_CHKSUM_NAME) == 0) {
+        return MD5_CHKSUM_SCHEME;
+    } else if (strcmp (schemeName, SHA256_CHKSUM_NAME) == 0) {
+        return SHA256_CHKSUM_SCHEME;
+    } else if (strcmp (schemeName, SHA256_TREE_CHKSUM_NAME) == 0) {
+        return SHA256_TREE_CHKSUM_SCHEME;
+    } else {
+        return USER_CHKSUM_SCHEME_ERR;
+    }
+}
+
+/* getChksumScheme - the scheme of a stored chksum. A chksum without a
+ * scheme name is md5. Returns DEF_CHKSUM_SCHEME for an empty chksumStr.
+ */
+int
+getChksumScheme (char *chksumStr)
+{
+    char schemeName[NAME_LEN];
+    char *sepPtr;
+    int len;
+
+    if (chksumStr == NULL || *chksumStr == '\0') return DEF_CHKSUM_SCHEME;
+
+    if ((sepPtr = strchr (chksumStr, CHKSUM_SCHEME_SEP)) == NULL)
+        return MD5_CHKSUM_SCHEME;
+
+    len = sepPtr - chksumStr;
+    if (len >= NAME_LEN) return USER_CHKSUM_SCHEME_ERR;
+    strncpy (schemeName, chksumStr, len);
+    schemeName[len] = '\0';
+
+    return getChksumSchemeByName (schemeName);
+}
+
+int
+initChksumEngine (chksumEngine_t *chksumEngine, int scheme)
+{
+    if (scheme == DEF_CHKSUM_SCHEME) scheme = getDefChksumScheme ();
+
+    memset (chksumEngine, 0, sizeof (chksumEngine_t));
+    chksumEngine->scheme = scheme;
+
+    switch (scheme) {
+      case MD5_CHKSUM_SCHEME:
+        MD5Init (&chksumEngine->md5Context);
+        break;
+      case SHA256_CHKSUM_SCHEME:
+        SHA256Init (&chksumEngine->shaContext);
+        break;
+      case SHA256_TREE_CHKSUM_SCHEME:
+        SHA256Init (&chksumEngine->shaContext);
+        SHA256Init (&chksumEngine->treeContext);
+        break;
+      default:
+        rodsLog (LOG_NOTICE,
+          "initChksumEngine: unknown chksum scheme %d", scheme);
+        return USER_CHKSUM_SCHEME_ERR;
+    }
+    return 0;
+}
+
+int
+updateChksumEngine (chksumEngine_t *chksumEngine, unsigned char *buf,
+int len)
+{
+    int toHash;
+
+    switch (chksumEngine->scheme) {
+      case MD5_CHKSUM_SCHEME:
+        MD5Update (&chksumEngine->md5Context, buf, len);
+        break;
+      case SHA256_CHKSUM_SCHEME:
+        SHA256Update (&chksumEngine->shaContext, buf, len);
+        break;
+      case SHA256_TREE_CHKSUM_SCHEME:
+        while (len > 0) {
+            toHash = len;
+            if (chksumEngine->chunkLen + toHash > TREE_CHKSUM_CHUNK_SZ)
+                toHash = TREE_CHKSUM_CHUNK_SZ - chksumEngine->chunkLen;
+            SHA256Update (&chksumEngine->shaContext, buf, toHash);
+            chksumEngine->chunkLen += toHash;
+            buf += toHash;
+            len -= toHash;
+            if (chksumEngine->chunkLen == TREE_CHKSUM_CHUNK_SZ)
+                endTreeChunk (chksumEngine);
+        }
+        break;
+      default:
+        return USER_CHKSUM_SCHEME_ERR;
+    }
+    return 0;
+}
+
+int
+finalChksumEngine (chksumEngine_t *chksumEngine, char *chksumStr)
+{
+    unsigned char digest[SHA256_DIGEST_LEN];
+
+    switch (chksumEngine->scheme) {
+      case MD5_CHKSUM_SCHEME:
+        MD5Final (digest, &chksumEngine->md5Context);
+        return md5ToStr (digest, chksumStr);
+      case SHA256_CHKSUM_SCHEME:
+        SHA256Final (digest, &chksumEngine->shaContext);
+        return shaDigestToStr (SHA256_CHKSUM_NAME, digest, chksumStr);
+      case SHA256_TREE_CHKSUM_SCHEME:
+        if (chksumEngine->chunkLen > 0 || chksumEngine->chunkCnt == 0)
+            endTreeChunk (chksumEngine);
+        SHA256Final (digest, &chksumEngine->treeContext);
+        return shaDigestToStr (SHA256_TREE_CHKSUM_NAME, digest, chksumStr);
+      default:
+        return USER_CHKSUM_SCHEME_ERR;
+    }
+}
+
+static int
+endTreeChunk (chksumEngine_t *chksumEngine)
+{
+    unsigned char digest[SHA256_DIGEST_LEN];
+
+    SHA256Final (digest, &chksumEngine->shaContext);
+    SHA256Update (&chksumEngine->treeContext, digest, SHA256_DIGEST_LEN);
+    SHA256Init (&chksumEngine->shaContext);
+    chksumEngine->chunkCnt++;
+    chksumEngine->chunkLen = 0;
+    return 0;
+}
+
+static int
+shaDigestToStr (char *schemeName, unsigned char *digest, char *chksumStr)
+{
+    unsigned long outLen;
+    int len;
+
+    len = snprintf (chksumStr, NAME_LEN, "%s%c", schemeName,
+      CHKSUM_SCHEME_SEP);
+    outLen = NAME_LEN - len;
+    if (base64_encode (digest, SHA256_DIGEST_LEN,
+      (unsigned char *) chksumStr + len, &outLen) != 0) {
+        *chksumStr = '\0';
+        return SYS_INTERNAL_NULL_INPUT_ERR;
+    }
+    return 0;
+}
+
+int
+getTreeChksumThreads ()
+{
+    char *tmpStr;
+    int numThreads;
+
+    if ((tmpStr = getenv (TREE_CHKSUM_THREADS_KW)) == NULL)
+        return DEF_TREE_CHKSUM_THREADS;
+    numThreads = atoi (tmpStr);
+    if (numThreads <= 0) return 1;
+    if (numThreads > MAX_TREE_CHKSUM_THREADS)
+        numThreads = MAX_TREE_CHKSUM_THREADS;
+    return numThreads;
+}
+
+/* treeDigestsToChksum - the sha2tree chksum of the chunkCnt digests of
+ * the chunks of a file, e.g., as they were hashed by separate threads.
+ */
+int
+treeDigestsToChksum (unsigned char *chunkDigest, int chunkCnt,
+char *chksumStr)
+{
+    SHA256_CTX context;
+    unsigned char digest[SHA256_DIGEST_LEN];
+
+    SHA256Init (&context);
+    SHA256Update (&context, chunkDigest, chunkCnt * SHA256_DIGEST_LEN);
+    SHA256Final (digest, &context);
+
+    return shaDigestToStr (SHA256_TREE_CHKSUM_NAME, digest, chksumStr);
+}
+
+#ifdef TREE_CHKSUM_THREADS
+/* treeChksumChunks - hash the chunks threadNum, threadNum + numThreads,
+ * ... of the file.
+ */
+static void
+treeChksumChunks (treeChksumInp_t *myInput)
+{
+    SHA256_CTX context;
+    unsigned char *buf;
+    rodsLong_t offset, toRead;
+    int chunk, len;
+
+    buf = (unsigned char *) malloc (TREE_CHKSUM_BUF_SZ);
+    for (chunk = myInput->threadNum; chunk < myInput->chunkCnt;
+      chunk += myInput->numThreads) {
+        offset = (rodsLong_t) chunk * TREE_CHKSUM_CHUNK_SZ;
+        toRead = myInput->fileSize - offset;
+        if (toRead > TREE_CHKSUM_CHUNK_SZ) toRead = TREE_CHKSUM_CHUNK_SZ;
+        SHA256Init (&context);
+        while (toRead > 0) {
+            len = toRead > TREE_CHKSUM_BUF_SZ ? TREE_CHKSUM_BUF_SZ : toRead;
+            len = pread (myInput->fd, buf, len, offset);
+            if (len <= 0) {
+                if (len < 0 && errno == EINTR) continue;
+                myInput->status = len < 0 ?
+                  UNIX_FILE_READ_ERR - errno : SYS_COPY_LEN_ERR;
+                free (buf);
+                return;
+            }
+            SHA256Update (&context, buf, len);
+            offset += len;
+            toRead -= len;
+        }
+        SHA256Final (&myInput->digest[chunk * SHA256_DIGEST_LEN], &context);
+    }
+    free (buf);
+}
+
+/* treeChksumLocFile - sha2tree chksum a local file with numThreads
+ * threads.
+ */
+int
+treeChksumLocFile (char *fileName, char *chksumStr, int numThreads)
+{
+    treeChksumInp_t myInput[MAX_TREE_CHKSUM_THREADS];
+#ifdef USE_BOOST
+    boost::thread* tid[MAX_TREE_CHKSUM_THREADS];
+#else
+    pthread_t tid[MAX_TREE_CHKSUM_THREADS];
+    int created[MAX_TREE_CHKSUM_THREADS];
+#endif
+    struct stat statbuf;
+    unsigned char *chunkDigest;
+    int fd, chunkCnt, i;
+    int status = 0;
+
+    if ((fd = open (fileName, O_RDONLY)) < 0) {
+        status = UNIX_FILE_OPEN_ERR - errno;
+        rodsLogError (LOG_NOTICE, status,
+          "treeChksumLocFile: open failed for %s. status = %d",
+          fileName, status);
+        return (status);
+    }
+    if (fstat (fd, &statbuf) < 0) {
+        status = UNIX_FILE_STAT_ERR - errno;
+        close (fd);
+        return (status);
+    }
+
+    /* an empty file still has one (empty) chunk */
+    chunkCnt = (statbuf.st_size + TREE_CHKSUM_CHUNK_SZ - 1) /
+      TREE_CHKSUM_CHUNK_SZ;
+    if (chunkCnt <= 0) chunkCnt = 1;
+    if (numThreads > MAX_TREE_CHKSUM_THREADS)
+        numThreads = MAX_TREE_CHKSUM_THREADS;
+    if (numThreads > chunkCnt) numThreads = chunkCnt;
+    if (numThreads <= 0) numThreads = 1;
+
+    chunkDigest = (unsigned char *) malloc (chunkCnt * SHA256_DIGEST_LEN);
+    memset (myInput, 0, sizeof (myInput));
+    for (i = 0; i < numThreads; i++) {
+        myInput[i].fd = fd;
+        myInput[i].threadNum = i;
+        myInput[i].numThreads = numThreads;
+        myInput[i].chunkCnt = chunkCnt;
+        myInput[i].fileSize = statbuf.st_size;
+        myInput[i].digest = chunkDigest;
+    }
+
+    if (numThreads == 1) {
+        treeChksumChunks (&myInput[0]);
+    } else {
+        for (i = 0; i < numThreads; i++) {
+            /* if a thread cannot be made, hash its chunks here */
+#ifdef USE_BOOST
+            try {
+                tid[i] = new boost::thread (treeChksumChunks, &myInput[i]);
+            } catch (...) {
+                tid[i] = NULL;
+            }
+            if (tid[i] == NULL) {
+                treeChksumChunks (&myInput[i]);
+            }
+#else
+            created[i] = pthread_create (&tid[i], pthread_attr_default,
+             (void *(*)(void *)) treeChksumChunks, (void *) &myInput[i]) == 0;
+            if (!created[i]) {
+                treeChksumChunks (&myInput[i]);
+            }
+#endif
+        }
+        for (i = 0; i < numThreads; i++) {
+#ifdef USE_BOOST
+            if (tid[i] == NULL) continue;
+            tid[i]->join ();
+            delete tid[i];
+#else
+            if (!created[i]) continue;
+            pthread_join (tid[i], NULL);
+#endif
+        }
+    }
+    close (fd);
+
+    for (i = 0; i < numThreads; i++) {
+        if (myInput[i].status < 0) {
+            status = myInput[i].status;
+            rodsLogError (LOG_NOTICE, status,
+              "treeChksumLocFile: read of %s failed. status = %d",
+              fileName, status);
+            free (chunkDigest);
+            return (status);
+        }
+    }
+
+    status = treeDigestsToChksum (chunkDigest, chunkCnt, chksumStr);
+    free (chunkDigest);
+
+    return (status);
+}
+#else	/* TREE_CHKSUM_THREADS */
+int
+treeChksumLocFile (char *fileName, char *chksumStr, int numThreads)
+{
+    return chksumLocFileByScheme (fileName, chksumStr,
+      SHA256_TREE_CHKSUM_SCHEME);
+}
+#endif	/* TREE_CHKSUM_THREADS */
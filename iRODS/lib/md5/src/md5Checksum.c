@@ -4,7 +4,7 @@
 #include "md5Checksum.h"
 #include "rcMisc.h"
 
-#define MD5_BUF_SZ      (4 * 1024)
+#define MD5_BUF_SZ      (64 * 1024)
 
 #ifdef MD5_TESTING
 
@@ -34,13 +34,37 @@ int main (int argc, char *argv[])
 
 int
 chksumLocFile (char *fileName, char *chksumStr)
+{
+    return chksumLocFileByScheme (fileName, chksumStr, DEF_CHKSUM_SCHEME);
+}
+
+/* chksumLocFileByScheme - chksum a local file with the given scheme.
+ * A chksumScheme of DEF_CHKSUM_SCHEME means the one set by 
+ * CHKSUM_SCHEME_KW.
+ */
+int
+chksumLocFileByScheme (char *fileName, char *chksumStr, int chksumScheme)
 {
     FILE *file;
-    MD5_CTX context;
+    chksumEngine_t chksumEngine;
     int len;
-    unsigned char buffer[MD5_BUF_SZ], digest[16];
+    unsigned char *buffer;
     int status;
 
+    if (chksumScheme == DEF_CHKSUM_SCHEME)
+        chksumScheme = getDefChksumScheme ();
+
+#if !defined(windows_platform) && (defined(USE_BOOST) || defined(PARA_OPR))
+    if (chksumScheme == SHA256_TREE_CHKSUM_SCHEME) {
+        int numThreads = getTreeChksumThreads ();
+        if (numThreads > 1)
+            return treeChksumLocFile (fileName, chksumStr, numThreads);
+    }
+#endif
+
+    if ((status = initChksumEngine (&chksumEngine, chksumScheme)) < 0)
+        return status;
+
     if ((file = fopen (fileName, "rb")) == NULL) {
 	status = UNIX_FILE_OPEN_ERR - errno;
 	rodsLogError (LOG_NOTICE, status,
@@ -48,17 +72,15 @@ chksumLocFile (char *fileName, char *chksumStr)
 	return (status);
     }
 
-    MD5Init (&context);
+    buffer = (unsigned char *) malloc (MD5_BUF_SZ);
     while ((len = fread (buffer, 1, MD5_BUF_SZ, file)) > 0) {
-        MD5Update (&context, buffer, len);
+        updateChksumEngine (&chksumEngine, buffer, len);
     }
-    MD5Final (digest, &context);
+    free (buffer);
 
     fclose (file);
 
-    md5ToStr (digest, chksumStr);
-
-    return (0);
+    return finalChksumEngine (&chksumEngine, chksumStr);
 }
 
 int
@@ -86,13 +108,24 @@ md5ToStr (unsigned char *digest, char *chksumStr)
 
 int 
 rcChksumLocFile (char *fileName, char *chksumFlag, keyValPair_t *condInput)
+{
+    return rcChksumLocFileByScheme (fileName, chksumFlag, condInput,
+      DEF_CHKSUM_SCHEME);
+}
+
+/* rcChksumLocFileByScheme - rcChksumLocFile with the given chksumScheme.
+ * Used to compare with a chksum computed with a known scheme.
+ */
+int
+rcChksumLocFileByScheme (char *fileName, char *chksumFlag,
+keyValPair_t *condInput, int chksumScheme)
 {
     char chksumStr[NAME_LEN];
     int status;
 
     if (condInput == NULL || chksumFlag == NULL || fileName == NULL) {
 	rodsLog (LOG_NOTICE,
-	  "rcChksumLocFile: NULL input");
+	  "rcChksumLocFileByScheme: NULL input");
 	return (USER__NULL_INPUT_ERR);
     }
 
@@ -100,11 +133,11 @@ rcChksumLocFile (char *fileName, char *chksumFlag, keyValPair_t *condInput)
       strcmp (chksumFlag, REG_CHKSUM_KW) != 0 && 
       strcmp (chksumFlag, RSYNC_CHKSUM_KW) != 0) {
          rodsLog (LOG_NOTICE,
-          "rcChksumLocFile: bad input chksumFlag %s", chksumFlag);
+          "rcChksumLocFileByScheme: bad input chksumFlag %s", chksumFlag);
         return (USER_BAD_KEYWORD_ERR);
     }
  
-    status = chksumLocFile (fileName, chksumStr);
+    status = chksumLocFileByScheme (fileName, chksumStr, chksumScheme);
 
     if (status < 0) {
 	return (status);
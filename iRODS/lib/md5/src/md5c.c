@@ -33,6 +33,14 @@ Removed PROTO_LIST macro for C++ compatability.
 		is undefined.
 */
 
+/*
+Description:
+Faster F and G round functions. Decode with memcpy on little endian
+hosts and use the standard memcpy/memset as suggested by the notes
+below. The digest is unchanged.
+*/
+
+#include <string.h>
 #include "global.h"
 #include "md5.h"
 
@@ -93,8 +101,12 @@ static unsigned char PADDING[64] = {
 
 /* F, G, H and I are basic MD5 functions.
  */
-#define F(x, y, z) (((x) & (y)) | ((~x) & (z)))
-#define G(x, y, z) (((x) & (z)) | ((y) & (~z)))
+/* F and G are the usual "select" forms with one less operation:
+ * F(x, y, z) == (((x) & (y)) | ((~x) & (z)))
+ * G(x, y, z) == (((x) & (z)) | ((y) & (~z)))
+ */
+#define F(x, y, z) ((z) ^ ((x) & ((y) ^ (z))))
+#define G(x, y, z) ((y) ^ ((z) & ((x) ^ (y))))
 #define H(x, y, z) ((x) ^ (y) ^ (z))
 #define I(x, y, z) ((y) ^ ((x) | (~z)))
 
@@ -104,24 +116,31 @@ static unsigned char PADDING[64] = {
 
 /* FF, GG, HH, and II transformations for rounds 1, 2, 3, and 4.
 Rotation is separate from addition to prevent recomputation.
+x + ac is added first since it does not depend on the previous step.
+GG adds the two halves of G; they never have a bit in common.
  */
 #define FF(a, b, c, d, x, s, ac) { \
- (a) += F ((b), (c), (d)) + (x) + (UINT4)(ac); \
+ (a) += (x) + (UINT4)(ac); \
+ (a) += F ((b), (c), (d)); \
  (a) = ROTATE_LEFT ((a), (s)); \
  (a) += (b); \
   }
 #define GG(a, b, c, d, x, s, ac) { \
- (a) += G ((b), (c), (d)) + (x) + (UINT4)(ac); \
+ (a) += (x) + (UINT4)(ac); \
+ (a) += ((d) & (b)); \
+ (a) += ((~(d)) & (c)); \
  (a) = ROTATE_LEFT ((a), (s)); \
  (a) += (b); \
   }
 #define HH(a, b, c, d, x, s, ac) { \
- (a) += H ((b), (c), (d)) + (x) + (UINT4)(ac); \
+ (a) += (x) + (UINT4)(ac); \
+ (a) += H ((b), (c), (d)); \
  (a) = ROTATE_LEFT ((a), (s)); \
  (a) += (b); \
   }
 #define II(a, b, c, d, x, s, ac) { \
- (a) += I ((b), (c), (d)) + (x) + (UINT4)(ac); \
+ (a) += (x) + (UINT4)(ac); \
+ (a) += I ((b), (c), (d)); \
  (a) = ROTATE_LEFT ((a), (s)); \
  (a) += (b); \
   }
@@ -359,11 +378,15 @@ unsigned char *input;
 unsigned int len;
 #endif
 {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  memcpy (output, input, len);
+#else
   unsigned int i, j;
 
   for (i = 0, j = 0; j < len; i++, j += 4)
  output[i] = ((UINT4)input[j]) | (((UINT4)input[j+1]) << 8) |
    (((UINT4)input[j+2]) << 16) | (((UINT4)input[j+3]) << 24);
+#endif
 }
 
 /* Note: Replace "for loop" with standard memcpy if possible.
@@ -379,10 +402,7 @@ POINTER input;
 unsigned int len;
 #endif
 {
-  unsigned int i;
-
-  for (i = 0; i < len; i++)
-    output[i] = input[i];
+  memcpy (output, input, len);
 }
 
 /* Note: Replace "for loop" with standard memset if possible.
@@ -397,8 +417,5 @@ int value;
 unsigned int len;
 #endif
 {
-  unsigned int i;
-
-  for (i = 0; i < len; i++)
- ((char *)output)[i] = (char)value;
+  memset (output, value, len);
 }
@@ -0,0 +1,258 @@
+/* SHA256C.C - SHA-256 secure hash (FIPS 180-2)
+ */
+
+#include <string.h>
+#include "sha256.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+  !defined(windows_platform) && !defined(SHA256_NO_HW_ACCEL)
+#define SHA256_X86_ACCEL
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+typedef void (sha256Transform_t) (unsigned int state[8],
+  const unsigned char *data, unsigned int blockCnt);
+
+static void sha256TransformC (unsigned int state[8],
+  const unsigned char *data, unsigned int blockCnt);
+static sha256Transform_t *getSha256Transform ();
+
+static sha256Transform_t *Sha256Transform = NULL;
+
+static const unsigned int K256[64] = {
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+  0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+  0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+  0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+  0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+  0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+  0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+  0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+  0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static unsigned char PADDING[SHA256_BLOCK_LEN] = {
+  0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+#define ROTR(x, n) (((x) >> (n)) | ((x) << (32-(n))))
+
+#define CH(x, y, z)  ((z) ^ ((x) & ((y) ^ (z))))
+#define MAJ(x, y, z) (((x) & (y)) | ((z) & ((x) | (y))))
+#define EP0(x) (ROTR ((x), 2) ^ ROTR ((x), 13) ^ ROTR ((x), 22))
+#define EP1(x) (ROTR ((x), 6) ^ ROTR ((x), 11) ^ ROTR ((x), 25))
+#define SIG0(x) (ROTR ((x), 7) ^ ROTR ((x), 18) ^ ((x) >> 3))
+#define SIG1(x) (ROTR ((x), 17) ^ ROTR ((x), 19) ^ ((x) >> 10))
+
+/* RND - one round. Instead of moving the working variables around, the
+ * caller rotates the arguments.
+ */
+#define RND(a, b, c, d, e, f, g, h, i) { \
+ t1 = (h) + EP1 (e) + CH ((e), (f), (g)) + K256[i] + w[i]; \
+ t2 = EP0 (a) + MAJ ((a), (b), (c)); \
+ (d) += t1; \
+ (h) = t1 + t2; \
+  }
+
+void SHA256Init (SHA256_CTX *context)
+{
+  if (Sha256Transform == NULL)
+    Sha256Transform = getSha256Transform ();
+
+  context->count = 0;
+  context->state[0] = 0x6a09e667;
+  context->state[1] = 0xbb67ae85;
+  context->state[2] = 0x3c6ef372;
+  context->state[3] = 0xa54ff53a;
+  context->state[4] = 0x510e527f;
+  context->state[5] = 0x9b05688c;
+  context->state[6] = 0x1f83d9ab;
+  context->state[7] = 0x5be0cd19;
+}
+
+void SHA256Update (SHA256_CTX *context, unsigned char *input,
+unsigned int inputLen)
+{
+  unsigned int index, partLen, blockCnt;
+
+  index = (unsigned int) (context->count & (SHA256_BLOCK_LEN - 1));
+  context->count += inputLen;
+
+  if (index > 0) {
+    partLen = SHA256_BLOCK_LEN - index;
+    if (inputLen < partLen) {
+      memcpy (&context->buffer[index], input, inputLen);
+      return;
+    }
+    memcpy (&context->buffer[index], input, partLen);
+    Sha256Transform (context->state, context->buffer, 1);
+    input += partLen;
+    inputLen -= partLen;
+  }
+
+  /* whole blocks straight from the input */
+  blockCnt = inputLen / SHA256_BLOCK_LEN;
+  if (blockCnt > 0) {
+    Sha256Transform (context->state, input, blockCnt);
+    input += blockCnt * SHA256_BLOCK_LEN;
+    inputLen -= blockCnt * SHA256_BLOCK_LEN;
+  }
+
+  if (inputLen > 0)
+    memcpy (context->buffer, input, inputLen);
+}
+
+void SHA256Final (unsigned char digest[SHA256_DIGEST_LEN],
+SHA256_CTX *context)
+{
+  unsigned char bits[8];
+  unsigned long long bitCnt = context->count << 3;
+  unsigned int i, index, padLen;
+
+  for (i = 0; i < 8; i++)
+    bits[i] = (unsigned char) (bitCnt >> (56 - 8 * i));
+
+  /* Pad out to 56 mod 64 */
+  index = (unsigned int) (context->count & (SHA256_BLOCK_LEN - 1));
+  padLen = (index < 56) ? (56 - index) : (120 - index);
+  SHA256Update (context, PADDING, padLen);
+  SHA256Update (context, bits, 8);
+
+  for (i = 0; i < 8; i++) {
+    digest[4*i] = (unsigned char) (context->state[i] >> 24);
+    digest[4*i+1] = (unsigned char) (context->state[i] >> 16);
+    digest[4*i+2] = (unsigned char) (context->state[i] >> 8);
+    digest[4*i+3] = (unsigned char) context->state[i];
+  }
+
+  memset (context, 0, sizeof (*context));
+}
+
+/* SHA256HwAccel - returns 1 if the CPU SHA extensions are used */
+int SHA256HwAccel ()
+{
+  if (Sha256Transform == NULL)
+    Sha256Transform = getSha256Transform ();
+
+  return (Sha256Transform != sha256TransformC);
+}
+
+static void sha256TransformC (unsigned int state[8],
+const unsigned char *data, unsigned int blockCnt)
+{
+  unsigned int a, b, c, d, e, f, g, h, t1, t2, w[64];
+  int i;
+
+  while (blockCnt-- > 0) {
+    for (i = 0; i < 16; i++, data += 4) {
+      w[i] = ((unsigned int) data[0] << 24) | ((unsigned int) data[1] << 16) |
+        ((unsigned int) data[2] << 8) | (unsigned int) data[3];
+    }
+    for (i = 16; i < 64; i++)
+      w[i] = SIG1 (w[i-2]) + w[i-7] + SIG0 (w[i-15]) + w[i-16];
+
+    a = state[0]; b = state[1]; c = state[2]; d = state[3];
+    e = state[4]; f = state[5]; g = state[6]; h = state[7];
+
+    for (i = 0; i < 64; i += 8) {
+      RND (a, b, c, d, e, f, g, h, i);
+      RND (h, a, b, c, d, e, f, g, i+1);
+      RND (g, h, a, b, c, d, e, f, i+2);
+      RND (f, g, h, a, b, c, d, e, i+3);
+      RND (e, f, g, h, a, b, c, d, i+4);
+      RND (d, e, f, g, h, a, b, c, i+5);
+      RND (c, d, e, f, g, h, a, b, i+6);
+      RND (b, c, d, e, f, g, h, a, i+7);
+    }
+
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+  }
+}
+
+#ifdef SHA256_X86_ACCEL
+/* sha256TransformX86 - the block function using the SHA extensions.
+ * The state is kept as ABEF/CDGH as the sha256rnds2 instruction wants.
+ */
+__attribute__ ((target ("sha,sse4.1")))
+static void sha256TransformX86 (unsigned int state[8],
+const unsigned char *data, unsigned int blockCnt)
+{
+  __m128i state0, state1, abefSave, cdghSave, msg, tmp, m[4];
+  const __m128i byteSwap = _mm_set_epi64x (0x0c0d0e0f08090a0bULL,
+    0x0405060700010203ULL);
+  int i;
+
+  tmp = _mm_loadu_si128 ((const __m128i *) &state[0]);		/* DCBA */
+  state1 = _mm_loadu_si128 ((const __m128i *) &state[4]);	/* HGFE */
+  tmp = _mm_shuffle_epi32 (tmp, 0xB1);				/* CDAB */
+  state1 = _mm_shuffle_epi32 (state1, 0x1B);			/* EFGH */
+  state0 = _mm_alignr_epi8 (tmp, state1, 8);			/* ABEF */
+  state1 = _mm_blend_epi16 (state1, tmp, 0xF0);			/* CDGH */
+
+  while (blockCnt-- > 0) {
+    abefSave = state0;
+    cdghSave = state1;
+
+    for (i = 0; i < 4; i++) {
+      m[i] = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i *)
+        (data + 16 * i)), byteSwap);
+    }
+
+    /* 4 rounds per step. m[i & 3] holds w[4i .. 4i+3] */
+    for (i = 0; i < 16; i++) {
+      msg = _mm_add_epi32 (m[i & 3],
+        _mm_loadu_si128 ((const __m128i *) &K256[4 * i]));
+      state1 = _mm_sha256rnds2_epu32 (state1, state0, msg);
+      msg = _mm_shuffle_epi32 (msg, 0x0E);
+      state0 = _mm_sha256rnds2_epu32 (state0, state1, msg);
+      if (i < 12) {
+        /* the message schedule for step i + 4 */
+        tmp = _mm_sha256msg1_epu32 (m[i & 3], m[(i + 1) & 3]);
+        tmp = _mm_add_epi32 (tmp,
+          _mm_alignr_epi8 (m[(i + 3) & 3], m[(i + 2) & 3], 4));
+        m[i & 3] = _mm_sha256msg2_epu32 (tmp, m[(i + 3) & 3]);
+      }
+    }
+
+    state0 = _mm_add_epi32 (state0, abefSave);
+    state1 = _mm_add_epi32 (state1, cdghSave);
+    data += SHA256_BLOCK_LEN;
+  }
+
+  tmp = _mm_shuffle_epi32 (state0, 0x1B);			/* FEBA */
+  state1 = _mm_shuffle_epi32 (state1, 0xB1);			/* DCHG */
+  state0 = _mm_blend_epi16 (tmp, state1, 0xF0);			/* DCBA */
+  state1 = _mm_alignr_epi8 (state1, tmp, 8);			/* HGFE */
+
+  _mm_storeu_si128 ((__m128i *) &state[0], state0);
+  _mm_storeu_si128 ((__m128i *) &state[4], state1);
+}
+#endif	/* SHA256_X86_ACCEL */
+
+static sha256Transform_t *getSha256Transform ()
+{
+#ifdef SHA256_X86_ACCEL
+  unsigned int eax, ebx, ecx, edx;
+
+  /* SSSE3 and SSE4.1 in leaf 1 ecx, SHA in leaf 7 ebx */
+  if (__get_cpuid (1, &eax, &ebx, &ecx, &edx) != 0 &&
+    (ecx & (1 << 9)) != 0 && (ecx & (1 << 19)) != 0 &&
+    __get_cpuid_max (0, NULL) >= 7) {
+    __cpuid_count (7, 0, eax, ebx, ecx, edx);
+    if ((ebx & (1 << 29)) != 0)
+      return sha256TransformX86;
+  }
+#endif
+  return sha256TransformC;
+}
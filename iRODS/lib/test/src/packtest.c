@@ -3,6 +3,7 @@
 /* packtest.c - test the basic packing routines */
 
 #include "rodsClient.h" 
+#include <sys/time.h>
 struct myTest {
     char c1[17];
     char c2[18];
@@ -20,6 +21,10 @@ struct myStruct {
 
 int
 writePackedRes (bytesBuf_t *packedResult, char *outFile);
+int
+benchPack (int loopCnt);
+int
+benchMsgHeader (int loopCnt);
 
 int
 main(int argc, char **argv)
@@ -39,6 +44,14 @@ main(int argc, char **argv)
     genQueryInp_t genQueryInp, *outGenQueryInp;
     irodsProt_t irodsProt = XML_PROT;
 
+    if (argc > 1 && strcmp (argv[1], "bench") == 0) {
+        /* packtest bench [loopCnt] - time the pack routines */
+        status = benchPack (argc > 2 ? atoi (argv[2]) : 1000);
+	if (status >= 0) 
+	    status = benchMsgHeader (argc > 2 ? atoi (argv[2]) : 1000);
+        exit (status);
+    }
+
     memset (&genQueryInp, 0, sizeof (genQueryInp));
     addInxVal (&genQueryInp.sqlCondInp, COL_COLL_NAME, "=xyz");
     addInxIval (&genQueryInp.selectInp, COL_COLL_ID, 1);
@@ -187,6 +200,143 @@ main(int argc, char **argv)
     
 } 
 
+#define BENCH_ROWS	MAX_SQL_ROWS
+#define BENCH_ATTRS	10
+#define BENCH_VALUE_LEN	64
+
+/* benchPack - pack and unpack a full page genQueryOut_t and a
+ * dataObjInfo_t loopCnt times each, with both protocols, and print
+ * the time per message. */
+int
+benchPack (int loopCnt)
+{
+    genQueryOut_t myQueryOut, *outQueryOut;
+    dataObjInfo_t dataObjInfo, *outDataObjInfo;
+    bytesBuf_t *packedResult;
+    struct timeval startTime, endTime;
+    irodsProt_t irodsProt;
+    float elapsed;
+    int i, j, k, status;
+
+    if (loopCnt <= 0) loopCnt = 1000;
+
+    memset (&myQueryOut, 0, sizeof (myQueryOut));
+    myQueryOut.rowCnt = BENCH_ROWS;
+    myQueryOut.attriCnt = BENCH_ATTRS;
+    for (j = 0; j < BENCH_ATTRS; j++) {
+	myQueryOut.sqlResult[j].attriInx = 400 + j;
+	myQueryOut.sqlResult[j].len = BENCH_VALUE_LEN;
+	myQueryOut.sqlResult[j].value = 
+	  (char *) malloc (BENCH_ROWS * BENCH_VALUE_LEN);
+	for (k = 0; k < BENCH_ROWS; k++) {
+	    snprintf (&myQueryOut.sqlResult[j].value[k * BENCH_VALUE_LEN],
+	      BENCH_VALUE_LEN, "/tempZone/home/rods/bench/row%d/attr%d", k, j);
+	}
+    }
+
+    memset (&dataObjInfo, 0, sizeof (dataObjInfo));
+    strcpy (dataObjInfo.objPath, "/tempZone/home/rods/bench/file1");
+    strcpy (dataObjInfo.rescName, "demoResc");
+    strcpy (dataObjInfo.dataType, "generic");
+    strcpy (dataObjInfo.filePath, "/var/lib/irods/Vault/home/rods/file1");
+    addKeyVal (&dataObjInfo.condInput, "dataType", "generic");
+
+    for (irodsProt = NATIVE_PROT; irodsProt <= XML_PROT; 
+      irodsProt = (irodsProt_t) (irodsProt + 1)) {
+	(void) gettimeofday (&startTime, (struct timezone *) 0);
+	for (i = 0; i < loopCnt; i++) {
+	    status = packStruct (&myQueryOut, &packedResult, "GenQueryOut_PI",
+	      NULL, 0, irodsProt);
+	    if (status < 0) return status;
+	    status = unpackStruct (packedResult->buf, (void **) &outQueryOut,
+	      "GenQueryOut_PI", NULL, irodsProt);
+	    if (status < 0) return status;
+	    freeBBuf (packedResult);
+	    freeGenQueryOut (&outQueryOut);
+	}
+	(void) gettimeofday (&endTime, (struct timezone *) 0);
+	elapsed = (endTime.tv_sec - startTime.tv_sec) +
+	  (endTime.tv_usec - startTime.tv_usec) / 1000000.0;
+	printf ("%s GenQueryOut_PI %d rows x %d attrs: %.1f usec/msg\n",
+	  irodsProt == NATIVE_PROT ? "native" : "xml", BENCH_ROWS, 
+	  BENCH_ATTRS, elapsed * 1000000.0 / loopCnt);
+
+	(void) gettimeofday (&startTime, (struct timezone *) 0);
+	for (i = 0; i < loopCnt; i++) {
+	    status = packStruct (&dataObjInfo, &packedResult, "DataObjInfo_PI",
+	      NULL, 0, irodsProt);
+	    if (status < 0) return status;
+	    status = unpackStruct (packedResult->buf, (void **) &outDataObjInfo,
+	      "DataObjInfo_PI", NULL, irodsProt);
+	    if (status < 0) return status;
+	    freeBBuf (packedResult);
+	    clearKeyVal (&outDataObjInfo->condInput);
+	    free (outDataObjInfo);
+	}
+	(void) gettimeofday (&endTime, (struct timezone *) 0);
+	elapsed = (endTime.tv_sec - startTime.tv_sec) +
+	  (endTime.tv_usec - startTime.tv_usec) / 1000000.0;
+	printf ("%s DataObjInfo_PI: %.1f usec/msg\n",
+	  irodsProt == NATIVE_PROT ? "native" : "xml", 
+	  elapsed * 1000000.0 / loopCnt);
+    }
+    for (j = 0; j < BENCH_ATTRS; j++) {
+	free (myQueryOut.sqlResult[j].value);
+    }
+    clearKeyVal (&dataObjInfo.condInput);
+    return 0;
+}
+
+/* benchMsgHeader - time a round trip of a small API request and its
+ * reply over a socketpair with the XML and the binary msg header */
+int
+benchMsgHeader (int loopCnt)
+{
+    int sv[2];
+    msgHeader_t myHeader, outHeader;
+    struct timeval startTime, endTime;
+    float elapsed;
+    int i, binHdr, status;
+
+    if (loopCnt <= 0) loopCnt = 1000;
+    if (socketpair (AF_UNIX, SOCK_STREAM, 0, sv) < 0) {
+	return (SYS_SOCK_OPEN_ERR - errno);
+    }
+
+    memset (&myHeader, 0, sizeof (myHeader));
+    for (binHdr = 0; binHdr <= 1; binHdr++) {
+	setSockBinMsgHeader (sv[0], binHdr);
+	setSockBinMsgHeader (sv[1], binHdr);
+	(void) gettimeofday (&startTime, (struct timezone *) 0);
+	for (i = 0; i < loopCnt; i++) {
+	    rstrcpy (myHeader.type, RODS_API_REQ_T, HEADER_TYPE_LEN);
+	    myHeader.intInfo = i;
+	    if ((status = writeMsgHeader (sv[0], &myHeader)) < 0 ||
+	      (status = readMsgHeader (sv[1], &outHeader, NULL)) < 0) {
+		return status;
+	    }
+	    rstrcpy (myHeader.type, RODS_API_REPLY_T, HEADER_TYPE_LEN);
+	    if ((status = writeMsgHeader (sv[1], &myHeader)) < 0 ||
+	      (status = readMsgHeader (sv[0], &outHeader, NULL)) < 0) {
+		return status;
+	    }
+	    if (outHeader.intInfo != i || 
+	      strcmp (outHeader.type, RODS_API_REPLY_T) != 0) {
+		printf ("benchMsgHeader: header mismatch at %d\n", i);
+		return (SYS_HEADER_TPYE_LEN_ERR);
+	    }
+	}
+	(void) gettimeofday (&endTime, (struct timezone *) 0);
+	elapsed = (endTime.tv_sec - startTime.tv_sec) +
+	  (endTime.tv_usec - startTime.tv_usec) / 1000000.0;
+	printf ("%s MsgHeader round trip: %.1f usec\n",
+	  binHdr ? "binary" : "xml", elapsed * 1000000.0 / loopCnt);
+    }
+    close (sv[0]);
+    close (sv[1]);
+    return 0;
+}
+
 int
 writePackedRes (bytesBuf_t *packedResult, char *outFile)
 {
@@ -205,6 +205,71 @@ $postgresBinDir  = File::Spec->catdir( $POSTGRES_HOME, "bin" );
 # broken due to timeout or other reason. The default is on. 
 # $irodsReconnect=1;
 
+# agentPoolSize - Number of pre-started agents the irodsServer keeps ready.
+# A pooled agent reads the config files, connects to the ICAT and loads the
+# rules once, and is then handed client connections by the irodsServer.
+# The pool is off by default (an agent is forked for every connection).
+# $agentPoolSize=8;
+
+# agentPoolMaxSess - Number of client sessions a pooled agent serves before
+# it exits and is replaced by a fresh one. The default is 100.
+# $agentPoolMaxSess=100;
+
+# svrCfgSnapMaxAge - The irodsServer saves the zone and resource
+# configuration queried from the ICAT in shared memory and the agents use
+# it instead of querying the ICAT on each connection. The snapshot is
+# requeried when it is older than svrCfgSnapMaxAge seconds or when a zone
+# or resource is changed through this server. The default is 120. Setting
+# it to 0 turns the snapshot off.
+# $svrCfgSnapMaxAge=120;
+
+# portalChunkSize - Chunk size in MB of a parallel transfer. The transfer
+# threads take the next chunk of the file when they are done with one, so
+# a slow stream does not hold up the others. Setting it to 0 splits the
+# file into one fixed range per thread (the old behavior). The default is 8.
+# $portalChunkSize=8;
+
+# portalPipeBufCnt - Number of rotating buffers of each parallel transfer
+# stream. With 2 or more, a helper thread writes out one buffer while the
+# stream reads the next one, so the disk and the network work at the same
+# time. Setting it to 0 turns this off. The default is 2. Clients read the
+# same variable from their environment.
+# $portalPipeBufCnt=2;
+
+# replChainMinSize - Min size in MB of an object replicated to several
+# resources at once (irepl -a) through a replication chain. The source is
+# read once and each new copy forwards the data to the next one while it
+# writes it. Copies which fail in the chain are made one at a time as
+# before. Setting it to 0 turns the chain off. The default is 32.
+# $replChainMinSize=32;
+
+# tranThrExplore - With msiSetNumThreads("adaptive",...) in acSetNumThreads,
+# the number of threads of a parallel transfer is the one with the best
+# throughput measured so far for the resource and the client subnet. Every
+# tranThrExplore'th transfer tries a number next to it instead, so that
+# changes of the network or the disks are picked up. The default is 8.
+# Setting it to 0 turns the trials off.
+# $tranThrExplore=8;
+
+# portalStat - Log the statistics of each stream of a parallel transfer:
+# the bytes moved, the time blocked on the socket and on the vault file,
+# the stalls (waits of 0.1 sec or more) and the TCP_INFO round trip time,
+# congestion window and retransmits of the socket. One "portalStat:" line
+# of key=value pairs is logged per stream. The iput and iget --stats option
+# prints both sides, whether this is set or not. Off by default.
+# $portalStat=1;
+
+# irodsChksumScheme - Scheme of the checksums computed by the server: md5,
+# sha2 (SHA-256) or sha2tree (SHA-256 of the SHA-256 of each 64 MB chunk,
+# which is hashed with several threads). Existing checksums are always
+# verified with their own scheme. The default is md5. Clients read the
+# same variable from their environment.
+# $irodsChksumScheme="md5";
+
+# irodsTreeChksumThreads - Number of threads hashing a vault file with the
+# sha2tree scheme. The default is 4.
+# $irodsTreeChksumThreads=4;
+
 # RETESTFLAG - option for logging micro-service calls
 # use 1 to make it log.  Note that, at least for some micro-services,
 # this will cause the micro-service to log the call but not actually
@@ -260,6 +325,16 @@ if ($svrPortRangeStart)		{ $ENV{'svrPortRangeStart'}   = $svrPortRangeStart; }
 if ($svrPortRangeEnd)		{ $ENV{'svrPortRangeEnd'}     = $svrPortRangeEnd; }
 if ($reServerOption)		{ $ENV{'reServerOption'}      = $reServerOption; }
 if ($irodsReconnect)		{ $ENV{'irodsReconnect'}    = $irodsReconnect; }
+if ($agentPoolSize)		{ $ENV{'agentPoolSize'}       = $agentPoolSize; }
+if ($agentPoolMaxSess)		{ $ENV{'agentPoolMaxSess'}    = $agentPoolMaxSess; }
+if (defined($svrCfgSnapMaxAge))	{ $ENV{'svrCfgSnapMaxAge'}    = $svrCfgSnapMaxAge; }
+if (defined($portalChunkSize))	{ $ENV{'portalChunkSize'}     = $portalChunkSize; }
+if (defined($portalPipeBufCnt))	{ $ENV{'portalPipeBufCnt'}    = $portalPipeBufCnt; }
+if (defined($replChainMinSize))	{ $ENV{'replChainMinSize'}    = $replChainMinSize; }
+if (defined($tranThrExplore))	{ $ENV{'tranThrExplore'}      = $tranThrExplore; }
+if ($portalStat)		{ $ENV{'portalStat'}          = $portalStat; }
+if ($irodsChksumScheme)		{ $ENV{'irodsChksumScheme'}   = $irodsChksumScheme; }
+if ($irodsTreeChksumThreads)	{ $ENV{'irodsTreeChksumThreads'} = $irodsTreeChksumThreads; }
 if ($RETESTFLAG)		{ $ENV{'RETESTFLAG'}          = $RETESTFLAG; }
 if ($GLOBALALLRULEEXECFLAG)    { $ENV{'GLOBALALLRULEEXECFLAG'} = $GLOBALALLRULEEXECFLAG; }
 if ($PREPOSTPROCFORGENQUERYFLAG)    { $ENV{'PREPOSTPROCFORGENQUERYFLAG'} = $PREPOSTPROCFORGENQUERYFLAG; }
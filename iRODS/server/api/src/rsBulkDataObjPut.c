@@ -505,7 +505,8 @@ renamedPhyFiles_t *renamedPhyFiles, genQueryOut_t *attriArray)
             if ((flags & VERIFY_CHKSUM_FLAG) != 0 && myChksum != NULL) {
                 char chksumStr[NAME_LEN];
                 /* verify the chksum */
-                status = chksumLocFile (dataObjInfo.filePath, chksumStr);
+                status = chksumLocFileByScheme (dataObjInfo.filePath,
+                  chksumStr, getChksumScheme (myChksum));
                 if (status < 0) {
                     rodsLog (LOG_ERROR,
                      "bulkProcAndRegSubfile: chksumLocFile error for %s ",
@@ -51,7 +51,9 @@ _rsBulkDataObjReg (rsComm_t *rsComm, genQueryOut_t *bulkDataObjRegInp,
 genQueryOut_t **bulkDataObjRegOut)
 {
 #ifdef RODS_CAT
-    dataObjInfo_t dataObjInfo;
+    dataObjInfo_t dataObjInfo, *regDataObjInfo, *tmpDataObjInfo;
+    int *regRowInx;
+    int regCnt;
     sqlResult_t *objPath, *dataType, *dataSize, *rescName, *filePath,
       *dataMode, *oprType, *rescGroupName, *replNum, *chksum;
     char *tmpObjPath, *tmpDataType, *tmpDataSize, *tmpRescName, *tmpFilePath,
@@ -134,6 +136,14 @@ genQueryOut_t **bulkDataObjRegOut)
     }
 
     (*bulkDataObjRegOut)->rowCnt = bulkDataObjRegInp->rowCnt;
+
+    /* the new objects are registered together with chlRegDataObjBulk
+     * after the loop */
+    regDataObjInfo = (dataObjInfo_t *) calloc (bulkDataObjRegInp->rowCnt,
+      sizeof (dataObjInfo_t));
+    regRowInx = (int *) calloc (bulkDataObjRegInp->rowCnt, sizeof (int));
+    regCnt = 0;
+    status = 0;
     for (i = 0;i < bulkDataObjRegInp->rowCnt; i++) {
         tmpObjPath = &objPath->value[objPath->len * i];
         tmpDataType = &dataType->value[dataType->len * i];
@@ -146,41 +156,67 @@ genQueryOut_t **bulkDataObjRegOut)
 	tmpReplNum =  &replNum->value[replNum->len * i];
         tmpObjId = &objId->value[objId->len * i];
 
-        bzero (&dataObjInfo, sizeof (dataObjInfo_t));
-	dataObjInfo.flags = NO_COMMIT_FLAG;
-        rstrcpy (dataObjInfo.objPath, tmpObjPath, MAX_NAME_LEN);
-        rstrcpy (dataObjInfo.dataType, tmpDataType, NAME_LEN);
-	dataObjInfo.dataSize = strtoll (tmpDataSize, 0, 0);
-        rstrcpy (dataObjInfo.rescName, tmpRescName, NAME_LEN);
-        rstrcpy (dataObjInfo.filePath, tmpFilePath, MAX_NAME_LEN);
-        rstrcpy (dataObjInfo.dataMode, tmpDataMode, NAME_LEN);
-        rstrcpy (dataObjInfo.rescGroupName, tmpRescGroupName, NAME_LEN);
-	dataObjInfo.replNum = atoi (tmpReplNum);
+	if (strcmp (tmpOprType, REGISTER_OPR) == 0) {
+	    tmpDataObjInfo = &regDataObjInfo[regCnt];
+	    regRowInx[regCnt] = i;
+	    regCnt++;
+	} else {
+	    tmpDataObjInfo = &dataObjInfo;
+            bzero (&dataObjInfo, sizeof (dataObjInfo_t));
+	}
+	tmpDataObjInfo->flags = NO_COMMIT_FLAG;
+        rstrcpy (tmpDataObjInfo->objPath, tmpObjPath, MAX_NAME_LEN);
+        rstrcpy (tmpDataObjInfo->dataType, tmpDataType, NAME_LEN);
+	tmpDataObjInfo->dataSize = strtoll (tmpDataSize, 0, 0);
+        rstrcpy (tmpDataObjInfo->rescName, tmpRescName, NAME_LEN);
+        rstrcpy (tmpDataObjInfo->filePath, tmpFilePath, MAX_NAME_LEN);
+        rstrcpy (tmpDataObjInfo->dataMode, tmpDataMode, NAME_LEN);
+        rstrcpy (tmpDataObjInfo->rescGroupName, tmpRescGroupName, NAME_LEN);
+	tmpDataObjInfo->replNum = atoi (tmpReplNum);
         if (chksum != NULL) {
 	    tmpChksum = &chksum->value[chksum->len * i];
 	    if (strlen (tmpChksum) > 0) {
-	        rstrcpy (dataObjInfo.chksum, tmpChksum, NAME_LEN);
+	        rstrcpy (tmpDataObjInfo->chksum, tmpChksum, NAME_LEN);
 	    }
 	}
  
-	dataObjInfo.replStatus = NEWLY_CREATED_COPY;
-	if (strcmp (tmpOprType, REGISTER_OPR) == 0) {
-	    status = svrRegDataObj (rsComm, &dataObjInfo);
-	} else {
+	tmpDataObjInfo->replStatus = NEWLY_CREATED_COPY;
+	if (tmpDataObjInfo == &dataObjInfo) {
 	    status = modDataObjSizeMeta (rsComm, &dataObjInfo, tmpDataSize);
+	    if (status >= 0) {
+	        snprintf (tmpObjId, NAME_LEN, "%lld", dataObjInfo.dataId);
+	    } else {
+	        rodsLog (LOG_ERROR,
+	          "rsBulkDataObjReg: ModDataObj failed for %s,stat=%d",
+                  tmpObjPath, status);
+	        break;
+	    }
         }
+    }
+
+    if (status >= 0 && regCnt > 0) {
+	status = chlRegDataObjBulk (rsComm, regDataObjInfo, regCnt);
 	if (status >= 0) {
-	    snprintf (tmpObjId, NAME_LEN, "%lld", dataObjInfo.dataId);
+	    for (i = 0; i < regCnt; i++) {
+		tmpObjId = &objId->value[objId->len * regRowInx[i]];
+		snprintf (tmpObjId, NAME_LEN, "%lld",
+		  regDataObjInfo[i].dataId);
+	    }
 	} else {
 	    rodsLog (LOG_ERROR,
-	     "rsBulkDataObjReg: RegDataObj or ModDataObj failed for %s,stat=%d",
-              tmpObjPath, status);
-	    chlRollback (rsComm);
-            freeGenQueryOut (bulkDataObjRegOut);
-            *bulkDataObjRegOut = NULL;
-            return status;
+	      "rsBulkDataObjReg: chlRegDataObjBulk failed for %d objs, stat=%d",
+              regCnt, status);
 	}
     }
+    free (regDataObjInfo);
+    free (regRowInx);
+    if (status < 0) {
+	chlRollback (rsComm);
+        freeGenQueryOut (bulkDataObjRegOut);
+        *bulkDataObjRegOut = NULL;
+        return status;
+    }
+
     status = chlCommit(rsComm);
 
     if (status < 0) {
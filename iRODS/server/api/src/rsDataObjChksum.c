@@ -219,7 +219,8 @@ char **outChksumStr)
         return (status);
     }
 
-    if (strcmp (*outChksumStr, dataObjInfo->chksum) != 0) {
+    if (chksumMismatch (dataObjInfo->objPath, dataObjInfo->chksum,
+      *outChksumStr)) {
         rodsLog (LOG_ERROR,
           "verifyDatObjChksum: computed chksum %s != icat value %s for %s",
           *outChksumStr, dataObjInfo->chksum, dataObjInfo->objPath);
@@ -28,6 +28,8 @@
 #include "dataObjTrim.h"
 #include "dataObjLock.h"
 #include "getRescQuota.h"
+#include "streamChksum.h"
+#include "rcPortalOpr.h"
 
 #ifdef LOG_TRANSFERS
 #include <sys/time.h>
@@ -335,6 +337,20 @@ _rsDataObjClose (rsComm_t *rsComm, openedDataObjInp_t *dataObjCloseInp)
                   L1desc[l1descInx].dataObjInfo->objPath);
 	    }
 	}
+	if (isGetChksumAtClose (l1descInx)) {
+	    /* send the client the chksum of the data it got. A portal 
+	     * transfer computed it on the way out */
+	    status = dataObjChksumAndReg (rsComm, 
+	      L1desc[l1descInx].dataObjInfo, &chksumStr);
+	    if (chksumStr != NULL) {
+		char msgStr[ERR_MSG_LEN];
+
+		snprintf (msgStr, ERR_MSG_LEN, "%s%s", PORTAL_CHKSUM_MSG,
+		  chksumStr);
+		addRErrorMsg (&rsComm->rError, 0, msgStr);
+		free (chksumStr);
+	    }
+	}
 #ifdef LOG_TRANSFERS
        if (L1desc[l1descInx].oprType == GET_OPR) {
 	  logTransfer("get", L1desc[l1descInx].dataObjInfo->objPath,
@@ -781,6 +797,23 @@ l3Stat (rsComm_t *rsComm, dataObjInfo_t *dataObjInfo, rodsStat_t **myStat)
     return (status);
 }
 
+/* chksumForClose - the chksum of the data written through l1descInx.
+ * Use the one computed while the data was put if there is one.
+ */
+static int
+chksumForClose (rsComm_t *rsComm, int l1descInx, char **chksumStr)
+{
+    int chksumScheme = getL1descChksumScheme (l1descInx);
+
+    if (strlen (L1desc[l1descInx].streamChksum) > 0 &&
+      getChksumScheme (L1desc[l1descInx].streamChksum) == chksumScheme) {
+        *chksumStr = strdup (L1desc[l1descInx].streamChksum);
+        return 0;
+    }
+    return _dataObjChksumByScheme (rsComm, L1desc[l1descInx].dataObjInfo, 
+      chksumStr, chksumScheme);
+}
+
 /* procChksumForClose - handle checksum issues on close. Returns a non-null
  * chksumStr if it needs to be registered.
  */
@@ -807,7 +840,7 @@ procChksumForClose (rsComm_t *rsComm, int l1descInx, char **chksumStr)
           srcDataObjInfo->replStatus > 0) {
             /* the source has chksum. Must verify chksum */
 
-            status = _dataObjChksum (rsComm, dataObjInfo, chksumStr);
+            status = chksumForClose (rsComm, l1descInx, chksumStr);
             if (status < 0) {
                 rodsLog (LOG_NOTICE,
                  "procChksumForClose: _dataObjChksum error for %s, status = %d",
@@ -815,7 +848,8 @@ procChksumForClose (rsComm_t *rsComm, int l1descInx, char **chksumStr)
 		return status;
             } else {
 		rstrcpy (dataObjInfo->chksum, *chksumStr, NAME_LEN);
-                if (strcmp (srcDataObjInfo->chksum, *chksumStr) != 0) {
+                if (chksumMismatch (dataObjInfo->objPath, srcDataObjInfo->chksum,
+                  *chksumStr)) {
                     free (*chksumStr);
 		    *chksumStr = NULL;
                     rodsLog (LOG_NOTICE,
@@ -836,13 +870,14 @@ procChksumForClose (rsComm_t *rsComm, int l1descInx, char **chksumStr)
     if (L1desc[l1descInx].chksumFlag == 0) {
 	return 0;
     } else if (L1desc[l1descInx].chksumFlag == VERIFY_CHKSUM) {
-        status = _dataObjChksum (rsComm, dataObjInfo, chksumStr);
+        status = chksumForClose (rsComm, l1descInx, chksumStr);
         if (status < 0)  return (status);
 
         if (strlen (L1desc[l1descInx].chksum) > 0) {
             /* from a put type operation */
             /* verify against the input value. */
-            if (strcmp (L1desc[l1descInx].chksum, *chksumStr) != 0) {
+            if (chksumMismatch (dataObjInfo->objPath, L1desc[l1descInx].chksum,
+              *chksumStr)) {
                 rodsLog (LOG_NOTICE,
                  "procChksumForClose: mismach chksum for %s.inp=%s,compute %s",
                   dataObjInfo->objPath,
@@ -859,7 +894,8 @@ procChksumForClose (rsComm_t *rsComm, int l1descInx, char **chksumStr)
        } else if (oprType == REPLICATE_DEST) {
             if (strlen (dataObjInfo->chksum) > 0) {
                 /* for replication, the chksum in dataObjInfo was duplicated */
-                if (strcmp (dataObjInfo->chksum, *chksumStr) != 0) {
+                if (chksumMismatch (dataObjInfo->objPath, dataObjInfo->chksum,
+                  *chksumStr)) {
                     rodsLog (LOG_NOTICE,
                      "procChksumForClose:mismach chksum for %s.Rcat=%s,comp %s",
                      dataObjInfo->objPath, dataObjInfo->chksum, *chksumStr);
@@ -886,7 +922,8 @@ procChksumForClose (rsComm_t *rsComm, int l1descInx, char **chksumStr)
             srcDataObjInfo = L1desc[srcL1descInx].dataObjInfo;
 
             if (strlen (srcDataObjInfo->chksum) > 0) {
-                if (strcmp (srcDataObjInfo->chksum, *chksumStr) != 0) {
+                if (chksumMismatch (dataObjInfo->objPath, srcDataObjInfo->chksum,
+                  *chksumStr)) {
                     rodsLog (LOG_NOTICE,
                      "procChksumForClose:mismach chksum for %s.Rcat=%s,comp %s",
                      dataObjInfo->objPath, srcDataObjInfo->chksum, *chksumStr);
@@ -902,7 +939,7 @@ procChksumForClose (rsComm_t *rsComm, int l1descInx, char **chksumStr)
             return 0;
 	}
     } else {	/* REG_CHKSUM */
-        status = _dataObjChksum (rsComm, dataObjInfo, chksumStr);
+        status = chksumForClose (rsComm, l1descInx, chksumStr);
         if (status < 0)  return (status);
 
         if (strlen (L1desc[l1descInx].chksum) > 0) {
@@ -16,6 +16,7 @@
 #include "specColl.h"
 #include "subStructFileGet.h"
 #include "getRemoteZoneResc.h"
+#include "streamChksum.h"
 
 int
 rsDataObjGet (rsComm_t *rsComm, dataObjInp_t *dataObjInp, 
@@ -100,6 +101,10 @@ portalOprOut_t **portalOprOut, bytesBuf_t *dataObjOutBBuf, int handlerFlag)
         if (strlen (dataObjInfo->chksum) > 0) {
             /* a chksum already exists */
 	    chksumStr = strdup (dataObjInfo->chksum);
+        } else if (L1desc[l1descInx].l3descInx <= 2) {
+	    /* l3DataGetSingleBuf will chksum the data it reads */
+        } else if (isGetChksumAtClose (l1descInx)) {
+	    /* chksummed on the way out and sent back by rsDataObjClose */
         } else {
 
             status = dataObjChksumAndReg (rsComm, dataObjInfo, &chksumStr);
@@ -230,6 +235,22 @@ bytesBuf_t *dataObjOutBBuf, portalOprOut_t **portalOprOut)
 	bytesRead = 0;
     }
 
+    if (bytesRead >= 0 && strlen (dataObjInfo->chksum) == 0 &&
+      getValByKey (&L1desc[l1descInx].dataObjInp->condInput, 
+      VERIFY_CHKSUM_KW) != NULL) {
+	char *chksumStr = NULL;
+
+	if (bytesRead == dataObjInfo->dataSize) {
+	    /* the whole file is in the buffer. No need to read it again */
+	    chksumDataBuf ((char *) dataObjOutBBuf->buf, bytesRead,
+	      DEF_CHKSUM_SCHEME, (*portalOprOut)->chksum);
+	    regDataObjChksum (rsComm, dataObjInfo, (*portalOprOut)->chksum);
+	} else if (dataObjChksumAndReg (rsComm, dataObjInfo, &chksumStr) >= 0) {
+	    rstrcpy ((*portalOprOut)->chksum, chksumStr, NAME_LEN);
+	    free (chksumStr);
+	}
+    }
+
 #if 0   /* tested in _rsFileGet. don't need to go it again */
     if (bytesRead != dataObjInfo->dataSize) {
 	free (dataObjOutBBuf->buf);
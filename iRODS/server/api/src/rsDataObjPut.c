@@ -20,6 +20,7 @@
 #include "subStructFilePut.h"
 #include "dataObjRepl.h"
 #include "getRemoteZoneResc.h"
+#include "streamChksum.h"
 
 
 int
@@ -379,6 +380,12 @@ bytesBuf_t *dataObjInpBBuf)
                 myDataObjInfo->replNum = status;
 	    }
         }
+        if (bytesWritten == dataObjInpBBuf->len && 
+	  isStreamChksumNeeded (l1descInx)) {
+	    /* the whole file is in the buffer. No need to read it back */
+	    chksumDataBuf ((char *) dataObjInpBBuf->buf, bytesWritten,
+	      getL1descChksumScheme (l1descInx), L1desc[l1descInx].streamChksum);
+	}
         /* myDataObjInfo->dataSize = bytesWritten; update size problem */
 	if (bytesWritten == 0 && myDataObjInfo->dataSize > 0) {
 	    /* overwrite with 0 len file */
@@ -25,6 +25,8 @@
 #include "unbunAndRegPhyBunfile.h"
 #include "dataObjTrim.h"
 #include "dataObjLock.h"
+#include "dataObjUnlink.h"
+#include "miscServerFunct.h"
 
 int
 rsDataObjRepl250 (rsComm_t *rsComm, dataObjInp_t *dataObjInp,
@@ -424,6 +426,9 @@ dataObjInfo_t *outDataObjInfo)
     int savedStatus = 0;
     rescInfo_t *compRescInfo = NULL;
     rescInfo_t *cacheRescInfo = NULL;
+    rescInfo_t *chainRescInfo[MAX_REPL_CHAIN_LEN];
+    int chainCnt = 0;
+    int i;
 
     if (getValByKey (&dataObjInp->condInput, ALL_KW) != NULL) {
         allFlag = 1;
@@ -440,6 +445,12 @@ dataObjInfo_t *outDataObjInfo)
           compRescInfo, &cacheRescInfo);
     }
     transStat->bytesWritten = srcDataObjInfoHead->dataSize;
+    if (allFlag == 1 && outDataObjInfo == NULL) {
+	/* read the src once for all the new copies it can do */
+	chainCnt = _rsDataObjReplChain (rsComm, dataObjInp, 
+	  srcDataObjInfoHead, destRescGrpInfo, cacheRescInfo, transStat,
+	  chainRescInfo);
+    }
     tmpRescGrpInfo = destRescGrpInfo;
     while (tmpRescGrpInfo != NULL) {
         tmpRescInfo = tmpRescGrpInfo->rescInfo;
@@ -449,6 +460,14 @@ dataObjInfo_t *outDataObjInfo)
 	    tmpRescGrpInfo = tmpRescGrpInfo->next;
 	    continue;
 	}
+	for (i = 0; i < chainCnt; i++) {
+	    if (chainRescInfo[i] == tmpRescInfo) break;
+	}
+	if (i < chainCnt) {
+	    /* done by the replication chain */
+	    tmpRescGrpInfo = tmpRescGrpInfo->next;
+	    continue;
+	}
         if (getRescClass (tmpRescInfo) == COMPOUND_CL) {
             /* need to get a copy in cache first */
             if ((status = getCacheDataInfoOfCompResc (rsComm, dataObjInp,
@@ -492,6 +511,200 @@ dataObjInfo_t *outDataObjInfo)
     }
 }
 
+/* _rsDataObjReplChain - make the new copies of an ALL_KW replication in
+ * destRescGrpInfo through a replication chain. The src is read once and
+ * streamed to the head of the chain which writes it and forwards it to
+ * the next copy and so on, one stream per hop. Each host can be in the
+ * chain only once since its agent is busy with the transfer, and only
+ * the head can be on this host since the others are served by their own
+ * agent. The portals are set up from the tail so each one is waiting
+ * before its upstream connects. A copy that is not complete is removed
+ * and left to the one at a time replication of the caller.
+ * Returns the number of copies made. Their rescInfo are in doneRescInfo.
+ */
+int
+_rsDataObjReplChain (rsComm_t *rsComm, dataObjInp_t *dataObjInp,
+dataObjInfo_t *srcDataObjInfo, rescGrpInfo_t *destRescGrpInfo,
+rescInfo_t *skipRescInfo, transferStat_t *transStat, 
+rescInfo_t **doneRescInfo)
+{
+    rescGrpInfo_t *tmpRescGrpInfo;
+    rescInfo_t *tmpRescInfo;
+    rodsServerHost_t *srcHost, *tmpHost;
+    rodsServerHost_t *chainHost[MAX_REPL_CHAIN_LEN];
+    rescGrpInfo_t *chainRescGrp[MAX_REPL_CHAIN_LEN];
+    int l1descInx[MAX_REPL_CHAIN_LEN];
+    int chainStatus[MAX_REPL_CHAIN_LEN];
+    int chainLen = 0;
+    int doneCnt = 0;
+    int headInx = -1;
+    int i, status;
+    rodsLong_t minSize;
+    dataObjInp_t myDataObjInp;
+    portalOprOut_t *portalOprOut;
+    openedDataObjInp_t dataObjCloseInp;
+    dataObjInfo_t *myDestDataObjInfo;
+    char chainPortal[MAX_NAME_LEN];
+
+    minSize = getReplChainMinSize ();
+    if (minSize <= 0 || srcDataObjInfo->dataSize < minSize ||
+      srcDataObjInfo->dataSize <= MAX_SZ_FOR_SINGLE_BUF ||
+      dataObjInp->numThreads == NO_THREADING ||
+      getValByKey (&dataObjInp->condInput, RBUDP_TRANSFER_KW) != NULL) {
+	return 0;
+    }
+    if (getRescClass (srcDataObjInfo->rescInfo) == COMPOUND_CL ||
+      getRescClass (srcDataObjInfo->rescInfo) == BUNDLE_CL ||
+      srcDataObjInfo->rescInfo->rescStatus == INT_RESC_STATUS_DOWN ||
+      resolveHostByRescInfo (srcDataObjInfo->rescInfo, &srcHost) < 0) {
+	return 0;
+    }
+
+    /* pick the copies of the chain */
+    tmpRescGrpInfo = destRescGrpInfo;
+    while (tmpRescGrpInfo != NULL && chainLen < MAX_REPL_CHAIN_LEN) {
+	tmpRescInfo = tmpRescGrpInfo->rescInfo;
+	if (tmpRescInfo == skipRescInfo || 
+	  getRescClass (tmpRescInfo) == COMPOUND_CL ||
+	  tmpRescInfo->rescStatus == INT_RESC_STATUS_DOWN ||
+	  resolveHostByRescInfo (tmpRescInfo, &tmpHost) < 0 ||
+	  tmpHost == srcHost) {
+	    tmpRescGrpInfo = tmpRescGrpInfo->next;
+	    continue;
+	}
+	for (i = 0; i < chainLen; i++) {
+	    if (chainHost[i] == tmpHost) break;
+	}
+	if (i < chainLen) {
+	    tmpRescGrpInfo = tmpRescGrpInfo->next;
+	    continue;
+	}
+	if (tmpHost->localFlag == LOCAL_HOST) {
+	    /* has to be the head */
+	    for (i = chainLen; i > 0; i--) {
+		chainHost[i] = chainHost[i - 1];
+		chainRescGrp[i] = chainRescGrp[i - 1];
+	    }
+	    i = 0;
+	} else {
+	    i = chainLen;
+	}
+	chainHost[i] = tmpHost;
+	chainRescGrp[i] = tmpRescGrpInfo;
+	chainLen++;
+	tmpRescGrpInfo = tmpRescGrpInfo->next;
+    }
+    if (chainLen < 2) return 0;
+
+    /* one stream per hop */
+    myDataObjInp = *dataObjInp;
+    memset (&myDataObjInp.condInput, 0, sizeof (keyValPair_t));
+    replKeyVal (&dataObjInp->condInput, &myDataObjInp.condInput);
+    addKeyVal (&myDataObjInp.condInput, NO_PARA_OP_KW, "");
+
+    for (i = 0; i < chainLen; i++) {
+	l1descInx[i] = dataObjOpenForRepl (rsComm, &myDataObjInp, 
+	  srcDataObjInfo, chainRescGrp[i]->rescInfo, 
+	  chainRescGrp[i]->rescGroupName, NULL, 0);
+	if (l1descInx[i] < 0) {
+	    chainStatus[i] = l1descInx[i];
+	} else if (L1desc[l1descInx[i]].dataObjInp->numThreads != 1 ||
+	  L1desc[l1descInx[i]].stageFlag != NO_STAGING) {
+	    chainStatus[i] = SYS_INVALID_PORTAL_OPR;
+	} else {
+	    chainStatus[i] = 0;
+	    if (headInx < 0) headInx = i;
+	}
+    }
+    clearKeyVal (&myDataObjInp.condInput);
+
+    /* set up the portals from the tail. A copy that fails here is just
+     * left out of the chain */
+    chainPortal[0] = '\0';
+    for (i = chainLen - 1; i > headInx && headInx >= 0; i--) {
+	if (chainStatus[i] < 0) continue;
+	if (chainPortal[0] != '\0') {
+	    addKeyVal (&L1desc[l1descInx[i]].dataObjInp->condInput,
+	      CHAIN_PORTAL_KW, chainPortal);
+	}
+	portalOprOut = NULL;
+	status = preProcParaPut (rsComm, l1descInx[i], &portalOprOut);
+	if (status < 0 || portalOprOut == NULL || 
+	  portalOprOut->numThreads != 1) {
+	    rodsLog (LOG_NOTICE,
+	      "_rsDataObjReplChain: preProcParaPut of %s error, status = %d",
+	      L1desc[l1descInx[i]].dataObjInfo->filePath, status);
+	    chainStatus[i] = status < 0 ? status : SYS_INVALID_PORTAL_OPR;
+	} else {
+	    snprintf (chainPortal, MAX_NAME_LEN, "%d:%d:%s", 
+	      portalOprOut->portList.portNum, portalOprOut->portList.cookie,
+	      portalOprOut->portList.hostAddr);
+	}
+	if (portalOprOut != NULL) free (portalOprOut);
+    }
+
+    if (headInx >= 0) {
+	if (chainPortal[0] != '\0') {
+	    addKeyVal (&L1desc[l1descInx[headInx]].dataObjInp->condInput,
+	      CHAIN_PORTAL_KW, chainPortal);
+	}
+	chainStatus[headInx] = dataObjCopy (rsComm, l1descInx[headInx]);
+	if (chainStatus[headInx] < 0 && chainPortal[0] != '\0') {
+	    /* in case the head never got to connect */
+	    abortChainPortal (rsComm, chainPortal);
+	}
+    }
+
+    /* the close of each copy waits for its transfer and checks its size */
+    for (i = 0; i < chainLen; i++) {
+	if (l1descInx[i] < 0) continue;
+	memset (&dataObjCloseInp, 0, sizeof (dataObjCloseInp));
+	dataObjCloseInp.l1descInx = l1descInx[i];
+	L1desc[l1descInx[i]].oprStatus = chainStatus[i];
+	if (chainStatus[i] >= 0) {
+	    L1desc[l1descInx[i]].bytesWritten =
+	      L1desc[l1descInx[i]].dataObjInfo->dataSize;
+	}
+	myDestDataObjInfo = NULL;
+	status = irsDataObjClose (rsComm, &dataObjCloseInp, 
+	  &myDestDataObjInfo);
+	if (chainStatus[i] >= 0 && status >= 0) {
+	    doneRescInfo[doneCnt] = chainRescGrp[i]->rescInfo;
+	    doneCnt++;
+	} else if (myDestDataObjInfo != NULL && (chainStatus[i] < 0 ||
+	  status == SYS_COPY_LEN_ERR)) {
+	    /* not registered. don't leave the partial file in the vault */
+	    rodsLog (LOG_NOTICE,
+	      "_rsDataObjReplChain: chain copy %s failed, status = %d",
+	      myDestDataObjInfo->filePath, 
+	      chainStatus[i] < 0 ? chainStatus[i] : status);
+	    l3Unlink (rsComm, myDestDataObjInfo);
+	}
+	if (myDestDataObjInfo != NULL) freeDataObjInfo (myDestDataObjInfo);
+    }
+
+    if (doneCnt > 0) {
+	transStat->numThreads = 1;
+    }
+    return doneCnt;
+}
+
+rodsLong_t
+getReplChainMinSize ()
+{
+    char *tmpStr;
+    int minSize;
+
+    if ((tmpStr = getenv (REPL_CHAIN_MIN_SIZE_KW)) == NULL) {
+	minSize = DEF_REPL_CHAIN_MIN_SIZE;
+    } else {
+	minSize = atoi (tmpStr);
+    }
+    if (minSize <= 0) return 0;
+
+    return (rodsLong_t) minSize * 1024 * 1024;
+}
+
 /* _rsDataObjReplS - replicate a single obj 
  *   dataObjInfo_t *srcDataObjInfo - the src to be replicated. 
  *   rescInfo_t *destRescInfo - The dest resource info
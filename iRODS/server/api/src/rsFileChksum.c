@@ -5,6 +5,7 @@
 
 #include "fileChksum.h"
 #include "miscServerFunct.h"
+#include "streamChksum.h"
 
 #define SVR_MD5_BUF_SZ (1024*1024)
 
@@ -73,7 +74,7 @@ char **chksumStr)
     *chksumStr = (char*)malloc (NAME_LEN);
 
     status = fileChksum (fileChksumInp->fileType, rsComm, 
-      fileChksumInp->fileName, *chksumStr);
+      fileChksumInp->fileName, fileChksumInp->flag, *chksumStr);
 
     if (status < 0) {
         rodsLog (LOG_NOTICE, 
@@ -88,17 +89,34 @@ char **chksumStr)
 } 
 
 int
-fileChksum (int fileType, rsComm_t *rsComm, char *fileName, char *chksumStr)
+fileChksum (int fileType, rsComm_t *rsComm, char *fileName, int chksumScheme,
+char *chksumStr)
 {
     int fd;
-    MD5_CTX context;
+    chksumEngine_t chksumEngine;
     int len;
-    unsigned char buffer[SVR_MD5_BUF_SZ], digest[16];
+    unsigned char buffer[SVR_MD5_BUF_SZ];
     int status;
 #ifdef MD5_DEBUG
     rodsLong_t bytesRead = 0;	/* XXXX debug */
 #endif
 
+    /* computed while the data was put through this agent */
+    if (chksumScheme == DEF_CHKSUM_SCHEME)
+        chksumScheme = getDefChksumScheme ();
+    if (getSavedStreamChksum (fileType, rsComm, fileName, chksumScheme,
+      chksumStr) >= 0)
+        return (0);
+
+    if (chksumScheme == SHA256_TREE_CHKSUM_SCHEME && 
+      fileType == UNIX_FILE_TYPE && getTreeChksumThreads () > 1) {
+	/* hash the chunks of a vault file in parallel */
+	return treeChksumLocFile (fileName, chksumStr, getTreeChksumThreads ());
+    }
+
+    if ((status = initChksumEngine (&chksumEngine, chksumScheme)) < 0)
+        return (status);
+
     if ((fd = fileOpen ((fileDriverType_t)fileType, rsComm, fileName, O_RDONLY, 0, NULL)) < 0) {
         status = UNIX_FILE_OPEN_ERR - errno;
         rodsLog (LOG_NOTICE,
@@ -106,18 +124,17 @@ fileChksum (int fileType, rsComm_t *rsComm, char *fileName, char *chksumStr)
         return (status);
     }
 
-    MD5Init (&context);
     while ((len = fileRead ((fileDriverType_t)fileType, rsComm, fd, buffer, SVR_MD5_BUF_SZ)) > 0) {
 #ifdef MD5_DEBUG
 	bytesRead += len;	/* XXXX debug */
 #endif
-        MD5Update (&context, buffer, len);
+        updateChksumEngine (&chksumEngine, buffer, len);
     }
-    MD5Final (digest, &context);
 
     fileClose ((fileDriverType_t)fileType, rsComm, fd);
 
-    md5ToStr (digest, chksumStr);
+    status = finalChksumEngine (&chksumEngine, chksumStr);
+    if (status < 0) return (status);
 
 #ifdef MD5_DEBUG
     rodsLog (LOG_NOTICE,	/* XXXX debug */
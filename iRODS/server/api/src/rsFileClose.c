@@ -59,6 +59,8 @@ rodsServerHost_t *rodsServerHost)
     memset (&remFileCloseInp, 0, sizeof (remFileCloseInp));
     remFileCloseInp.fileInx = convL3descInx (fileCloseInp->fileInx);
     status = rcFileClose (rodsServerHost->conn, &remFileCloseInp);
+    /* the statistics of a portal transfer done by the resource server */
+    fwdPortalMsg (rodsServerHost->conn->rError, &rsComm->rError);
 
     if (status < 0) { 
         rodsLog (LOG_NOTICE,
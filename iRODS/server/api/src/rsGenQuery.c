@@ -46,6 +46,35 @@ genQueryOut_t **genQueryOut)
     return (status);
 }
 
+/* rsGenQueryCompact - rsGenQuery with the result in the compact encoding,
+ * for clients that can read it (see rcGenQuery).
+ */
+int
+rsGenQueryCompact (rsComm_t *rsComm, genQueryInp_t *genQueryInp,
+genQueryCompactOut_t **genQueryCompactOut)
+{
+    genQueryOut_t *genQueryOut = NULL;
+    int status, status1;
+
+    if (genQueryInp->maxRows > MAX_COMPACT_SQL_ROWS)
+        genQueryInp->maxRows = MAX_COMPACT_SQL_ROWS;
+
+    status = rsGenQuery (rsComm, genQueryInp, &genQueryOut);
+    if (genQueryOut != NULL) {
+        if (status >= 0) {
+            status1 = genQueryOutToCompact (genQueryOut, genQueryCompactOut);
+            if (status1 < 0) {
+                rodsLog (LOG_NOTICE,
+                  "rsGenQueryCompact: genQueryOutToCompact error, status = %d",
+                  status1);
+                status = status1;
+            }
+        }
+        freeGenQueryOut (&genQueryOut);
+    }
+    return (status);
+}
+
 #ifdef RODS_CAT
 int
 _rsGenQuery (rsComm_t *rsComm, genQueryInp_t *genQueryInp,
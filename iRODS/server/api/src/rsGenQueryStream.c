@@ -0,0 +1,131 @@
+/*** Copyright (c), The Regents of the University of California            ***
+ *** For more information please refer to files in the COPYRIGHT directory ***/
+
+/* See genQueryStream.h for a description of this API call.*/
+
+#include "genQueryStream.h"
+#include "genQuery.h"
+#include "rsApiHandler.h"
+#include "sockComm.h"
+
+/* readGenQueryAck - read the ack of a page. If waitFlag is 0, return
+ * 0 at once if there is none yet. Returns 1 with the ack in *ack */
+static int
+readGenQueryAck (rsComm_t *rsComm, int waitFlag, int *ack)
+{
+    struct timeval tv;
+    fd_set set;
+    int myBuf;
+    int nbytes, status;
+
+    if (waitFlag == 0) {
+        FD_ZERO (&set);
+        FD_SET (rsComm->sock, &set);
+        tv.tv_sec = 0;
+        tv.tv_usec = 0;
+        status = select (rsComm->sock + 1, &set, NULL, NULL, &tv);
+        if (status <= 0) return (0);
+    }
+    nbytes = myRead (rsComm->sock, (void *) &myBuf, sizeof (myBuf),
+      SOCK_TYPE, NULL, NULL);
+    if (nbytes != sizeof (myBuf)) {
+        rodsLog (LOG_ERROR,
+          "readGenQueryAck: read %d bytes, errno = %d", nbytes, errno);
+        return (SYS_SOCK_READ_ERR - errno);
+    }
+    *ack = ntohl (myBuf);
+    return (1);
+}
+
+int
+rsGenQueryStream (rsComm_t *rsComm, genQueryInp_t *genQueryInp,
+genQueryCompactOut_t **genQueryCompactOut)
+{
+    genQueryOut_t *genQueryOut = NULL;
+    genQueryCompactOut_t *pageOut;
+    char *tmpStr;
+    int window, credit;
+    int ackCnt = 0;	/* pages sent and not acked */
+    int cancelFlag = 0;
+    int continueInx, status, status1, ack;
+
+    window = DEF_GEN_QUERY_WINDOW;
+    if ((tmpStr = getValByKey (&genQueryInp->condInput,
+      GEN_QUERY_WINDOW_KW)) != NULL) {
+        window = atoi (tmpStr);
+        if (window < MIN_GEN_QUERY_WINDOW) window = MIN_GEN_QUERY_WINDOW;
+    }
+    credit = window;
+    if (genQueryInp->maxRows <= 0)
+        genQueryInp->maxRows = MAX_SQL_ROWS;
+    else if (genQueryInp->maxRows > MAX_COMPACT_SQL_ROWS)
+        genQueryInp->maxRows = MAX_COMPACT_SQL_ROWS;
+
+    while (1) {
+        status = rsGenQuery (rsComm, genQueryInp, &genQueryOut);
+        if (status < 0) {
+            freeGenQueryOut (&genQueryOut);
+            break;
+        }
+        pageOut = NULL;
+        status = genQueryOutToCompact (genQueryOut, &pageOut);
+        continueInx = genQueryOut->continueInx;
+        freeGenQueryOut (&genQueryOut);
+        if (status < 0) {
+            rodsLog (LOG_NOTICE,
+              "rsGenQueryStream: genQueryOutToCompact error, status = %d",
+              status);
+            freeGenQueryCompactOut (&pageOut);
+            break;
+        }
+        if (continueInx <= 0) {
+            /* the last page goes in the final reply */
+            *genQueryCompactOut = pageOut;
+            break;
+        }
+        genQueryInp->continueInx = continueInx;
+
+        credit -= getGenQueryCompactSize (pageOut);
+        /* sendAndProcApiReply frees pageOut and, through the FREE_POINTER
+         * packing, its arrays */
+        status = sendAndProcApiReply (rsComm, rsComm->apiInx,
+          SYS_SVR_TO_CLI_GEN_QUERY_PAGE, pageOut, NULL);
+        if (status < 0) {
+            rodsLog (LOG_NOTICE,
+              "rsGenQueryStream: sendAndProcApiReply error, status = %d",
+              status);
+            return (status);
+        }
+        ackCnt++;
+
+        /* take the acks that are in. Wait for one if out of credit */
+        while (ackCnt > 0) {
+            status = readGenQueryAck (rsComm, credit <= 0, &ack);
+            if (status < 0) return (status);
+            if (status == 0) break;
+            ackCnt--;
+            if (ack == GEN_QUERY_STREAM_CANCEL) {
+                cancelFlag = 1;
+                break;
+            }
+            credit += ack;
+        }
+        if (cancelFlag > 0) {
+            /* close out the statement */
+            genQueryInp->maxRows = 0;
+            status = rsGenQuery (rsComm, genQueryInp, &genQueryOut);
+            freeGenQueryOut (&genQueryOut);
+            if (status == CAT_NO_ROWS_FOUND) status = 0;
+            break;
+        }
+    }
+
+    /* the client acks every page. Take the rest before the final reply */
+    while (ackCnt > 0) {
+        status1 = readGenQueryAck (rsComm, 1, &ack);
+        if (status1 < 0) return (status1);
+        ackCnt--;
+    }
+
+    return (status);
+}
@@ -6,6 +6,7 @@
 #include "generalAdmin.h"
 #include "reGlobalsExtern.h"
 #include "icatHighLevelRoutines.h"
+#include "svrCfgSnap.h"
 
 int
 rsGeneralAdmin (rsComm_t *rsComm, generalAdminInp_t *generalAdminInp )
@@ -37,6 +38,14 @@ rsGeneralAdmin (rsComm_t *rsComm, generalAdminInp_t *generalAdminInp )
     if (status < 0) { 
        rodsLog (LOG_NOTICE,
 		"rsGeneralAdmin: rcGeneralAdmin error %d", status);
+    } else if ((strcmp (generalAdminInp->arg0, "add") == 0 ||
+      strcmp (generalAdminInp->arg0, "modify") == 0 ||
+      strcmp (generalAdminInp->arg0, "rm") == 0) &&
+      (strcmp (generalAdminInp->arg1, "zone") == 0 ||
+      strcmp (generalAdminInp->arg1, "resource") == 0)) {
+       /* the zone/resource config changed. Have the agents on this host
+	* requery it instead of using the shared snapshot */
+       bumpSvrCfgGeneration (rsComm);
     }
     return (status);
 }
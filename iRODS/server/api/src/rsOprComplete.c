@@ -2,6 +2,7 @@
 #include "oprComplete.h"
 #include "dataObjClose.h"
 #include "rsGlobalExtern.h"
+#include "miscServerFunct.h"
 
 int rsOprComplete (rsComm_t *rsComm, int *retval)
 {
@@ -13,6 +14,8 @@ int rsOprComplete (rsComm_t *rsComm, int *retval)
         if (L1desc[l1descInx].remoteZoneHost != NULL) {
             *retval = rcOprComplete (L1desc[l1descInx].remoteZoneHost->conn,
 	      L1desc[l1descInx].remoteL1descInx);
+	    fwdPortalMsg (L1desc[l1descInx].remoteZoneHost->conn->rError,
+	      &rsComm->rError);
 	    freeL1desc (l1descInx);
 	} else {
             memset (&dataObjCloseInp, 0, sizeof (dataObjCloseInp));
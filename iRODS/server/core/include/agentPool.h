@@ -0,0 +1,62 @@
+/*** Copyright (c), The Regents of the University of California            ***
+ *** For more information please refer to files in the COPYRIGHT directory ***/
+
+/* agentPool.h - header file for agentPool.c
+ */
+
+
+
+#ifndef AGENT_POOL_H
+#define AGENT_POOL_H
+
+#include "rods.h"
+#include "initServer.h"
+
+/* env variables (set in irodsctl) for the pool of pre-started agents.
+ * The pool is off unless AGENT_POOL_SIZE_KW is set to a positive value */
+#define AGENT_POOL_SIZE_KW	"agentPoolSize"
+#define AGENT_POOL_MAX_SESS_KW	"agentPoolMaxSess"
+
+/* env variable giving a pooled agent its end of the control socketpair */
+#define SP_AGENT_POOL_SOCK	"spAgentPoolSock"
+
+#define MAX_AGENT_POOL_SIZE	64
+#define DEF_AGENT_POOL_MAX_SESS	100	/* sessions served before recycling */
+
+/* definition for the state of a pool slot */
+#define POOL_AGENT_FREE		0	/* no agent in this slot */
+#define POOL_AGENT_STARTING	1	/* forked, still initializing */
+#define POOL_AGENT_IDLE		2	/* waiting for a connection */
+#define POOL_AGENT_BUSY		3	/* serving a client */
+#define POOL_AGENT_EXITING	4	/* closed its control socket */
+
+/* definition for the msg sent by a pooled agent to the server */
+#define POOL_AGENT_READY_MSG	1	/* ready to take a new connection */
+
+typedef struct poolAgent {
+    int pid;
+    int ctrlSock;	/* the server end of the socketpair */
+    int state;
+    int sessCnt;	/* number of sessions handed to this agent */
+} poolAgent_t;
+
+/* the request sent to a pooled agent together with the client socket */
+typedef struct agentPoolReq {
+    startupPack_t startupPack;
+    struct sockaddr_in remoteAddr;
+} agentPoolReq_t;
+
+int
+sendSockToPoolAgent (int ctrlSock, int newSock, agentPoolReq_t *poolReq);
+int
+recvSockFromServer (int ctrlSock, int *newSock, agentPoolReq_t *poolReq);
+int
+sendPoolAgentMsg (int ctrlSock, int msg);
+int
+readPoolAgentMsg (int ctrlSock, int *msg);
+int
+getAgentPoolSize ();
+int
+getAgentPoolMaxSess ();
+
+#endif	/* AGENT_POOL_H */
@@ -191,10 +191,16 @@ setExecArg (char *commandArgv, char *av[]);
 #ifdef RULE_ENGINE_N
 int
 initAgent (int processType, rsComm_t *rsComm);
+int
+initAgentEnv (int processType, rsComm_t *rsComm);
 #else
 int
 initAgent (rsComm_t *rsComm);
+int
+initAgentEnv (rsComm_t *rsComm);
 #endif
+int
+initAgentSession (rsComm_t *rsComm);
 void cleanupAndExit (int status);
 #ifdef  __cplusplus
 void signalExit ( int );
@@ -23,6 +23,8 @@
 #include "fileOpen.h"
 #include "dataObjInpOut.h"
 #include "dataCopy.h"
+#include "rcPortalOpr.h"
+#include "streamChksum.h"
 #ifdef RBUDP_TRANSFER
 #include "QUANTAnet_rbudpBase_c.h"
 #include "QUANTAnet_rbudpSender_c.h"
@@ -33,6 +35,37 @@
 
 #define MAX_RECON_ERROR_CNT	10
 
+/* env variable (set in irodsctl) giving the chunk size in MB of a 
+ * dynamic portal transfer. 0 turns the dynamic mode off */
+#define PORTAL_CHUNK_SIZE_KW	"portalChunkSize"
+#define DEF_PORTAL_CHUNK_SIZE	(8*1024*1024)
+
+/* the shared offset counter of a dynamic portal transfer. Each thread
+ * takes the next chunkSize chunk until endOffset is reached, so fast 
+ * streams end up doing more of the transfer */
+typedef struct PortalChunkCnt {
+    rodsLong_t nextOffset;
+    rodsLong_t endOffset;
+    rodsLong_t chunkSize;
+#ifdef USE_BOOST
+    boost::mutex *lock;
+#else
+#ifndef windows_platform
+    pthread_mutex_t lock;
+#endif
+#endif
+} portalChunkCnt_t;
+
+/* the link of a replication chain to the portal of the next replica.
+ * The next replica asks for the data in order with transfer headers as
+ * in a put and is sent the data this one writes */
+typedef struct PortalForward {
+    int sock;
+    rodsLong_t offset;		/* of the next byte to forward */
+    rodsLong_t toSend;		/* bytes asked for and not sent yet */
+    int status;
+} portalForward_t;
+
 typedef struct PortalTransferInp {
     rsComm_t *rsComm;
     int destFd;
@@ -46,6 +79,15 @@ typedef struct PortalTransferInp {
     int flags;
     int status;
     dataOprInp_t *dataOprInp;
+    portalChunkCnt_t *chunkCnt;	/* non NULL for a dynamic transfer */
+    streamChksum_t *streamChksum; /* non NULL to chksum the data */
+    treeStreamChksum_t *treeChksum; /* non NULL to sha2tree chksum the
+				     * data of a parallel transfer */
+    treeChunkChksum_t treeChunk; /* the chunk of treeChksum being done */
+    orderedStreamChksum_t *orderedChksum; /* non NULL to chksum the data
+				     * of a parallel transfer in order */
+    portalForward_t *portalForward; /* non NULL to forward the data */
+    portalStat_t *portalStat;	/* non NULL to keep the statistics */
 } portalTransferInp_t;
 
 int
@@ -65,6 +107,30 @@ partialDataPut (portalTransferInp_t *myInput);
 void
 partialDataGet (portalTransferInp_t *myInput);
 int
+logPortalStat (rsComm_t *rsComm, int oprType, dataOprInp_t *dataOprInp,
+portalTransferInp_t *myInput, int numThreads);
+int
+fwdPortalMsg (rError_t *inError, rError_t *outError);
+int
+recordPortalTranRate (rsComm_t *rsComm, dataOprInp_t *dataOprInp,
+int numThreads, struct timeval *startTime);
+int
+getPortalChunkSize (dataOprInp_t *dataOprInp, int numThreads);
+int
+getNextPortalChunk (portalTransferInp_t *myInput, int rescTypeInx,
+int l3descInx, rodsLong_t *myOffset, rodsLong_t *bytesToGet);
+int
+getZeroCopyFd (int l3descInx);
+int
+openPortalForward (rsComm_t *rsComm, char *chainPortal,
+portalForward_t *portalForward);
+int
+forwardPortalData (portalForward_t *portalForward, char *buf, int len);
+int
+closePortalForward (portalForward_t *portalForward, int status);
+int
+abortChainPortal (rsComm_t *rsComm, char *chainPortal);
+int
 fillPortalTransferInp (portalTransferInp_t *myInput, rsComm_t *rsComm,
 int srcFd, int destFd, int destRescTypeInx, int srcRescTypeInx,
 int threadNum, rodsLong_t size, rodsLong_t offset, int flags);
@@ -48,6 +48,7 @@ typedef struct l1desc {
     int chksumFlag;     /* parsed from condition */
     int srcL1descInx;
     char chksum[NAME_LEN]; /* the input chksum */
+    char streamChksum[NAME_LEN]; /* chksum of the data as it was written */
 #ifdef LOG_TRANSFERS
     struct timeval openStartTime;
 #endif
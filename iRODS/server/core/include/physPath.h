@@ -60,12 +60,20 @@ int
 dataObjChksum (rsComm_t *rsComm, int l1descInx, keyValPair_t *regParam);
 int
 _dataObjChksum (rsComm_t *rsComm, dataObjInfo_t *dataObjInfo, char **chksumStr);
+int
+_dataObjChksumByScheme (rsComm_t *rsComm, dataObjInfo_t *dataObjInfo,
+char **chksumStr, int chksumScheme);
 rodsLong_t 
 getSizeInVault (rsComm_t *rsComm, dataObjInfo_t *dataObjInfo);
 int
+chksumMismatch (char *objPath, char *expected, char *computed);
+int
 dataObjChksumAndReg (rsComm_t *rsComm, dataObjInfo_t *dataObjInfo,
 char **chksumStr);
 int
+regDataObjChksum (rsComm_t *rsComm, dataObjInfo_t *dataObjInfo,
+char *chksumStr);
+int
 chkAndHandleOrphanFile (rsComm_t *rsComm, char *filePath, 
 rescInfo_t *rescInfo, int replStatus);
 int
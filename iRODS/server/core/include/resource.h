@@ -100,6 +100,8 @@ initResc (rsComm_t *rsComm);
 int
 getHostStatusByRescInfo (rodsServerHost_t *rodsServerHost);
 int
+initRescFromSnap ();
+int
 procAndQueRescResult (genQueryOut_t *genQueryOut);
 int
 printLocalResc ();
@@ -24,5 +24,9 @@
 #define READ_RETRY_SLEEP_TIME	1	
 
 int agentMain (rsComm_t *rsComm);
+int serveAgentSession (rsComm_t *rsComm);
+int agentPoolMain (rsComm_t *rsComm, int poolSock);
+int chkAgentSessionReuse (rsComm_t *rsComm);
+int endAgentSession (rsComm_t *rsComm);
 
 #endif	/* RODS_AGENT_H */
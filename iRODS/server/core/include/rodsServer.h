@@ -30,6 +30,7 @@
 #include "getRodsEnv.h"
 #include "rcConnect.h"
 #include "initServer.h"
+#include "agentPool.h"
 
 
 extern char *optarg;
@@ -105,4 +106,18 @@ int
 procBadReq ();
 void
 purgeLockFileWorkerTask ();
+int
+closeInheritedSock ();
+int
+initAgentPool ();
+int
+replenishAgentPool ();
+int
+startPoolAgent (poolAgent_t *poolAgent);
+int
+procAgentPoolMsg ();
+int
+dispatchToPoolAgent (agentProc_t *connReq);
+int
+procPoolAgentExit (int childPid);
 #endif	/* RODS_SERVER_H */
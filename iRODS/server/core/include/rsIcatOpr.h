@@ -18,4 +18,6 @@ int
 disconnectRcat (rsComm_t *rsComm);
 int
 resetRcat (rsComm_t *rsComm);
+int
+resetRcatSession (rsComm_t *rsComm);
 #endif	/* RS_ICAT_OPR_H */
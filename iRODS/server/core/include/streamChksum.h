@@ -0,0 +1,151 @@
+/*** Copyright (c), The Regents of the University of California            ***
+ *** For more information please refer to files in the COPYRIGHT directory ***/
+
+/* streamChksum.h - header file for streamChksum.c
+ */
+
+
+
+#ifndef STREAM_CHKSUM_H
+#define STREAM_CHKSUM_H
+
+#include "rods.h"
+#include "md5Checksum.h"
+#ifdef USE_BOOST
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition.hpp>
+#elif !defined(windows_platform)
+#include <pthread.h>
+#endif
+
+/* definition for the state of a streamChksum_t */
+#define STREAM_CHKSUM_ON	1
+#define STREAM_CHKSUM_BROKEN	2	/* the data did not come in order */
+
+#define MAX_SAVED_STREAM_CHKSUM	8
+
+/* the chksum of the data written through a transfer stream. The data must
+ * come in order starting from offset 0 */
+typedef struct StreamChksum {
+    int state;
+    rodsLong_t nextOffset;
+    chksumEngine_t chksumEngine;
+} streamChksum_t;
+
+/* the sha2tree chksum of the data moved by the threads of a parallel
+ * transfer. Each TREE_CHKSUM_CHUNK_SZ chunk of the file must be moved from
+ * start to end by one thread, so svrPortalPutGet gives the threads whole
+ * chunks. The threads fill in the digests of the chunks they finish and
+ * the digests are combined after the join */
+typedef struct TreeStreamChksum {
+    int state;
+    int chunkCnt;
+    rodsLong_t dataSize;
+    unsigned char *digest;	/* chunkCnt SHA256_DIGEST_LEN digests */
+    char *chunkDone;		/* chunkCnt flags */
+} treeStreamChksum_t;
+
+/* a copy of the data of an orderedStreamChksum_t that came ahead of
+ * nextOffset */
+typedef struct PendingChksumBuf {
+    rodsLong_t offset;
+    int len;
+    char *buf;
+    struct PendingChksumBuf *next;
+} pendingChksumBuf_t;
+
+/* the md5 or sha2 chksum of the data moved by the threads of a parallel
+ * transfer with dynamic chunks. These schemes take the data in order, so
+ * a thread ahead of streamChksum.nextOffset queues a copy of its data.
+ * The thread with the data at nextOffset hashes it and the queued data
+ * following it. A thread waits while maxPendingSize bytes are queued. The
+ * chunks are handed out in order, so the thread at nextOffset is never
+ * one of them */
+typedef struct OrderedStreamChksum {
+    streamChksum_t streamChksum;
+    rodsLong_t pendingSize;
+    rodsLong_t maxPendingSize;
+    pendingChksumBuf_t *pending;	/* sorted by offset */
+#ifdef USE_BOOST
+    boost::mutex *lock;
+    boost::condition_variable_any *cond;
+#else
+#ifndef windows_platform
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+#endif
+#endif
+} orderedStreamChksum_t;
+
+#define MAX_CHKSUM_PENDING_SZ	(64*1024*1024)
+
+/* the chunk of a treeStreamChksum_t a thread is in */
+typedef struct TreeChunkChksum {
+    int inChunk;		/* 0 if between chunks */
+    int chunkInx;
+    rodsLong_t nextOffset;
+    SHA256_CTX context;
+} treeChunkChksum_t;
+
+/* the chksum of a file computed by a stream of this agent. It is good
+ * as long as the size and mtime of the file have not changed. A second
+ * is too coarse for the mtime, so only the chksum of a unix file on a
+ * platform with the nanoseconds of the mtime is saved */
+typedef struct SavedStreamChksum {
+    int fileType;
+    char fileName[MAX_NAME_LEN];
+    rodsLong_t fileSize;
+    time_t mtime;
+    long mtimeNsec;
+    char chksum[NAME_LEN];
+} savedStreamChksum_t;
+
+#if defined(linux_platform) || defined(solaris_platform)
+#define STAT_MTIME_NSEC(statbuf)	((statbuf)->st_mtim.tv_nsec)
+#elif defined(osx_platform)
+#define STAT_MTIME_NSEC(statbuf)	((statbuf)->st_mtimespec.tv_nsec)
+#endif
+
+int
+initStreamChksum (streamChksum_t *streamChksum, int chksumScheme);
+int
+updateStreamChksum (streamChksum_t *streamChksum, rodsLong_t offset,
+char *buf, int len);
+int
+finalStreamChksum (streamChksum_t *streamChksum, char *chksumStr);
+int
+chksumDataBuf (char *buf, int len, int chksumScheme, char *chksumStr);
+int
+saveStreamChksum (rsComm_t *rsComm, int l3descInx,
+streamChksum_t *streamChksum);
+int
+getSavedStreamChksum (int fileType, rsComm_t *rsComm, char *fileName,
+int chksumScheme, char *chksumStr);
+int
+initOrderedStreamChksum (orderedStreamChksum_t *orderedChksum,
+int chksumScheme, rodsLong_t maxPendingSize);
+int
+updateOrderedStreamChksum (orderedStreamChksum_t *orderedChksum,
+rodsLong_t offset, char *buf, int len);
+int
+breakOrderedStreamChksum (orderedStreamChksum_t *orderedChksum);
+int
+clearOrderedStreamChksum (orderedStreamChksum_t *orderedChksum);
+int
+initTreeStreamChksum (treeStreamChksum_t *treeChksum, rodsLong_t dataSize);
+int
+updateTreeStreamChksum (treeStreamChksum_t *treeChksum,
+treeChunkChksum_t *chunkChksum, rodsLong_t offset, char *buf, int len);
+int
+saveTreeStreamChksum (rsComm_t *rsComm, int l3descInx,
+treeStreamChksum_t *treeChksum);
+int
+clearTreeStreamChksum (treeStreamChksum_t *treeChksum);
+int
+isStreamChksumNeeded (int l1descInx);
+int
+getL1descChksumScheme (int l1descInx);
+int
+isGetChksumAtClose (int l1descInx);
+
+#endif	/* STREAM_CHKSUM_H */
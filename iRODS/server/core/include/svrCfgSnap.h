@@ -0,0 +1,81 @@
+/*** Copyright (c), The Regents of the University of California            ***
+ *** For more information please refer to files in the COPYRIGHT directory ***/
+
+/* svrCfgSnap.h - header file for svrCfgSnap.c
+ */
+
+
+
+#ifndef SVR_CFG_SNAP_H
+#define SVR_CFG_SNAP_H
+
+#include "rods.h"
+#include "rodsGenQuery.h"
+#include "rcMisc.h"
+
+/* env variable (set in irodsctl) giving the max age in sec of the
+ * shared memory snapshot of the zone and resource configuration.
+ * 0 turns the snapshot off. */
+#define SVR_CFG_SNAP_MAX_AGE_KW	"svrCfgSnapMaxAge"
+#define DEF_SVR_CFG_SNAP_MAX_AGE	120
+
+#define SVR_CFG_SNAP_NAME	"/irodsSvrCfg"	/* shm name prefix */
+#define SVR_CFG_SNAP_MAGIC	0x53434631	/* "SCF1" */
+#define MAX_SVR_CFG_RESULT	64
+
+/* definition for the slot of a saved query result */
+#define SVR_CFG_ZONE_SLOT	1	/* the initZone query */
+#define SVR_CFG_RESC_SLOT	2	/* the initResc query, one per page */
+
+/* definition for the state of the snapshot in this process */
+#define SVR_CFG_SNAP_INACTIVE	0
+#define SVR_CFG_SNAP_LOADED	1	/* results read from the snapshot */
+#define SVR_CFG_SNAP_CAPTURE	2	/* saving query results to publish */
+
+/* the header of the shared memory segment. It is followed by
+ * resultCnt svrCfgResultHdr_t and then the packed genQueryOut of
+ * each result. */
+typedef struct svrCfgSnapHdr {
+    int magic;
+    int generation;	/* bumped by admin changes of zones and resources */
+    int snapGeneration;	/* generation the results were queried at */
+    int resultCnt;
+    rodsLong_t buildTime;
+    rodsLong_t dataLen;
+} svrCfgSnapHdr_t;
+
+typedef struct svrCfgResultHdr {
+    int slot;
+    int len;
+} svrCfgResultHdr_t;
+
+typedef struct svrCfgResult {
+    int slot;
+    bytesBuf_t *packedResult;
+} svrCfgResult_t;
+
+typedef struct svrCfgSnap {
+    int state;
+    int generation;
+    int resultCnt;
+    svrCfgResult_t result[MAX_SVR_CFG_RESULT];
+} svrCfgSnap_t;
+
+int
+beginSvrCfgSnap (rsComm_t *rsComm);
+int
+endSvrCfgSnap (rsComm_t *rsComm, int inpStatus);
+int
+isSvrCfgSnapLoaded ();
+int
+getSvrCfgSnapResult (int slot, int inx, genQueryOut_t **genQueryOut);
+int
+addSvrCfgSnapResult (int slot, genQueryOut_t *genQueryOut);
+int
+bumpSvrCfgGeneration (rsComm_t *rsComm);
+int
+removeSvrCfgSnap (rsComm_t *rsComm);
+int
+getSvrCfgSnapMaxAge ();
+
+#endif	/* SVR_CFG_SNAP_H */
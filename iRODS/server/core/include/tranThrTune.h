@@ -0,0 +1,65 @@
+/*** Copyright (c), The Regents of the University of California            ***
+ *** For more information please refer to files in the COPYRIGHT directory ***/
+
+/* tranThrTune.h - header file for tranThrTune.c
+ */
+
+
+
+#ifndef TRAN_THR_TUNE_H
+#define TRAN_THR_TUNE_H
+
+#include "rods.h"
+
+/* env variable (set in irodsctl) giving how often the tuner tries a
+ * thread count next to the best one, i.e., every tranThrExplore'th
+ * transfer of a resource and client subnet. 0 turns the trials off. */
+#define TRAN_THR_EXPLORE_KW	"tranThrExplore"
+#define DEF_TRAN_THR_EXPLORE	8
+
+#define TRAN_THR_TUNE_NAME	"/irodsTranThr"	/* shm name prefix */
+#define TRAN_THR_TUNE_MAGIC	0x54544832	/* "TTH2" */
+#define MAX_TRAN_THR_ENTRY	256
+#define TRAN_THR_SUBNET_MASK	0xffffff00	/* client subnet is a /24 */
+#define TRAN_THR_EWMA_WEIGHT	0.25	/* weight of a new sample */
+
+/* definition for sizeClass. Small files are dominated by the setup of
+ * the streams, so they are tuned apart from the large ones */
+#define TRAN_THR_SMALL_SZ	(64*1024*1024)
+#define TRAN_THR_LARGE_SZ	(1024*1024*1024)
+#define TRAN_THR_SMALL_CLASS	0
+#define TRAN_THR_MEDIUM_CLASS	1
+#define TRAN_THR_LARGE_CLASS	2
+
+/* the throughput history of a resource, client subnet and size class.
+ * rate[n] is the moving average in bytes/sec of the transfers done with
+ * n threads and sampleCnt[n] the number of them. pickCnt counts the
+ * thread counts given out, also for transfers that are not measured */
+typedef struct tranThrEntry {
+    char rescName[NAME_LEN];
+    unsigned int subnet;
+    int sizeClass;
+    int tranCnt;
+    int pickCnt;
+    int lastUsed;
+    int sampleCnt[MAX_NUM_CONFIG_TRAN_THR + 1];
+    double rate[MAX_NUM_CONFIG_TRAN_THR + 1];
+} tranThrEntry_t;
+
+/* the shared memory segment */
+typedef struct tranThrTable {
+    int magic;
+    int entryCnt;
+    tranThrEntry_t entry[MAX_TRAN_THR_ENTRY];
+} tranThrTable_t;
+
+int
+getTunedNumThreads (rsComm_t *rsComm, char *rescName, rodsLong_t dataSize,
+int defNumThr, int maxNumThr);
+int
+recordTranThrRate (rsComm_t *rsComm, char *rescName, rodsLong_t dataSize,
+int numThreads, rodsLong_t elapsedUsec);
+int
+getTranThrExplore ();
+
+#endif	/* TRAN_THR_TUNE_H */
@@ -0,0 +1,193 @@
+/*** Copyright (c), The Regents of the University of California            ***
+ *** For more information please refer to files in the COPYRIGHT directory ***/
+
+/* agentPool.c - routines for handing client connections from the
+ * irodsServer to pre-started (pooled) agents. The client socket is passed
+ * over a UNIX domain socketpair with SCM_RIGHTS together with the
+ * startupPack already read by the server.
+ */
+
+#include "agentPool.h"
+
+#ifndef windows_platform
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
+
+int
+getAgentPoolSize ()
+{
+    char *tmpStr;
+    int poolSize;
+
+    if ((tmpStr = getenv (AGENT_POOL_SIZE_KW)) == NULL) return 0;
+    poolSize = atoi (tmpStr);
+    if (poolSize <= 0) return 0;
+    if (poolSize > MAX_AGENT_POOL_SIZE) {
+        rodsLog (LOG_NOTICE,
+          "getAgentPoolSize: %s %d exceeds max of %d", AGENT_POOL_SIZE_KW,
+          poolSize, MAX_AGENT_POOL_SIZE);
+        poolSize = MAX_AGENT_POOL_SIZE;
+    }
+    return poolSize;
+}
+
+int
+getAgentPoolMaxSess ()
+{
+    char *tmpStr;
+    int maxSess;
+
+    if ((tmpStr = getenv (AGENT_POOL_MAX_SESS_KW)) == NULL)
+        return DEF_AGENT_POOL_MAX_SESS;
+    maxSess = atoi (tmpStr);
+    if (maxSess <= 0) return DEF_AGENT_POOL_MAX_SESS;
+    return maxSess;
+}
+
+#ifndef windows_platform
+/* sendSockToPoolAgent - pass newSock and the poolReq to a pooled agent
+ * through its control socket.
+ */
+int
+sendSockToPoolAgent (int ctrlSock, int newSock, agentPoolReq_t *poolReq)
+{
+    struct msghdr msg;
+    struct iovec iov;
+    struct cmsghdr *cmsg;
+    char ctrlBuf[CMSG_SPACE (sizeof (int))];
+    int status;
+
+    if (poolReq == NULL) return USER__NULL_INPUT_ERR;
+
+    memset (&msg, 0, sizeof (msg));
+    memset (ctrlBuf, 0, sizeof (ctrlBuf));
+    iov.iov_base = (char *) poolReq;
+    iov.iov_len = sizeof (agentPoolReq_t);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = ctrlBuf;
+    msg.msg_controllen = sizeof (ctrlBuf);
+
+    cmsg = CMSG_FIRSTHDR (&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN (sizeof (int));
+    memcpy (CMSG_DATA (cmsg), &newSock, sizeof (int));
+
+    while ((status = sendmsg (ctrlSock, &msg, 0)) < 0 && errno == EINTR);
+
+    if (status != (int) sizeof (agentPoolReq_t)) {
+        rodsLog (LOG_ERROR,
+          "sendSockToPoolAgent: sendmsg error, status = %d, errno = %d",
+          status, errno);
+        return SYS_AGENT_POOL_ERR - errno;
+    }
+    return 0;
+}
+
+/* recvSockFromServer - the pooled agent side of sendSockToPoolAgent.
+ * Blocks until the server hands over a connection. Returns
+ * SYS_AGENT_POOL_ERR if the server has closed the control socket.
+ */
+int
+recvSockFromServer (int ctrlSock, int *newSock, agentPoolReq_t *poolReq)
+{
+    struct msghdr msg;
+    struct iovec iov;
+    struct cmsghdr *cmsg;
+    char ctrlBuf[CMSG_SPACE (sizeof (int))];
+    int status;
+
+    if (newSock == NULL || poolReq == NULL) return USER__NULL_INPUT_ERR;
+
+    *newSock = -1;
+    memset (&msg, 0, sizeof (msg));
+    memset (poolReq, 0, sizeof (agentPoolReq_t));
+    iov.iov_base = (char *) poolReq;
+    iov.iov_len = sizeof (agentPoolReq_t);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = ctrlBuf;
+    msg.msg_controllen = sizeof (ctrlBuf);
+
+    while ((status = recvmsg (ctrlSock, &msg, 0)) < 0 && errno == EINTR);
+
+    if (status == 0) {
+        /* the server went away */
+        return SYS_AGENT_POOL_ERR;
+    } else if (status != (int) sizeof (agentPoolReq_t)) {
+        rodsLog (LOG_ERROR,
+          "recvSockFromServer: recvmsg error, status = %d, errno = %d",
+          status, errno);
+        return SYS_AGENT_POOL_ERR - errno;
+    }
+
+    cmsg = CMSG_FIRSTHDR (&msg);
+    if (cmsg == NULL || cmsg->cmsg_level != SOL_SOCKET ||
+      cmsg->cmsg_type != SCM_RIGHTS) {
+        rodsLog (LOG_ERROR,
+          "recvSockFromServer: no socket passed with the request");
+        return SYS_AGENT_POOL_ERR;
+    }
+    memcpy (newSock, CMSG_DATA (cmsg), sizeof (int));
+
+    return 0;
+}
+
+int
+sendPoolAgentMsg (int ctrlSock, int msg)
+{
+    int status;
+
+    while ((status = write (ctrlSock, &msg, sizeof (msg))) < 0 &&
+      errno == EINTR);
+
+    if (status != (int) sizeof (msg)) {
+        return SYS_AGENT_POOL_ERR - errno;
+    }
+    return 0;
+}
+
+/* readPoolAgentMsg - read a msg from a pooled agent. Returns 0 if
+ * the agent has closed its end */
+int
+readPoolAgentMsg (int ctrlSock, int *msg)
+{
+    int status;
+
+    while ((status = read (ctrlSock, msg, sizeof (int))) < 0 &&
+      errno == EINTR);
+
+    if (status == 0) {
+        return 0;
+    } else if (status != (int) sizeof (int)) {
+        return SYS_AGENT_POOL_ERR - errno;
+    }
+    return status;
+}
+#else	/* windows_platform */
+int
+sendSockToPoolAgent (int ctrlSock, int newSock, agentPoolReq_t *poolReq)
+{
+    return SYS_NOT_SUPPORTED;
+}
+
+int
+recvSockFromServer (int ctrlSock, int *newSock, agentPoolReq_t *poolReq)
+{
+    return SYS_NOT_SUPPORTED;
+}
+
+int
+sendPoolAgentMsg (int ctrlSock, int msg)
+{
+    return SYS_NOT_SUPPORTED;
+}
+
+int
+readPoolAgentMsg (int ctrlSock, int *msg)
+{
+    return SYS_NOT_SUPPORTED;
+}
+#endif	/* windows_platform */
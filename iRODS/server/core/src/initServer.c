@@ -23,6 +23,7 @@
 #include "getRemoteZoneResc.h"
 #include "getRescQuota.h"
 #include "physPath.h"
+#include "svrCfgSnap.h"
 #ifdef HPSS
 #include "hpssFileDriver.h"
 #endif
@@ -243,11 +244,16 @@ initServerInfo (rsComm_t *rsComm)
         return (status);
     }
 #endif
+    /* use the shared snapshot of the zone and resource config if it
+     * is good. Otherwise the ICAT query results are saved to it */
+    beginSvrCfgSnap (rsComm);
+
     status = initZone (rsComm);
     if (status < 0) {
         rodsLog (LOG_SYS_FATAL,
           "initServerInfo: initZone error, status = %d",
           status);
+        endSvrCfgSnap (rsComm, status);
         return (status);
     }
 
@@ -261,10 +267,13 @@ initServerInfo (rsComm_t *rsComm)
             rodsLog (LOG_SYS_FATAL,
               "initServerInfo: initResc error, status = %d",
               status);
+            endSvrCfgSnap (rsComm, status);
             return (status);
 	}
     }
 
+    endSvrCfgSnap (rsComm, status);
+
     return (status);
 }
 
@@ -1135,7 +1144,13 @@ initZone (rsComm_t *rsComm)
     addInxIval (&genQueryInp.selectInp, COL_ZONE_COMMENT, 1);
     genQueryInp.maxRows = MAX_SQL_ROWS;
 
-    status =  rsGenQuery (rsComm, &genQueryInp, &genQueryOut);
+    if (isSvrCfgSnapLoaded ()) {
+        status = getSvrCfgSnapResult (SVR_CFG_ZONE_SLOT, 0, &genQueryOut);
+    } else {
+        status =  rsGenQuery (rsComm, &genQueryInp, &genQueryOut);
+        if (status >= 0)
+            addSvrCfgSnapResult (SVR_CFG_ZONE_SLOT, genQueryOut);
+    }
 
     clearGenQueryInp (&genQueryInp);
 
@@ -1344,8 +1359,33 @@ initAgent (rsComm_t *rsComm)
 #endif
 {
     int status;
-    rsComm_t myComm;
-    ruleExecInfo_t rei;
+
+#ifdef RULE_ENGINE_N
+    status = initAgentEnv (processType, rsComm);
+#else
+    status = initAgentEnv (rsComm);
+#endif
+    if (status < 0) {
+        return (status);
+    }
+
+    return (initAgentSession (rsComm));
+}
+
+/* initAgentEnv - the part of the agent initialization that does not
+ * depend on the client: server/zone/resource info, the ICAT connection,
+ * the descriptor tables and the rule engine. A pooled agent does this
+ * once and then calls initAgentSession for each client it serves.
+ */
+#ifdef RULE_ENGINE_N
+int
+initAgentEnv (int processType, rsComm_t *rsComm)
+#else
+int
+initAgentEnv (rsComm_t *rsComm)
+#endif
+{
+    int status;
 
     initProcLog ();
 
@@ -1383,6 +1423,27 @@ initAgent (rsComm_t *rsComm)
         return(status);
     }
 
+#ifndef windows_platform
+    initExecCmdMutex ();
+#endif
+
+    InitialState = INITIAL_DONE;
+    ThisComm = rsComm;
+
+    return (status);
+}
+
+/* initAgentSession - the client dependent part of the agent
+ * initialization. rsComm must already have been set up with the
+ * client's startupPack.
+ */
+int
+initAgentSession (rsComm_t *rsComm)
+{
+    int status = 0;
+    rsComm_t myComm;
+    ruleExecInfo_t rei;
+
     memset (&rei, 0, sizeof (rei));
     rei.rsComm = rsComm;
 
@@ -1432,7 +1493,6 @@ initAgent (rsComm_t *rsComm)
 	      status);
 	}
     }
-    initExecCmdMutex ();
 #endif
 
     InitialState = INITIAL_DONE;
@@ -1928,6 +1988,9 @@ initRsCommWithStartupPack (rsComm_t *rsComm, startupPack_t *startupPack)
 #endif
         
     }
+    /* the client asks for the binary msg header in the option */
+    setSockBinMsgHeader (rsComm->sock, stripBinMsgHeaderOpt (rsComm->option));
+
     if (rsComm->sock != 0) { /* added by RAJA Nov 16 2010 to remove error 
                               * messages from xmsLog */
         setLocalAddr (rsComm->sock, &rsComm->localAddr);
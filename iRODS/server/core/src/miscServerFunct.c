@@ -19,6 +19,8 @@
 #include "dataObjRead.h"
 #include "rcPortalOpr.h"
 #include "initServer.h"
+#include "unixFileDriver.h"
+#include "tranThrTune.h"
 #ifdef PARA_OPR
 #ifdef USE_BOOST
 #include <boost/thread/thread.hpp>
@@ -253,6 +255,12 @@ acceptSrvPortal (rsComm_t *rsComm, portList_t *thisPortList)
         rodsLog (LOG_ERROR, "acceptSrvPortal: select select failed, errno = %d",
           errno);
     }
+    if (nSelected == 0) {
+	/* nobody came. e.g., the upstream of a replication chain died */
+        rodsLog (LOG_NOTICE,
+         "acceptSrvPortal: no connection in %d sec", SELECT_TIMEOUT_FOR_CONN);
+        return SYS_SOCK_ACCEPT_ERR;
+    }
     myFd = accept (lsock, 0, 0);
     if (myFd < 0) {
         rodsLog (LOG_NOTICE,
@@ -299,6 +307,18 @@ svrPortalPutGet (rsComm_t *rsComm)
     int oprType;
     int flags = 0;
     int retVal = 0;
+    portalChunkCnt_t chunkCnt;
+    portalChunkCnt_t *dynChunkCnt = NULL;
+    int chunkSize;
+    struct timeval startTime;
+    portalStat_t portalStat[MAX_NUM_CONFIG_TRAN_THR];
+    int statFlag = isPortalStatOn ();
+    treeStreamChksum_t treeChksum;
+    treeStreamChksum_t *myTreeChksum = NULL;
+    orderedStreamChksum_t orderedChksum;
+    orderedStreamChksum_t *myOrderedChksum = NULL;
+    streamChksum_t streamChksum;
+    char *chksumScheme;
     
     myPortalOpr = rsComm->portalOpr;
 
@@ -330,6 +350,9 @@ svrPortalPutGet (rsComm_t *rsComm)
 	flags |= STREAMING_FLAG;
     }
 
+    if (getValByKey (&dataOprInp->condInput, PORTAL_STAT_KW) != NULL)
+	statFlag = 1;
+
     numThreads = dataOprInp->numThreads;
 
     if (numThreads <= 0 || numThreads > MAX_NUM_CONFIG_TRAN_THR) {
@@ -343,9 +366,61 @@ svrPortalPutGet (rsComm_t *rsComm)
     memset (tid, 0, sizeof (tid));
 #endif
 
-    size0 = dataOprInp->dataSize / numThreads;
-    size1 = dataOprInp->dataSize - size0 * (numThreads - 1);
     offset0 = dataOprInp->offset;
+    chksumScheme = getValByKey (&dataOprInp->condInput, STREAM_CHKSUM_KW);
+#ifdef PARA_OPR
+    if (chksumScheme != NULL && numThreads > 1 && offset0 == 0 &&
+      (flags & STREAMING_FLAG) == 0 &&
+      atoi (chksumScheme) == SHA256_TREE_CHKSUM_SCHEME &&
+      initTreeStreamChksum (&treeChksum, dataOprInp->dataSize) >= 0) {
+	/* the threads are given whole chunks of the tree below, so each
+	 * one can hash the chunks it moves */
+	myTreeChksum = &treeChksum;
+    }
+#endif
+    chunkSize = getPortalChunkSize (dataOprInp, numThreads);
+    if (chunkSize > 0 && myTreeChksum != NULL) 
+	chunkSize = TREE_CHKSUM_CHUNK_SZ;
+#ifdef PARA_OPR
+    if (chksumScheme != NULL && numThreads > 1 && offset0 == 0 &&
+      chunkSize > 0 && myTreeChksum == NULL) {
+	/* the chunks are handed out in order, so the queue of the data
+	 * ahead of the hash stays short. With fixed ranges, it would 
+	 * hold most of the file. Those are chksummed at the close */
+	rodsLong_t maxPendingSize = (rodsLong_t) numThreads * chunkSize;
+
+	if (maxPendingSize > MAX_CHKSUM_PENDING_SZ) 
+	    maxPendingSize = MAX_CHKSUM_PENDING_SZ;
+	if (initOrderedStreamChksum (&orderedChksum, atoi (chksumScheme),
+	  maxPendingSize) >= 0) {
+	    myOrderedChksum = &orderedChksum;
+	}
+    }
+#endif
+    if (chunkSize > 0) {
+	/* dynamic mode. The threads take the chunks from chunkCnt */
+	memset (&chunkCnt, 0, sizeof (chunkCnt));
+	chunkCnt.nextOffset = offset0;
+	chunkCnt.endOffset = offset0 + dataOprInp->dataSize;
+	chunkCnt.chunkSize = chunkSize;
+#ifdef USE_BOOST
+	chunkCnt.lock = new boost::mutex;
+#elif !defined(windows_platform)
+	pthread_mutex_init (&chunkCnt.lock, NULL);
+#endif
+	dynChunkCnt = &chunkCnt;
+	size0 = size1 = 0;
+    } else {
+        size0 = dataOprInp->dataSize / numThreads;
+	if (myTreeChksum != NULL) {
+	    /* round up to whole chunks. The last threads may get less or
+	     * nothing */
+	    size0 = (size0 + TREE_CHKSUM_CHUNK_SZ - 1) / 
+	      TREE_CHKSUM_CHUNK_SZ * TREE_CHKSUM_CHUNK_SZ;
+	    if (size0 <= 0) size0 = TREE_CHKSUM_CHUNK_SZ;
+	}
+        size1 = dataOprInp->dataSize - size0 * (numThreads - 1);
+    }
 
     lsock = getTcpSockFromPortList (thisPortList);
 
@@ -357,27 +432,63 @@ svrPortalPutGet (rsComm_t *rsComm)
 	  errno);
 	
         CLOSE_SOCK (lsock);
+	if (myTreeChksum != NULL) clearTreeStreamChksum (myTreeChksum);
+	if (myOrderedChksum != NULL) 
+	    clearOrderedStreamChksum (myOrderedChksum);
 
         return (portalFd);
     }
+    gettimeofday (&startTime, NULL);
 
     if (oprType == PUT_OPR) {
         fillPortalTransferInp (&myInput[0], rsComm,
          portalFd, dataOprInp->destL3descInx, 0, dataOprInp->destRescTypeInx,
-          0, size0, offset0, flags);
+          0, size0 < dataOprInp->dataSize ? size0 : dataOprInp->dataSize,
+	  offset0, flags);
     } else {
         fillPortalTransferInp (&myInput[0], rsComm,
          dataOprInp->srcL3descInx, portalFd, dataOprInp->srcRescTypeInx, 0,
           0, size0, offset0, flags);
     }
+    myInput[0].chunkCnt = dynChunkCnt;
+    myInput[0].treeChksum = myTreeChksum;
+    myInput[0].orderedChksum = myOrderedChksum;
+    if (statFlag > 0) myInput[0].portalStat = &portalStat[0];
 
     if (numThreads == 1) {
+	if (chksumScheme != NULL && 
+	  initStreamChksum (&streamChksum, atoi (chksumScheme)) >= 0) {
+	    /* the data goes in order. chksum it on the way */
+	    myInput[0].streamChksum = &streamChksum;
+	}
         if (oprType == PUT_OPR) {
+	    portalForward_t portalForward;
+	    char *chainPortal;
+
+	    if ((chainPortal = getValByKey (&dataOprInp->condInput,
+	      CHAIN_PORTAL_KW)) != NULL) {
+		/* a replication chain. pass the data on */
+		openPortalForward (rsComm, chainPortal, &portalForward);
+		myInput[0].portalForward = &portalForward;
+	    }
             partialDataPut (&myInput[0]);
+	    if (myInput[0].streamChksum != NULL && myInput[0].status >= 0) {
+		saveStreamChksum (rsComm, dataOprInp->destL3descInx,
+		  &streamChksum);
+	    }
+	    if (myInput[0].portalForward != NULL)
+		closePortalForward (&portalForward, myInput[0].status);
 	} else {
             partialDataGet (&myInput[0]);
+	    if (myInput[0].streamChksum != NULL && myInput[0].status >= 0) {
+		saveStreamChksum (rsComm, dataOprInp->srcL3descInx,
+		  &streamChksum);
+	    }
 	}
         CLOSE_SOCK (lsock);
+	logPortalStat (rsComm, oprType, dataOprInp, myInput, 1);
+	if (myInput[0].status >= 0 && (flags & STREAMING_FLAG) == 0)
+	    recordPortalTranRate (rsComm, dataOprInp, numThreads, &startTime);
 
 	return (myInput[0].status);
     } else {
@@ -404,6 +515,10 @@ svrPortalPutGet (rsComm_t *rsComm)
 	    } else {
 		mySize = size1;
 	    }
+	    /* ranges of whole tree chunks may end early */
+	    if (mySize > dataOprInp->dataSize - myOffset)
+		mySize = dataOprInp->dataSize - myOffset;
+	    if (mySize < 0) mySize = 0;
 
 	    if (oprType == PUT_OPR) {
 	        /* open the file */ 
@@ -412,6 +527,10 @@ svrPortalPutGet (rsComm_t *rsComm)
     	        fillPortalTransferInp (&myInput[i], rsComm,
 		 portalFd, l3descInx, 0, dataOprInp->destRescTypeInx,
 	          i, mySize, myOffset, flags);
+		myInput[i].chunkCnt = dynChunkCnt;
+		myInput[i].treeChksum = myTreeChksum;
+		myInput[i].orderedChksum = myOrderedChksum;
+		if (statFlag > 0) myInput[i].portalStat = &portalStat[i];
 		#ifdef USE_BOOST
 		tid[i] = new boost::thread( partialDataPut, &myInput[i] );
 		#else
@@ -425,6 +544,10 @@ svrPortalPutGet (rsComm_t *rsComm)
                 fillPortalTransferInp (&myInput[i], rsComm,
 		 l3descInx, portalFd, dataOprInp->srcRescTypeInx, 0,
                   i, mySize, myOffset, flags);
+		myInput[i].chunkCnt = dynChunkCnt;
+		myInput[i].treeChksum = myTreeChksum;
+		myInput[i].orderedChksum = myOrderedChksum;
+		if (statFlag > 0) myInput[i].portalStat = &portalStat[i];
 		#ifdef USE_BOOST
 		tid[i] = new boost::thread( partialDataGet, &myInput[i] );
 		#else
@@ -463,7 +586,33 @@ svrPortalPutGet (rsComm_t *rsComm)
                 retVal = myInput[i].status;
             }
         }
+	if (myTreeChksum != NULL) {
+	    if (retVal >= 0) {
+		saveTreeStreamChksum (rsComm, oprType == PUT_OPR ? 
+		  dataOprInp->destL3descInx : dataOprInp->srcL3descInx,
+		  myTreeChksum);
+	    }
+	    clearTreeStreamChksum (myTreeChksum);
+	}
+	if (myOrderedChksum != NULL) {
+	    if (retVal >= 0) {
+		saveStreamChksum (rsComm, oprType == PUT_OPR ? 
+		  dataOprInp->destL3descInx : dataOprInp->srcL3descInx,
+		  &myOrderedChksum->streamChksum);
+	    }
+	    clearOrderedStreamChksum (myOrderedChksum);
+	}
+	if (dynChunkCnt != NULL) {
+#ifdef USE_BOOST
+	    delete dynChunkCnt->lock;
+#elif !defined(windows_platform)
+	    pthread_mutex_destroy (&dynChunkCnt->lock);
+#endif
+	}
         CLOSE_SOCK (lsock);
+	logPortalStat (rsComm, oprType, dataOprInp, myInput, numThreads);
+	if (retVal >= 0)
+	    recordPortalTranRate (rsComm, dataOprInp, numThreads, &startTime);
 	return (retVal);
 
 #else	/* PARA_OPR */
@@ -473,6 +622,176 @@ svrPortalPutGet (rsComm_t *rsComm)
     }
 }
 
+/* logPortalStat - log the statistics of the streams of a portal
+ * transfer, one line per stream. If the client asked for them
+ * (PORTAL_STAT_KW), also add them to the rError sent back with the
+ * reply to its rcOprComplete */
+int
+logPortalStat (rsComm_t *rsComm, int oprType, dataOprInp_t *dataOprInp,
+portalTransferInp_t *myInput, int numThreads)
+{
+    char statStr[MAX_NAME_LEN];
+    char msgStr[ERR_MSG_LEN];
+    char *rescName;
+    char *oprStr = oprType == PUT_OPR ? "put" : "get";
+    int sendFlag;
+    int i;
+
+    if ((rescName = getValByKey (&dataOprInp->condInput, RESC_NAME_KW)) ==
+      NULL) {
+        rescName = "";
+    }
+    sendFlag = getValByKey (&dataOprInp->condInput, PORTAL_STAT_KW) != NULL;
+    for (i = 0; i < numThreads; i++) {
+        if (myInput[i].portalStat == NULL) continue;
+        fmtPortalStat (myInput[i].portalStat, numThreads, statStr,
+          MAX_NAME_LEN);
+        rodsLog (LOG_NOTICE,
+          "%s opr=%s resc=%s client=%s size=%lld %s", PORTAL_STAT_MSG,
+          oprStr, rescName, rsComm->clientAddr, dataOprInp->dataSize,
+          statStr);
+        if (sendFlag) {
+            snprintf (msgStr, ERR_MSG_LEN,
+              "%s side=server opr=%s resc=%s size=%lld %s", PORTAL_STAT_MSG,
+              oprStr, rescName, dataOprInp->dataSize, statStr);
+            addRErrorMsg (&rsComm->rError, 0, msgStr);
+        }
+    }
+    return 0;
+}
+
+/* fwdPortalMsg - pass the statistics and the chksum a resource server
+ * or a remote zone sent back in inError on to the client. They come with
+ * the first reply after the transfer, e.g., the one to the file close */
+int
+fwdPortalMsg (rError_t *inError, rError_t *outError)
+{
+    int i;
+
+    if (inError == NULL || outError == NULL) return 0;
+    for (i = 0; i < inError->len; i++) {
+        if (isPortalStatMsg (inError->errMsg[i]->msg) == 0 &&
+          isPortalChksumMsg (inError->errMsg[i]->msg) == 0) {
+            continue;
+        }
+        addRErrorMsg (outError, inError->errMsg[i]->status,
+          inError->errMsg[i]->msg);
+    }
+    return 0;
+}
+
+/* recordPortalTranRate - add the throughput of a completed portal
+ * transfer to the thread count history of the resource.
+ */
+int
+recordPortalTranRate (rsComm_t *rsComm, dataOprInp_t *dataOprInp,
+int numThreads, struct timeval *startTime)
+{
+    struct timeval endTime;
+    rodsLong_t elapsedUsec;
+
+    if (dataOprInp->dataSize < MIN_SZ_FOR_PARA_TRAN) return 0;
+
+    gettimeofday (&endTime, NULL);
+    elapsedUsec = (rodsLong_t) (endTime.tv_sec - startTime->tv_sec) *
+      1000000 + (endTime.tv_usec - startTime->tv_usec);
+
+    return recordTranThrRate (rsComm,
+      getValByKey (&dataOprInp->condInput, RESC_NAME_KW),
+      dataOprInp->dataSize, numThreads, elapsedUsec);
+}
+
+/* getPortalChunkSize - return the chunk size of a dynamic portal
+ * transfer, or 0 if the fixed ranges should be used. The client must 
+ * have said it can take the chunks in any order (DYN_PORTAL_CHUNK_KW).
+ */
+int
+getPortalChunkSize (dataOprInp_t *dataOprInp, int numThreads)
+{
+    char *tmpStr;
+    int chunkSize;
+
+    if (numThreads <= 1 || dataOprInp->dataSize <= 0 ||
+      getValByKey (&dataOprInp->condInput, STREAMING_KW) != NULL ||
+      getValByKey (&dataOprInp->condInput, DYN_PORTAL_CHUNK_KW) == NULL) {
+	return 0;
+    }
+
+    if ((tmpStr = getenv (PORTAL_CHUNK_SIZE_KW)) == NULL) {
+	return DEF_PORTAL_CHUNK_SIZE;
+    }
+    chunkSize = atoi (tmpStr);
+    if (chunkSize <= 0) {
+	return 0;
+    } else if (chunkSize > TRANS_SZ / (1024 * 1024)) {
+	/* a header is sent every TRANS_SZ anyway */
+	chunkSize = TRANS_SZ / (1024 * 1024);
+    }
+    return chunkSize * 1024 * 1024;
+}
+
+/* getNextPortalChunk - take the next chunk of a dynamic transfer and
+ * seek l3descInx to it if it does not follow the last one. Returns 1
+ * if a chunk was taken, 0 if the transfer is done or not dynamic.
+ */
+int
+getNextPortalChunk (portalTransferInp_t *myInput, int rescTypeInx,
+int l3descInx, rodsLong_t *myOffset, rodsLong_t *bytesToGet)
+{
+    portalChunkCnt_t *chunkCnt = myInput->chunkCnt;
+    rodsLong_t chunkOffset, chunkLen, status;
+
+    if (chunkCnt == NULL || myInput->status < 0) return 0;
+
+#ifdef USE_BOOST
+    chunkCnt->lock->lock();
+#elif !defined(windows_platform)
+    pthread_mutex_lock (&chunkCnt->lock);
+#endif
+    chunkOffset = chunkCnt->nextOffset;
+    chunkLen = chunkCnt->endOffset - chunkOffset;
+    if (chunkLen > chunkCnt->chunkSize) chunkLen = chunkCnt->chunkSize;
+    if (chunkLen > 0) chunkCnt->nextOffset += chunkLen;
+#ifdef USE_BOOST
+    chunkCnt->lock->unlock();
+#elif !defined(windows_platform)
+    pthread_mutex_unlock (&chunkCnt->lock);
+#endif
+
+    if (chunkLen <= 0) return 0;
+
+    if (chunkOffset != *myOffset) {
+        status = _l3Lseek (myInput->rsComm, rescTypeInx, l3descInx, 
+	  chunkOffset, SEEK_SET);
+	if (status < 0) {
+	    myInput->status = status;
+            rodsLog (LOG_NOTICE,
+              "getNextPortalChunk: _l3Lseek error, status = %d ", 
+	      myInput->status);
+	    return (myInput->status);
+	}
+	*myOffset = chunkOffset;
+    }
+    *bytesToGet = chunkLen;
+    return 1;
+}
+
+/* getZeroCopyFd - return the unix fd behind l3descInx if portal data can
+ * move directly between it and the socket, i.e., a local file of the unix
+ * driver. Otherwise return -1 and the data goes through a buffer.
+ */
+int
+getZeroCopyFd (int l3descInx)
+{
+    rodsServerHost_t *rodsServerHost;
+
+    if (getServerHostByFileInx (l3descInx, &rodsServerHost) != LOCAL_HOST)
+        return -1;
+    if (FileDesc[l3descInx].fileType != UNIX_FILE_TYPE) return -1;
+
+    return FileDesc[l3descInx].fd;
+}
+
 int
 fillPortalTransferInp (portalTransferInp_t *myInput, rsComm_t *rsComm,
 int srcFd, int destFd, int srcRescTypeInx, int destRescTypeInx,
@@ -496,6 +815,160 @@ int threadNum, rodsLong_t size, rodsLong_t offset, int flags)
 }
 
 
+/* openPortalForward - connect to the portal of the next replica of a
+ * replication chain given by the CHAIN_PORTAL_KW value chainPortal.
+ * A failure only affects the replicas down the chain. These come out
+ * short and are replicated again the usual way.
+ */
+int
+openPortalForward (rsComm_t *rsComm, char *chainPortal,
+portalForward_t *portalForward)
+{
+    char hostAddr[LONG_NAME_LEN];
+    int portNum, cookie;
+
+    memset (portalForward, 0, sizeof (portalForward_t));
+    portalForward->sock = -1;
+
+    if (sscanf (chainPortal, "%d:%d:%255s", &portNum, &cookie, 
+      hostAddr) != 3) {
+        rodsLog (LOG_NOTICE,
+          "openPortalForward: bad chain portal %s", chainPortal);
+	portalForward->status = SYS_INVALID_PORTAL_OPR;
+	return portalForward->status;
+    }
+
+    portalForward->sock = connectToRhostPortal (hostAddr, portNum, cookie,
+      rsComm->windowSize);
+    if (portalForward->sock < 0) {
+        rodsLog (LOG_NOTICE,
+          "openPortalForward: connect to %s:%d error, status = %d",
+	  hostAddr, portNum, portalForward->sock);
+	portalForward->status = portalForward->sock;
+	portalForward->sock = -1;
+    }
+    return portalForward->status;
+}
+
+/* forwardPortalData - forward the next len bytes of the data to the
+ * next replica as it asks for them. The data must come in order.
+ */
+int
+forwardPortalData (portalForward_t *portalForward, char *buf, int len)
+{
+    transferHeader_t myHeader;
+    int toSend, bytesWritten;
+
+    while (len > 0 && portalForward->status >= 0) {
+	if (portalForward->toSend <= 0) {
+	    portalForward->status = rcvTranHeader (portalForward->sock, 
+	      &myHeader);
+	    if (portalForward->status < 0) break;
+	    if (myHeader.oprType != PUT_OPR || 
+	      myHeader.offset != portalForward->offset) {
+		/* the next replica gave up or is out of step */
+		rodsLog (LOG_NOTICE,
+		  "forwardPortalData: oprType %d for offset %lld at %lld",
+		  myHeader.oprType, myHeader.offset, portalForward->offset);
+		portalForward->status = SYS_COPY_LEN_ERR;
+		break;
+	    }
+	    portalForward->toSend = myHeader.length;
+	}
+	if (len < portalForward->toSend) {
+	    toSend = len;
+	} else {
+	    toSend = portalForward->toSend;
+	}
+	bytesWritten = myWrite (portalForward->sock, buf, toSend, SOCK_TYPE,
+	  NULL);
+	if (bytesWritten != toSend) {
+	    if (bytesWritten < 0) {
+		portalForward->status = bytesWritten;
+	    } else {
+		portalForward->status = SYS_COPY_LEN_ERR;
+	    }
+	    break;
+	}
+	buf += toSend;
+	len -= toSend;
+	portalForward->toSend -= toSend;
+	portalForward->offset += toSend;
+    }
+
+    if (portalForward->status < 0 && portalForward->sock >= 0) {
+	rodsLog (LOG_NOTICE,
+	  "forwardPortalData: forward stopped at %lld, status = %d",
+	  portalForward->offset, portalForward->status);
+	CLOSE_SOCK (portalForward->sock);
+	portalForward->sock = -1;
+    }
+    return portalForward->status;
+}
+
+/* closePortalForward - end the forward. If this replica is good (status
+ * >= 0), wait for the next one to say it is done so the replicas down 
+ * the chain are complete when this portal operation returns. Otherwise
+ * just drop the connection.
+ */
+int
+closePortalForward (portalForward_t *portalForward, int status)
+{
+    transferHeader_t myHeader;
+
+    if (portalForward->sock < 0) return portalForward->status;
+
+    if (status >= 0 && portalForward->status >= 0) {
+	portalForward->status = rcvTranHeader (portalForward->sock, &myHeader);
+	if (portalForward->status >= 0 && (myHeader.oprType != DONE_OPR ||
+	  portalForward->toSend > 0)) {
+	    portalForward->status = SYS_COPY_LEN_ERR;
+	}
+    }
+    CLOSE_SOCK (portalForward->sock);
+    portalForward->sock = -1;
+    return portalForward->status;
+}
+
+/* abortChainPortal - a portal of a replication chain is waiting for a
+ * connection that will not come. Connect and drop it so the agent
+ * behind it gives up right away instead of after SELECT_TIMEOUT_FOR_CONN.
+ */
+int
+abortChainPortal (rsComm_t *rsComm, char *chainPortal)
+{
+    portalForward_t portalForward;
+
+    if (openPortalForward (rsComm, chainPortal, &portalForward) < 0)
+	return portalForward.status;
+
+    return closePortalForward (&portalForward, SYS_COPY_LEN_ERR);
+}
+
+/* portalPipeL3Write and portalPipeSockWrite - the write side of the
+ * portal pipe of partialDataPut and partialDataGet */
+static int
+portalPipeL3Write (void *writeArg, char *buf, int len)
+{
+    portalTransferInp_t *myInput = (portalTransferInp_t *) writeArg;
+    int bytesWritten;
+
+    bytesWritten = _l3Write (myInput->rsComm, myInput->destRescTypeInx,
+      myInput->destFd, buf, len);
+    if (bytesWritten == len && myInput->portalForward != NULL)
+	forwardPortalData (myInput->portalForward, buf, len);
+
+    return bytesWritten;
+}
+
+static int
+portalPipeSockWrite (void *writeArg, char *buf, int len)
+{
+    portalTransferInp_t *myInput = (portalTransferInp_t *) writeArg;
+
+    return myWrite (myInput->destFd, buf, len, SOCK_TYPE, NULL);
+}
+
 void
 partialDataPut (portalTransferInp_t *myInput)
 {
@@ -504,6 +977,12 @@ partialDataPut (portalTransferInp_t *myInput)
     int bytesWritten;
     rodsLong_t bytesToGet;
     rodsLong_t myOffset = 0;
+    int zeroCopyFd;
+    int pipeFd[2];
+    portalPipe_t portalPipe;
+    int pipeBufCnt = 0;
+    portalStat_t *portalStat;
+    rodsLong_t waitStart;
 
 #ifdef PARA_TIMING
     time_t startTime, afterSeek, afterTransfer,
@@ -520,6 +999,9 @@ partialDataPut (portalTransferInp_t *myInput)
     destL3descInx = myInput->destFd;
     srcFd = myInput->srcFd;
     destRescTypeInx = myInput->destRescTypeInx;
+    myInput->bytesWritten = 0;
+    portalStat = myInput->portalStat;
+    beginPortalStat (portalStat, myInput->threadNum);
 
     if (myInput->offset != 0) {
         myOffset = _l3Lseek (myInput->rsComm, destRescTypeInx, 
@@ -529,6 +1011,7 @@ partialDataPut (portalTransferInp_t *myInput)
             rodsLog (LOG_NOTICE,
 	      "_partialDataPut: _objSeek error, status = %d ",
               myInput->status);
+	    breakOrderedStreamChksum (myInput->orderedChksum);
 	    if (myInput->threadNum > 0)
                 _l3Close (myInput->rsComm, destRescTypeInx, destL3descInx);
             CLOSE_SOCK (srcFd);
@@ -536,6 +1019,25 @@ partialDataPut (portalTransferInp_t *myInput)
         }
     }
     buf = (char*)malloc (TRANS_BUF_SZ);
+    if (myInput->streamChksum != NULL || myInput->treeChksum != NULL ||
+      myInput->orderedChksum != NULL || myInput->portalForward != NULL) {
+	/* the data has to pass through buf to be chksummed or forwarded */
+	zeroCopyFd = -1;
+    } else {
+        zeroCopyFd = getZeroCopyFd (destL3descInx);
+    }
+    if (zeroCopyFd >= 0 && unixFileOpenSplicePipe (pipeFd) < 0)
+        zeroCopyFd = -1;
+    if (zeroCopyFd < 0 && (pipeBufCnt = getPortalPipeBufCnt ()) > 0) {
+	/* overlap the socket reads with the file writes */
+	if (initPortalPipe (&portalPipe, pipeBufCnt, portalPipeL3Write, 
+	  myInput) < 0) {
+	    pipeBufCnt = 0;
+	} else {
+	    free (buf);
+	    buf = NULL;
+	}
+    }
 
 #ifdef PARA_TIMING
     afterSeek=time(0);
@@ -543,7 +1045,8 @@ partialDataPut (portalTransferInp_t *myInput)
 
     bytesToGet = myInput->size;
 
-    while (bytesToGet > 0) {
+    while (bytesToGet > 0 || getNextPortalChunk (myInput, destRescTypeInx,
+      destL3descInx, &myOffset, &bytesToGet) > 0) {
         int toread0;
         int bytesRead;
 
@@ -559,17 +1062,28 @@ partialDataPut (portalTransferInp_t *myInput)
             toread0 = bytesToGet;
         }
 
+	waitStart = getPortalStatUsec (portalStat);
 	myInput->status = sendTranHeader (srcFd, PUT_OPR, myInput->flags,
 	  myOffset, toread0);
+	addPortalStatUsec (portalStat, PORTAL_STAT_SOCK, waitStart);
 
 	if (myInput->status < 0) {
 	    rodsLog (LOG_NOTICE, 
 	      "partialDataPut: sendTranHeader error. status = %d", 
 	      myInput->status);
+	    if (pipeBufCnt > 0) {
+		endPortalPipe (&portalPipe);
+	    } else {
+	        free (buf);
+	    }
+	    if (zeroCopyFd >= 0) {
+		close (pipeFd[0]);
+		close (pipeFd[1]);
+	    }
+	    breakOrderedStreamChksum (myInput->orderedChksum);
 	    if (myInput->threadNum > 0)
                 _l3Close (myInput->rsComm, destRescTypeInx, destL3descInx);
             CLOSE_SOCK (srcFd);
-	    free (buf);
 	    return;
 	} 
 
@@ -581,13 +1095,59 @@ partialDataPut (portalTransferInp_t *myInput)
 	    } else {
 		toread1 = toread0;
 	    }
-            bytesRead = myRead (srcFd, buf, toread1, SOCK_TYPE, NULL, NULL);
+	    waitStart = getPortalStatUsec (portalStat);
+	    if (pipeBufCnt > 0 && 
+	      (buf = getPortalPipeBuf (&portalPipe)) == NULL) {
+		myInput->status = drainPortalPipe (&portalPipe);
+		break;
+	    }
+	    addPortalStatUsec (portalStat, PORTAL_STAT_DISK, waitStart);
+	    /* a zero copy recv is timed as the socket */
+	    waitStart = getPortalStatUsec (portalStat);
+	    if (zeroCopyFd >= 0) {
+		bytesRead = bytesWritten = unixFileRecvFromSock (zeroCopyFd,
+		  srcFd, toread1, pipeFd, buf);
+		if (bytesRead == SYS_NOT_SUPPORTED) {
+		    /* nothing was read. Use the buffer from now on */
+		    close (pipeFd[0]);
+		    close (pipeFd[1]);
+		    zeroCopyFd = -1;
+		    continue;
+		}
+	    } else {
+                bytesRead = myRead (srcFd, buf, toread1, SOCK_TYPE, NULL, 
+		  NULL);
+	    }
+	    addPortalStatUsec (portalStat, PORTAL_STAT_SOCK, waitStart);
 
 #ifdef PARA_TIMING
             tafterRead=time(0);
 #endif
-            if (bytesRead == toread1) {
-                if ((bytesWritten = _l3Write (myInput->rsComm, destRescTypeInx,
+	    if (bytesRead == toread1 && myInput->streamChksum != NULL) {
+		updateStreamChksum (myInput->streamChksum, myOffset, buf,
+		  bytesRead);
+	    }
+	    if (bytesRead == toread1 && myInput->treeChksum != NULL) {
+		updateTreeStreamChksum (myInput->treeChksum, 
+		  &myInput->treeChunk, myOffset, buf, bytesRead);
+	    }
+	    if (bytesRead == toread1 && myInput->orderedChksum != NULL) {
+		updateOrderedStreamChksum (myInput->orderedChksum, myOffset,
+		  buf, bytesRead);
+	    }
+            if (bytesRead == toread1 && pipeBufCnt > 0) {
+		if ((myInput->status = queuePortalPipeBuf (&portalPipe, 
+		  bytesRead)) < 0) {
+		    break;
+		}
+                bytesToGet -= bytesRead;
+		toread0 -= bytesRead;
+                myOffset += bytesRead;
+		myInput->bytesWritten += bytesRead;
+            } else if (bytesRead == toread1) {
+		waitStart = getPortalStatUsec (portalStat);
+                if (zeroCopyFd < 0 && (bytesWritten = _l3Write (
+		  myInput->rsComm, destRescTypeInx,
 		  destL3descInx, buf, bytesRead)) != bytesRead) {
 		    rodsLog (LOG_NOTICE,
                      "_partialDataPut:Bytes written %d don't match read %d",
@@ -600,9 +1160,15 @@ partialDataPut (portalTransferInp_t *myInput)
                     }
                     break;
                 }
+		addPortalStatUsec (portalStat, PORTAL_STAT_DISK, waitStart);
+		if (myInput->portalForward != NULL) {
+		    forwardPortalData (myInput->portalForward, buf, 
+		      bytesWritten);
+		}
                 bytesToGet -= bytesWritten;
 		toread0 -= bytesWritten;
                 myOffset += bytesWritten;
+		myInput->bytesWritten += bytesWritten;
             } else if (bytesRead < 0) {
                 myInput->status = bytesRead;
                 break;
@@ -623,12 +1189,32 @@ partialDataPut (portalTransferInp_t *myInput)
 	}	/* while loop toread0 */
 	if (myInput->status < 0)
             break;
+	if (pipeBufCnt > 0 && bytesToGet <= 0) {
+	    /* the next chunk may need a seek */
+	    waitStart = getPortalStatUsec (portalStat);
+	    if ((myInput->status = drainPortalPipe (&portalPipe)) < 0)
+		break;
+	    addPortalStatUsec (portalStat, PORTAL_STAT_DISK, waitStart);
+	}
     }           /* while loop bytesToGet */
 #ifdef PARA_TIMING
     afterTransfer=time(0);
 #endif
-    free (buf);
+    waitStart = getPortalStatUsec (portalStat);
+    if (pipeBufCnt > 0) {
+	int status = endPortalPipe (&portalPipe);
+	if (status < 0 && myInput->status >= 0) myInput->status = status;
+    } else {
+        free (buf);
+    }
+    addPortalStatUsec (portalStat, PORTAL_STAT_DISK, waitStart);
+    if (zeroCopyFd >= 0) {
+	close (pipeFd[0]);
+	close (pipeFd[1]);
+    }
+    if (myInput->status < 0) breakOrderedStreamChksum (myInput->orderedChksum);
     sendTranHeader (srcFd, DONE_OPR, 0, 0, 0);
+    endPortalStat (portalStat, srcFd, myInput->bytesWritten);
     if (myInput->threadNum > 0)
         _l3Close (myInput->rsComm, destRescTypeInx, destL3descInx);
     mySockClose (srcFd);
@@ -650,6 +1236,11 @@ partialDataGet (portalTransferInp_t *myInput)
     int bytesWritten;
     rodsLong_t bytesToGet;
     rodsLong_t myOffset = 0;
+    int zeroCopyFd;
+    portalPipe_t portalPipe;
+    int pipeBufCnt = 0;
+    portalStat_t *portalStat;
+    rodsLong_t waitStart;
 
 #ifdef PARA_TIMING
     time_t startTime, afterSeek, afterTransfer,
@@ -666,6 +1257,9 @@ partialDataGet (portalTransferInp_t *myInput)
     srcL3descInx = myInput->srcFd;
     destFd = myInput->destFd;
     srcRescTypeInx = myInput->srcRescTypeInx;
+    myInput->bytesWritten = 0;
+    portalStat = myInput->portalStat;
+    beginPortalStat (portalStat, myInput->threadNum);
 
     if (myInput->offset != 0) {
         myOffset = _l3Lseek (myInput->rsComm, srcRescTypeInx,
@@ -675,6 +1269,7 @@ partialDataGet (portalTransferInp_t *myInput)
             rodsLog (LOG_NOTICE,
               "_partialDataGet: _objSeek error, status = %d ",
               myInput->status);
+            breakOrderedStreamChksum (myInput->orderedChksum);
             if (myInput->threadNum > 0)
                 _l3Close (myInput->rsComm, srcRescTypeInx, srcL3descInx);
             CLOSE_SOCK (destFd);
@@ -682,6 +1277,23 @@ partialDataGet (portalTransferInp_t *myInput)
         }
     }
     buf = (char*)malloc (TRANS_BUF_SZ);
+    if (myInput->streamChksum != NULL || myInput->treeChksum != NULL ||
+      myInput->orderedChksum != NULL) {
+        /* the data has to pass through buf to be chksummed */
+        zeroCopyFd = -1;
+    } else {
+        zeroCopyFd = getZeroCopyFd (srcL3descInx);
+    }
+    if (zeroCopyFd < 0 && (pipeBufCnt = getPortalPipeBufCnt ()) > 0) {
+        /* overlap the file reads with the socket writes */
+        if (initPortalPipe (&portalPipe, pipeBufCnt, portalPipeSockWrite,
+          myInput) < 0) {
+            pipeBufCnt = 0;
+        } else {
+            free (buf);
+            buf = NULL;
+        }
+    }
 
 #ifdef PARA_TIMING
     afterSeek=time(0);
@@ -689,7 +1301,8 @@ partialDataGet (portalTransferInp_t *myInput)
 
     bytesToGet = myInput->size;
 
-    while (bytesToGet > 0) {
+    while (bytesToGet > 0 || getNextPortalChunk (myInput, srcRescTypeInx,
+      srcL3descInx, &myOffset, &bytesToGet) > 0) {
         int toread0;
         int bytesRead;
 
@@ -705,17 +1318,24 @@ partialDataGet (portalTransferInp_t *myInput)
             toread0 = bytesToGet;
         }
 
+        waitStart = getPortalStatUsec (portalStat);
         myInput->status = sendTranHeader (destFd, GET_OPR, myInput->flags,
           myOffset, toread0);
+        addPortalStatUsec (portalStat, PORTAL_STAT_SOCK, waitStart);
 
         if (myInput->status < 0) {
             rodsLog (LOG_NOTICE,
               "partialDataGet: sendTranHeader error. status = %d",
               myInput->status);
+            if (pipeBufCnt > 0) {
+                endPortalPipe (&portalPipe);
+            } else {
+                free (buf);
+            }
+            breakOrderedStreamChksum (myInput->orderedChksum);
             if (myInput->threadNum > 0)
                 _l3Close (myInput->rsComm, srcRescTypeInx, srcL3descInx);
             CLOSE_SOCK (destFd);
-            free (buf);
             return;
         }
 
@@ -727,16 +1347,60 @@ partialDataGet (portalTransferInp_t *myInput)
             } else {
                 toread1 = toread0;
             }
-	    bytesRead = _l3Read (myInput->rsComm, srcRescTypeInx,
-             srcL3descInx, buf, toread1);
+            waitStart = getPortalStatUsec (portalStat);
+            if (pipeBufCnt > 0 &&
+              (buf = getPortalPipeBuf (&portalPipe)) == NULL) {
+                myInput->status = drainPortalPipe (&portalPipe);
+                break;
+            }
+            addPortalStatUsec (portalStat, PORTAL_STAT_SOCK, waitStart);
+            waitStart = getPortalStatUsec (portalStat);
+	    if (zeroCopyFd >= 0) {
+		/* a zero copy send is timed as the socket */
+		bytesRead = bytesWritten = unixFileSendToSock (zeroCopyFd, 
+		  destFd, toread1);
+		addPortalStatUsec (portalStat, PORTAL_STAT_SOCK, waitStart);
+		if (bytesRead == SYS_NOT_SUPPORTED) {
+		    /* nothing was sent. Use the buffer from now on */
+		    zeroCopyFd = -1;
+		    continue;
+		}
+	    } else {
+	        bytesRead = _l3Read (myInput->rsComm, srcRescTypeInx,
+                 srcL3descInx, buf, toread1);
+		addPortalStatUsec (portalStat, PORTAL_STAT_DISK, waitStart);
+	    }
 
 #ifdef PARA_TIMING
             tafterRead=time(0);
 #endif
-            if (bytesRead == toread1) {
-                if ((bytesWritten = myWrite (destFd, buf, bytesRead,
-		  SOCK_TYPE, NULL))
-                  != bytesRead) {
+            if (bytesRead == toread1 && zeroCopyFd < 0) {
+                if (myInput->streamChksum != NULL) {
+                    updateStreamChksum (myInput->streamChksum, myOffset, 
+                      buf, bytesRead);
+                }
+                if (myInput->treeChksum != NULL) {
+                    updateTreeStreamChksum (myInput->treeChksum,
+                      &myInput->treeChunk, myOffset, buf, bytesRead);
+                }
+                if (myInput->orderedChksum != NULL) {
+                    updateOrderedStreamChksum (myInput->orderedChksum, 
+                      myOffset, buf, bytesRead);
+                }
+            }
+            if (bytesRead == toread1 && pipeBufCnt > 0) {
+                if ((myInput->status = queuePortalPipeBuf (&portalPipe,
+                  bytesRead)) < 0) {
+                    break;
+                }
+                bytesToGet -= bytesRead;
+                toread0 -= bytesRead;
+                myOffset += bytesRead;
+                myInput->bytesWritten += bytesRead;
+            } else if (bytesRead == toread1) {
+                waitStart = getPortalStatUsec (portalStat);
+                if (zeroCopyFd < 0 && (bytesWritten = myWrite (destFd, buf, 
+		  bytesRead, SOCK_TYPE, NULL)) != bytesRead) {
                     rodsLog (LOG_NOTICE,
                      "_partialDataGet:Bytes written %d don't match read %d",
                       bytesWritten, bytesRead);
@@ -748,9 +1412,12 @@ partialDataGet (portalTransferInp_t *myInput)
                     }
                     break;
                 }
+                if (zeroCopyFd < 0)
+                    addPortalStatUsec (portalStat, PORTAL_STAT_SOCK, waitStart);
                 bytesToGet -= bytesWritten;
                 toread0 -= bytesWritten;
                 myOffset += bytesWritten;
+                myInput->bytesWritten += bytesWritten;
             } else if (bytesRead < 0) {
                 myInput->status = bytesRead;
                 break;
@@ -771,12 +1438,28 @@ partialDataGet (portalTransferInp_t *myInput)
         }       /* while loop toread0 */
         if (myInput->status < 0)
             break;
+        if (pipeBufCnt > 0) {
+            /* the next header must follow the data on the socket */
+            waitStart = getPortalStatUsec (portalStat);
+            if ((myInput->status = drainPortalPipe (&portalPipe)) < 0)
+                break;
+            addPortalStatUsec (portalStat, PORTAL_STAT_SOCK, waitStart);
+        }
     }           /* while loop bytesToGet */
 #ifdef PARA_TIMING
     afterTransfer=time(0);
 #endif
-    free (buf);
+    waitStart = getPortalStatUsec (portalStat);
+    if (pipeBufCnt > 0) {
+        int status = endPortalPipe (&portalPipe);
+        if (status < 0 && myInput->status >= 0) myInput->status = status;
+    } else {
+        free (buf);
+    }
+    addPortalStatUsec (portalStat, PORTAL_STAT_SOCK, waitStart);
+    if (myInput->status < 0) breakOrderedStreamChksum (myInput->orderedChksum);
     sendTranHeader (destFd, DONE_OPR, 0, 0, 0);
+    endPortalStat (portalStat, destFd, myInput->bytesWritten);
     if (myInput->threadNum > 0)
         _l3Close (myInput->rsComm, srcRescTypeInx, srcL3descInx);
     CLOSE_SOCK (destFd);
@@ -838,6 +1521,11 @@ remToLocPartialCopy (portalTransferInp_t *myInput)
             break;
         }
         if (myHeader.offset != curOffset) {
+	    if (myInput->portalForward != NULL) {
+		/* the forwarded data has to be in order */
+		myInput->portalForward->status = SYS_COPY_LEN_ERR;
+		forwardPortalData (myInput->portalForward, NULL, 0);
+	    }
             curOffset = myHeader.offset;
             myOffset = _l3Lseek (myInput->rsComm, destRescTypeInx,
               destL3descInx, myHeader.offset, SEEK_SET);
@@ -890,6 +1578,10 @@ remToLocPartialCopy (portalTransferInp_t *myInput)
                 }
                 break;
             }
+	    if (myInput->portalForward != NULL) {
+		forwardPortalData (myInput->portalForward, (char *) buf,
+		  bytesWritten);
+	    }
 
             toGet -= bytesWritten;
         }
@@ -1051,7 +1743,18 @@ remLocCopy (rsComm_t *rsComm, dataCopyInp_t *dataCopyInp)
             myInput[0].flags = NO_CHK_COPY_LEN_FLAG;
         }
 	if (oprType == COPY_TO_LOCAL_OPR) {
+	    portalForward_t portalForward;
+	    char *chainPortal;
+
+	    if ((chainPortal = getValByKey (&dataOprInp->condInput,
+	      CHAIN_PORTAL_KW)) != NULL) {
+		/* the head of a replication chain. pass the data on */
+		openPortalForward (rsComm, chainPortal, &portalForward);
+		myInput[0].portalForward = &portalForward;
+	    }
             remToLocPartialCopy (&myInput[0]);
+	    if (myInput[0].portalForward != NULL)
+		closePortalForward (&portalForward, myInput[0].status);
 	} else {
 	    locToRemPartialCopy (&myInput[0]);
 	}
@@ -1327,6 +2030,7 @@ void
 sameHostPartialCopy (portalTransferInp_t *myInput)
 {
     int destL3descInx, srcL3descInx, destRescTypeInx, srcRescTypeInx;
+    int srcFd, destFd;
     void *buf;
     rodsLong_t myOffset = 0;
     rodsLong_t toCopy;
@@ -1378,10 +2082,27 @@ sameHostPartialCopy (portalTransferInp_t *myInput)
         }
     }
 
-    buf = malloc (TRANS_BUF_SZ);
-
     toCopy = myInput->size;
 
+    if ((srcFd = getZeroCopyFd (srcL3descInx)) >= 0 && 
+      (destFd = getZeroCopyFd (destL3descInx)) >= 0) {
+	/* two local unix files. Let the kernel copy or reflink them */
+	rodsLong_t bytesCopied = unixFileCopyRange (srcFd, destFd, toCopy);
+
+	if (bytesCopied >= 0) {
+	    toCopy -= bytesCopied;
+	    myInput->bytesWritten += bytesCopied;
+	} else if (bytesCopied != SYS_NOT_SUPPORTED) {
+	    myInput->status = bytesCopied;
+	    rodsLogError (LOG_ERROR, myInput->status,
+              "sameHostPartialCopy: unixFileCopyRange error");
+	    toCopy = 0;
+	}
+    }
+
+    /* whatever is left goes through buf. Short reads are caught here */
+    buf = malloc (TRANS_BUF_SZ);
+
     while (toCopy > 0) {
         int toRead;
 
@@ -10,6 +10,7 @@
 #include "rodsDef.h"
 #include "rsGlobalExtern.h"
 #include "fileChksum.h"
+#include "streamChksum.h"
 #include "modDataObjMeta.h"
 #include "objMetaOpr.h"
 #include "collection.h"
@@ -21,6 +22,7 @@
 #include "reSysDataObjOpr.h"
 #include "genQuery.h"
 #include "rodsClient.h"
+#include "rcPortalOpr.h"
 #ifdef LOG_TRANSFERS
 #include <sys/time.h>
 #endif
@@ -381,6 +383,7 @@ initDataOprInp (dataOprInp_t *dataOprInp, int l1descInx, int oprType)
 {
     dataObjInfo_t *dataObjInfo;
     dataObjInp_t  *dataObjInp;
+    char *chainPortal;
 #ifdef RBUDP_TRANSFER
     char *tmpStr;
 #endif
@@ -400,6 +403,12 @@ initDataOprInp (dataOprInp_t *dataOprInp, int l1descInx, int oprType)
         dataOprInp->destL3descInx = L1desc[l1descInx].l3descInx;
         if (L1desc[l1descInx].remoteZoneHost == NULL)
             dataOprInp->destRescTypeInx = dataObjInfo->rescInfo->rescTypeInx;
+        if (isStreamChksumNeeded (l1descInx)) {
+            char chksumScheme[NAME_LEN];
+            snprintf (chksumScheme, NAME_LEN, "%d",
+              getL1descChksumScheme (l1descInx));
+            addKeyVal (&dataOprInp->condInput, STREAM_CHKSUM_KW, chksumScheme);
+        }
     } else if (oprType == GET_OPR) {
 	if (dataObjInfo->dataSize > 0) {
             dataOprInp->dataSize = dataObjInfo->dataSize;
@@ -409,6 +418,12 @@ initDataOprInp (dataOprInp_t *dataOprInp, int l1descInx, int oprType)
         dataOprInp->srcL3descInx = L1desc[l1descInx].l3descInx;
         if (L1desc[l1descInx].remoteZoneHost == NULL)
             dataOprInp->srcRescTypeInx = dataObjInfo->rescInfo->rescTypeInx;
+        if (isGetChksumAtClose (l1descInx)) {
+            char chksumScheme[NAME_LEN];
+            snprintf (chksumScheme, NAME_LEN, "%d",
+              getL1descChksumScheme (l1descInx));
+            addKeyVal (&dataOprInp->condInput, STREAM_CHKSUM_KW, chksumScheme);
+        }
     } else if (oprType == SAME_HOST_COPY_OPR) {
 	int srcL1descInx = L1desc[l1descInx].srcL1descInx;
 	int srcL3descInx = L1desc[srcL1descInx].l3descInx;
@@ -471,6 +486,26 @@ initDataOprInp (dataOprInp_t *dataOprInp, int l1descInx, int oprType)
         addKeyVal (&dataOprInp->condInput, NO_PARA_OP_KW, "");
     }
 
+    if ((oprType == PUT_OPR || oprType == GET_OPR) &&
+      getValByKey (&dataObjInp->condInput, PORTAL_STAT_KW) != NULL) {
+        /* the client wants the statistics of the server side */
+        addKeyVal (&dataOprInp->condInput, PORTAL_STAT_KW, "");
+    }
+
+    if ((oprType == PUT_OPR || oprType == COPY_TO_LOCAL_OPR) &&
+      (chainPortal = getValByKey (&dataObjInp->condInput, CHAIN_PORTAL_KW)) 
+      != NULL) {
+	/* the receiving end forwards the data down a replication chain */
+        addKeyVal (&dataOprInp->condInput, CHAIN_PORTAL_KW, chainPortal);
+    }
+
+    /* remLocCopy follows the chunk offsets. For a put or get it is up
+     * to the client */
+    if (oprType == COPY_TO_REM_OPR || oprType == COPY_TO_LOCAL_OPR ||
+      getValByKey (&dataObjInp->condInput, DYN_PORTAL_CHUNK_KW) != NULL) {
+        addKeyVal (&dataOprInp->condInput, DYN_PORTAL_CHUNK_KW, "");
+    }
+
 #ifdef RBUDP_TRANSFER
     if (getValByKey (&dataObjInp->condInput, RBUDP_TRANSFER_KW) != NULL) {
 	if (dataObjInfo->rescInfo != NULL) {
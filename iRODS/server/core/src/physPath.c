@@ -480,9 +480,20 @@ dataObjChksum (rsComm_t *rsComm, int l1descInx, keyValPair_t *regParam)
 }
 #endif
 
+/* _dataObjChksum - chksum the data of inpDataObjInfo with the scheme of
+ * its registered chksum or the default scheme if it has none.
+ */
 int 
 _dataObjChksum (rsComm_t *rsComm, dataObjInfo_t *inpDataObjInfo, 
 char **chksumStr)
+{
+    return _dataObjChksumByScheme (rsComm, inpDataObjInfo, chksumStr,
+      getChksumScheme (inpDataObjInfo->chksum));
+}
+
+int
+_dataObjChksumByScheme (rsComm_t *rsComm, dataObjInfo_t *inpDataObjInfo,
+char **chksumStr, int chksumScheme)
 {
     fileChksumInp_t fileChksumInp;
     int rescTypeInx;
@@ -493,6 +504,11 @@ char **chksumStr)
     int destL1descInx = -1;
     rescInfo_t *cacheResc;
 
+    /* resolve the default here. The resource server may have another */
+    if (chksumScheme == DEF_CHKSUM_SCHEME)
+        chksumScheme = getDefChksumScheme ();
+    if (chksumScheme < 0) return chksumScheme;
+
     rescClass = getRescClass (rescInfo);
     if (rescClass == COMPOUND_CL) {
 #if 0
@@ -547,6 +563,7 @@ char **chksumStr)
         rstrcpy (fileChksumInp.addr.hostAddr, rescInfo->rescLoc,
           NAME_LEN);
         rstrcpy (fileChksumInp.fileName, dataObjInfo->filePath, MAX_NAME_LEN);
+        fileChksumInp.flag = chksumScheme;
 	status = rsFileChksum (rsComm, &fileChksumInp, chksumStr);
         break;
       default:
@@ -563,12 +580,27 @@ char **chksumStr)
     return (status);
 }
 
+/* chksumMismatch - whether the computed chksum differs from the expected
+ * one. A resource server older than the chksum schemes ignores the scheme
+ * asked for and returns an md5. Digests of different schemes cannot be
+ * compared, so that is not a mismatch. The computed one is still good.
+ */
+int
+chksumMismatch (char *objPath, char *expected, char *computed)
+{
+    if (getChksumScheme (expected) != getChksumScheme (computed)) {
+        rodsLog (LOG_NOTICE,
+         "chksumMismatch: scheme differs for %s. exp=%s, comp=%s, not verified",
+          objPath, expected, computed);
+        return 0;
+    }
+    return (strcmp (expected, computed) != 0);
+}
+
 int
 dataObjChksumAndReg (rsComm_t *rsComm, dataObjInfo_t *dataObjInfo, 
 char **chksumStr) 
 {
-    keyValPair_t regParam;
-    modDataObjMeta_t modDataObjMetaInp;
     int status;
 
     status = _dataObjChksum (rsComm, dataObjInfo, chksumStr);
@@ -579,9 +611,20 @@ char **chksumStr)
         return (status);
     }
 
-    /* register it */
+    return regDataObjChksum (rsComm, dataObjInfo, *chksumStr);
+}
+
+/* regDataObjChksum - register chksumStr as the chksum of dataObjInfo */
+int
+regDataObjChksum (rsComm_t *rsComm, dataObjInfo_t *dataObjInfo,
+char *chksumStr)
+{
+    keyValPair_t regParam;
+    modDataObjMeta_t modDataObjMetaInp;
+    int status;
+
     memset (&regParam, 0, sizeof (regParam));
-    addKeyVal (&regParam, CHKSUM_KW, *chksumStr);
+    addKeyVal (&regParam, CHKSUM_KW, chksumStr);
 
     modDataObjMetaInp.dataObjInfo = dataObjInfo;
     modDataObjMetaInp.regParam = &regParam;
@@ -592,7 +635,7 @@ char **chksumStr)
 
     if (status < 0) {
         rodsLog (LOG_NOTICE,
-         "dataObjChksumAndReg: rsModDataObjMeta error for %s, status = %d",
+         "regDataObjChksum: rsModDataObjMeta error for %s, status = %d",
          dataObjInfo->objPath, status);
 	/* don't return error because it is not fatal */
     }
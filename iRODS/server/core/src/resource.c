@@ -5,6 +5,7 @@
 #include "resource.h"
 #include "genQuery.h"
 #include "rodsClient.h"
+#include "svrCfgSnap.h"
 
 /* getRescInfo - Given the rescName or rescgrpName in condInput keyvalue
  * pair or defaultResc, return the rescGrpInfo containing the info on
@@ -1145,6 +1146,11 @@ initResc (rsComm_t *rsComm)
         RescGrpInfo = NULL;
     }
 
+    if (isSvrCfgSnapLoaded ()) {
+        clearGenQueryInp (&genQueryInp);
+        return (initRescFromSnap ());
+    }
+
     continueInx = 1;	/* a fake one so it will do the first query */
     while (continueInx > 0) {
         status =  rsGenQuery (rsComm, &genQueryInp, &genQueryOut);
@@ -1159,6 +1165,8 @@ initResc (rsComm_t *rsComm)
             return (status);
         }
 
+        addSvrCfgSnapResult (SVR_CFG_RESC_SLOT, genQueryOut);
+
         status = procAndQueRescResult (genQueryOut);
 
         if (status < 0) {
@@ -1180,6 +1188,36 @@ initResc (rsComm_t *rsComm)
     return (status);
 }
 
+/* initRescFromSnap - same as initResc () but the query results come
+ * from the shared snapshot of the resource config (svrCfgSnap.c).
+ */
+
+int
+initRescFromSnap ()
+{
+    genQueryOut_t *genQueryOut = NULL;
+    int status = 0;
+    int i;
+
+    for (i = 0; ; i++) {
+        status = getSvrCfgSnapResult (SVR_CFG_RESC_SLOT, i, &genQueryOut);
+        if (status < 0) {
+            /* no more pages */
+            if (status == CAT_NO_ROWS_FOUND && i > 0) status = 0;
+            break;
+        }
+        status = procAndQueRescResult (genQueryOut);
+        freeGenQueryOut (&genQueryOut);
+        if (status < 0) {
+            rodsLog (LOG_NOTICE,
+              "initRescFromSnap: procAndQueRescResult error, status = %d",
+              status);
+            break;
+        }
+    }
+    return (status);
+}
+
 /* procAndQueRescResult - Process the query results from initResc ().
  * Queue the results in the global resource link list RescGrpInfo.
  */
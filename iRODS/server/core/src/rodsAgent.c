@@ -10,11 +10,17 @@
 #include "rsApiHandler.h"
 #include "icatHighLevelRoutines.h"
 #include "miscServerFunct.h"
+#include "agentPool.h"
+#include "rsIcatOpr.h"
 #ifdef windows_platform
 #include "rsLog.h"
 static void NtAgentSetEnvsFromArgs(int ac, char **av);
 #endif
 
+/* set when the session did a GSI/KRB/SSL handshake. A pooled agent does
+ * not take another client after such a session */
+static int NoAgentReuse = 0;
+
 /* #define SERVER_DEBUG 1   */
 int
 main(int argc, char *argv[])
@@ -22,6 +28,7 @@ main(int argc, char *argv[])
     int status;
     rsComm_t rsComm;
     char *tmpStr;
+    char *poolSockStr;
 
     ProcessType = AGENT_PT;
 
@@ -62,11 +69,17 @@ main(int argc, char *argv[])
 
     memset (&rsComm, 0, sizeof (rsComm));
 
-    status = initRsCommWithStartupPack (&rsComm, NULL);
+    /* a pooled agent is started before any client connects and gets its
+     * connections from the server through this socket */
+    poolSockStr = getenv (SP_AGENT_POOL_SOCK);
 
-    if (status < 0) {
-	sendVersion (rsComm.sock, status, 0, NULL, 0);
-        cleanupAndExit (status);
+    if (poolSockStr == NULL) {
+        status = initRsCommWithStartupPack (&rsComm, NULL);
+
+        if (status < 0) {
+	    sendVersion (rsComm.sock, status, 0, NULL, 0);
+            cleanupAndExit (status);
+        }
     }
 
     /* Handle option to log sql commands */
@@ -95,6 +108,11 @@ main(int argc, char *argv[])
     openlog("rodsAgent",LOG_ODELAY|LOG_PID,LOG_DAEMON);
 #endif
 
+    if (poolSockStr != NULL) {
+        status = agentPoolMain (&rsComm, atoi (poolSockStr));
+        cleanupAndExit (status);
+    }
+
     status = getRodsEnv (&rsComm.myEnv);
 
     if (status < 0) {
@@ -109,12 +127,9 @@ main(int argc, char *argv[])
 #endif
 
 #ifdef RULE_ENGINE_N
-    status = initAgent (RULE_ENGINE_TRY_CACHE, &rsComm);
+    status = initAgentEnv (RULE_ENGINE_TRY_CACHE, &rsComm);
 #else
-    status = initAgent (&rsComm);
-#endif
-#ifdef SYS_TIMING
-    printSysTiming ("irodsAgent", "initAgent", 0);
+    status = initAgentEnv (&rsComm);
 #endif
 
     if (status < 0) {
@@ -126,39 +141,205 @@ main(int argc, char *argv[])
      * the user does not specify one in the input */
     initConnectControl ();
 
-    if (rsComm.clientUser.userName[0] != '\0') {
-        status = chkAllowedUser (rsComm.clientUser.userName,
-         rsComm.clientUser.rodsZone);
+    status = serveAgentSession (&rsComm);
+
+    cleanupAndExit (status);
+
+    return (status);
+}
+
+/* serveAgentSession - finish the client dependent initialization, send
+ * the version to the client and process its requests until it 
+ * disconnects.
+ */
+int
+serveAgentSession (rsComm_t *rsComm)
+{
+    int status;
+
+    status = initAgentSession (rsComm);
+#ifdef SYS_TIMING
+    printSysTiming ("irodsAgent", "initAgent", 0);
+#endif
+
+    if (status < 0) {
+	sendVersion (rsComm->sock, SYS_AGENT_INIT_ERR, 0, NULL, 0);
+        return (status);
+    }
+
+    if (rsComm->clientUser.userName[0] != '\0') {
+        status = chkAllowedUser (rsComm->clientUser.userName,
+         rsComm->clientUser.rodsZone);
 
         if (status < 0) {
-            sendVersion (rsComm.sock, status, 0, NULL, 0);
-            cleanupAndExit (status);
+            sendVersion (rsComm->sock, status, 0, NULL, 0);
+            return (status);
 	}
     }
 
     /* send the server version and atatus as part of the protocol. Put
-     * rsComm.reconnPort as the status */
+     * rsComm->reconnPort as the status */
 
-    status = sendVersion (rsComm.sock, status, rsComm.reconnPort,
-      rsComm.reconnAddr, rsComm.cookie);
+    status = sendVersion (rsComm->sock, status, rsComm->reconnPort,
+      rsComm->reconnAddr, rsComm->cookie);
 
     if (status < 0) {
-	sendVersion (rsComm.sock, SYS_AGENT_INIT_ERR, 0, NULL, 0);
-        cleanupAndExit (status);
+	sendVersion (rsComm->sock, SYS_AGENT_INIT_ERR, 0, NULL, 0);
+        return (status);
     }
 #ifdef SYS_TIMING
     printSysTiming ("irodsAgent", "sendVersion", 0);
 #endif
 
-    logAgentProc (&rsComm);
+    logAgentProc (rsComm);
 
-    status = agentMain (&rsComm);
+    status = agentMain (rsComm);
 
-    cleanupAndExit (status);
+    return (status);
+}
+
+/* agentPoolMain - main loop of a pooled agent. Do the client independent
+ * initialization once, then serve up to agentPoolMaxSess clients handed
+ * over by the server through poolSock before exiting. 
+ */
+int
+agentPoolMain (rsComm_t *rsComm, int poolSock)
+{
+    int status;
+    int newSock;
+    int sessCnt, maxSess;
+    agentPoolReq_t poolReq;
+    rsComm_t initComm;
+    char *localZone;
+
+    status = getRodsEnv (&rsComm->myEnv);
+
+    if (status < 0) {
+        rodsLog (LOG_ERROR,
+          "agentPoolMain: getRodsEnv error. status = %d", status);
+        return (status);
+    }
+
+#if RODS_CAT
+    if (strstr(rsComm->myEnv.rodsDebug, "CAT") != NULL) {
+       chlDebug(rsComm->myEnv.rodsDebug);
+    }
+#endif
+
+#ifdef RULE_ENGINE_N
+    status = initAgentEnv (RULE_ENGINE_TRY_CACHE, rsComm);
+#else
+    status = initAgentEnv (rsComm);
+#endif
+    if (status < 0) {
+        rodsLog (LOG_ERROR,
+          "agentPoolMain: initAgentEnv error. status = %d", status);
+        return (status);
+    }
+    initConnectControl ();
 
+    /* the client independent state to start each session with */
+    initComm = *rsComm;
+    maxSess = getAgentPoolMaxSess ();
+
+    for (sessCnt = 0; sessCnt < maxSess; sessCnt++) {
+        status = sendPoolAgentMsg (poolSock, POOL_AGENT_READY_MSG);
+        if (status < 0) break;
+
+        status = recvSockFromServer (poolSock, &newSock, &poolReq);
+        if (status < 0) {
+            /* the server has closed the pool */
+            status = 0;
+            break;
+        }
+
+        *rsComm = initComm;
+        rsComm->sock = newSock;
+        status = initRsCommWithStartupPack (rsComm, &poolReq.startupPack);
+        if (status < 0) {
+            /* as an exec'ed agent would, but stay for the next client */
+            rodsLog (LOG_NOTICE,
+              "agentPoolMain: initRsCommWithStartupPack error. status = %d",
+              status);
+            sendVersion (rsComm->sock, status, 0, NULL, 0);
+            close (newSock);
+            rsComm->sock = -1;
+            continue;
+        }
+        /* an exec'ed agent adds this hop in initRsCommWithStartupPack */
+        rsComm->connectCnt ++;
+        /* initZone fills in the zone of an exec'ed agent */
+        if ((localZone = getLocalZoneName ()) != NULL) {
+            if (strlen (rsComm->proxyUser.rodsZone) == 0)
+                rstrcpy (rsComm->proxyUser.rodsZone, localZone, NAME_LEN);
+            if (strlen (rsComm->clientUser.rodsZone) == 0)
+                rstrcpy (rsComm->clientUser.rodsZone, localZone, NAME_LEN);
+        }
+
+        status = serveAgentSession (rsComm);
+        if (status < 0) {
+            rodsLog (LOG_NOTICE,
+              "agentPoolMain: session for %s from %s ended with status %d",
+              rsComm->clientUser.userName, rsComm->clientAddr, status);
+        }
+
+        if (chkAgentSessionReuse (rsComm) == 0) {
+            /* let cleanupAndExit take care of it */
+            break;
+        }
+        endAgentSession (rsComm);
+    }
+
+    close (poolSock);
     return (status);
 }
 
+/* chkAgentSessionReuse - return 1 if the agent can go back to the pool
+ * after this session. Sessions with a reconnect thread or a GSI/KRB/SSL
+ * context cannot be cleaned up in place */
+int
+chkAgentSessionReuse (rsComm_t *rsComm)
+{
+    if (NoAgentReuse != 0) return 0;
+    if (rsComm->reconnFlag == RECONN_TIMEOUT) return 0;
+#ifdef USE_SSL
+    if (rsComm->ssl != NULL) return 0;
+#endif
+    return 1;
+}
+
+/* endAgentSession - release everything the session left behind so that
+ * the next client starts with a clean agent */
+int
+endAgentSession (rsComm_t *rsComm)
+{
+    int i;
+
+    closeAllL1desc (rsComm);
+    for (i = 3; i < NUM_L1_DESC; i++) {
+        if (L1desc[i].inuseFlag == FD_INUSE) freeL1desc (i);
+    }
+    for (i = 1; i < NUM_SPEC_COLL_DESC; i++) {
+        if (SpecCollDesc[i].inuseFlag == FD_INUSE) freeSpecCollDesc (i);
+    }
+    for (i = 0; i < NUM_COLL_HANDLE; i++) {
+        if (CollHandle[i].inuseFlag == FD_INUSE) freeCollHandle (i);
+    }
+    disconnectAllSvrToSvrConn ();
+#ifdef RODS_CAT
+    resetRcatSession (rsComm);
+#endif
+    freeRErrorContent (&rsComm->rError);
+
+    if (rsComm->sock > 0) {
+        close (rsComm->sock);
+        rsComm->sock = -1;
+    }
+    rmProcLog (getpid ());
+
+    return (0);
+}
+
 int 
 agentMain (rsComm_t *rsComm)
 {
@@ -170,16 +351,19 @@ agentMain (rsComm_t *rsComm)
         if (rsComm->gsiRequest==1) {
 	    status = igsiServersideAuth(rsComm) ;
 	    rsComm->gsiRequest=0; 
+	    NoAgentReuse = 1;
         }
         if (rsComm->gsiRequest==2) {
 	    status = ikrbServersideAuth(rsComm) ;
 	    rsComm->gsiRequest=0; 
+	    NoAgentReuse = 1;
         }
 
 #ifdef USE_SSL
         if (rsComm->ssl_do_accept) {
             status = sslAccept(rsComm);
             rsComm->ssl_do_accept = 0;
+	    NoAgentReuse = 1;
         }
         if (rsComm->ssl_do_shutdown) {
             status = sslShutdown(rsComm);
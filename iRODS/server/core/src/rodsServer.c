@@ -4,6 +4,8 @@
 #include "rodsServer.h"
 #include "resource.h"
 #include "miscServerFunct.h"
+#include "agentPool.h"
+#include "svrCfgSnap.h"
 
 #include <syslog.h>
 
@@ -28,6 +30,10 @@ agentProc_t *ConnReqHead = NULL;
 agentProc_t *SpawnReqHead = NULL;
 agentProc_t *BadReqHead = NULL;
 
+/* the pool of pre-started agents */
+poolAgent_t AgentPool[MAX_AGENT_POOL_SIZE];
+int AgentPoolSize = 0;
+
 #if 0	/* defined in config.mk */
 #define USE_BOOST 
 #define USE_BOOST_COND
@@ -40,12 +46,14 @@ agentProc_t *BadReqHead = NULL;
 	#include <boost/thread/condition.hpp>
 	boost::mutex		  ConnectedAgentMutex;
 	boost::mutex		  BadReqMutex;
+	boost::mutex		  AgentPoolMutex;
 	boost::thread*		  ReadWorkerThread[NUM_READ_WORKER_THR];
 	boost::thread*		  SpawnManagerThread;
 	boost::thread*		  PurgeLockFileThread;
 	#else
 	pthread_mutex_t ConnectedAgentMutex;
 	pthread_mutex_t BadReqMutex;
+	pthread_mutex_t AgentPoolMutex;
 	pthread_t       ReadWorkerThread[NUM_READ_WORKER_THR];
 	pthread_t       SpawnManagerThread;
 	pthread_t	PurgeLockFileThread;
@@ -285,6 +293,7 @@ serverMain (char *logDir)
     FD_ZERO(&sockMask);
 
     SvrSock = svrComm.sock;
+    initAgentPool ();
     while (1) {		/* infinite loop */
         FD_SET(svrComm.sock, &sockMask);
         while ((numSock = select (svrComm.sock + 1, &sockMask, 
@@ -398,7 +407,10 @@ procChildren (agentProc_t **agentProcHead)
 #ifndef _WIN32
     while ((childPid = waitpid (-1, &status, WNOHANG | WUNTRACED)) > 0) {
 	tmpAgentProc = getAgentProcByPid (childPid, agentProcHead);
-	if (tmpAgentProc != NULL) {
+	if (procPoolAgentExit (childPid) > 0 && tmpAgentProc == NULL) {
+	    rodsLog (LOG_NOTICE, "Pooled agent process %d exited with status %d",
+	      childPid, status);
+	} else if (tmpAgentProc != NULL) {
 	    rodsLog (LOG_NOTICE, "Agent process %d exited with status %d", 
 	      childPid, status);
 	    free (tmpAgentProc);
@@ -472,31 +484,11 @@ spawnAgent (agentProc_t *connReq, agentProc_t **agentProcHead)
     if (childPid < 0) {
 	return SYS_FORK_ERROR -errno;
     } else if (childPid == 0) {	/* child */
-	agentProc_t *tmpAgentProc;
-	close (SvrSock);
 #ifdef SYS_TIMING
         printSysTiming ("irodsAent", "after fork", 0);
         initSysTiming ("irodsAent", "after fork", 1);
 #endif
-	/* close any socket still in the queue */
-#ifndef SINGLE_SVR_THR
-	/* These queues may be inconsistent because of the multi-threading 
-         * of the parent. set sock to -1 if it has been closed */
-	tmpAgentProc = ConnReqHead;
-	while (tmpAgentProc != NULL) {
-	    if (tmpAgentProc->sock == -1) break;
-	    close (tmpAgentProc->sock);
-	    tmpAgentProc->sock = -1;
-	    tmpAgentProc = tmpAgentProc->next;
-	}
-        tmpAgentProc = SpawnReqHead;
-        while (tmpAgentProc != NULL) {
-	    if (tmpAgentProc->sock == -1) break;
-            close (tmpAgentProc->sock);
-	    tmpAgentProc->sock = -1;
-            tmpAgentProc = tmpAgentProc->next;
-        }
-#endif
+	closeInheritedSock ();
 	execAgent (newSock, startupPack);
     } else {			/* parent */
 #ifdef SYS_TIMING
@@ -512,6 +504,46 @@ spawnAgent (agentProc_t *connReq, agentProc_t **agentProcHead)
     return (childPid);
 }
 
+/* closeInheritedSock - called by a newly forked agent to close the 
+ * listening socket, any socket still in the queues and the control 
+ * sockets of the agent pool */
+int
+closeInheritedSock ()
+{
+#ifndef windows_platform
+    agentProc_t *tmpAgentProc;
+    int i;
+
+    close (SvrSock);
+    /* close any socket still in the queue */
+#ifndef SINGLE_SVR_THR
+    /* These queues may be inconsistent because of the multi-threading 
+     * of the parent. set sock to -1 if it has been closed */
+    tmpAgentProc = ConnReqHead;
+    while (tmpAgentProc != NULL) {
+	if (tmpAgentProc->sock == -1) break;
+	close (tmpAgentProc->sock);
+	tmpAgentProc->sock = -1;
+	tmpAgentProc = tmpAgentProc->next;
+    }
+    tmpAgentProc = SpawnReqHead;
+    while (tmpAgentProc != NULL) {
+	if (tmpAgentProc->sock == -1) break;
+        close (tmpAgentProc->sock);
+	tmpAgentProc->sock = -1;
+        tmpAgentProc = tmpAgentProc->next;
+    }
+#endif
+    for (i = 0; i < AgentPoolSize; i++) {
+	if (AgentPool[i].ctrlSock >= 0) {
+	    close (AgentPool[i].ctrlSock);
+	    AgentPool[i].ctrlSock = -1;
+	}
+    }
+#endif
+    return (0);
+}
+
 int
 execAgent (int newSock, startupPack_t *startupPack)
 {
@@ -888,6 +920,9 @@ initServerMain (rsComm_t *svrComm)
 
     setRsCommFromRodsEnv (svrComm);
 
+    /* start with a fresh snapshot of the zone/resource config */
+    removeSvrCfgSnap (svrComm);
+
     status = initServer (svrComm);
 
     if (status < 0) {
@@ -991,6 +1026,7 @@ initConnThreadEnv ()
     pthread_mutex_init (&ConnectedAgentMutex, NULL);
     pthread_mutex_init (&SpawnReqCondMutex, NULL);
     pthread_mutex_init (&BadReqMutex, NULL);
+    pthread_mutex_init (&AgentPoolMutex, NULL);
     pthread_cond_init (&ReadReqCond, NULL);
     pthread_cond_init (&SpawnReqCond, NULL);
     #endif
@@ -1198,6 +1234,23 @@ spawnManagerTask ()
 	    pthread_mutex_unlock (&SpawnReqCondMutex);
 	    #endif
 #endif
+            status = dispatchToPoolAgent (mySpawnReq);
+            if (status > 0) {
+                close (mySpawnReq->sock);
+                rodsLog (LOG_NOTICE,
+                 "Pooled agent process %d took puser=%s and cuser=%s from %s",
+                  mySpawnReq->pid, mySpawnReq->startupPack.proxyUser,
+                  mySpawnReq->startupPack.clientUser,
+                  inet_ntoa (mySpawnReq->remoteAddr.sin_addr));
+#ifndef SINGLE_SVR_THR
+	        #ifdef USE_BOOST_COND
+	        spwn_req_lock.lock();
+	        #else
+	        pthread_mutex_lock (&SpawnReqCondMutex);
+	        #endif
+#endif
+                continue;
+            }
             status = spawnAgent (mySpawnReq, &ConnectedAgentHead);
             close (mySpawnReq->sock);
 
@@ -1272,6 +1325,16 @@ procSingleConnReq (agentProc_t *connReq)
 
     connReq->startupPack = *startupPack;
     free (startupPack);
+    status = dispatchToPoolAgent (connReq);
+    if (status > 0) {
+        close (newSock);
+        rodsLog (LOG_NOTICE,
+         "Pooled agent process %d took puser=%s and cuser=%s from %s",
+          connReq->pid, connReq->startupPack.proxyUser,
+          connReq->startupPack.clientUser,
+          inet_ntoa (connReq->remoteAddr.sin_addr));
+        return status;
+    }
     status = spawnAgent (connReq, &ConnectedAgentHead);
 
 #ifndef windows_platform
@@ -1336,3 +1399,235 @@ purgeLockFileWorkerTask ()
     }
 }
 
+
+/* initAgentPool - start the pool of pre-initialized agents if
+ * agentPoolSize is configured */
+int
+initAgentPool ()
+{
+    int i;
+
+    AgentPoolSize = getAgentPoolSize ();
+    for (i = 0; i < MAX_AGENT_POOL_SIZE; i++) {
+	memset (&AgentPool[i], 0, sizeof (poolAgent_t));
+	AgentPool[i].ctrlSock = -1;
+    }
+    if (AgentPoolSize <= 0) return 0;
+
+    rodsLog (LOG_NOTICE,
+      "initAgentPool: starting %d pooled agents, %d sessions per agent",
+      AgentPoolSize, getAgentPoolMaxSess ());
+
+    return (replenishAgentPool ());
+}
+
+/* replenishAgentPool - start an agent in every free slot of the pool.
+ * The caller must hold AgentPoolMutex */
+int
+replenishAgentPool ()
+{
+    int i;
+    int status = 0;
+
+    for (i = 0; i < AgentPoolSize; i++) {
+	if (AgentPool[i].state != POOL_AGENT_FREE) continue;
+	status = startPoolAgent (&AgentPool[i]);
+	if (status < 0) {
+	    rodsLog (LOG_ERROR,
+	      "replenishAgentPool: startPoolAgent error, status = %d", status);
+	    break;
+	}
+    }
+    return (status);
+}
+
+/* startPoolAgent - fork and exec an agent which initializes itself and
+ * then waits for connections on its end of a socketpair */
+int
+startPoolAgent (poolAgent_t *poolAgent)
+{
+#ifndef windows_platform
+    int sv[2];
+    int childPid;
+    char *myArgv[2];
+    char buf[NAME_LEN];
+
+    if (socketpair (AF_UNIX, SOCK_STREAM, 0, sv) < 0) {
+	return SYS_AGENT_POOL_ERR - errno;
+    }
+
+    childPid = fork ();
+    if (childPid < 0) {
+	close (sv[0]);
+	close (sv[1]);
+	return SYS_FORK_ERROR - errno;
+    } else if (childPid == 0) {	/* child */
+	closeInheritedSock ();
+	close (sv[0]);
+	mySetenvInt (SP_AGENT_POOL_SOCK, sv[1]);
+	mySetenvInt (SERVER_BOOT_TIME, ServerBootTime);
+	rstrcpy (buf, AGENT_EXE, NAME_LEN);
+	myArgv[0] = buf;
+	myArgv[1] = NULL;
+	execv (myArgv[0], myArgv);
+	rodsLog (LOG_ERROR, "startPoolAgent: execv error errno=%d", errno);
+	exit (1);
+    }
+
+    /* parent */
+    close (sv[1]);
+    poolAgent->pid = childPid;
+    poolAgent->ctrlSock = sv[0];
+    poolAgent->state = POOL_AGENT_STARTING;
+    poolAgent->sessCnt = 0;
+    return (childPid);
+#else
+    return SYS_NOT_SUPPORTED;
+#endif
+}
+
+/* procAgentPoolMsg - poll the control sockets of the pool and update
+ * the state of the agents that are ready for a new connection. An agent
+ * that finished a session is removed from ConnectedAgentHead.
+ * The caller must hold AgentPoolMutex */
+int
+procAgentPoolMsg ()
+{
+#ifndef windows_platform
+    fd_set sockMask;
+    struct timeval tv;
+    int maxSock = -1;
+    int i, status, msg;
+    agentProc_t *tmpAgentProc;
+
+    FD_ZERO (&sockMask);
+    for (i = 0; i < AgentPoolSize; i++) {
+	if (AgentPool[i].ctrlSock < 0) continue;
+	FD_SET (AgentPool[i].ctrlSock, &sockMask);
+	if (AgentPool[i].ctrlSock > maxSock) maxSock = AgentPool[i].ctrlSock;
+    }
+    if (maxSock < 0) return 0;
+
+    tv.tv_sec = 0;
+    tv.tv_usec = 0;
+    status = select (maxSock + 1, &sockMask, NULL, NULL, &tv);
+    if (status <= 0) return 0;
+
+    for (i = 0; i < AgentPoolSize; i++) {
+	if (AgentPool[i].ctrlSock < 0 || 
+	  !FD_ISSET (AgentPool[i].ctrlSock, &sockMask)) continue;
+	status = readPoolAgentMsg (AgentPool[i].ctrlSock, &msg);
+	if (status <= 0) {
+	    /* the agent is exiting. procChildren frees the slot */
+	    close (AgentPool[i].ctrlSock);
+	    AgentPool[i].ctrlSock = -1;
+	    AgentPool[i].state = POOL_AGENT_EXITING;
+	    continue;
+	}
+	if (msg != POOL_AGENT_READY_MSG) continue;
+	if (AgentPool[i].state == POOL_AGENT_BUSY) {
+	    tmpAgentProc = getAgentProcByPid (AgentPool[i].pid, 
+	      &ConnectedAgentHead);
+	    if (tmpAgentProc != NULL) free (tmpAgentProc);
+	}
+	AgentPool[i].state = POOL_AGENT_IDLE;
+    }
+#endif
+    return 0;
+}
+
+/* dispatchToPoolAgent - hand connReq to an idle pooled agent.
+ * Returns the pid of the agent, 0 if no pooled agent is available (the
+ * caller should spawn a new agent) or a negative error. */
+int
+dispatchToPoolAgent (agentProc_t *connReq)
+{
+    int i, status;
+    int childPid = 0;
+    agentPoolReq_t poolReq;
+
+    if (connReq == NULL) return USER__NULL_INPUT_ERR;
+    if (AgentPoolSize <= 0) return 0;
+
+#ifndef SINGLE_SVR_THR
+    #ifdef USE_BOOST
+    boost::unique_lock< boost::mutex > pool_lock( AgentPoolMutex );
+    #else
+    pthread_mutex_lock (&AgentPoolMutex);
+    #endif
+#endif
+
+    procAgentPoolMsg ();
+
+    memset (&poolReq, 0, sizeof (poolReq));
+    poolReq.startupPack = connReq->startupPack;
+    poolReq.remoteAddr = connReq->remoteAddr;
+
+    for (i = 0; i < AgentPoolSize; i++) {
+	if (AgentPool[i].state != POOL_AGENT_IDLE) continue;
+	status = sendSockToPoolAgent (AgentPool[i].ctrlSock, connReq->sock,
+	  &poolReq);
+	if (status < 0) {
+	    /* don't use this one again. procChildren frees the slot */
+	    close (AgentPool[i].ctrlSock);
+	    AgentPool[i].ctrlSock = -1;
+	    AgentPool[i].state = POOL_AGENT_EXITING;
+	    continue;
+	}
+	AgentPool[i].state = POOL_AGENT_BUSY;
+	AgentPool[i].sessCnt ++;
+	childPid = AgentPool[i].pid;
+	break;
+    }
+
+    replenishAgentPool ();
+
+#ifndef SINGLE_SVR_THR
+    #ifdef USE_BOOST
+    pool_lock.unlock();
+    #else
+    pthread_mutex_unlock (&AgentPoolMutex);
+    #endif
+#endif
+
+    if (childPid > 0) {
+	queConnectedAgentProc (childPid, connReq, &ConnectedAgentHead);
+    }
+    return (childPid);
+}
+
+/* procPoolAgentExit - free the pool slot of an exited agent. Returns 1
+ * if childPid was a pooled agent */
+int
+procPoolAgentExit (int childPid)
+{
+    int i;
+    int found = 0;
+
+    if (AgentPoolSize <= 0) return 0;
+
+#ifndef SINGLE_SVR_THR
+    #ifdef USE_BOOST
+    boost::unique_lock< boost::mutex > pool_lock( AgentPoolMutex );
+    #else
+    pthread_mutex_lock (&AgentPoolMutex);
+    #endif
+#endif
+    for (i = 0; i < AgentPoolSize; i++) {
+	if (AgentPool[i].state == POOL_AGENT_FREE || 
+	  AgentPool[i].pid != childPid) continue;
+	if (AgentPool[i].ctrlSock >= 0) close (AgentPool[i].ctrlSock);
+	memset (&AgentPool[i], 0, sizeof (poolAgent_t));
+	AgentPool[i].ctrlSock = -1;
+	found = 1;
+	break;
+    }
+#ifndef SINGLE_SVR_THR
+    #ifdef USE_BOOST
+    pool_lock.unlock();
+    #else
+    pthread_mutex_unlock (&AgentPoolMutex);
+    #endif
+#endif
+    return (found);
+}
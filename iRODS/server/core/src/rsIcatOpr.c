@@ -90,4 +90,21 @@ resetRcat (rsComm_t *rsComm)
     return 0;
 }
 
+/* resetRcatSession - clear the client specific ICAT state but keep the
+ * connection. Used by pooled agents between sessions */
+int
+resetRcatSession (rsComm_t *rsComm)
+{
+    int status;
+
+    if (IcatConnState != INITIAL_DONE) return 0;
+
+    status = chlResetSession (rsComm);
+    if (status < 0) {
+        rodsLog (LOG_NOTICE,
+         "resetRcatSession: chlResetSession Error. Status = %d", status);
+    }
+    return status;
+}
+
 #endif
@@ -0,0 +1,566 @@
+/*** Copyright (c), The Regents of the University of California            ***
+ *** For more information please refer to files in the COPYRIGHT directory ***/
+
+/* streamChksum.c - routines for computing the chksum of a data object
+ * while its data streams through a single buffer or single stream
+ * transfer, so the file does not have to be read again for the chksum.
+ * The threads of a parallel transfer take the sha2tree chunk digests
+ * separately. For the md5 and sha2 schemes, they hash the data in order
+ * through an orderedStreamChksum_t.
+ * A chksum computed by a portal transfer is saved in this agent and
+ * picked up by fileChksum, which may be called through a server to
+ * server connection from the agent that opened the object.
+ */
+
+#include "streamChksum.h"
+#include "fileDriver.h"
+#include "objDesc.h"
+#include "rsGlobalExtern.h"
+#include "rodsKeyWdDef.h"
+
+static savedStreamChksum_t SavedStreamChksum[MAX_SAVED_STREAM_CHKSUM];
+static int NextSavedStreamChksum = 0;
+
+static void
+saveChksumOfL3desc (int l3descInx, struct stat *statbuf, char *chksumStr);
+#ifndef windows_platform
+static void
+_breakOrderedStreamChksum (orderedStreamChksum_t *orderedChksum);
+#endif
+
+int
+initStreamChksum (streamChksum_t *streamChksum, int chksumScheme)
+{
+    int status;
+
+    streamChksum->nextOffset = 0;
+    status = initChksumEngine (&streamChksum->chksumEngine, chksumScheme);
+    if (status < 0) {
+        streamChksum->state = STREAM_CHKSUM_BROKEN;
+        return status;
+    }
+    streamChksum->state = STREAM_CHKSUM_ON;
+    return 0;
+}
+
+/* updateStreamChksum - add len bytes of data at offset. Data out of order
+ * breaks the chksum for good.
+ */
+int
+updateStreamChksum (streamChksum_t *streamChksum, rodsLong_t offset,
+char *buf, int len)
+{
+    if (streamChksum == NULL || streamChksum->state != STREAM_CHKSUM_ON)
+        return 0;
+
+    if (offset != streamChksum->nextOffset) {
+        streamChksum->state = STREAM_CHKSUM_BROKEN;
+        return 0;
+    }
+    updateChksumEngine (&streamChksum->chksumEngine, (unsigned char *) buf,
+      len);
+    streamChksum->nextOffset += len;
+    return 0;
+}
+
+int
+finalStreamChksum (streamChksum_t *streamChksum, char *chksumStr)
+{
+    if (streamChksum == NULL || streamChksum->state != STREAM_CHKSUM_ON)
+        return SYS_INTERNAL_NULL_INPUT_ERR;
+
+    streamChksum->state = 0;
+    return finalChksumEngine (&streamChksum->chksumEngine, chksumStr);
+}
+
+int
+chksumDataBuf (char *buf, int len, int chksumScheme, char *chksumStr)
+{
+    streamChksum_t streamChksum;
+    int status;
+
+    if ((status = initStreamChksum (&streamChksum, chksumScheme)) < 0)
+        return status;
+    updateStreamChksum (&streamChksum, 0, buf, len);
+    return finalStreamChksum (&streamChksum, chksumStr);
+}
+
+/* saveStreamChksum - save the chksum of the file opened as l3descInx
+ * if streamChksum covers the whole file.
+ */
+int
+saveStreamChksum (rsComm_t *rsComm, int l3descInx,
+streamChksum_t *streamChksum)
+{
+    struct stat statbuf;
+    char chksumStr[NAME_LEN];
+    int status;
+
+    if (l3descInx < 3 || l3descInx >= NUM_FILE_DESC ||
+      FileDesc[l3descInx].inuseFlag == 0) {
+        return SYS_BAD_FILE_DESCRIPTOR;
+    }
+    if (streamChksum == NULL || streamChksum->state != STREAM_CHKSUM_ON)
+        return 0;
+
+    status = fileFstat ((fileDriverType_t) FileDesc[l3descInx].fileType,
+      rsComm, FileDesc[l3descInx].fd, &statbuf);
+    if (status < 0 || statbuf.st_size != streamChksum->nextOffset) {
+        /* something else wrote the file */
+        return 0;
+    }
+    if ((status = finalStreamChksum (streamChksum, chksumStr)) < 0)
+        return status;
+
+    saveChksumOfL3desc (l3descInx, &statbuf, chksumStr);
+    return 0;
+}
+
+/* saveChksumOfL3desc - save chksumStr as the chksum of the file opened as
+ * l3descInx, whose stat is statbuf.
+ */
+static void
+saveChksumOfL3desc (int l3descInx, struct stat *statbuf, char *chksumStr)
+{
+    savedStreamChksum_t *saved;
+
+#ifdef STAT_MTIME_NSEC
+    if (FileDesc[l3descInx].fileType != UNIX_FILE_TYPE) return;
+
+    saved = &SavedStreamChksum[NextSavedStreamChksum];
+    NextSavedStreamChksum = 
+      (NextSavedStreamChksum + 1) % MAX_SAVED_STREAM_CHKSUM;
+    saved->fileType = FileDesc[l3descInx].fileType;
+    rstrcpy (saved->fileName, FileDesc[l3descInx].fileName, MAX_NAME_LEN);
+    saved->fileSize = statbuf->st_size;
+    saved->mtime = statbuf->st_mtime;
+    saved->mtimeNsec = STAT_MTIME_NSEC (statbuf);
+    rstrcpy (saved->chksum, chksumStr, NAME_LEN);
+#endif
+}
+
+#ifndef windows_platform
+static void
+lockOrderedStreamChksum (orderedStreamChksum_t *orderedChksum)
+{
+#ifdef USE_BOOST
+    orderedChksum->lock->lock ();
+#else
+    pthread_mutex_lock (&orderedChksum->lock);
+#endif
+}
+
+static void
+unlockOrderedStreamChksum (orderedStreamChksum_t *orderedChksum)
+{
+#ifdef USE_BOOST
+    orderedChksum->lock->unlock ();
+#else
+    pthread_mutex_unlock (&orderedChksum->lock);
+#endif
+}
+
+/* waitOrderedStreamChksum - wait for the data to be hashed with the lock
+ * held */
+static void
+waitOrderedStreamChksum (orderedStreamChksum_t *orderedChksum)
+{
+#ifdef USE_BOOST
+    orderedChksum->cond->wait (*orderedChksum->lock);
+#else
+    pthread_cond_wait (&orderedChksum->cond, &orderedChksum->lock);
+#endif
+}
+
+static void
+wakeOrderedStreamChksum (orderedStreamChksum_t *orderedChksum)
+{
+#ifdef USE_BOOST
+    orderedChksum->cond->notify_all ();
+#else
+    pthread_cond_broadcast (&orderedChksum->cond);
+#endif
+}
+
+/* freePendingChksumBuf - free the queued data of orderedChksum with the
+ * lock held */
+static void
+freePendingChksumBuf (orderedStreamChksum_t *orderedChksum)
+{
+    pendingChksumBuf_t *pending;
+
+    while ((pending = orderedChksum->pending) != NULL) {
+        orderedChksum->pending = pending->next;
+        free (pending->buf);
+        free (pending);
+    }
+    orderedChksum->pendingSize = 0;
+}
+
+int
+initOrderedStreamChksum (orderedStreamChksum_t *orderedChksum,
+int chksumScheme, rodsLong_t maxPendingSize)
+{
+    int status;
+
+    memset (orderedChksum, 0, sizeof (orderedStreamChksum_t));
+    status = initStreamChksum (&orderedChksum->streamChksum, chksumScheme);
+    if (status < 0) return status;
+
+    orderedChksum->maxPendingSize = maxPendingSize;
+#ifdef USE_BOOST
+    orderedChksum->lock = new boost::mutex;
+    orderedChksum->cond = new boost::condition_variable_any;
+#else
+    pthread_mutex_init (&orderedChksum->lock, NULL);
+    pthread_cond_init (&orderedChksum->cond, NULL);
+#endif
+    return 0;
+}
+
+/* updateOrderedStreamChksum - add len bytes of data at offset moved by
+ * one of the threads. Data at nextOffset is hashed right away, followed
+ * by the queued data it reaches. Data ahead is copied to the queue. Data
+ * behind, or no memory for the copy, breaks the chksum for good.
+ */
+int
+updateOrderedStreamChksum (orderedStreamChksum_t *orderedChksum,
+rodsLong_t offset, char *buf, int len)
+{
+    streamChksum_t *streamChksum = &orderedChksum->streamChksum;
+    pendingChksumBuf_t *pending, **prev;
+
+    lockOrderedStreamChksum (orderedChksum);
+    while (streamChksum->state == STREAM_CHKSUM_ON &&
+      offset > streamChksum->nextOffset && orderedChksum->pendingSize > 0 &&
+      orderedChksum->pendingSize + len > orderedChksum->maxPendingSize) {
+        waitOrderedStreamChksum (orderedChksum);
+    }
+    if (streamChksum->state != STREAM_CHKSUM_ON) {
+        unlockOrderedStreamChksum (orderedChksum);
+        return 0;
+    }
+    if (offset < streamChksum->nextOffset) {
+        _breakOrderedStreamChksum (orderedChksum);
+        unlockOrderedStreamChksum (orderedChksum);
+        return 0;
+    }
+
+    if (offset > streamChksum->nextOffset) {
+        pending = (pendingChksumBuf_t *) malloc (sizeof (pendingChksumBuf_t));
+        if (pending == NULL || 
+          (pending->buf = (char *) malloc (len)) == NULL) {
+            if (pending != NULL) free (pending);
+            _breakOrderedStreamChksum (orderedChksum);
+            unlockOrderedStreamChksum (orderedChksum);
+            return SYS_MALLOC_ERR;
+        }
+        memcpy (pending->buf, buf, len);
+        pending->offset = offset;
+        pending->len = len;
+        prev = &orderedChksum->pending;
+        while (*prev != NULL && (*prev)->offset < offset)
+            prev = &(*prev)->next;
+        pending->next = *prev;
+        *prev = pending;
+        orderedChksum->pendingSize += len;
+        unlockOrderedStreamChksum (orderedChksum);
+        return 0;
+    }
+
+    /* nobody else has the data at nextOffset, so it can be hashed
+     * without the lock while the other threads queue theirs */
+    pending = NULL;
+    while (1) {
+        unlockOrderedStreamChksum (orderedChksum);
+        updateChksumEngine (&streamChksum->chksumEngine, 
+          (unsigned char *) buf, len);
+        lockOrderedStreamChksum (orderedChksum);
+        streamChksum->nextOffset += len;
+        if (pending != NULL) {
+            free (pending->buf);
+            free (pending);
+        }
+        pending = orderedChksum->pending;
+        if (streamChksum->state != STREAM_CHKSUM_ON || pending == NULL || 
+          pending->offset != streamChksum->nextOffset) {
+            break;
+        }
+        orderedChksum->pending = pending->next;
+        orderedChksum->pendingSize -= pending->len;
+        buf = pending->buf;
+        len = pending->len;
+        wakeOrderedStreamChksum (orderedChksum);
+    }
+    wakeOrderedStreamChksum (orderedChksum);
+    unlockOrderedStreamChksum (orderedChksum);
+    return 0;
+}
+
+/* breakOrderedStreamChksum - give up on orderedChksum, e.g., because a
+ * thread quit with its data not hashed. The threads waiting for it go on.
+ */
+int
+breakOrderedStreamChksum (orderedStreamChksum_t *orderedChksum)
+{
+    if (orderedChksum == NULL) return 0;
+
+    lockOrderedStreamChksum (orderedChksum);
+    _breakOrderedStreamChksum (orderedChksum);
+    unlockOrderedStreamChksum (orderedChksum);
+    return 0;
+}
+
+/* _breakOrderedStreamChksum - breakOrderedStreamChksum with the lock
+ * held */
+static void
+_breakOrderedStreamChksum (orderedStreamChksum_t *orderedChksum)
+{
+    orderedChksum->streamChksum.state = STREAM_CHKSUM_BROKEN;
+    freePendingChksumBuf (orderedChksum);
+    wakeOrderedStreamChksum (orderedChksum);
+}
+
+/* clearOrderedStreamChksum - free orderedChksum after the join. The
+ * chksum itself is taken with saveStreamChksum on its streamChksum.
+ */
+int
+clearOrderedStreamChksum (orderedStreamChksum_t *orderedChksum)
+{
+    freePendingChksumBuf (orderedChksum);
+#ifdef USE_BOOST
+    delete orderedChksum->lock;
+    delete orderedChksum->cond;
+#else
+    pthread_mutex_destroy (&orderedChksum->lock);
+    pthread_cond_destroy (&orderedChksum->cond);
+#endif
+    return 0;
+}
+#endif	/* windows_platform */
+
+int
+initTreeStreamChksum (treeStreamChksum_t *treeChksum, rodsLong_t dataSize)
+{
+    memset (treeChksum, 0, sizeof (treeStreamChksum_t));
+    if (dataSize <= 0) {
+        treeChksum->state = STREAM_CHKSUM_BROKEN;
+        return SYS_INTERNAL_NULL_INPUT_ERR;
+    }
+    treeChksum->dataSize = dataSize;
+    treeChksum->chunkCnt = (dataSize + TREE_CHKSUM_CHUNK_SZ - 1) /
+      TREE_CHKSUM_CHUNK_SZ;
+    treeChksum->digest = (unsigned char *) malloc (treeChksum->chunkCnt *
+      SHA256_DIGEST_LEN);
+    treeChksum->chunkDone = (char *) calloc (treeChksum->chunkCnt, 1);
+    if (treeChksum->digest == NULL || treeChksum->chunkDone == NULL) {
+        clearTreeStreamChksum (treeChksum);
+        treeChksum->state = STREAM_CHKSUM_BROKEN;
+        return SYS_MALLOC_ERR;
+    }
+    treeChksum->state = STREAM_CHKSUM_ON;
+    return 0;
+}
+
+/* updateTreeStreamChksum - add len bytes of data at offset moved by
+ * the thread of chunkChksum. A chunk must be moved in order from its
+ * start by one thread. Anything else breaks the chksum for good.
+ */
+int
+updateTreeStreamChksum (treeStreamChksum_t *treeChksum,
+treeChunkChksum_t *chunkChksum, rodsLong_t offset, char *buf, int len)
+{
+    rodsLong_t chunkEnd;
+    int toHash;
+
+    if (treeChksum == NULL || treeChksum->state != STREAM_CHKSUM_ON)
+        return 0;
+
+    while (len > 0) {
+        if (chunkChksum->inChunk == 0) {
+            if (offset % TREE_CHKSUM_CHUNK_SZ != 0 ||
+              offset >= treeChksum->dataSize) {
+                treeChksum->state = STREAM_CHKSUM_BROKEN;
+                return 0;
+            }
+            chunkChksum->inChunk = 1;
+            chunkChksum->chunkInx = offset / TREE_CHKSUM_CHUNK_SZ;
+            chunkChksum->nextOffset = offset;
+            SHA256Init (&chunkChksum->context);
+        } else if (offset != chunkChksum->nextOffset) {
+            treeChksum->state = STREAM_CHKSUM_BROKEN;
+            return 0;
+        }
+        chunkEnd = (rodsLong_t) (chunkChksum->chunkInx + 1) *
+          TREE_CHKSUM_CHUNK_SZ;
+        if (chunkEnd > treeChksum->dataSize) chunkEnd = treeChksum->dataSize;
+        toHash = len;
+        if (offset + toHash > chunkEnd) toHash = chunkEnd - offset;
+        SHA256Update (&chunkChksum->context, (unsigned char *) buf, toHash);
+        offset += toHash;
+        buf += toHash;
+        len -= toHash;
+        chunkChksum->nextOffset = offset;
+        if (offset == chunkEnd) {
+            /* each chunk has its own digest, so no lock is needed */
+            SHA256Final (&treeChksum->digest[chunkChksum->chunkInx *
+              SHA256_DIGEST_LEN], &chunkChksum->context);
+            treeChksum->chunkDone[chunkChksum->chunkInx] = 1;
+            chunkChksum->inChunk = 0;
+        }
+    }
+    return 0;
+}
+
+/* saveTreeStreamChksum - save the chksum of the file opened as l3descInx
+ * if all the chunks of treeChksum were done. Called after the join.
+ */
+int
+saveTreeStreamChksum (rsComm_t *rsComm, int l3descInx,
+treeStreamChksum_t *treeChksum)
+{
+    struct stat statbuf;
+    char chksumStr[NAME_LEN];
+    int i, status;
+
+    if (l3descInx < 3 || l3descInx >= NUM_FILE_DESC ||
+      FileDesc[l3descInx].inuseFlag == 0) {
+        return SYS_BAD_FILE_DESCRIPTOR;
+    }
+    if (treeChksum == NULL || treeChksum->state != STREAM_CHKSUM_ON)
+        return 0;
+    for (i = 0; i < treeChksum->chunkCnt; i++) {
+        if (treeChksum->chunkDone[i] == 0) return 0;
+    }
+
+    status = fileFstat ((fileDriverType_t) FileDesc[l3descInx].fileType,
+      rsComm, FileDesc[l3descInx].fd, &statbuf);
+    if (status < 0 || statbuf.st_size != treeChksum->dataSize) {
+        /* something else wrote the file */
+        return 0;
+    }
+    status = treeDigestsToChksum (treeChksum->digest, treeChksum->chunkCnt,
+      chksumStr);
+    if (status < 0) return status;
+
+    saveChksumOfL3desc (l3descInx, &statbuf, chksumStr);
+    return 0;
+}
+
+int
+clearTreeStreamChksum (treeStreamChksum_t *treeChksum)
+{
+    if (treeChksum->digest != NULL) {
+        free (treeChksum->digest);
+        treeChksum->digest = NULL;
+    }
+    if (treeChksum->chunkDone != NULL) {
+        free (treeChksum->chunkDone);
+        treeChksum->chunkDone = NULL;
+    }
+    treeChksum->state = 0;
+    return 0;
+}
+
+/* getSavedStreamChksum - get the saved chksum of fileName. Returns 0 and
+ * fills in chksumStr if it is still good and of chksumScheme,
+ * SYS_INTERNAL_NULL_INPUT_ERR if there is none.
+ */
+int
+getSavedStreamChksum (int fileType, rsComm_t *rsComm, char *fileName,
+int chksumScheme, char *chksumStr)
+{
+    savedStreamChksum_t *saved;
+    struct stat statbuf;
+    int i, status;
+
+    if (chksumScheme == DEF_CHKSUM_SCHEME)
+        chksumScheme = getDefChksumScheme ();
+
+    for (i = 0; i < MAX_SAVED_STREAM_CHKSUM; i++) {
+        saved = &SavedStreamChksum[i];
+        if (saved->fileType != fileType ||
+          strcmp (saved->fileName, fileName) != 0) {
+            continue;
+        }
+        /* one time use */
+        saved->fileName[0] = '\0';
+        status = fileStat ((fileDriverType_t) fileType, rsComm, fileName,
+          &statbuf);
+        if (status < 0 || statbuf.st_size != saved->fileSize ||
+          statbuf.st_mtime != saved->mtime ||
+#ifdef STAT_MTIME_NSEC
+          STAT_MTIME_NSEC (&statbuf) != saved->mtimeNsec ||
+#endif
+          getChksumScheme (saved->chksum) != chksumScheme) {
+            break;
+        }
+        rstrcpy (chksumStr, saved->chksum, NAME_LEN);
+        return 0;
+    }
+    return SYS_INTERNAL_NULL_INPUT_ERR;
+}
+
+/* isStreamChksumNeeded - whether procChksumForClose will need the chksum
+ * of the data written through l1descInx.
+ */
+int
+isStreamChksumNeeded (int l1descInx)
+{
+    dataObjInfo_t *dataObjInfo = L1desc[l1descInx].dataObjInfo;
+
+    if (L1desc[l1descInx].chksumFlag != 0) return 1;
+    if (dataObjInfo != NULL && strlen (dataObjInfo->chksum) > 0) return 1;
+    return 0;
+}
+
+/* getL1descChksumScheme - the scheme to chksum the data written through
+ * l1descInx with. It must match the chksum it will be compared with:
+ * the one from the client, then the one of the source of a copy, then
+ * the one of the replica being overwritten. Otherwise the default.
+ */
+int
+getL1descChksumScheme (int l1descInx)
+{
+    dataObjInfo_t *dataObjInfo = L1desc[l1descInx].dataObjInfo;
+    int srcL1descInx = L1desc[l1descInx].srcL1descInx;
+    int scheme;
+
+    if (strlen (L1desc[l1descInx].chksum) > 0)
+        return getChksumScheme (L1desc[l1descInx].chksum);
+
+    if (srcL1descInx > 2 && srcL1descInx < NUM_L1_DESC &&
+      L1desc[srcL1descInx].inuseFlag == FD_INUSE &&
+      L1desc[srcL1descInx].dataObjInfo != NULL &&
+      strlen (L1desc[srcL1descInx].dataObjInfo->chksum) > 0) {
+        return getChksumScheme (L1desc[srcL1descInx].dataObjInfo->chksum);
+    }
+
+    if (dataObjInfo != NULL && 
+      (scheme = getChksumScheme (dataObjInfo->chksum)) != DEF_CHKSUM_SCHEME)
+        return scheme;
+
+    return getDefChksumScheme ();
+}
+
+/* isGetChksumAtClose - whether the chksum of the get through l1descInx
+ * is left to the close. The client asked to verify it, takes it after
+ * the transfer (CHKSUM_AT_CLOSE_KW) and there is none registered yet, so
+ * the stream can compute it on the way out.
+ */
+int
+isGetChksumAtClose (int l1descInx)
+{
+    dataObjInfo_t *dataObjInfo = L1desc[l1descInx].dataObjInfo;
+    dataObjInp_t *dataObjInp = L1desc[l1descInx].dataObjInp;
+
+    if (L1desc[l1descInx].oprType != GET_OPR || dataObjInp == NULL ||
+      dataObjInfo == NULL || strlen (dataObjInfo->chksum) > 0) {
+        return 0;
+    }
+    if (getValByKey (&dataObjInp->condInput, VERIFY_CHKSUM_KW) == NULL ||
+      getValByKey (&dataObjInp->condInput, CHKSUM_AT_CLOSE_KW) == NULL) {
+        return 0;
+    }
+    return 1;
+}
@@ -0,0 +1,447 @@
+/*** Copyright (c), The Regents of the University of California            ***
+ *** For more information please refer to files in the COPYRIGHT directory ***/
+
+/* svrCfgSnap.c - routines for the shared memory snapshot of the zone and
+ * resource configuration. The irodsServer queries the ICAT in initZone
+ * and initResc and publishes the packed query results in a shared memory
+ * segment. Agents replay these results instead of querying the ICAT
+ * again. The snapshot is rebuilt by the first process that finds it
+ * stale, i.e., older than svrCfgSnapMaxAge or taken before the last
+ * bumpSvrCfgGeneration (called by rsGeneralAdmin when a zone or
+ * resource is added, modified or removed).
+ */
+
+#include "svrCfgSnap.h"
+
+#ifndef windows_platform
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#endif
+
+static svrCfgSnap_t SvrCfgSnap;
+
+static void
+freeSvrCfgSnap ()
+{
+    int i;
+
+    for (i = 0; i < SvrCfgSnap.resultCnt; i++) {
+        freeBBuf (SvrCfgSnap.result[i].packedResult);
+    }
+    memset (&SvrCfgSnap, 0, sizeof (SvrCfgSnap));
+}
+
+int
+getSvrCfgSnapMaxAge ()
+{
+    char *tmpStr;
+    int maxAge;
+
+    if ((tmpStr = getenv (SVR_CFG_SNAP_MAX_AGE_KW)) == NULL)
+        return DEF_SVR_CFG_SNAP_MAX_AGE;
+    maxAge = atoi (tmpStr);
+    if (maxAge < 0) return 0;
+    return maxAge;
+}
+
+int
+isSvrCfgSnapLoaded ()
+{
+    if (SvrCfgSnap.state == SVR_CFG_SNAP_LOADED)
+        return 1;
+    else
+        return 0;
+}
+
+/* getSvrCfgSnapResult - get the inx'th result of the given slot from the
+ * loaded snapshot. Returns CAT_NO_ROWS_FOUND if there is no such result.
+ */
+int
+getSvrCfgSnapResult (int slot, int inx, genQueryOut_t **genQueryOut)
+{
+    int i, status;
+    int cnt = 0;
+
+    if (SvrCfgSnap.state != SVR_CFG_SNAP_LOADED) return SYS_SVR_CFG_SNAP_ERR;
+
+    for (i = 0; i < SvrCfgSnap.resultCnt; i++) {
+        if (SvrCfgSnap.result[i].slot != slot) continue;
+        if (cnt < inx) {
+            cnt++;
+            continue;
+        }
+        status = unpackStruct (SvrCfgSnap.result[i].packedResult->buf,
+          (void **) genQueryOut, "GenQueryOut_PI", NULL, NATIVE_PROT);
+        if (status < 0) {
+            rodsLog (LOG_ERROR,
+              "getSvrCfgSnapResult: unpackStruct error, status = %d", status);
+        }
+        return status;
+    }
+    return CAT_NO_ROWS_FOUND;
+}
+
+/* addSvrCfgSnapResult - save a query result to be published by
+ * endSvrCfgSnap. Does nothing unless a snapshot is being captured.
+ */
+int
+addSvrCfgSnapResult (int slot, genQueryOut_t *genQueryOut)
+{
+    bytesBuf_t *packedResult = NULL;
+    int status;
+
+    if (SvrCfgSnap.state != SVR_CFG_SNAP_CAPTURE || genQueryOut == NULL)
+        return 0;
+
+    if (SvrCfgSnap.resultCnt >= MAX_SVR_CFG_RESULT) {
+        rodsLog (LOG_NOTICE,
+          "addSvrCfgSnapResult: more than %d results, snapshot not saved",
+          MAX_SVR_CFG_RESULT);
+        freeSvrCfgSnap ();
+        return 0;
+    }
+
+    status = packStruct ((void *) genQueryOut, &packedResult,
+      "GenQueryOut_PI", NULL, 0, NATIVE_PROT);
+    if (status < 0) {
+        rodsLog (LOG_NOTICE,
+          "addSvrCfgSnapResult: packStruct error, status = %d", status);
+        freeSvrCfgSnap ();
+        return status;
+    }
+    SvrCfgSnap.result[SvrCfgSnap.resultCnt].slot = slot;
+    SvrCfgSnap.result[SvrCfgSnap.resultCnt].packedResult = packedResult;
+    SvrCfgSnap.resultCnt++;
+
+    return 0;
+}
+
+#ifndef windows_platform
+static void
+getSvrCfgSnapName (rsComm_t *rsComm, char *shmName)
+{
+    snprintf (shmName, NAME_LEN, "%s.%d", SVR_CFG_SNAP_NAME,
+      rsComm->myEnv.rodsPort);
+}
+
+static int
+lockSvrCfgSnap (int fd, int lockType)
+{
+    struct flock myLock;
+    int status;
+
+    memset (&myLock, 0, sizeof (myLock));
+    myLock.l_type = lockType;
+    myLock.l_whence = SEEK_SET;
+
+    while ((status = fcntl (fd, F_SETLKW, &myLock)) < 0 && errno == EINTR);
+
+    if (status < 0) {
+        rodsLog (LOG_NOTICE,
+          "lockSvrCfgSnap: fcntl error, errno = %d", errno);
+        return SYS_SVR_CFG_SNAP_ERR - errno;
+    }
+    return 0;
+}
+
+/* loadSvrCfgSnap - copy the results from the mapped segment if the
+ * snapshot is still good. Otherwise get ready to capture a new one.
+ */
+static int
+loadSvrCfgSnap (char *shmBuf, rodsLong_t shmSize, int maxAge)
+{
+    svrCfgSnapHdr_t *snapHdr = (svrCfgSnapHdr_t *) shmBuf;
+    svrCfgResultHdr_t *resultHdr;
+    char *dataPtr;
+    rodsLong_t dataLen = 0;
+    time_t curTime;
+    int i;
+
+    if (snapHdr->magic != SVR_CFG_SNAP_MAGIC) return 0;
+
+    SvrCfgSnap.generation = snapHdr->generation;
+    curTime = time (NULL);
+    if (snapHdr->snapGeneration != snapHdr->generation ||
+      snapHdr->resultCnt <= 0 || snapHdr->resultCnt > MAX_SVR_CFG_RESULT ||
+      curTime < snapHdr->buildTime || curTime - snapHdr->buildTime >= maxAge) {
+        return 0;
+    }
+    if (shmSize < (rodsLong_t) (sizeof (svrCfgSnapHdr_t) +
+      snapHdr->resultCnt * sizeof (svrCfgResultHdr_t)) + snapHdr->dataLen) {
+        rodsLog (LOG_NOTICE, "loadSvrCfgSnap: snapshot is truncated");
+        return 0;
+    }
+
+    resultHdr = (svrCfgResultHdr_t *) (shmBuf + sizeof (svrCfgSnapHdr_t));
+    dataPtr = (char *) &resultHdr[snapHdr->resultCnt];
+    for (i = 0; i < snapHdr->resultCnt; i++) {
+        bytesBuf_t *packedResult;
+
+        dataLen += resultHdr[i].len;
+        if (resultHdr[i].len <= 0 || dataLen > snapHdr->dataLen) {
+            rodsLog (LOG_NOTICE, "loadSvrCfgSnap: bad result length %d",
+              resultHdr[i].len);
+            freeSvrCfgSnap ();
+            SvrCfgSnap.state = SVR_CFG_SNAP_CAPTURE;
+            SvrCfgSnap.generation = snapHdr->generation;
+            return 0;
+        }
+        packedResult = (bytesBuf_t *) malloc (sizeof (bytesBuf_t));
+        packedResult->len = resultHdr[i].len;
+        packedResult->buf = malloc (resultHdr[i].len);
+        memcpy (packedResult->buf, dataPtr, resultHdr[i].len);
+        dataPtr += resultHdr[i].len;
+        SvrCfgSnap.result[i].slot = resultHdr[i].slot;
+        SvrCfgSnap.result[i].packedResult = packedResult;
+        SvrCfgSnap.resultCnt++;
+    }
+    SvrCfgSnap.state = SVR_CFG_SNAP_LOADED;
+
+    return 0;
+}
+
+/* beginSvrCfgSnap - called by initServerInfo before initZone and
+ * initResc. If the shared snapshot is good, it is loaded and
+ * isSvrCfgSnapLoaded() returns 1. Otherwise the results of the ICAT
+ * queries will be captured and published by endSvrCfgSnap.
+ */
+int
+beginSvrCfgSnap (rsComm_t *rsComm)
+{
+    char shmName[NAME_LEN];
+    struct stat statbuf;
+    char *shmBuf;
+    int maxAge;
+    int fd;
+
+    freeSvrCfgSnap ();
+
+    if ((maxAge = getSvrCfgSnapMaxAge ()) <= 0) return 0;
+
+    SvrCfgSnap.state = SVR_CFG_SNAP_CAPTURE;
+
+    getSvrCfgSnapName (rsComm, shmName);
+    if ((fd = shm_open (shmName, O_RDONLY, 0)) < 0) {
+        /* not created yet */
+        return 0;
+    }
+
+    if (lockSvrCfgSnap (fd, F_RDLCK) < 0) {
+        close (fd);
+        freeSvrCfgSnap ();
+        return 0;
+    }
+    if (fstat (fd, &statbuf) == 0 &&
+      statbuf.st_size >= (off_t) sizeof (svrCfgSnapHdr_t)) {
+        shmBuf = (char *) mmap (NULL, statbuf.st_size, PROT_READ, MAP_SHARED,
+          fd, 0);
+        if (shmBuf != MAP_FAILED) {
+            loadSvrCfgSnap (shmBuf, statbuf.st_size, maxAge);
+            munmap (shmBuf, statbuf.st_size);
+        }
+    }
+    lockSvrCfgSnap (fd, F_UNLCK);
+    close (fd);
+
+    return 0;
+}
+
+static int
+publishSvrCfgSnap (rsComm_t *rsComm)
+{
+    char shmName[NAME_LEN];
+    struct stat statbuf;
+    svrCfgSnapHdr_t snapHdr;
+    svrCfgResultHdr_t *resultHdr;
+    char *shmBuf, *dataPtr;
+    rodsLong_t shmSize;
+    int fd, i, status;
+
+    getSvrCfgSnapName (rsComm, shmName);
+    if ((fd = shm_open (shmName, O_RDWR | O_CREAT, 0600)) < 0) {
+        rodsLog (LOG_NOTICE,
+          "publishSvrCfgSnap: shm_open of %s error, errno = %d",
+          shmName, errno);
+        return SYS_SVR_CFG_SNAP_ERR - errno;
+    }
+    if ((status = lockSvrCfgSnap (fd, F_WRLCK)) < 0) {
+        close (fd);
+        return status;
+    }
+
+    /* don't publish if the config was changed while we were querying */
+    status = 0;
+    if (fstat (fd, &statbuf) == 0 &&
+      statbuf.st_size >= (off_t) sizeof (svrCfgSnapHdr_t)) {
+        shmBuf = (char *) mmap (NULL, sizeof (svrCfgSnapHdr_t), PROT_READ,
+          MAP_SHARED, fd, 0);
+        if (shmBuf != MAP_FAILED) {
+            memcpy (&snapHdr, shmBuf, sizeof (snapHdr));
+            munmap (shmBuf, sizeof (svrCfgSnapHdr_t));
+            if (snapHdr.magic == SVR_CFG_SNAP_MAGIC &&
+              snapHdr.generation != SvrCfgSnap.generation) {
+                status = SYS_SVR_CFG_SNAP_ERR;
+            }
+        }
+    }
+
+    if (status >= 0) {
+        memset (&snapHdr, 0, sizeof (snapHdr));
+        snapHdr.magic = SVR_CFG_SNAP_MAGIC;
+        snapHdr.generation = snapHdr.snapGeneration = SvrCfgSnap.generation;
+        snapHdr.resultCnt = SvrCfgSnap.resultCnt;
+        snapHdr.buildTime = time (NULL);
+        for (i = 0; i < SvrCfgSnap.resultCnt; i++) {
+            snapHdr.dataLen += SvrCfgSnap.result[i].packedResult->len;
+        }
+        shmSize = sizeof (svrCfgSnapHdr_t) +
+          SvrCfgSnap.resultCnt * sizeof (svrCfgResultHdr_t) + snapHdr.dataLen;
+
+        if (ftruncate (fd, shmSize) < 0) {
+            rodsLog (LOG_NOTICE,
+              "publishSvrCfgSnap: ftruncate of %s error, errno = %d",
+              shmName, errno);
+            status = SYS_SVR_CFG_SNAP_ERR - errno;
+        } else if ((shmBuf = (char *) mmap (NULL, shmSize,
+          PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED) {
+            rodsLog (LOG_NOTICE,
+              "publishSvrCfgSnap: mmap of %s error, errno = %d",
+              shmName, errno);
+            status = SYS_SVR_CFG_SNAP_ERR - errno;
+        } else {
+            memcpy (shmBuf, &snapHdr, sizeof (snapHdr));
+            resultHdr = (svrCfgResultHdr_t *)
+              (shmBuf + sizeof (svrCfgSnapHdr_t));
+            dataPtr = (char *) &resultHdr[SvrCfgSnap.resultCnt];
+            for (i = 0; i < SvrCfgSnap.resultCnt; i++) {
+                bytesBuf_t *packedResult = SvrCfgSnap.result[i].packedResult;
+
+                resultHdr[i].slot = SvrCfgSnap.result[i].slot;
+                resultHdr[i].len = packedResult->len;
+                memcpy (dataPtr, packedResult->buf, packedResult->len);
+                dataPtr += packedResult->len;
+            }
+            munmap (shmBuf, shmSize);
+        }
+    }
+    lockSvrCfgSnap (fd, F_UNLCK);
+    close (fd);
+
+    return status;
+}
+
+/* bumpSvrCfgGeneration - invalidate the snapshot after an admin change
+ * of the zone or resource configuration.
+ */
+int
+bumpSvrCfgGeneration (rsComm_t *rsComm)
+{
+    char shmName[NAME_LEN];
+    struct stat statbuf;
+    svrCfgSnapHdr_t *snapHdr;
+    int fd, status;
+
+    if (getSvrCfgSnapMaxAge () <= 0) return 0;
+
+    getSvrCfgSnapName (rsComm, shmName);
+    if ((fd = shm_open (shmName, O_RDWR | O_CREAT, 0600)) < 0) {
+        rodsLog (LOG_NOTICE,
+          "bumpSvrCfgGeneration: shm_open of %s error, errno = %d",
+          shmName, errno);
+        return SYS_SVR_CFG_SNAP_ERR - errno;
+    }
+    if ((status = lockSvrCfgSnap (fd, F_WRLCK)) < 0) {
+        close (fd);
+        return status;
+    }
+
+    if (fstat (fd, &statbuf) < 0 ||
+      (statbuf.st_size < (off_t) sizeof (svrCfgSnapHdr_t) &&
+      ftruncate (fd, sizeof (svrCfgSnapHdr_t)) < 0)) {
+        status = SYS_SVR_CFG_SNAP_ERR - errno;
+    } else if ((snapHdr = (svrCfgSnapHdr_t *) mmap (NULL,
+      sizeof (svrCfgSnapHdr_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) ==
+      MAP_FAILED) {
+        status = SYS_SVR_CFG_SNAP_ERR - errno;
+    } else {
+        if (snapHdr->magic != SVR_CFG_SNAP_MAGIC) {
+            /* new segment. Make sure a capture started before it is
+             * created (with generation 0) does not get published */
+            memset (snapHdr, 0, sizeof (svrCfgSnapHdr_t));
+            snapHdr->magic = SVR_CFG_SNAP_MAGIC;
+            snapHdr->snapGeneration = -1;
+        }
+        snapHdr->generation++;
+        munmap (snapHdr, sizeof (svrCfgSnapHdr_t));
+    }
+    if (status < 0) {
+        rodsLog (LOG_NOTICE,
+          "bumpSvrCfgGeneration: error for %s, status = %d", shmName, status);
+    }
+    lockSvrCfgSnap (fd, F_UNLCK);
+    close (fd);
+
+    return status;
+}
+
+/* removeSvrCfgSnap - called by the irodsServer at startup so that the
+ * snapshot is rebuilt from the ICAT */
+int
+removeSvrCfgSnap (rsComm_t *rsComm)
+{
+    char shmName[NAME_LEN];
+
+    getSvrCfgSnapName (rsComm, shmName);
+    if (shm_unlink (shmName) < 0 && errno != ENOENT) {
+        rodsLog (LOG_NOTICE,
+          "removeSvrCfgSnap: shm_unlink of %s error, errno = %d",
+          shmName, errno);
+        return SYS_SVR_CFG_SNAP_ERR - errno;
+    }
+    return 0;
+}
+#else	/* windows_platform */
+int
+beginSvrCfgSnap (rsComm_t *rsComm)
+{
+    freeSvrCfgSnap ();
+    return 0;
+}
+
+static int
+publishSvrCfgSnap (rsComm_t *rsComm)
+{
+    return SYS_NOT_SUPPORTED;
+}
+
+int
+bumpSvrCfgGeneration (rsComm_t *rsComm)
+{
+    return 0;
+}
+
+int
+removeSvrCfgSnap (rsComm_t *rsComm)
+{
+    return 0;
+}
+#endif	/* windows_platform */
+
+/* endSvrCfgSnap - called by initServerInfo after initZone and initResc
+ * with their status. Publishes the captured results if the queries
+ * succeeded.
+ */
+int
+endSvrCfgSnap (rsComm_t *rsComm, int inpStatus)
+{
+    int status = 0;
+
+    if (SvrCfgSnap.state == SVR_CFG_SNAP_CAPTURE && inpStatus >= 0 &&
+      SvrCfgSnap.resultCnt > 0) {
+        status = publishSvrCfgSnap (rsComm);
+    }
+    freeSvrCfgSnap ();
+
+    return status;
+}
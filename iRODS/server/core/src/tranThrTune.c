@@ -0,0 +1,316 @@
+/*** Copyright (c), The Regents of the University of California            ***
+ *** For more information please refer to files in the COPYRIGHT directory ***/
+
+/* tranThrTune.c - routines for tuning the number of threads of a parallel
+ * transfer from the measured throughput. svrPortalPutGet records the
+ * throughput of each completed transfer by the resource, the subnet of
+ * the client and the size class of the file in a shared memory table,
+ * so the history is kept when the agents exit. getTunedNumThreads
+ * (used by msiSetNumThreads with "adaptive") returns the thread count
+ * with the best throughput so far, and now and then one next to it so
+ * that a change of the link or the disk is noticed. The trials go by the
+ * number of counts given out, not the number measured, since a count may
+ * not end up in a portal transfer (e.g. one thread to a local resource).
+ */
+
+#include "tranThrTune.h"
+
+#ifndef windows_platform
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <arpa/inet.h>
+#endif
+
+int
+getTranThrExplore ()
+{
+    char *tmpStr;
+    int explore;
+
+    if ((tmpStr = getenv (TRAN_THR_EXPLORE_KW)) == NULL)
+        return DEF_TRAN_THR_EXPLORE;
+    explore = atoi (tmpStr);
+    if (explore < 0) return 0;
+    return explore;
+}
+
+static int
+getTranThrSizeClass (rodsLong_t dataSize)
+{
+    if (dataSize < TRAN_THR_SMALL_SZ)
+        return TRAN_THR_SMALL_CLASS;
+    else if (dataSize < TRAN_THR_LARGE_SZ)
+        return TRAN_THR_MEDIUM_CLASS;
+    else
+        return TRAN_THR_LARGE_CLASS;
+}
+
+#ifndef windows_platform
+static unsigned int
+getTranThrSubnet (rsComm_t *rsComm)
+{
+    struct in_addr inAddr;
+
+    if (inet_aton (rsComm->clientAddr, &inAddr) == 0) return 0;
+    return ntohl (inAddr.s_addr) & TRAN_THR_SUBNET_MASK;
+}
+
+static void
+getTranThrTableName (rsComm_t *rsComm, char *shmName)
+{
+    snprintf (shmName, NAME_LEN, "%s.%d", TRAN_THR_TUNE_NAME,
+      rsComm->myEnv.rodsPort);
+}
+
+static int
+lockTranThrTable (int fd, int lockType)
+{
+    struct flock myLock;
+    int status;
+
+    memset (&myLock, 0, sizeof (myLock));
+    myLock.l_type = lockType;
+    myLock.l_whence = SEEK_SET;
+
+    while ((status = fcntl (fd, F_SETLKW, &myLock)) < 0 && errno == EINTR);
+
+    if (status < 0) {
+        rodsLog (LOG_NOTICE,
+          "lockTranThrTable: fcntl error, errno = %d", errno);
+        return SYS_TRAN_THR_TUNE_ERR - errno;
+    }
+    return 0;
+}
+
+/* mapTranThrTable - open, lock and map the table. A write lock creates
+ * the table if needed. Returns NULL if there is no table. */
+static tranThrTable_t *
+mapTranThrTable (rsComm_t *rsComm, int lockType, int *outFd)
+{
+    char shmName[NAME_LEN];
+    struct stat statbuf;
+    tranThrTable_t *table;
+    int fd;
+
+    getTranThrTableName (rsComm, shmName);
+    if (lockType == F_WRLCK) {
+        fd = shm_open (shmName, O_RDWR | O_CREAT, 0600);
+    } else {
+        fd = shm_open (shmName, O_RDONLY, 0);
+    }
+    if (fd < 0) {
+        if (lockType == F_WRLCK) {
+            rodsLog (LOG_NOTICE,
+              "mapTranThrTable: shm_open of %s error, errno = %d",
+              shmName, errno);
+        }
+        return NULL;
+    }
+    if (lockTranThrTable (fd, lockType) < 0) {
+        close (fd);
+        return NULL;
+    }
+    if (fstat (fd, &statbuf) < 0 ||
+      (statbuf.st_size < (off_t) sizeof (tranThrTable_t) &&
+      (lockType != F_WRLCK || ftruncate (fd, sizeof (tranThrTable_t)) < 0))) {
+        lockTranThrTable (fd, F_UNLCK);
+        close (fd);
+        return NULL;
+    }
+    table = (tranThrTable_t *) mmap (NULL, sizeof (tranThrTable_t),
+      lockType == F_WRLCK ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED,
+      fd, 0);
+    if (table == MAP_FAILED) {
+        rodsLog (LOG_NOTICE,
+          "mapTranThrTable: mmap of %s error, errno = %d", shmName, errno);
+        lockTranThrTable (fd, F_UNLCK);
+        close (fd);
+        return NULL;
+    }
+    if (table->magic != TRAN_THR_TUNE_MAGIC) {
+        if (lockType != F_WRLCK) {
+            munmap (table, sizeof (tranThrTable_t));
+            lockTranThrTable (fd, F_UNLCK);
+            close (fd);
+            return NULL;
+        }
+        memset (table, 0, sizeof (tranThrTable_t));
+        table->magic = TRAN_THR_TUNE_MAGIC;
+    }
+    *outFd = fd;
+    return table;
+}
+
+static void
+unmapTranThrTable (tranThrTable_t *table, int fd)
+{
+    munmap (table, sizeof (tranThrTable_t));
+    lockTranThrTable (fd, F_UNLCK);
+    close (fd);
+}
+
+static tranThrEntry_t *
+matchTranThrEntry (tranThrTable_t *table, char *rescName,
+unsigned int subnet, int sizeClass)
+{
+    int i;
+
+    if (table->entryCnt > MAX_TRAN_THR_ENTRY) return NULL;
+    for (i = 0; i < table->entryCnt; i++) {
+        tranThrEntry_t *entry = &table->entry[i];
+        if (entry->subnet == subnet && entry->sizeClass == sizeClass &&
+          strcmp (entry->rescName, rescName) == 0)
+            return entry;
+    }
+    return NULL;
+}
+
+/* getTunedNumThreads - return the number of threads to use for a transfer
+ * of dataSize bytes between the client and rescName. defNumThr is used
+ * until there is some history. The result is no more than maxNumThr.
+ */
+int
+getTunedNumThreads (rsComm_t *rsComm, char *rescName, rodsLong_t dataSize,
+int defNumThr, int maxNumThr)
+{
+    tranThrTable_t *table;
+    tranThrEntry_t *entry;
+    int fd, i, explore;
+    int best = 0;
+    int numThr;
+
+    /* no point in a thread with less than TRANS_BUF_SZ to do */
+    if (dataSize / TRANS_BUF_SZ + 1 < maxNumThr)
+        maxNumThr = dataSize / TRANS_BUF_SZ + 1;
+    if (maxNumThr > MAX_NUM_CONFIG_TRAN_THR)
+        maxNumThr = MAX_NUM_CONFIG_TRAN_THR;
+    if (maxNumThr <= 1) return maxNumThr;
+    if (defNumThr > maxNumThr)
+        defNumThr = maxNumThr;
+    else if (defNumThr < 1)
+        defNumThr = 1;
+
+    if (rsComm == NULL || rescName == NULL || *rescName == '\0')
+        return defNumThr;
+
+    /* a write lock, since pickCnt is updated */
+    if ((table = mapTranThrTable (rsComm, F_WRLCK, &fd)) == NULL)
+        return defNumThr;
+
+    entry = matchTranThrEntry (table, rescName, getTranThrSubnet (rsComm),
+      getTranThrSizeClass (dataSize));
+    if (entry != NULL) {
+        for (i = 1; i <= maxNumThr; i++) {
+            if (entry->sampleCnt[i] > 0 &&
+              (best == 0 || entry->rate[i] > entry->rate[best]))
+                best = i;
+        }
+    }
+    if (best == 0) {
+        unmapTranThrTable (table, fd);
+        return defNumThr;
+    }
+
+    numThr = best;
+    explore = getTranThrExplore ();
+    if (entry->pickCnt < 0) entry->pickCnt = 0;
+    if (explore > 0 && entry->pickCnt % explore == explore - 1) {
+        /* try the least measured count next to the best one. Not 1,
+         * which may go without a portal and then is never measured */
+        int cand[4];
+        cand[0] = best - 1;
+        cand[1] = best + 1;
+        cand[2] = best / 2;
+        cand[3] = best * 2;
+        for (i = 0; i < 4; i++) {
+            if (cand[i] <= 1 || cand[i] > maxNumThr || cand[i] == best)
+                continue;
+            if (numThr == best ||
+              entry->sampleCnt[cand[i]] < entry->sampleCnt[numThr])
+                numThr = cand[i];
+        }
+    }
+    entry->pickCnt++;
+    unmapTranThrTable (table, fd);
+
+    return numThr;
+}
+
+/* recordTranThrRate - add a completed transfer of dataSize bytes with
+ * numThreads threads to the history of rescName.
+ */
+int
+recordTranThrRate (rsComm_t *rsComm, char *rescName, rodsLong_t dataSize,
+int numThreads, rodsLong_t elapsedUsec)
+{
+    tranThrTable_t *table;
+    tranThrEntry_t *entry;
+    unsigned int subnet;
+    int sizeClass;
+    double rate;
+    int fd, i;
+
+    if (rescName == NULL || *rescName == '\0' || numThreads <= 0 ||
+      numThreads > MAX_NUM_CONFIG_TRAN_THR || elapsedUsec <= 0 ||
+      dataSize <= 0) {
+        return 0;
+    }
+
+    if ((table = mapTranThrTable (rsComm, F_WRLCK, &fd)) == NULL)
+        return SYS_TRAN_THR_TUNE_ERR;
+
+    subnet = getTranThrSubnet (rsComm);
+    sizeClass = getTranThrSizeClass (dataSize);
+    if (table->entryCnt < 0 || table->entryCnt > MAX_TRAN_THR_ENTRY)
+        table->entryCnt = 0;
+    entry = matchTranThrEntry (table, rescName, subnet, sizeClass);
+    if (entry == NULL) {
+        if (table->entryCnt < MAX_TRAN_THR_ENTRY) {
+            entry = &table->entry[table->entryCnt];
+            table->entryCnt++;
+        } else {
+            /* replace the least recently used one */
+            entry = &table->entry[0];
+            for (i = 1; i < MAX_TRAN_THR_ENTRY; i++) {
+                if (table->entry[i].lastUsed < entry->lastUsed)
+                    entry = &table->entry[i];
+            }
+        }
+        memset (entry, 0, sizeof (tranThrEntry_t));
+        rstrcpy (entry->rescName, rescName, NAME_LEN);
+        entry->subnet = subnet;
+        entry->sizeClass = sizeClass;
+    }
+
+    rate = (double) dataSize * 1000000.0 / (double) elapsedUsec;
+    if (entry->sampleCnt[numThreads] == 0) {
+        entry->rate[numThreads] = rate;
+    } else {
+        entry->rate[numThreads] += TRAN_THR_EWMA_WEIGHT *
+          (rate - entry->rate[numThreads]);
+    }
+    entry->sampleCnt[numThreads]++;
+    entry->tranCnt++;
+    entry->lastUsed = time (NULL);
+
+    unmapTranThrTable (table, fd);
+
+    return 0;
+}
+#else	/* windows_platform */
+int
+getTunedNumThreads (rsComm_t *rsComm, char *rescName, rodsLong_t dataSize,
+int defNumThr, int maxNumThr)
+{
+    if (defNumThr > maxNumThr) defNumThr = maxNumThr;
+    return defNumThr;
+}
+
+int
+recordTranThrRate (rsComm_t *rsComm, char *rescName, rodsLong_t dataSize,
+int numThreads, rodsLong_t elapsedUsec)
+{
+    return 0;
+}
+#endif	/* windows_platform */
@@ -57,6 +57,7 @@
 
 #define NB_READ_TOUT_SEC	60	/* 60 sec timeout */
 #define NB_WRITE_TOUT_SEC	60	/* 60 sec timeout */
+#define SPLICE_PIPE_SZ		(1024*1024)	/* pipe size for splice */
 
 int
 unixFileCreate (rsComm_t *rsComm, char *fileName, int mode, rodsLong_t mySize, keyValPair_t *condInput);
@@ -114,5 +115,13 @@ int
 nbFileRead (rsComm_t *rsComm, int fd, void *buf, int len);
 int
 nbFileWrite (rsComm_t *rsComm, int fd, void *buf, int len);
+int
+unixFileSendToSock (int fd, int sock, int len);
+int
+unixFileOpenSplicePipe (int *pipeFd);
+int
+unixFileRecvFromSock (int fd, int sock, int len, int *pipeFd, char *buf);
+rodsLong_t
+unixFileCopyRange (int inFd, int outFd, rodsLong_t len);
 
 #endif	/* UNIX_FILE_DRIVER_H */
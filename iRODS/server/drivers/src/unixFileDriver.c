@@ -6,6 +6,11 @@
 
 
 #include "unixFileDriver.h"
+#ifdef linux_platform
+#include <sys/sendfile.h>
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+#endif
 
 int
 unixFileCreate (rsComm_t *rsComm, char *fileName, int mode, rodsLong_t mySize, keyValPair_t *condInput)
@@ -615,7 +620,7 @@ int
 unixFileCopy (int mode, char *srcFileName, char *destFileName)
 {
     int inFd, outFd;
-    char myBuf[TRANS_BUF_SZ];
+    char *myBuf;
     rodsLong_t bytesCopied = 0;
     int bytesRead;
     int bytesWritten;
@@ -650,6 +655,22 @@ unixFileCopy (int mode, char *srcFileName, char *destFileName)
         return status;
     }
 
+    /* let the kernel do it if it can */
+    bytesCopied = unixFileCopyRange (inFd, outFd, statbuf.st_size);
+    if (bytesCopied == SYS_NOT_SUPPORTED) {
+	bytesCopied = 0;
+    } else if (bytesCopied < 0) {
+	status = (int) bytesCopied;
+        rodsLog (LOG_ERROR,
+         "unixFileCopy: copy error for destFileName %s, status = %d",
+         destFileName, status);
+	close (inFd);
+	close (outFd);
+	return status;
+    }
+
+    /* whatever is left, e.g., the file has grown */
+    myBuf = (char *) malloc (TRANS_BUF_SZ);
     while ((bytesRead = read (inFd, (void *) myBuf, TRANS_BUF_SZ)) > 0) {
 	bytesWritten = write (outFd, (void *) myBuf, bytesRead);
 	if (bytesWritten <= 0) {
@@ -657,12 +678,14 @@ unixFileCopy (int mode, char *srcFileName, char *destFileName)
             rodsLog (LOG_ERROR,
              "unixFileCopy: write error for srcFileName %s, status = %d",
              destFileName, status);
+	    free (myBuf);
 	    close (inFd);
 	    close (outFd);
             return status;
 	}
 	bytesCopied += bytesWritten;
     }
+    free (myBuf);
 
     close (inFd);
     close (outFd);
@@ -677,3 +700,182 @@ unixFileCopy (int mode, char *srcFileName, char *destFileName)
     }
 }
 
+
+/* unixFileCopyRange - copy len bytes from the current offset of inFd to
+ * the current offset of outFd inside the kernel with copy_file_range, 
+ * which may also share the blocks (nfs, xfs, btrfs). A copy of a whole
+ * file first tries a FICLONE reflink, which shares all the blocks at
+ * once. Both offsets are moved past the bytes copied. Returns the bytes
+ * copied, or SYS_NOT_SUPPORTED if nothing was copied and the caller 
+ * should use read/write instead, e.g., the files are on different
+ * file systems.
+ */
+rodsLong_t
+unixFileCopyRange (int inFd, int outFd, rodsLong_t len)
+{
+#ifdef linux_platform
+#if defined(__GLIBC__) && \
+  (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+    rodsLong_t total = 0;
+    ssize_t nbytes;
+#endif
+#ifdef FICLONE
+    struct stat statbuf;
+
+    if (len > 0 && lseek (inFd, 0, SEEK_CUR) == 0 && 
+      lseek (outFd, 0, SEEK_CUR) == 0 && fstat (inFd, &statbuf) == 0 &&
+      statbuf.st_size == len && ioctl (outFd, FICLONE, inFd) == 0) {
+	lseek (inFd, len, SEEK_SET);
+	lseek (outFd, len, SEEK_SET);
+	return len;
+    }
+#endif
+#if defined(__GLIBC__) && \
+  (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+    while (total < len) {
+	nbytes = copy_file_range (inFd, NULL, outFd, NULL, 
+	  (size_t) (len - total), 0);
+        if (nbytes < 0) {
+            if (errno == EINTR) continue;
+            if (total == 0 && (errno == EXDEV || errno == EINVAL ||
+	      errno == ENOSYS || errno == EOPNOTSUPP || errno == EBADF))
+                return SYS_NOT_SUPPORTED;
+            rodsLog (LOG_NOTICE,
+              "unixFileCopyRange: copy_file_range error, errno = %d", errno);
+            return UNIX_FILE_WRITE_ERR - errno;
+        } else if (nbytes == 0) {
+            /* EOF */
+            break;
+        }
+        total += nbytes;
+    }
+    return total;
+#else
+    return SYS_NOT_SUPPORTED;
+#endif
+#else
+    return SYS_NOT_SUPPORTED;
+#endif
+}
+
+/* unixFileSendToSock - send len bytes starting at the current offset of
+ * the unix file fd to sock without copying them to user space. Returns
+ * the bytes sent, or SYS_NOT_SUPPORTED if nothing was sent and the
+ * caller should use read/write instead.
+ */
+int
+unixFileSendToSock (int fd, int sock, int len)
+{
+#ifdef linux_platform
+    int total = 0;
+    ssize_t nbytes;
+
+    while (total < len) {
+        nbytes = sendfile (sock, fd, NULL, len - total);
+        if (nbytes < 0) {
+            if (errno == EINTR) continue;
+            if (total == 0 && (errno == EINVAL || errno == ENOSYS))
+                return SYS_NOT_SUPPORTED;
+            rodsLog (LOG_NOTICE,
+              "unixFileSendToSock: sendfile error, errno = %d", errno);
+            return UNIX_FILE_READ_ERR - errno;
+        } else if (nbytes == 0) {
+            /* EOF */
+            break;
+        }
+        total += nbytes;
+    }
+    return total;
+#else
+    return SYS_NOT_SUPPORTED;
+#endif
+}
+
+/* unixFileOpenSplicePipe - create the pipe used by unixFileRecvFromSock.
+ */
+int
+unixFileOpenSplicePipe (int *pipeFd)
+{
+#ifdef linux_platform
+    if (pipe (pipeFd) < 0) return SYS_NOT_SUPPORTED;
+#ifdef F_SETPIPE_SZ
+    /* fewer round trips per slice. Failure just keeps the default size */
+    fcntl (pipeFd[1], F_SETPIPE_SZ, SPLICE_PIPE_SZ);
+#endif
+    return 0;
+#else
+    return SYS_NOT_SUPPORTED;
+#endif
+}
+
+/* unixFileRecvFromSock - receive len bytes from sock and write them at the
+ * current offset of the unix file fd, moving the pages through pipeFd
+ * with splice. If the file system cannot take spliced pages, what is in
+ * the pipe and the rest of len go through buf, which must hold at least
+ * len bytes. Returns the bytes written, or SYS_NOT_SUPPORTED if nothing
+ * was received and the caller should use read/write instead.
+ */
+int
+unixFileRecvFromSock (int fd, int sock, int len, int *pipeFd, char *buf)
+{
+#ifdef linux_platform
+    int total = 0;
+    ssize_t nbytes, inPipe, moved;
+
+    while (total < len) {
+        nbytes = splice (sock, NULL, pipeFd[1], NULL, len - total,
+          SPLICE_F_MOVE | SPLICE_F_MORE);
+        if (nbytes < 0) {
+            if (errno == EINTR) continue;
+            if (total == 0 && (errno == EINVAL || errno == ENOSYS))
+                return SYS_NOT_SUPPORTED;
+            rodsLog (LOG_NOTICE,
+              "unixFileRecvFromSock: splice from sock error, errno = %d",
+              errno);
+            return SYS_SOCK_READ_ERR - errno;
+        } else if (nbytes == 0) {
+            /* the peer closed the connection */
+            break;
+        }
+        inPipe = nbytes;
+        while (inPipe > 0) {
+            moved = splice (pipeFd[0], NULL, fd, NULL, inPipe,
+              SPLICE_F_MOVE | SPLICE_F_MORE);
+            if (moved > 0) {
+                inPipe -= moved;
+                total += moved;
+                continue;
+            } else if (moved < 0 && errno == EINTR) {
+                continue;
+            } else if (moved < 0 && errno != EINVAL) {
+                rodsLog (LOG_NOTICE,
+                  "unixFileRecvFromSock: splice to file error, errno = %d",
+                  errno);
+                return UNIX_FILE_WRITE_ERR - errno;
+            }
+            /* the file system does not take spliced pages. Drain the
+             * pipe and finish the slice with read/write */
+            if (myRead (pipeFd[0], buf, inPipe, FILE_DESC_TYPE, NULL, NULL) 
+              != inPipe || 
+              myWrite (fd, buf, inPipe, FILE_DESC_TYPE, NULL) != inPipe) {
+                return UNIX_FILE_WRITE_ERR - errno;
+            }
+            total += inPipe;
+            if (total < len) {
+                nbytes = myRead (sock, buf, len - total, SOCK_TYPE, NULL, 
+                  NULL);
+                if (nbytes <= 0) return total;
+                if (myWrite (fd, buf, nbytes, FILE_DESC_TYPE, NULL) != 
+                  nbytes) {
+                    return UNIX_FILE_WRITE_ERR - errno;
+                }
+                total += nbytes;
+            }
+            return total;
+        }
+    }
+    return total;
+#else
+    return SYS_NOT_SUPPORTED;
+#endif
+}
@@ -12,7 +12,11 @@
 
 #define   MAX_NUM_OF_SELECT_ITEMS                  30
 #define   MAX_NUM_OF_CONCURRENT_STMTS              50
+#define   MAX_NUM_OF_CACHED_STMTS                  40  /* prepared stmts
+                                  kept per connection, see icatLowLevelOdbc.c */
 #define   MAX_NUM_OF_COLS_IN_TABLE                 50
+#define   MAX_SEQ_VAL_BLOCK                        64  /* object ids
+                    reserved at a time, see cmlGetNextSeqVal */
 #define   MAX_SQL_SIZE  4000
 #define   MAX_SQL_SIZE_GENERAL_QUERY  12000
 
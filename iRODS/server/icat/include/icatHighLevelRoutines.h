@@ -20,9 +20,12 @@
 int chlOpen(char *DBUser, char *DBpasswd);
 int chlClose();
 int chlIsConnected();
+int chlResetSession(rsComm_t *rsComm);
 int chlModDataObjMeta(rsComm_t *rsComm, dataObjInfo_t *dataObjInfo,
     keyValPair_t *regParam);
 int chlRegDataObj(rsComm_t *rsComm, dataObjInfo_t *dataObjInfo);
+int chlRegDataObjBulk(rsComm_t *rsComm, dataObjInfo_t *dataObjInfo,
+		      int numOfObjs);
 int chlRegRuleExecObj(rsComm_t *rsComm,
 		      ruleExecSubmitInp_t *ruleExecSubmitInp);
 int chlRegReplica(rsComm_t *rsComm, dataObjInfo_t *srcDataObjInfo,
@@ -46,6 +49,7 @@ int chlGenQuery(genQueryInp_t genQueryInp, genQueryOut_t *result);
 int chlGenQueryAccessControlSetup(char *user, char *zone, char *host, 
 				  int priv, int controlFlag);
 int chlGenQueryTicketSetup(char *ticket, char *clientAddr);
+int chlGenQueryResetSession();
 int chlSpecificQuery(specificQueryInp_t specificQueryInp,
                      genQueryOut_t *genQueryOut);
 
@@ -135,6 +139,7 @@ int sColumn(int defineVal, char *tableName, char *columnName);
 
 int chlDebug(char *debugMode);
 int chlDebugGenQuery(int mode);
+int chlGenQueryPlanCache(int onOff);
 int chlDebugGenUpdate(int mode);
 int chlInsRuleTable(rsComm_t *rsComm,
 		    char *baseName, char *priorityStr, char *ruleName,
@@ -28,6 +28,7 @@
 #define MAX_BIND_VARS  120
 
 extern int cllBindVarCount;
+extern int cllFetchRows;
 extern char *cllBindVars[MAX_BIND_VARS];
 
 
@@ -48,6 +49,8 @@ int cllConnectRda(icatSessionStruct *icss);
 int cllConnectDbr(icatSessionStruct *icss, char *odbcEntryName);
 int cllDisconnect(icatSessionStruct *icss);
 int cllExecSqlNoResult(icatSessionStruct *icss, char *sql);
+int cllExecSqlNoResultArray(icatSessionStruct *icss, char *sql,
+			    char *bindVars[], int numOfVars, int numOfRows);
 int cllExecSqlWithResult(icatSessionStruct *icss, int *stmtNum, char *sql);
 int cllExecSqlWithResultBV(icatSessionStruct *icss, int *stmtNum, char *sql,
 			     char *bindVar1, char *bindVar2, char *bindVar3,
@@ -60,5 +63,6 @@ int cllCurrentValueString(char *itemName, char *outString, int maxSize);
 int cllGetRowCount(icatSessionStruct *icss, int statementNumber);
 int cllCheckPending(char *sql, int option, int dbType);
 int cllGetLastErrorMessage(char *msg, int maxChars);
+int cllSetStmtCache(icatSessionStruct *icss, int onOff);
 
 #endif	/* CLL_PSQ_H */
@@ -15,6 +15,7 @@
 #define MAX_BIND_VARS 120
 
 extern int cllBindVarCount;
+extern int cllFetchRows;
 extern char *cllBindVars[MAX_BIND_VARS];
 
 
@@ -23,6 +24,8 @@ int cllCloseEnv(icatSessionStruct *icss);
 int cllConnect(icatSessionStruct *icss);
 int cllDisconnect(icatSessionStruct *icss);
 int cllExecSqlNoResult(icatSessionStruct *icss, char *sql);
+int cllExecSqlNoResultArray(icatSessionStruct *icss, char *sql,
+			    char *bindVars[], int numOfVars, int numOfRows);
 int cllExecSqlNoResultBV(icatSessionStruct *icss, char *sql, char *bindVar1,
 		       char *bindVar2, char *bindVar3);
 int cllExecSqlWithResult(icatSessionStruct *icss, int *stmtNum, char *sql);
@@ -39,4 +42,5 @@ int cllGetRowCount(icatSessionStruct *icss, int statementNumber);
 int cllConnectRda(icatSessionStruct *icss);
 int cllConnectDbr(icatSessionStruct *icss, char *unused);
 int cllGetLastErrorMessage(char *msg, int maxChars);
+int cllSetStmtCache(icatSessionStruct *icss, int onOff);
 #endif	/* CLL_ORA_H */
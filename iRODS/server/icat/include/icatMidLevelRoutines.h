@@ -19,6 +19,12 @@ int cmlClose( icatSessionStruct *icss);
 int cmlExecuteNoAnswerSql( char *sql, 
 			   icatSessionStruct *icss);
 
+int cmlExecuteNoAnswerSqlArray( char *sql, 
+				char *bindVars[],
+				int numOfVars,
+				int numOfRows,
+				icatSessionStruct *icss);
+
 int cmlGetRowFromSql (char *sql, 
 		   char *cVal[], 
 		   int cValSize[], 
@@ -155,6 +161,9 @@ int cmlGetOneRowFromSql (char *sql,
 
 rodsLong_t cmlGetNextSeqVal(icatSessionStruct *icss);
 
+int cmlGetNextSeqVals(int numOfVals, rodsLong_t seqVals[], 
+		      icatSessionStruct *icss);
+
 rodsLong_t cmlGetCurrentSeqVal(icatSessionStruct *icss);
 
 int cmlGetNextSeqStr(char *seqStr, int maxSeqStrLen, icatSessionStruct *icss);
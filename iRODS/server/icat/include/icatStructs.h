@@ -20,8 +20,24 @@ typedef struct
   int     selectColIds[MAX_NUM_OF_SELECT_ITEMS];  /* rods-id to column in the
                                                      result (unused, so far) */
   char    *resultValue[MAX_NUM_OF_SELECT_ITEMS];  /* pointer to data area */
+  int     cachedStmtInx;  /* index in icss->cachedStmt, -1 if not cached */
+  int     rowArraySize;   /* rows gotten per fetch (block fetch) */
+  int     numOfRows;      /* rows in the current block */
+  int     curRow;         /* the row of the block in resultValue */
+  char    *resultBlock[MAX_NUM_OF_SELECT_ITEMS]; /* rowArraySize values
+                                       per column; resultValue points in */
+  int     resultLen[MAX_NUM_OF_SELECT_ITEMS];  /* size of each value */
+  void    *fetchArea;     /* db specific fetch info (indicators) */
 } icatStmtStrct;
 
+typedef struct
+{
+  char    *sql;             /* the SQL text, the key of the cache */
+  void*   stmtPtr;          /* the prepared db statement handle */
+  int     inUse;            /* executing or has an open result set */
+  int     lastUsed;         /* for the LRU replacement */
+} icatCachedStmtStrct;
+
 
 
 typedef struct {
@@ -32,6 +48,10 @@ typedef struct {
   char databaseUsername[DB_USERNAME_LEN];  /* username for accessing the db */
   char databasePassword[DB_PASSWORD_LEN];  /* password for accessing the db */
   int         databaseType;     /* DB type, DB_TYPE_POSTGRES, etc */
+  icatCachedStmtStrct cachedStmt[MAX_NUM_OF_CACHED_STMTS]; /* prepared
+                                   statements, reused by SQL text */
+  int         cachedStmtClock;  /* LRU clock for cachedStmt */
+  int         cachedStmtOff;    /* set to not use the cache */
 }icatSessionStruct;
 
 
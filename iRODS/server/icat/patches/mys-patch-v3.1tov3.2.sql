@@ -0,0 +1,26 @@
+--- Run these SQL statements using the MySQL client mysql
+--- to upgrade from a 3.1 MySQL ICAT to 3.2.
+
+create table R_COLL_ANCESTRY
+(
+   ancestor_id bigint not null,
+   coll_id bigint not null
+);
+
+--- Fill in the collection tree: each collection is under '/', itself
+--- and each collection whose name (plus a '/') begins its name.
+insert into R_COLL_ANCESTRY (ancestor_id, coll_id)
+   select A.coll_id, C.coll_id from R_COLL_MAIN A, R_COLL_MAIN C
+   where A.coll_name = '/' or A.coll_id = C.coll_id or
+      substr(C.coll_name, 1, char_length(A.coll_name)+1) = concat(A.coll_name, '/');
+
+create unique index idx_coll_ancestry1 on R_COLL_ANCESTRY (ancestor_id,coll_id);
+create index idx_coll_ancestry2 on R_COLL_ANCESTRY (coll_id);
+
+create table R_QUOTA_DELTA
+(
+   user_id bigint,
+   resc_id bigint,
+   quota_delta bigint,
+   modify_ts varchar(32)
+);
@@ -21,3 +21,30 @@ create table R_OBJT_FILESYSTEM_META
 create unique index idx_obj_filesystem_meta1 on R_OBJT_FILESYSTEM_META (object_id);
 
 insert into R_TOKN_MAIN values ('resc_type',407,'direct access file system','','','','','1311740184','1311740184');
+
+create table R_COLL_ANCESTRY
+(
+   ancestor_id bigint not null,
+   coll_id bigint not null
+);
+
+--- Fill in the collection tree by walking up from each collection.
+insert into R_COLL_ANCESTRY (ancestor_id, coll_id)
+with recursive T (ancestor_id, coll_id, parent_name) as (
+   select coll_id, coll_id, parent_coll_name from R_COLL_MAIN
+   union all
+   select P.coll_id, T.coll_id, P.parent_coll_name from T, R_COLL_MAIN P
+      where P.coll_name = T.parent_name and P.coll_id <> T.ancestor_id
+)
+select ancestor_id, coll_id from T;
+
+create unique index idx_coll_ancestry1 on R_COLL_ANCESTRY (ancestor_id,coll_id);
+create index idx_coll_ancestry2 on R_COLL_ANCESTRY (coll_id);
+
+create table R_QUOTA_DELTA
+(
+   user_id bigint,
+   resc_id bigint,
+   quota_delta bigint,
+   modify_ts varchar(32)
+);
@@ -32,6 +32,8 @@ drop table R_TICKET_MAIN;
 drop table R_TICKET_ALLOWED_GROUPS;
 drop table R_TICKET_ALLOWED_USERS;
 drop table R_TICKET_ALLOWED_HOSTS;
+drop table R_COLL_ANCESTRY;
+drop table R_QUOTA_DELTA;
 drop sequence R_ObjectId;
 drop index idx_zone_main1;
 drop index idx_zone_main2;
@@ -68,3 +70,5 @@ drop index idx_tokn_main3;
 drop index idx_tokn_main4;
 drop index idx_specific_query1;
 drop index idx_specific_query2;
+drop index idx_coll_ancestry1;
+drop index idx_coll_ancestry2;
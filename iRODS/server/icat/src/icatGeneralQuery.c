@@ -1000,6 +1000,8 @@ checkCondition(char *condition) {
    if (cp != NULL) setBlank(cp, 8);
    cp = strstr(tmpStr,"parent_of");
    if (cp != NULL) setBlank(cp, 9);
+   cp = strstr(tmpStr,"descendant_of");
+   if (cp != NULL) setBlank(cp, 13);
    cp = strstr(tmpStr,"not");
    if (cp != NULL) setBlank(cp, 3);
    cp = strstr(tmpStr,"NOT");
@@ -1177,6 +1179,31 @@ addBetweenClauseToWhere(char *inArg) {
    return(0);
 }
 
+/*
+add a clause to the whereSQL string for the descendant_of option:
+the column (a collection name) is collName or the name of a
+collection under it.  This uses the collection tree (R_COLL_ANCESTRY)
+instead of a LIKE 'collName/%' scan of R_COLL_MAIN.  The bind
+variable (collName) is already set.
+ */
+int
+addDescendantOfClauseToWhere() {
+   int len, suffixLen;
+
+   len = strlen(whereSQL);
+   suffixLen = strlen(".coll_name");
+   if (len > suffixLen && 
+       strcmp(whereSQL+len-suffixLen, ".coll_name")==0) {
+      /* a coll_name column, use the coll_id of the same table */
+      whereSQL[len-suffixLen]='\0';
+      rstrcat(whereSQL, ".coll_id IN (select CA.coll_id from R_COLL_ANCESTRY CA where CA.ancestor_id = (select CA_P.coll_id from R_COLL_MAIN CA_P where CA_P.coll_name = ?))", MAX_SQL_SIZE_GQ);
+   }
+   else {
+      rstrcat(whereSQL, " IN (select CA_C.coll_name from R_COLL_MAIN CA_C, R_COLL_ANCESTRY CA where CA_C.coll_id = CA.coll_id and CA.ancestor_id = (select CA_P.coll_id from R_COLL_MAIN CA_P where CA_P.coll_name = ?))", MAX_SQL_SIZE_GQ);
+   }
+   return(0);
+}
+
 /*
 insert a new where clause using bind-variables
  */
@@ -1256,7 +1283,7 @@ insertWhere(char *condition, int option) {
    cllBindVars[cllBindVarCount++]=thisBindVar;
 
  /* basic legality check on the condition */
-   if ((cpFirstQuote-condition) > 10) return(CAT_INVALID_ARGUMENT);
+   if ((cpFirstQuote-condition) > 15) return(CAT_INVALID_ARGUMENT);
 
    tmpStr[0]=' ';
    i=1;
@@ -1299,6 +1326,10 @@ insertWhere(char *condition, int option) {
 	 status = addInClauseToWhereForParentOf(thisBindVar);
 	 if (status < 0) return(status);
       }
+      else if (strstr(myCondition, "descendant_of") != NULL) {
+	 status = addDescendantOfClauseToWhere();
+	 if (status < 0) return(status);
+      }
       else {
 	 tmpStr[i++]='?';
 	 tmpStr[i++]=' ';
@@ -1473,6 +1504,218 @@ generateSpecialQuery(genQueryInp_t genQueryInp, char *resultingSQL) {
    return (0);
 }
 
+/*
+ The plan cache.  generateSQL keeps the SQL it made for each query
+ shape, so a repeated query skips setTable, tScan and the rest of the
+ planning.  The condition values are all bind variables, so the SQL of
+ a shape is always the same text and the statement cache of the ODBC
+ layer reuses the prepared statement too.
+
+ The key is made of the options, the select columns, the condition
+ columns and the SQL that insertWhere makes for the conditions (which
+ has the operators and the number of values of an IN or parent_of, but
+ not the values), plus the access control state and row offset that
+ change the SQL.  genqPlanKey makes the condition SQL with the same
+ calls generateSQL uses, so on a hit the bind variables are already set.
+ */
+#define MAX_GENQ_PLANS 64
+
+typedef struct {
+   unsigned int hash;
+   char *key;
+   char *sql;
+   char *countSQL;   /* Oracle only */
+   char *selectSQL;  /* for genqAppendAccessCheck */
+   int lastUsed;
+} genqPlan_t;
+
+static genqPlan_t genqPlans[MAX_GENQ_PLANS];
+static int genqPlanClock=0;
+static int genqPlanCacheOn=1;
+int genqPlanHits=0;
+int genqPlanMisses=0;
+
+static unsigned int
+genqPlanHash(char *key) {
+   unsigned int hash=5381;
+   char *cp;
+   for (cp=key;*cp!='\0';cp++) {
+      hash = hash*33 + (unsigned char)*cp;
+   }
+   return(hash);
+}
+
+/*
+ Change the condition genAllInCollQCond makes for everything under a
+ collection, " = 'X' || like 'X/%' ", to "descendant_of 'X'" so that
+ the query uses the collection tree instead of a LIKE prefix scan.
+ Only done for the collection name columns and when X has no
+ characters that are special to LIKE (or quotes), so the result is the
+ same.  The condition is changed in place (it only gets shorter).
+ */
+static void
+genqSubtreeConditions(genQueryInp_t genQueryInp) {
+   char *cond, *cp, *name;
+   int i, nameLen;
+
+   for (i=0;i<genQueryInp.sqlCondInp.len;i++) {
+      if (genQueryInp.sqlCondInp.inx[i]!=COL_COLL_NAME &&
+	  genQueryInp.sqlCondInp.inx[i]!=COL_COLL_PARENT_NAME) continue;
+      cond = genQueryInp.sqlCondInp.value[i];
+      cp = cond;
+      while (*cp==' ') cp++;
+      if (strncmp(cp, "= '", 3)!=0) continue;
+      name = cp+3;
+      nameLen = strcspn(name, "'%_");
+      if (nameLen==0 || name[nameLen]!='\'') continue;
+      cp = name+nameLen;
+      if (strncmp(cp, "' || like '", 11)!=0) continue;
+      cp += 11;
+      if (strncmp(cp, name, nameLen)!=0) continue;
+      cp += nameLen;
+      if (strncmp(cp, "/%'", 3)!=0) continue;
+      cp += 3;
+      while (*cp==' ') cp++;
+      if (*cp!='\0') continue;
+      /* the new condition is shorter, so it fits in cond */
+      memmove(cond+strlen("descendant_of '"), name, nameLen);
+      memcpy(cond, "descendant_of '", strlen("descendant_of '"));
+      cond[strlen("descendant_of '")+nameLen]='\'';
+      cond[strlen("descendant_of '")+nameLen+1]='\0';
+   }
+}
+
+/*
+ Make the plan cache key of genQueryInp, binding the condition values
+ on the way.  Returns 0 if the query is not to be cached.
+ */
+static int
+genqPlanKey(genQueryInp_t genQueryInp, char *key, int maxKeyLen) {
+   char condition[MAX_SQL_SIZE_GQ];
+   char *cptr;
+   int i, len, castOption, status;
+
+   len = snprintf(key, maxKeyLen, "o%d r%d a%d%d%d%d s", 
+		  genQueryInp.options,
+#if MY_ICAT
+		  genQueryInp.rowOffset,   /* the offset is in the SQL */
+#else
+		  genQueryInp.rowOffset > 0,
+#endif
+		  accessControlPriv==LOCAL_PRIV_USER_AUTH,
+		  accessControlControlFlag > 1,
+		  strncmp(accessControlUserName,ANONYMOUS_USER, MAX_NAME_LEN)==0,
+		  sessionTicket[0]!='\0');
+   for (i=0;i<genQueryInp.selectInp.len && len<maxKeyLen;i++) {
+      len += snprintf(key+len, maxKeyLen-len, "%d:%d,", 
+		      genQueryInp.selectInp.inx[i],
+		      genQueryInp.selectInp.value[i]);
+   }
+
+   rstrcpy(whereSQL, "where ", MAX_SQL_SIZE_GQ);
+   insertWhere("",1);
+   handleCompoundCondition("", -1);
+   for (i=0;i<genQueryInp.sqlCondInp.len && len<maxKeyLen;i++) {
+      if (strlen(genQueryInp.sqlCondInp.value[i]) >= MAX_SQL_SIZE_GQ) {
+	 return(0);
+      }
+      /* a copy, generateSQL still needs to see the 'n' of a cast */
+      rstrcpy(condition, genQueryInp.sqlCondInp.value[i], MAX_SQL_SIZE_GQ);
+      castOption=0;
+      cptr = condition;
+      while (*cptr==' ') cptr++;
+      if (*cptr=='n' && 
+	  (*(cptr+1)=='<' || *(cptr+1)=='>' || *(cptr+1)=='=')) {
+	 castOption=1;
+	 *cptr=' ';
+      }
+      len += snprintf(key+len, maxKeyLen-len, " c%d:%d",
+		      genQueryInp.sqlCondInp.inx[i], castOption);
+      if (compoundConditionSpecified(condition)) {
+	 status = handleCompoundCondition(condition, strlen(whereSQL));
+      }
+      else {
+	 status = insertWhere(condition, 0);
+      }
+      if (status) return(0);  /* generateSQL will report it */
+   }
+   if (len<maxKeyLen) {
+      len += snprintf(key+len, maxKeyLen-len, " %s", whereSQL);
+   }
+   if (len>=maxKeyLen) return(0);
+   return(1);
+}
+
+static genqPlan_t *
+genqPlanFind(char *key) {
+   unsigned int hash;
+   int i;
+
+   hash = genqPlanHash(key);
+   for (i=0;i<MAX_GENQ_PLANS;i++) {
+      if (genqPlans[i].key != NULL && genqPlans[i].hash == hash &&
+	  strcmp(genqPlans[i].key, key)==0) {
+	 genqPlans[i].lastUsed = ++genqPlanClock;
+	 return(&genqPlans[i]);
+      }
+   }
+   return(NULL);
+}
+
+static void
+genqPlanFree(genqPlan_t *plan) {
+   if (plan->key != NULL) free(plan->key);
+   if (plan->sql != NULL) free(plan->sql);
+   if (plan->countSQL != NULL) free(plan->countSQL);
+   if (plan->selectSQL != NULL) free(plan->selectSQL);
+   memset(plan, 0, sizeof(genqPlan_t));
+}
+
+static void
+genqPlanSave(char *key, char *sql, char *countSQL) {
+   genqPlan_t *plan;
+   int i;
+
+   /* an empty slot or else the least recently used one */
+   plan = &genqPlans[0];
+   for (i=0;i<MAX_GENQ_PLANS;i++) {
+      if (genqPlans[i].key == NULL) {
+	 plan = &genqPlans[i];
+	 break;
+      }
+      if (genqPlans[i].lastUsed < plan->lastUsed) plan = &genqPlans[i];
+   }
+   genqPlanFree(plan);
+   plan->key = strdup(key);
+   plan->sql = strdup(sql);
+   plan->selectSQL = strdup(selectSQL);
+   if (countSQL != NULL) plan->countSQL = strdup(countSQL);
+   if (plan->key == NULL || plan->sql == NULL || plan->selectSQL == NULL ||
+       (countSQL != NULL && plan->countSQL == NULL)) {
+      genqPlanFree(plan);
+      return;
+   }
+   plan->hash = genqPlanHash(key);
+   plan->lastUsed = ++genqPlanClock;
+}
+
+/*
+ Turn the plan cache on (onOff=1) or off (0).  Turning it off also
+ drops the plans, so it starts out empty when turned on again.
+ */
+int
+chlGenQueryPlanCache(int onOff) {
+   int i;
+
+   genqPlanCacheOn = onOff;
+   if (onOff==0) {
+      for (i=0;i<MAX_GENQ_PLANS;i++) {
+	 genqPlanFree(&genqPlans[i]);
+      }
+   }
+   return(0);
+}
+
 /* 
 Called by chlGenQuery to generate the SQL.
 */
@@ -1496,12 +1739,46 @@ generateSQL(genQueryInp_t genQueryInp, char *resultingSQL,
 #else
    static char offsetStr[20];
 #endif
+   char planKey[MAX_SQL_SIZE_GQ*2];
+   genqPlan_t *plan;
+   int cllBindVarCountSave;
 
    if (firstCall) {
       icatGeneralQuerySetup(); /* initialize */
    }
    firstCall=0;
 
+   genqSubtreeConditions(genQueryInp);
+
+   planKey[0]='\0';
+   if (genqPlanCacheOn) {
+      cllBindVarCountSave = cllBindVarCount;
+      if (genqPlanKey(genQueryInp, planKey, sizeof(planKey))==0) {
+	 planKey[0]='\0';
+      }
+      else if ((plan = genqPlanFind(planKey)) != NULL) {
+	 /* the condition values are bound, add the rest as below */
+	 genqPlanHits++;
+	 if (debug) printf("plan cache hit: %s\n", plan->sql);
+	 rstrcpy(selectSQL, plan->selectSQL, MAX_SQL_SIZE_GQ);
+	 genqAppendAccessCheck();
+#if !ORA_ICAT && !MY_ICAT
+	 if (genQueryInp.rowOffset > 0) {
+	    snprintf (offsetStr, sizeof offsetStr, "%d", 
+		      genQueryInp.rowOffset);
+	    cllBindVars[cllBindVarCount++]=offsetStr;
+	 }
+#endif
+	 strncpy(resultingSQL, plan->sql, MAX_SQL_SIZE_GQ);
+#if ORA_ICAT
+	 strncpy(resultingCountSQL, plan->countSQL, MAX_SQL_SIZE_GQ);
+#endif
+	 return(0);
+      }
+      genqPlanMisses++;
+      cllBindVarCount = cllBindVarCountSave;
+   }
+
    nToFind = 0;
    for (i=0;i<nTables;i++) {
       Tables[i].flag=0;
@@ -1713,9 +1990,24 @@ generateSQL(genQueryInp_t genQueryInp, char *resultingSQL,
    if (debug) printf("countSQL=:%s:\n",countSQL);
    strncpy(resultingCountSQL, countSQL, MAX_SQL_SIZE_GQ);
 #endif
+
+   if (planKey[0]!='\0') {
+#if ORA_ICAT
+      genqPlanSave(planKey, combinedSQL, countSQL);
+#else
+      genqPlanSave(planKey, combinedSQL, NULL);
+#endif
+   }
    return(0);
 }
 
+/* the last access check of checkCondInputAccess, reused for the next
+   rows of the same data object */
+static char prevDataId[LONG_NAME_LEN];
+static char prevUser[LONG_NAME_LEN];
+static char prevAccess[LONG_NAME_LEN];
+static int prevStatus;
+
 /*
  Perform a check based on the condInput parameters;
  Verify that the user has access to the dataObj at the requested level.
@@ -1731,10 +2023,6 @@ checkCondInputAccess(genQueryInp_t genQueryInp, int statementNum,
    int status;
    char *zoneName;
    char *ticketString=NULL;
-   static char prevDataId[LONG_NAME_LEN];
-   static char prevUser[LONG_NAME_LEN];
-   static char prevAccess[LONG_NAME_LEN];
-   static int prevStatus;
 
    for (i=0;i<genQueryInp.condInput.len;i++) {
       if (strcmp(genQueryInp.condInput.keyWord[i],
@@ -1855,11 +2143,32 @@ chlGenQueryAccessControlSetup(char *user, char *zone, char *host, int priv,
     return(0);
 }
 
+/*
+ Clear the per-client state kept here.  Called by chlResetSession for a
+ pooled agent between clients, after it has freed the open statements.
+ The acAclPolicy setting (accessControlControlFlag) is for the server
+ and is kept.
+ */
+int
+chlGenQueryResetSession() {
+   accessControlUserName[0]='\0';
+   accessControlZone[0]='\0';
+   accessControlPriv=0;
+   prevDataId[0]='\0';
+   prevUser[0]='\0';
+   prevAccess[0]='\0';
+   prevStatus=0;
+   chlGenQueryTicketSetup("", "");
+   return(0);
+}
+
 int 
 chlGenQueryTicketSetup(char *ticket, char *clientAddr) {
    rstrcpy(sessionTicket, ticket, sizeof(sessionTicket));
    rstrcpy(sessionClientAddr, clientAddr, sizeof(sessionClientAddr));
-   rodsLog(LOG_NOTICE, "session ticket setup, value: %s", ticket);
+   if (*ticket != '\0') {
+      rodsLog(LOG_NOTICE, "session ticket setup, value: %s", ticket);
+   }
    return(0);
 }
 
@@ -1874,10 +2183,8 @@ chlGenQuery(genQueryInp_t genQueryInp, genQueryOut_t *result) {
 
    int status, statementNum;
    int numOfCols;
-   int attriTextLen;
    int totalLen;
    int maxColSize;
-   int currentMaxColSize;
    char *tResult, *tResult2;
    static int recursiveCall=0;
 
@@ -1889,8 +2196,6 @@ chlGenQuery(genQueryInp_t genQueryInp, genQueryOut_t *result) {
    result->rowCnt=0;
    result->totalRowCount = 0;
 
-   currentMaxColSize=0;
-
    icss = chlGetRcs();
    if (icss==NULL) return(CAT_NOT_OPEN);
 #ifdef ADDR_64BITS
@@ -1945,6 +2250,8 @@ chlGenQuery(genQueryInp_t genQueryInp, genQueryOut_t *result) {
       }
 #endif
 
+      /* the rows are read a page at a time below, fetch them so */
+      cllFetchRows = genQueryInp.maxRows;
       status = cmlGetFirstRowFromSql(combinedSQL, &statementNum, 
                                      genQueryInp.rowOffset, icss);
       if (status < 0) {
@@ -2027,23 +2334,19 @@ chlGenQuery(genQueryInp_t genQueryInp, genQueryOut_t *result) {
       result->attriCnt=numOfCols;
       result->continueInx = statementNum+1;
 
-      maxColSize=0;
-
-      for (k=0;k<numOfCols;k++) {
-	 j = strlen(icss->stmtPtr[statementNum]->resultValue[k]);
-	 if (maxColSize <= j) maxColSize=j;
-      }
-      maxColSize++; /* for the null termination */
-      if (maxColSize < MINIMUM_COL_SIZE) {
-	 maxColSize=MINIMUM_COL_SIZE;  /* make it a reasonable size */
-      }
-      if (debug) printf("maxColSize=%d\n",maxColSize);
-
-      if (i==0) {  /* first time thru, allocate and initialize */
-	  attriTextLen= numOfCols * maxColSize;
-	 if (debug) printf("attriTextLen=%d\n",attriTextLen);
-	 totalLen = attriTextLen * genQueryInp.maxRows;
-	 for (j=0;j<numOfCols;j++) {
+      /* Each column is padded to its own longest value so far. On the
+         first row, allocate the result strings.  If a value is longer
+         than the ones before it, allocate a new result string for the
+         column, copy the earlier rows over, and free the old one. */
+      for (j=0;j<numOfCols;j++) {
+	 maxColSize = strlen(icss->stmtPtr[statementNum]->resultValue[j]);
+	 maxColSize++; /* for the null termination */
+	 if (i==0) {  /* first time thru, allocate and initialize */
+	    if (maxColSize < MINIMUM_COL_SIZE) {
+	       maxColSize=MINIMUM_COL_SIZE;  /* make it a reasonable size */
+	    }
+	    if (debug) printf("maxColSize[%d]=%d\n",j,maxColSize);
+	    totalLen = maxColSize * genQueryInp.maxRows;
 	    tResult = (char*)malloc(totalLen);
 	    if (tResult==NULL) return(SYS_MALLOC_ERR);
 	    memset(tResult, 0, totalLen);
@@ -2056,25 +2359,13 @@ chlGenQuery(genQueryInp_t genQueryInp, genQueryOut_t *result) {
 	    result->sqlResult[j].len = maxColSize;
 	    result->sqlResult[j].value = tResult;
 	 }
-	 currentMaxColSize = maxColSize;
-      }
-
-
-      /* Check to see if the current row has a max column size that
-         is larger than what we've been using so far.  If so, allocate
-         new result strings, copy each row value over, and free the 
-         old one. */
-      if (maxColSize > currentMaxColSize) {
-	 maxColSize += MINIMUM_COL_SIZE; /* bump it up to try to avoid
-					    some multiple resizes */
-	 if (debug) printf("Bumping %d to %d\n",
-			   currentMaxColSize, maxColSize);
-	 attriTextLen= numOfCols * maxColSize;
-	 if (debug) printf("attriTextLen=%d\n",attriTextLen);
-	 totalLen = attriTextLen * genQueryInp.maxRows;
-	 for (j=0;j<numOfCols;j++) {
+	 else if (maxColSize > result->sqlResult[j].len) {
 	    char *cp1, *cp2;
-	    int k;
+	    maxColSize += MINIMUM_COL_SIZE; /* bump it up to try to avoid
+					       some multiple resizes */
+	    if (debug) printf("Bumping %d to %d\n",
+			      result->sqlResult[j].len, maxColSize);
+	    totalLen = maxColSize * genQueryInp.maxRows;
 	    tResult = (char*)malloc(totalLen);
 	    if (tResult==NULL) return(SYS_MALLOC_ERR);
 	    memset(tResult, 0, totalLen);
@@ -2089,17 +2380,14 @@ chlGenQuery(genQueryInp_t genQueryInp, genQueryOut_t *result) {
 	    result->sqlResult[j].len = maxColSize;
 	    result->sqlResult[j].value = tResult;
 	 }
-	 currentMaxColSize = maxColSize;
-      }
 
-      /* Store the current row values into the appropriate spots in
-         the attribute string */
-      for (j=0;j<numOfCols;j++) {
+         /* Store the current row value into the appropriate spot in
+            the attribute string */
 	 tResult2 = result->sqlResult[j].value; /* ptr to value str */
-	 tResult2 += currentMaxColSize*(result->rowCnt-1);  /* skip forward 
-							for this row */
+	 tResult2 += result->sqlResult[j].len*(result->rowCnt-1);  /* skip 
+							forward for this row */
 	 strncpy(tResult2, icss->stmtPtr[statementNum]->resultValue[j],
-		 currentMaxColSize); /* copy in the value text */
+		 result->sqlResult[j].len); /* copy in the value text */
       }
 
    }
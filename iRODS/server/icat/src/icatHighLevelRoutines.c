@@ -88,6 +88,9 @@ int logSQL=0;
 
 static int _delColl(rsComm_t *rsComm, collInfo_t *collInfo);
 static int removeAVUs();
+static void quotaDeltaSql(char *sign, char *dataWhere, char *tSQL);
+static int _addQuotaDeltas(char *sign, char *dataWhere, 
+			   char *arg1, char *arg2, char *arg3);
 
 icatSessionStruct icss={0};
 char localZone[MAX_NAME_LEN]="";
@@ -207,6 +210,30 @@ int chlClose() {
    return(i);
 }
 
+/*
+ Reset the per-client state kept here (session ticket, the challenge
+ signature and the GenQuery state), free the statements the client left
+ open and roll back anything left uncommitted.  Called by a pooled agent
+ between clients so the next session starts clean on the same database
+ connection.  An open GenQuery statement would otherwise let the next
+ client continue it (continueInx) and read the previous client's rows.
+ */
+int chlResetSession(rsComm_t *rsComm) {
+   int status, i;
+   if (logSQL!=0) rodsLog(LOG_SQL, "chlResetSession");
+   memset(prevChalSig, 0, sizeof(prevChalSig));
+   mySessionTicket[0]='\0';
+   mySessionClientAddr[0]='\0';
+   creatingUserByGroupAdmin=0;
+   chlGenQueryResetSession();
+   if (icss.status != 1) return(0);
+   for (i=0;i<MAX_NUM_OF_CONCURRENT_STMTS;i++) {
+      if (icss.stmtPtr[i]!=NULL) cllFreeStatement(&icss, i);
+   }
+   status = chlRollback(rsComm);
+   return(status);
+}
+
 int chlIsConnected() {
    if (logSQL!=0) rodsLog(LOG_SQL, "chlIsConnected");
    return(icss.status);
@@ -356,6 +383,9 @@ int chlModDataObjMeta(rsComm_t *rsComm, dataObjInfo_t *dataObjInfo,
 
    char objIdString[MAX_NAME_LEN];
    char *neededAccess;
+   int doingUsage=0;
+   char *usageWhere;
+   char *usageReplNum;
 
    if (logSQL!=0) rodsLog(LOG_SQL, "chlModDataObjMeta");
 
@@ -538,6 +568,27 @@ int chlModDataObjMeta(rsComm_t *rsComm, dataObjInfo_t *dataObjInfo,
       numConditions++;
    }
 
+   /* The usage (for quotas) changes if the size, resource or owner of
+      the copies does; take out the old values before the update and
+      put in the new ones after it */
+   if (getValByKey(regParam, DATA_SIZE_KW) != NULL ||
+       getValByKey(regParam, RESC_NAME_KW) != NULL ||
+       getValByKey(regParam, DATA_OWNER_KW) != NULL ||
+       getValByKey(regParam, DATA_OWNER_ZONE_KW) != NULL) {
+      doingUsage=1;
+      usageWhere = "DM.data_id=?";
+      usageReplNum = NULL;
+      if (numConditions > 1) {
+	 usageWhere = "DM.data_id=? and DM.data_repl_num=?";
+	 usageReplNum = replNum1;
+      }
+      status = _addQuotaDeltas("-", usageWhere, idVal, usageReplNum, NULL);
+      if (status != 0) {
+	 _rollback("chlModDataObjMeta");
+	 return(status);
+      }
+   }
+
    mode =0;
    if (getValByKey(regParam, ALL_REPL_STATUS_KW)) { 
       mode=1;
@@ -592,6 +643,22 @@ int chlModDataObjMeta(rsComm_t *rsComm, dataObjInfo_t *dataObjInfo,
       return(status);
    }
 
+   if (doingUsage) {
+      usageReplNum = NULL;
+      if (numConditions > 1) {
+	 usageReplNum = getValByKey(regParam, REPL_NUM_KW);
+	 if (usageReplNum == NULL) {
+	    snprintf(replNum1, MAX_NAME_LEN, "%d", dataObjInfo->replNum);
+	    usageReplNum = replNum1;
+	 }
+      }
+      status = _addQuotaDeltas("", usageWhere, idVal, usageReplNum, NULL);
+      if (status != 0) {
+	 _rollback("chlModDataObjMeta");
+	 return(status);
+      }
+   }
+
    if ( !(dataObjInfo->flags & NO_COMMIT_FLAG) ) {
       status =  cmlExecuteNoAnswerSql("commit", &icss);
       if (status != 0) {
@@ -721,6 +788,13 @@ int chlRegDataObj(rsComm_t *rsComm, dataObjInfo_t *dataObjInfo) {
       return(status);
    }
 
+   status = _addQuotaDeltas("", "DM.data_id=? and DM.data_repl_num=?",
+			    dataIdNum, dataReplNum, NULL);
+   if (status != 0) {
+      _rollback("chlRegDataObj");
+      return(status);
+   }
+
    if (inheritFlag) {
       /* If inherit is set (sticky bit), then add access rows for this
          dataobject that match those of the parent collection */
@@ -817,6 +891,319 @@ int chlRegDataObj(rsComm_t *rsComm, dataObjInfo_t *dataObjInfo) {
    return(0);
 }
 
+/* per object and per collection info used by chlRegDataObjBulk */
+typedef struct {
+   char dataId[NAME_LEN];
+   char replNum[NAME_LEN];
+   char dataSize[NAME_LEN];
+   char replStatus[NAME_LEN];
+   char regUid[NAME_LEN];
+   char *dataName;
+   int collInx;
+} regBulkObj_t;
+
+typedef struct {
+   char collName[MAX_NAME_LEN];
+   char collId[NAME_LEN];
+   int inheritFlag;
+} regBulkColl_t;
+
+#define REG_BULK_DATA_VARS 18	/* bind variables per R_DATA_MAIN row */
+
+static int
+_regDataObjBulk(rsComm_t *rsComm, dataObjInfo_t *dataObjInfo, int numOfObjs,
+		regBulkObj_t *objs, regBulkColl_t *colls,
+		rodsLong_t *seqVals, char **bindVars) {
+   char myTime[50];
+   char tSQL[MAX_SQL_SIZE];
+   char logicalFileName[MAX_NAME_LEN];
+   char logicalDirName[MAX_NAME_LEN];
+   char lastDataType[NAME_LEN];
+   char **bv;
+   rodsLong_t iVal;
+   int numOfColls, numOfRows;
+   int i, j, status;
+   int inheritFlag;
+
+   /* Check that each collection exists and the user has write
+      permission, and get its inherit flag, once per collection.
+      Also check each data type once (they are usually all the same). */
+   numOfColls=0;
+   lastDataType[0]='\0';
+   for (i=0;i<numOfObjs;i++) {
+      status = splitPathByKey(dataObjInfo[i].objPath, 
+			      logicalDirName, logicalFileName, '/');
+      objs[i].dataName = strrchr(dataObjInfo[i].objPath, '/');
+      if (status < 0 || objs[i].dataName == NULL) {
+	 return(CAT_INVALID_ARGUMENT);
+      }
+      objs[i].dataName++;
+
+      for (j=0;j<numOfColls;j++) {
+	 if (strcmp(colls[j].collName, logicalDirName)==0) break;
+      }
+      if (j==numOfColls) {
+	 iVal = cmlCheckDirAndGetInheritFlag(logicalDirName, 
+			rsComm->clientUser.userName,
+			rsComm->clientUser.rodsZone, 
+			ACCESS_MODIFY_OBJECT, &inheritFlag, 
+			mySessionTicket, mySessionClientAddr,&icss);
+	 if (iVal < 0) {
+	    char errMsg[105];
+	    if (iVal==CAT_UNKNOWN_COLLECTION) {
+	       snprintf(errMsg, 100, "collection '%s' is unknown", 
+			logicalDirName);
+	       addRErrorMsg (&rsComm->rError, 0, errMsg);
+	    }
+	    if (iVal==CAT_NO_ACCESS_PERMISSION) {
+	       snprintf(errMsg, 100, "no permission to update collection '%s'",
+			logicalDirName);
+	       addRErrorMsg (&rsComm->rError, 0, errMsg);
+	    }
+	    return (iVal);
+	 }
+	 rstrcpy(colls[j].collName, logicalDirName, MAX_NAME_LEN);
+	 snprintf(colls[j].collId, NAME_LEN, "%lld", iVal);
+	 colls[j].inheritFlag = inheritFlag;
+	 numOfColls++;
+      }
+      objs[i].collInx = j;
+
+      if (strcmp(dataObjInfo[i].dataType, lastDataType) != 0) {
+	 if (logSQL!=0) rodsLog(LOG_SQL, "chlRegDataObjBulk SQL 1");
+	 status = cmlCheckNameToken("data_type", 
+				    dataObjInfo[i].dataType, &icss);
+	 if (status !=0 ) {
+	    return(CAT_INVALID_DATA_TYPE);
+	 }
+	 rstrcpy(lastDataType, dataObjInfo[i].dataType, NAME_LEN);
+      }
+   }
+
+   /* Make sure no collection already exists by the name of an object */
+   for (i=0;i<numOfObjs;i++) {
+      if (logSQL!=0) rodsLog(LOG_SQL, "chlRegDataObjBulk SQL 2");
+      status = cmlGetIntegerValueFromSql(
+		 "select coll_id from R_COLL_MAIN where coll_name=?",
+		 &iVal, dataObjInfo[i].objPath, 0, 0, 0, 0, &icss);
+      if (status == 0) {
+	 return(CAT_NAME_EXISTS_AS_COLLECTION);
+      }
+   }
+
+   /* reserve the ids all at once */
+   if (logSQL!=0) rodsLog(LOG_SQL, "chlRegDataObjBulk SQL 3");
+   status = cmlGetNextSeqVals(numOfObjs, seqVals, &icss);
+   if (status < 0) {
+      rodsLog(LOG_NOTICE, "chlRegDataObjBulk cmlGetNextSeqVals failure %d",
+	      status);
+      _rollback("chlRegDataObjBulk");
+      return(status);
+   }
+
+   getNowStr(myTime);
+   for (i=0;i<numOfObjs;i++) {
+      dataObjInfo[i].dataId=seqVals[i];  /* store as output parameter */
+      snprintf(objs[i].dataId, NAME_LEN, "%lld", seqVals[i]);
+      snprintf(objs[i].replNum, NAME_LEN, "%d", dataObjInfo[i].replNum);
+      snprintf(objs[i].replStatus, NAME_LEN, "%d", dataObjInfo[i].replStatus);
+      snprintf(objs[i].dataSize, NAME_LEN, "%lld", dataObjInfo[i].dataSize);
+      snprintf(objs[i].regUid, NAME_LEN, "%d", dataObjInfo[i].regUid);
+
+      bv = &bindVars[i*REG_BULK_DATA_VARS];
+      bv[0]=objs[i].dataId;
+      bv[1]=colls[objs[i].collInx].collId;
+      bv[2]=objs[i].dataName;
+      bv[3]=objs[i].replNum;
+      bv[4]=dataObjInfo[i].version;
+      bv[5]=dataObjInfo[i].dataType;
+      bv[6]=objs[i].dataSize;
+      bv[7]=dataObjInfo[i].rescGroupName;
+      bv[8]=dataObjInfo[i].rescName;
+      bv[9]=dataObjInfo[i].filePath;
+      bv[10]=rsComm->clientUser.userName;
+      bv[11]=rsComm->clientUser.rodsZone;
+      bv[12]=objs[i].replStatus;
+      bv[13]=dataObjInfo[i].chksum;
+      bv[14]=dataObjInfo[i].dataMode;
+      bv[15]=objs[i].regUid;
+      bv[16]=myTime;
+      bv[17]=myTime;
+   }
+   if (logSQL!=0) rodsLog(LOG_SQL, "chlRegDataObjBulk SQL 4");
+   status = cmlExecuteNoAnswerSqlArray(
+       "insert into R_DATA_MAIN (data_id, coll_id, data_name, data_repl_num, data_version, data_type_name, data_size, resc_group_name, resc_name, data_path, data_owner_name, data_owner_zone, data_is_dirty, data_checksum, data_mode, data_reg_user_id, create_ts, modify_ts) values (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)", 
+       bindVars, REG_BULK_DATA_VARS, numOfObjs, &icss);
+   if (status != 0) {
+      rodsLog(LOG_NOTICE,
+	      "chlRegDataObjBulk cmlExecuteNoAnswerSqlArray failure %d",status);
+      _rollback("chlRegDataObjBulk");
+      return(status);
+   }
+
+   /* The usage of the new copies, for quotas (see _addQuotaDeltas) */
+   for (i=0;i<numOfObjs;i++) {
+      bv = &bindVars[i*3];
+      bv[0]=myTime;
+      bv[1]=objs[i].dataId;
+      bv[2]=objs[i].replNum;
+   }
+   quotaDeltaSql("", "DM.data_id=? and DM.data_repl_num=?", tSQL);
+   if (logSQL!=0) rodsLog(LOG_SQL, "chlRegDataObjBulk SQL 7");
+   status = cmlExecuteNoAnswerSqlArray(tSQL, bindVars, 3, numOfObjs, &icss);
+   if (status == CAT_SUCCESS_BUT_WITH_NO_INFO) status=0;
+   if (status != 0) {
+      rodsLog(LOG_NOTICE,
+	      "chlRegDataObjBulk cmlExecuteNoAnswerSqlArray insert usage failure %d",
+	      status);
+      _rollback("chlRegDataObjBulk");
+      return(status);
+   }
+
+   /* The access rows; owner access, or (if inherit is set on the
+      collection) the same rows as the collection */
+   numOfRows=0;
+   for (i=0;i<numOfObjs;i++) {
+      if (colls[objs[i].collInx].inheritFlag) continue;
+      bv = &bindVars[numOfRows*6];
+      bv[0]=objs[i].dataId;
+      bv[1]=rsComm->clientUser.userName;
+      bv[2]=rsComm->clientUser.rodsZone;
+      bv[3]=ACCESS_OWN;
+      bv[4]=myTime;
+      bv[5]=myTime;
+      numOfRows++;
+   }
+   if (numOfRows > 0) {
+      if (logSQL!=0) rodsLog(LOG_SQL, "chlRegDataObjBulk SQL 5");
+      status = cmlExecuteNoAnswerSqlArray(
+	       "insert into R_OBJT_ACCESS values (?, (select user_id from R_USER_MAIN where user_name=? and zone_name=?), (select token_id from R_TOKN_MAIN where token_namespace = 'access_type' and token_name = ?), ?, ?)",
+	       bindVars, 6, numOfRows, &icss);
+      if (status != 0) {
+	 rodsLog(LOG_NOTICE,
+	     "chlRegDataObjBulk cmlExecuteNoAnswerSqlArray insert access failure %d",
+		 status);
+	 _rollback("chlRegDataObjBulk");
+	 return(status);
+      }
+   }
+
+   numOfRows=0;
+   for (i=0;i<numOfObjs;i++) {
+      if (!colls[objs[i].collInx].inheritFlag) continue;
+      bv = &bindVars[numOfRows*4];
+      bv[0]=objs[i].dataId;
+      bv[1]=myTime;
+      bv[2]=myTime;
+      bv[3]=colls[objs[i].collInx].collId;
+      numOfRows++;
+   }
+   if (numOfRows > 0) {
+      if (logSQL!=0) rodsLog(LOG_SQL, "chlRegDataObjBulk SQL 6");
+      status = cmlExecuteNoAnswerSqlArray(
+	       "insert into R_OBJT_ACCESS (object_id, user_id, access_type_id, create_ts, modify_ts) (select ?, user_id, access_type_id, ?, ? from R_OBJT_ACCESS where object_id = ?)",
+	       bindVars, 4, numOfRows, &icss);
+      if (status != 0) {
+	 rodsLog(LOG_NOTICE,
+	     "chlRegDataObjBulk cmlExecuteNoAnswerSqlArray insert access failure %d",
+		 status);
+	 _rollback("chlRegDataObjBulk");
+	 return(status);
+      }
+   }
+
+#ifdef FILESYSTEM_META
+   /* the filesystem metadata of the files the objects were put from,
+      as in chlRegDataObj */
+   numOfRows=0;
+   for (i=0;i<numOfObjs;i++) {
+      keyValPair_t *condInput = &dataObjInfo[i].condInput;
+      if (getValByKey(condInput, FILE_UID_KW) == NULL) continue;
+      bv = &bindVars[numOfRows*11];
+      bv[0]=objs[i].dataId;
+      bv[1]=getValByKey(condInput, FILE_UID_KW);
+      bv[2]=getValByKey(condInput, FILE_GID_KW);
+      bv[3]=getValByKey(condInput, FILE_OWNER_KW);
+      bv[4]=getValByKey(condInput, FILE_GROUP_KW);
+      bv[5]=getValByKey(condInput, FILE_MODE_KW);
+      bv[6]=getValByKey(condInput, FILE_CTIME_KW);
+      bv[7]=getValByKey(condInput, FILE_MTIME_KW);
+      bv[8]=getValByKey(condInput, FILE_SOURCE_PATH_KW);
+      bv[9]=myTime;
+      bv[10]=myTime;
+      numOfRows++;
+   }
+   if (numOfRows > 0) {
+      if (logSQL) rodsLog(LOG_SQL, "chlRegDataObjBulk xSQL 1");
+      status = cmlExecuteNoAnswerSqlArray(
+	       "insert into R_OBJT_FILESYSTEM_META (object_id, file_uid, file_gid, file_owner, file_group, file_mode, file_ctime, file_mtime, file_source_path, create_ts, modify_ts) values (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)",
+	       bindVars, 11, numOfRows, &icss);
+      if (status != 0) {
+	 rodsLog(LOG_NOTICE,
+	     "chlRegDataObjBulk cmlExecuteNoAnswerSqlArray insert filesystem_meta failure %d",
+		 status);
+	 _rollback("chlRegDataObjBulk");
+	 return(status);
+      }
+   }
+#endif /* FILESYSTEM_META */
+
+   for (i=0;i<numOfObjs;i++) {
+      status = cmlAudit3(AU_REGISTER_DATA_OBJ, objs[i].dataId,
+			 rsComm->clientUser.userName, 
+			 rsComm->clientUser.rodsZone, "", &icss);
+      if (status != 0) {
+	 rodsLog(LOG_NOTICE,
+		 "chlRegDataObjBulk cmlAudit3 failure %d",
+		 status);
+	 _rollback("chlRegDataObjBulk");
+	 return(status);
+      }
+   }
+   return(0);
+}
+
+/* 
+ * chlRegDataObjBulk - Register a set of new iRODS files (data objects),
+ * as for bulk put, with a few set-based statements: the collection
+ * checks are done once per collection, the ids are reserved with one
+ * query, and the R_DATA_MAIN and R_OBJT_ACCESS rows are inserted with
+ * array-bound statements.  Nothing is committed, the caller commits
+ * (or rolls back) as with the NO_COMMIT_FLAG of chlRegDataObj.
+ * Input - rsComm_t *rsComm  - the server handle
+ *         dataObjInfo_t *dataObjInfo - array of numOfObjs data objects;
+ *           the dataId of each is set on success.
+ */
+int chlRegDataObjBulk(rsComm_t *rsComm, dataObjInfo_t *dataObjInfo,
+		      int numOfObjs) {
+   regBulkObj_t *objs;
+   regBulkColl_t *colls;
+   rodsLong_t *seqVals;
+   char **bindVars;
+   int status;
+
+   if (logSQL!=0) rodsLog(LOG_SQL, "chlRegDataObjBulk");
+   if (!icss.status) {
+      return(CATALOG_NOT_CONNECTED);
+   }
+   if (numOfObjs <= 0) return(0);
+
+   objs = (regBulkObj_t *)calloc(numOfObjs, sizeof(regBulkObj_t));
+   colls = (regBulkColl_t *)calloc(numOfObjs, sizeof(regBulkColl_t));
+   seqVals = (rodsLong_t *)calloc(numOfObjs, sizeof(rodsLong_t));
+   bindVars = (char **)calloc(numOfObjs * REG_BULK_DATA_VARS, 
+			      sizeof(char *));
+
+   status = _regDataObjBulk(rsComm, dataObjInfo, numOfObjs, objs, colls,
+			    seqVals, bindVars);
+
+   free(objs);
+   free(colls);
+   free(seqVals);
+   free(bindVars);
+   return(status);
+}
+
 /* 
  * chlRegReplica - Register a new iRODS replica file (data object)
  * Input - rsComm_t *rsComm  - the server handle
@@ -952,6 +1339,14 @@ int chlRegReplica(rsComm_t *rsComm, dataObjInfo_t *srcDataObjInfo,
       return(status);
    }
 
+   status = _addQuotaDeltas("", "DM.data_id=? and DM.data_repl_num=?",
+			    objIdString, nextRepl, NULL);
+   if (status != 0) {
+      cmlFreeStatement(statementNumber, &icss);
+      _rollback("chlRegReplica");
+      return(status);
+   }
+
    cmlFreeStatement(statementNumber, &icss);
    if (status < 0) {
       rodsLog(LOG_NOTICE, "chlRegReplica cmlFreeStatement failure %d", status);
@@ -1146,6 +1541,23 @@ int chlUnregDataObj (rsComm_t *rsComm, dataObjInfo_t *dataObjInfo,
       }
    }
 
+   /* take the copies out of the usage, for quotas */
+   if (dataObjInfo->replNum >= 0) {
+      snprintf(replNumber, sizeof replNumber, "%d", dataObjInfo->replNum);
+      status = _addQuotaDeltas("-", 
+	 "DM.coll_id=(select coll_id from R_COLL_MAIN where coll_name=?) and DM.data_name=? and DM.data_repl_num=?",
+	 logicalDirName, logicalFileName, replNumber);
+   }
+   else {
+      status = _addQuotaDeltas("-", 
+	 "DM.coll_id=(select coll_id from R_COLL_MAIN where coll_name=?) and DM.data_name=?",
+	 logicalDirName, logicalFileName, NULL);
+   }
+   if (status != 0) {
+      _rollback("chlUnregDataObj");
+      return(status);
+   }
+
    cllBindVars[0]=logicalDirName;
    cllBindVars[1]=logicalFileName;
    if (dataObjInfo->replNum >= 0) {
@@ -1965,6 +2377,77 @@ int chlDelUserRE(rsComm_t *rsComm, userInfo_t *userInfo) {
    return(0);
 }
 
+/*
+ Add a new collection to the collection tree (R_COLL_ANCESTRY).  It is
+ under each ancestor of its parent (parentCollId) and under itself.
+ The id of the new collection is the current sequence value.
+ */
+static int
+_addCollAncestry(char *parentCollId, char *caller) {
+   char currStr[MAX_NAME_LEN];
+   char tSQL[MAX_SQL_SIZE];
+   int status;
+
+   cllCurrentValueString("R_ObjectID", currStr, MAX_NAME_LEN);
+
+   cllBindVars[cllBindVarCount++]=parentCollId;
+   snprintf(tSQL, MAX_SQL_SIZE, 
+	    "insert into R_COLL_ANCESTRY (ancestor_id, coll_id) select ancestor_id, %s from R_COLL_ANCESTRY where coll_id=?",
+	    currStr);
+   if (logSQL!=0) rodsLog(LOG_SQL, "_addCollAncestry SQL 1");
+   status =  cmlExecuteNoAnswerSql(tSQL, &icss);
+   if (status == CAT_SUCCESS_BUT_WITH_NO_INFO) status=0;
+   if (status == 0) {
+      snprintf(tSQL, MAX_SQL_SIZE, 
+	       "insert into R_COLL_ANCESTRY (ancestor_id, coll_id) values (%s, %s)",
+	       currStr, currStr);
+      if (logSQL!=0) rodsLog(LOG_SQL, "_addCollAncestry SQL 2");
+      status =  cmlExecuteNoAnswerSql(tSQL, &icss);
+   }
+   if (status != 0) {
+      rodsLog(LOG_NOTICE,
+	      "%s cmlExecuteNoAnswerSql(insert ancestry) failure %d",
+	      caller, status);
+   }
+   return(status);
+}
+
+/*
+ Move collection collId, and the collections under it, to under
+ newParentId in the collection tree: remove the rows that put them
+ under the old ancestors of collId and add rows for the new ones.
+ (The derived tables are for MySQL, which cannot select from the
+ table it deletes from.)
+ */
+static int
+_moveCollAncestry(char *collId, char *newParentId, char *caller) {
+   int status;
+
+   cllBindVars[cllBindVarCount++]=collId;
+   cllBindVars[cllBindVarCount++]=collId;
+   cllBindVars[cllBindVarCount++]=collId;
+   if (logSQL!=0) rodsLog(LOG_SQL, "_moveCollAncestry SQL 1");
+   status =  cmlExecuteNoAnswerSql(
+	"delete from R_COLL_ANCESTRY where coll_id in (select coll_id from (select coll_id from R_COLL_ANCESTRY where ancestor_id=?) SUBTREE) and ancestor_id in (select ancestor_id from (select ancestor_id from R_COLL_ANCESTRY where coll_id=? and ancestor_id<>?) OLDANC)",
+	&icss);
+   if (status == CAT_SUCCESS_BUT_WITH_NO_INFO) status=0;
+   if (status == 0) {
+      cllBindVars[cllBindVarCount++]=newParentId;
+      cllBindVars[cllBindVarCount++]=collId;
+      if (logSQL!=0) rodsLog(LOG_SQL, "_moveCollAncestry SQL 2");
+      status =  cmlExecuteNoAnswerSql(
+	   "insert into R_COLL_ANCESTRY (ancestor_id, coll_id) select A.ancestor_id, D.coll_id from R_COLL_ANCESTRY A, R_COLL_ANCESTRY D where A.coll_id=? and D.ancestor_id=?",
+	   &icss);
+      if (status == CAT_SUCCESS_BUT_WITH_NO_INFO) status=0;
+   }
+   if (status != 0) {
+      rodsLog(LOG_NOTICE,
+	      "%s cmlExecuteNoAnswerSql(move ancestry) failure %d",
+	      caller, status);
+   }
+   return(status);
+}
+
 /*
  Register a Collection by the admin.
  There are cases where the irods admin needs to create collections,
@@ -2035,7 +2518,7 @@ int chlRegCollByAdmin(rsComm_t *rsComm, collInfo_t *collInfo)
       return(status);
    }
 
-   snprintf(collIdNum, MAX_NAME_LEN, "%d", status);
+   snprintf(collIdNum, MAX_NAME_LEN, "%lld", iVal);
 
    /* String to get next sequence item for objects */
    cllNextValueString("R_ObjectID", nextStr, MAX_NAME_LEN);
@@ -2106,6 +2589,12 @@ int chlRegCollByAdmin(rsComm_t *rsComm, collInfo_t *collInfo)
       return(status);
    }
 
+   status = _addCollAncestry(collIdNum, "chlRegCollByAdmin");
+   if (status != 0) {
+      _rollback("chlRegCollByAdmin");
+      return(status);
+   }
+
    /* String to get current sequence item for objects */
    cllCurrentValueString("R_ObjectID", currStr, MAX_NAME_LEN);
    snprintf(currStr2, MAX_SQL_SIZE, " %s ", currStr);
@@ -2259,6 +2748,12 @@ int chlRegColl(rsComm_t *rsComm, collInfo_t *collInfo) {
       return(status);
    }
 
+   status = _addCollAncestry(collIdNum, "chlRegColl");
+   if (status != 0) {
+      _rollback("chlRegColl");
+      return(status);
+   }
+
    /* String to get current sequence item for objects */
    cllCurrentValueString("R_ObjectID", currStr, MAX_NAME_LEN);
    snprintf(currStr2, MAX_SQL_SIZE, " %s ", currStr);
@@ -3232,6 +3727,20 @@ int chlDelCollByAdmin(rsComm_t *rsComm, collInfo_t *collInfo) {
    snprintf(collIdNum, MAX_NAME_LEN, "%lld", iVal);
    removeMetaMapAndAVU(collIdNum);
 
+   /* remove it from the collection tree */
+   cllBindVars[cllBindVarCount++]=collIdNum;
+   if (logSQL!=0) rodsLog(LOG_SQL, "chlDelCollByAdmin SQL 2a");
+   status =  cmlExecuteNoAnswerSql(
+		   "delete from R_COLL_ANCESTRY where coll_id=?",
+		   &icss);
+   if (status != 0 && status != CAT_SUCCESS_BUT_WITH_NO_INFO) {
+      rodsLog(LOG_NOTICE,
+	      "chlDelCollByAdmin delete ancestry failure %d",
+	      status);
+      _rollback("chlDelCollByAdmin");
+      return(status);
+   }
+
 #ifdef FILESYSTEM_META
    /* remove any filesystem metadata entries */
    cllBindVars[cllBindVarCount++]=collIdNum;
@@ -3404,6 +3913,20 @@ static int _delColl(rsComm_t *rsComm, collInfo_t *collInfo) {
       _rollback("_delColl");
    }
 
+   /* remove it from the collection tree */
+   cllBindVars[cllBindVarCount++]=collIdNum;
+   if (logSQL!=0) rodsLog(LOG_SQL, "_delColl SQL 5a");
+   status =  cmlExecuteNoAnswerSql(
+		   "delete from R_COLL_ANCESTRY where coll_id=?",
+		   &icss);
+   if (status != 0 && status != CAT_SUCCESS_BUT_WITH_NO_INFO) {
+      rodsLog(LOG_NOTICE,
+	      "_delColl cmlExecuteNoAnswerSql delete ancestry failure %d",
+	      status);
+      _rollback("_delColl");
+      return(status);
+   }
+
    /* Remove associated AVUs, if any */
    removeMetaMapAndAVU(collIdNum);
 
@@ -6784,9 +7307,6 @@ int _modInheritance(int inheritFlag, int recursiveFlag, char *collIdStr, char *p
    rodsLong_t status;
    char myTime[50];
    char newValue[10];
-   char pathStart[MAX_NAME_LEN];
-   int len;
-   char pathStartLen[20];
    char auditStr[30];
 
    if (recursiveFlag==0) {
@@ -6822,19 +7342,12 @@ int _modInheritance(int inheritFlag, int recursiveFlag, char *collIdStr, char *p
    }
    else {
    /* Recursive mode */
-
-      snprintf(pathStart, MAX_NAME_LEN, "%s/", pathName);
-      len = strlen(pathStart);
-      snprintf(pathStartLen, 10, "%d", len);
-
       cllBindVars[cllBindVarCount++]=newValue;
       cllBindVars[cllBindVarCount++]=myTime;
-      cllBindVars[cllBindVarCount++]=pathName;
-      cllBindVars[cllBindVarCount++]=pathStartLen;
-      cllBindVars[cllBindVarCount++]=pathStart;
+      cllBindVars[cllBindVarCount++]=collIdStr;
       if (logSQL!=0) rodsLog(LOG_SQL, "_modInheritance SQL 2");
       status =  cmlExecuteNoAnswerSql(
-	      "update R_COLL_MAIN set coll_inheritance=?, modify_ts=? where coll_name = ? or substr(coll_name,1,?) = ?",
+	      "update R_COLL_MAIN set coll_inheritance=?, modify_ts=? where coll_id in (select coll_id from R_COLL_ANCESTRY where ancestor_id=?)",
 		 &icss);
    }
    if (status != 0) {
@@ -7004,9 +7517,6 @@ int chlModAccessControl(rsComm_t *rsComm, int recursiveFlag,
    char *myZone;
    char userIdStr[MAX_NAME_LEN];
    char objIdStr[MAX_NAME_LEN];
-   char pathStart[MAX_NAME_LEN];
-   int len;
-   char pathStartLen[20];
    int inheritFlag=0;
    char myAccessStr[LONG_NAME_LEN];
    int adminMode=0;
@@ -7313,18 +7823,12 @@ int chlModAccessControl(rsComm_t *rsComm, int recursiveFlag,
       return(CAT_INVALID_ARGUMENT);
    }
 
-   snprintf(pathStart, MAX_NAME_LEN, "%s/", pathName);
-   len = strlen(pathStart);
-   snprintf(pathStartLen, 10, "%d", len);
-
    cllBindVars[cllBindVarCount++]=userIdStr;
-   cllBindVars[cllBindVarCount++]=pathName;
-   cllBindVars[cllBindVarCount++]=pathStartLen;
-   cllBindVars[cllBindVarCount++]=pathStart;
+   cllBindVars[cllBindVarCount++]=collIdStr;
 
    if (logSQL!=0) rodsLog(LOG_SQL, "chlModAccessControl SQL 8");
    status =  cmlExecuteNoAnswerSql(
-               "delete from R_OBJT_ACCESS where user_id=? and object_id in (select data_id from R_DATA_MAIN where coll_id in (select coll_id from R_COLL_MAIN where coll_name = ? or substr(coll_name,1,?) = ?))",
+               "delete from R_OBJT_ACCESS where user_id=? and object_id in (select data_id from R_DATA_MAIN where coll_id in (select coll_id from R_COLL_ANCESTRY where ancestor_id=?))",
 	       &icss);
    if (status != 0 && status != CAT_SUCCESS_BUT_WITH_NO_INFO) {
       _rollback("chlModAccessControl");
@@ -7332,13 +7836,11 @@ int chlModAccessControl(rsComm_t *rsComm, int recursiveFlag,
    }
 
    cllBindVars[cllBindVarCount++]=userIdStr;
-   cllBindVars[cllBindVarCount++]=pathName;
-   cllBindVars[cllBindVarCount++]=pathStartLen;
-   cllBindVars[cllBindVarCount++]=pathStart;
+   cllBindVars[cllBindVarCount++]=collIdStr;
 
    if (logSQL!=0) rodsLog(LOG_SQL, "chlModAccessControl SQL 9");
    status =  cmlExecuteNoAnswerSql(
-               "delete from R_OBJT_ACCESS where user_id=? and object_id in (select coll_id from R_COLL_MAIN where coll_name = ? or substr(coll_name,1,?) = ?)",
+               "delete from R_OBJT_ACCESS where user_id=? and object_id in (select coll_id from R_COLL_ANCESTRY where ancestor_id=?)",
 	       &icss);
    if (status != 0 && status != CAT_SUCCESS_BUT_WITH_NO_INFO) {
       _rollback("chlModAccessControl");
@@ -7365,29 +7867,24 @@ int chlModAccessControl(rsComm_t *rsComm, int recursiveFlag,
    }
 
    getNowStr(myTime);
-   snprintf(pathStart, MAX_NAME_LEN, "%s/", pathName);
-   len = strlen(pathStart);
-   snprintf(pathStartLen, 10, "%d", len);
    cllBindVars[cllBindVarCount++]=userIdStr;
    cllBindVars[cllBindVarCount++]=myAccessLev;
    cllBindVars[cllBindVarCount++]=myTime;
    cllBindVars[cllBindVarCount++]=myTime;
-   cllBindVars[cllBindVarCount++]=pathName;
-   cllBindVars[cllBindVarCount++]=pathStartLen;
-   cllBindVars[cllBindVarCount++]=pathStart;
+   cllBindVars[cllBindVarCount++]=collIdStr;
    if (logSQL!=0) rodsLog(LOG_SQL, "chlModAccessControl SQL 10");
 #if ORA_ICAT
    /* For Oracle cast is to integer, for Postgres to bigint,for MySQL no cast*/
    status =  cmlExecuteNoAnswerSql(
-	         "insert into R_OBJT_ACCESS (object_id, user_id, access_type_id, create_ts, modify_ts)  (select distinct data_id, cast(? as integer), (select token_id from R_TOKN_MAIN where token_namespace = 'access_type' and token_name = ?), ?, ? from R_DATA_MAIN where coll_id in (select coll_id from R_COLL_MAIN where coll_name = ? or substr(coll_name,1,?) = ?))",
+	         "insert into R_OBJT_ACCESS (object_id, user_id, access_type_id, create_ts, modify_ts)  (select distinct data_id, cast(? as integer), (select token_id from R_TOKN_MAIN where token_namespace = 'access_type' and token_name = ?), ?, ? from R_DATA_MAIN where coll_id in (select coll_id from R_COLL_ANCESTRY where ancestor_id=?))",
 		 &icss);
 #elif MY_ICAT
    status =  cmlExecuteNoAnswerSql(
-	         "insert into R_OBJT_ACCESS (object_id, user_id, access_type_id, create_ts, modify_ts)  (select distinct data_id, ?, (select token_id from R_TOKN_MAIN where token_namespace = 'access_type' and token_name = ?), ?, ? from R_DATA_MAIN where coll_id in (select coll_id from R_COLL_MAIN where coll_name = ? or substr(coll_name,1,?) = ?))",
+	         "insert into R_OBJT_ACCESS (object_id, user_id, access_type_id, create_ts, modify_ts)  (select distinct data_id, ?, (select token_id from R_TOKN_MAIN where token_namespace = 'access_type' and token_name = ?), ?, ? from R_DATA_MAIN where coll_id in (select coll_id from R_COLL_ANCESTRY where ancestor_id=?))",
 		 &icss);
 #else
    status =  cmlExecuteNoAnswerSql(
-	         "insert into R_OBJT_ACCESS (object_id, user_id, access_type_id, create_ts, modify_ts)  (select distinct data_id, cast(? as bigint), (select token_id from R_TOKN_MAIN where token_namespace = 'access_type' and token_name = ?), ?, ? from R_DATA_MAIN where coll_id in (select coll_id from R_COLL_MAIN where coll_name = ? or substr(coll_name,1,?) = ?))",
+	         "insert into R_OBJT_ACCESS (object_id, user_id, access_type_id, create_ts, modify_ts)  (select distinct data_id, cast(? as bigint), (select token_id from R_TOKN_MAIN where token_namespace = 'access_type' and token_name = ?), ?, ? from R_DATA_MAIN where coll_id in (select coll_id from R_COLL_ANCESTRY where ancestor_id=?))",
 		 &icss);
 #endif
    if (status == CAT_SUCCESS_BUT_WITH_NO_INFO) status=0; /* no files, OK */
@@ -7402,22 +7899,20 @@ int chlModAccessControl(rsComm_t *rsComm, int recursiveFlag,
    cllBindVars[cllBindVarCount++]=myAccessLev;
    cllBindVars[cllBindVarCount++]=myTime;
    cllBindVars[cllBindVarCount++]=myTime;
-   cllBindVars[cllBindVarCount++]=pathName;
-   cllBindVars[cllBindVarCount++]=pathStartLen;
-   cllBindVars[cllBindVarCount++]=pathStart;
+   cllBindVars[cllBindVarCount++]=collIdStr;
    if (logSQL!=0) rodsLog(LOG_SQL, "chlModAccessControl SQL 11");
 #if ORA_ICAT
    /* For Oracle cast is to integer, for Postgres to bigint,for MySQL no cast*/
    status =  cmlExecuteNoAnswerSql(
-	         "insert into R_OBJT_ACCESS (object_id, user_id, access_type_id, create_ts, modify_ts)  (select distinct coll_id, cast(? as integer), (select token_id from R_TOKN_MAIN where token_namespace = 'access_type' and token_name = ?), ?, ? from R_COLL_MAIN where coll_name = ? or substr(coll_name,1,?) = ?)",
+	         "insert into R_OBJT_ACCESS (object_id, user_id, access_type_id, create_ts, modify_ts)  (select distinct coll_id, cast(? as integer), (select token_id from R_TOKN_MAIN where token_namespace = 'access_type' and token_name = ?), ?, ? from R_COLL_ANCESTRY where ancestor_id=?)",
 		 &icss);
 #elif MY_ICAT
    status =  cmlExecuteNoAnswerSql(
-	         "insert into R_OBJT_ACCESS (object_id, user_id, access_type_id, create_ts, modify_ts)  (select distinct coll_id, ?, (select token_id from R_TOKN_MAIN where token_namespace = 'access_type' and token_name = ?), ?, ? from R_COLL_MAIN where coll_name = ? or substr(coll_name,1,?) = ?)",
+	         "insert into R_OBJT_ACCESS (object_id, user_id, access_type_id, create_ts, modify_ts)  (select distinct coll_id, ?, (select token_id from R_TOKN_MAIN where token_namespace = 'access_type' and token_name = ?), ?, ? from R_COLL_ANCESTRY where ancestor_id=?)",
 		 &icss);
 #else
    status =  cmlExecuteNoAnswerSql(
-	         "insert into R_OBJT_ACCESS (object_id, user_id, access_type_id, create_ts, modify_ts)  (select distinct coll_id, cast(? as bigint), (select token_id from R_TOKN_MAIN where token_namespace = 'access_type' and token_name = ?), ?, ? from R_COLL_MAIN where coll_name = ? or substr(coll_name,1,?) = ?)",
+	         "insert into R_OBJT_ACCESS (object_id, user_id, access_type_id, create_ts, modify_ts)  (select distinct coll_id, cast(? as bigint), (select token_id from R_TOKN_MAIN where token_namespace = 'access_type' and token_name = ?), ?, ? from R_COLL_ANCESTRY where ancestor_id=?)",
 		 &icss);
 #endif
    if (status != 0) {
@@ -7994,6 +8489,13 @@ int chlMoveObject(rsComm_t *rsComm, rodsLong_t objId,
 	 return(status);
       }
 
+      /* and move the subtree in the collection tree */
+      status = _moveCollAncestry(objIdString, collIdString, "chlMoveObject");
+      if (status != 0) {
+	 _rollback("chlMoveObject");
+	 return(status);
+      }
+
       /* Audit */
       status = cmlAudit3(AU_MOVE_COLL,  
 			 objIdString,
@@ -8548,6 +9050,113 @@ int setOverQuota(rsComm_t *rsComm) {
 }
 
 
+/*
+ The usage (R_QUOTA_USAGE) is kept up to date between runs of
+ chlCalcUsageAndQuota with delta rows (R_QUOTA_DELTA) that are added,
+ in the same transaction, when data object copies are registered,
+ unregistered or changed in size, resource or owner.  The deltas are
+ folded into R_QUOTA_USAGE (and the over_quota values reset) by the
+ quota admin calls, in their transaction: chlSetQuota folds them and
+ chlCalcUsageAndQuota recounts the usage, which takes them in.  Quota
+ checks (chlCheckQuota and the QUOTA_QUERY GenQuery) only read.  Deltas
+ are only kept when some quota is set.
+ */
+static void
+quotaDeltaSql(char *sign, char *dataWhere, char *tSQL) {
+   snprintf(tSQL, MAX_SQL_SIZE, 
+	    "insert into R_QUOTA_DELTA (user_id, resc_id, quota_delta, modify_ts) select UM.user_id, RM.resc_id, %sDM.data_size, ? from R_DATA_MAIN DM, R_USER_MAIN UM, R_RESC_MAIN RM where %s and DM.data_size <> 0 and UM.user_name = DM.data_owner_name and UM.zone_name = DM.data_owner_zone and RM.resc_name = DM.resc_name and exists (select user_id from R_QUOTA_MAIN)",
+	    sign, dataWhere);
+}
+
+/*
+ Add deltas for the copies (R_DATA_MAIN DM rows) selected by
+ dataWhere, which has up to three bind variables; sign is "" when the
+ copies are added to the usage and "-" when they are taken out.
+ */
+static int
+_addQuotaDeltas(char *sign, char *dataWhere, 
+		char *arg1, char *arg2, char *arg3) {
+   char tSQL[MAX_SQL_SIZE];
+   char myTime[50];
+   int status;
+
+   getNowStr(myTime);
+   quotaDeltaSql(sign, dataWhere, tSQL);
+   cllBindVars[cllBindVarCount++]=myTime;
+   if (arg1 != NULL) cllBindVars[cllBindVarCount++]=arg1;
+   if (arg2 != NULL) cllBindVars[cllBindVarCount++]=arg2;
+   if (arg3 != NULL) cllBindVars[cllBindVarCount++]=arg3;
+   if (logSQL!=0) rodsLog(LOG_SQL, "_addQuotaDeltas SQL 1");
+   status =  cmlExecuteNoAnswerSql(tSQL, &icss);
+   if (status == CAT_SUCCESS_BUT_WITH_NO_INFO) status=0; /* none */
+   if (status != 0) {
+      rodsLog(LOG_NOTICE,
+	      "_addQuotaDeltas cmlExecuteNoAnswerSql insert failure %d",
+	      status);
+   }
+   return(status);
+}
+
+/*
+ Fold the deltas into R_QUOTA_USAGE.  The rows folded are first
+ marked (modify_ts set to QUOTA_DELTA_FOLDING) so that deltas added by
+ other agents meanwhile are left for the next time.  Does not commit.
+ Returns 1 if some were folded, 0 if there were none.
+ */
+#define QUOTA_DELTA_FOLDING "folding"
+static int
+_foldQuotaDeltas(char *myTime) {
+   int status, status2;
+   int statementNum;
+
+   cllBindVars[cllBindVarCount++]=QUOTA_DELTA_FOLDING;
+   cllBindVars[cllBindVarCount++]=QUOTA_DELTA_FOLDING;
+   if (logSQL!=0) rodsLog(LOG_SQL, "_foldQuotaDeltas SQL 1");
+   status =  cmlExecuteNoAnswerSql(
+      "update R_QUOTA_DELTA set modify_ts=? where modify_ts<>?", &icss);
+   if (status == CAT_SUCCESS_BUT_WITH_NO_INFO) return(0); /* none */
+   if (status != 0) return(status);
+
+   if (logSQL!=0) rodsLog(LOG_SQL, "_foldQuotaDeltas SQL 2");
+   status = cmlGetFirstRowFromSqlBV(
+      "select sum(quota_delta), user_id, resc_id from R_QUOTA_DELTA where modify_ts=? group by user_id, resc_id",
+      QUOTA_DELTA_FOLDING, 0, 0, 0, &statementNum, &icss);
+   while (status == 0) {
+      cllBindVars[cllBindVarCount++]=icss.stmtPtr[statementNum]->resultValue[0];
+      cllBindVars[cllBindVarCount++]=myTime;
+      cllBindVars[cllBindVarCount++]=icss.stmtPtr[statementNum]->resultValue[1];
+      cllBindVars[cllBindVarCount++]=icss.stmtPtr[statementNum]->resultValue[2];
+      if (logSQL!=0) rodsLog(LOG_SQL, "_foldQuotaDeltas SQL 3");
+      status2 =  cmlExecuteNoAnswerSql(
+	 "update R_QUOTA_USAGE set quota_usage=quota_usage+?, modify_ts=? where user_id=? and resc_id=?",
+	 &icss);
+      if (status2 == CAT_SUCCESS_BUT_WITH_NO_INFO) {
+	 /* the first usage of this user on this resource */
+	 cllBindVars[cllBindVarCount++]=icss.stmtPtr[statementNum]->resultValue[0];
+	 cllBindVars[cllBindVarCount++]=icss.stmtPtr[statementNum]->resultValue[2];
+	 cllBindVars[cllBindVarCount++]=icss.stmtPtr[statementNum]->resultValue[1];
+	 cllBindVars[cllBindVarCount++]=myTime;
+	 if (logSQL!=0) rodsLog(LOG_SQL, "_foldQuotaDeltas SQL 4");
+	 status2 =  cmlExecuteNoAnswerSql(
+	    "insert into R_QUOTA_USAGE (quota_usage, resc_id, user_id, modify_ts) values (?, ?, ?, ?)",
+	    &icss);
+      }
+      if (status2 != 0) {
+	 cmlFreeStatement(statementNum, &icss);
+	 return(status2);
+      }
+      status = cmlGetNextRowFromStatement(statementNum, &icss);
+   }
+   if (status != CAT_NO_ROWS_FOUND) return(status);
+
+   cllBindVars[cllBindVarCount++]=QUOTA_DELTA_FOLDING;
+   if (logSQL!=0) rodsLog(LOG_SQL, "_foldQuotaDeltas SQL 5");
+   status =  cmlExecuteNoAnswerSql(
+      "delete from R_QUOTA_DELTA where modify_ts=?", &icss);
+   if (status != 0) return(status);
+   return(1);
+}
+
 int chlCalcUsageAndQuota(rsComm_t *rsComm) {
    int status;
    char myTime[50];
@@ -8573,6 +9182,14 @@ int chlCalcUsageAndQuota(rsComm_t *rsComm) {
       return(status);
    }
 
+   /* The deltas are in the sums below */
+   if (logSQL!=0) rodsLog(LOG_SQL, "chlCalcUsageAndQuota SQL 1a");
+   status =  cmlExecuteNoAnswerSql("delete from R_QUOTA_DELTA", &icss);
+   if (status !=0 && status !=CAT_SUCCESS_BUT_WITH_NO_INFO) {
+      _rollback("chlCalcUsageAndQuota");
+      return(status);
+   }
+
    /* Add a row to R_QUOTA_USAGE for each user's usage on each resource */
    if (logSQL!=0) rodsLog(LOG_SQL, "chlCalcUsageAndQuota SQL 2");
    cllBindVars[cllBindVarCount++]=myTime;
@@ -8694,10 +9311,13 @@ int chlSetQuota(rsComm_t *rsComm, char *type, char *name,
       }
    }
 
-   /* Reset the over_quota flags based on previous usage info.  The
-      usage info may take a while to set, but setting the OverQuota
-      should be quick.  */
-   status = setOverQuota(rsComm);
+   /* Reset the over_quota flags based on previous usage info, with
+      the deltas folded in.  The usage info may take a while to set,
+      but setting the OverQuota should be quick.  */
+   getNowStr(myTime);
+   status = _foldQuotaDeltas(myTime);
+   if (status > 0) status = 0;
+   if (status == 0) status = setOverQuota(rsComm);
    if (status != 0) {
       _rollback("chlSetQuota");
       return(status);
@@ -8726,6 +9346,7 @@ chlCheckQuota(rsComm_t *rsComm, char *userName, char *rescName,
    char mySQL[]="select distinct QM.user_id, QM.resc_id, QM.quota_limit, QM.quota_over from R_QUOTA_MAIN QM, R_USER_MAIN UM, R_RESC_MAIN RM, R_USER_GROUP UG, R_USER_MAIN UM2 where ( (QM.user_id = UM.user_id and UM.user_name = ?) or (QM.user_id = UG.group_user_id and UM2.user_name = ? and UG.user_id = UM2.user_id) ) and ((QM.resc_id = RM.resc_id and RM.resc_name = ?) or QM.resc_id = '0') order by quota_over desc";
 
    *userQuota = 0;
+
    if (logSQL!=0) rodsLog(LOG_SQL, "chlCheckQuota SQL 1");
    cllBindVars[cllBindVarCount++]=userName;
    cllBindVars[cllBindVarCount++]=userName;
@@ -22,6 +22,7 @@ Callable functions:
    cllGetNumberOfColumns
    cllGetColumnInfo
    cllNextValueString
+   cllSetStmtCache
 
 Internal functions are those that do not begin with cll.
 The external functions used are those that begin with SQL.
@@ -33,11 +34,17 @@ int _cllFreeStatementColumns(icatSessionStruct *icss, int statementNumber);
 
 int
 _cllExecSqlNoResult(icatSessionStruct *icss, char *sql, int option);
+static int getCachedStmt(icatSessionStruct *icss, char *sql, HSTMT *myHstmt);
+static void releaseCachedStmt(icatSessionStruct *icss, int cacheInx,
+			      int dropIt);
+static void freeCachedStmts(icatSessionStruct *icss);
 
 
 int cllBindVarCount=0;
 char *cllBindVars[MAX_BIND_VARS];
 int cllBindVarCountPrev=0; /* cclBindVarCount earlier in processing */
+int cllFetchRows=0; /* set by a caller that will read many rows, so the
+		       next cllExecSqlWithResult* fetches them in blocks */
 
 SQLCHAR  psgErrorMsg[SQL_MAX_MESSAGE_LENGTH + 10];
 
@@ -62,11 +69,22 @@ SQLCHAR  psgErrorMsg[SQL_MAX_MESSAGE_LENGTH + 10];
 
 #define TMP_STR_LEN 1040
 
+/* limits on the block fetch; the rows in a block are also limited so
+   the column buffers of a statement take no more than MAX_ROW_ARRAY_BUF */
+#define MAX_ROW_ARRAY_SIZE 256
+#define MAX_ROW_ARRAY_BUF (256*1024)
+
+typedef struct {
+   SQL_UINT_OR_ULEN rowsFetched;
+   SQLLEN *ind;		/* numOfCols * rowArraySize indicators */
+} cllFetchArea;
+
 SQLINTEGER columnLength[MAX_TOKEN];  /* change me ! */
 
 #include <stdio.h>
 #include <pwd.h>
 #include <ctype.h>
+#include <sys/time.h>
 
 static int didBegin=0;
 static int noResultRowCount=0;
@@ -462,6 +480,8 @@ cllDisconnect(icatSessionStruct *icss) {
       /* Nothing to do if it fails */
    }
 
+   freeCachedStmts(icss);
+
    stat = SQLDisconnect(myHdbc);
    if (stat != SQL_SUCCESS) {
       rodsLog(LOG_ERROR, "cllDisconnect: SQLDisconnect failed: %d", stat);
@@ -502,6 +522,161 @@ cllExecSqlNoResult(icatSessionStruct *icss, char *sql)
    return (_cllExecSqlNoResult(icss, sql, 0));
 }
 
+/*
+ Execute a SQL command with no resulting table (typically an insert)
+ once for each of numOfRows sets of bind variables; bindVars has
+ numOfVars values per row.  The values are bound as parameter arrays
+ so the whole set goes to the DBMS in one SQLExecute.  If the driver
+ can not do parameter arrays, the rows are executed one at a time.
+ */
+int
+cllExecSqlNoResultArray(icatSessionStruct *icss, char *sql,
+			char *bindVars[], int numOfVars, int numOfRows)
+{
+   RETCODE stat;
+   HSTMT myHstmt;
+   int status, result;
+   int cacheInx;
+   int i, j, len, numOfBufs;
+   int maxLen[MAX_BIND_VARS];
+   char *paramBuf[MAX_BIND_VARS];
+   SQLLEN *paramInd;
+   SQL_UINT_OR_ULEN rowsProcessed;
+   char tmpStr[TMP_STR_LEN+2];
+
+   if (numOfRows <= 0) return(0);
+   if (numOfVars <= 0 || numOfVars > MAX_BIND_VARS) {
+      rodsLog(LOG_ERROR, 
+	      "cllExecSqlNoResultArray: bad number of bind variables: %d",
+	      numOfVars);
+      return(-1);
+   }
+
+   if (didBegin==0) {
+      status = _cllExecSqlNoResult(icss, "begin", 1);
+      if (status != SQL_SUCCESS) return(status);
+   }
+   didBegin=1;
+
+   noResultRowCount=0;
+   cacheInx = getCachedStmt(icss, sql, &myHstmt);
+   if (cacheInx < 0) {
+      stat = SQLAllocStmt(icss->connectPtr, &myHstmt); 
+      if (stat != SQL_SUCCESS) {
+	 rodsLog(LOG_ERROR, 
+		 "cllExecSqlNoResultArray: SQLAllocStmt failed: %d", stat);
+	 return(-1);
+      }
+      rodsLogSql("SQLPrepare");
+      stat = SQLPrepare(myHstmt, (unsigned char *)sql, SQL_NTS);
+      if (stat != SQL_SUCCESS) {
+	 rodsLog(LOG_ERROR, "cllExecSqlNoResultArray: SQLPrepare failed: %d",
+		 stat);
+	 SQLFreeStmt(myHstmt, SQL_DROP);
+	 return(-1);
+      }
+   }
+
+   stat = SQL_ERROR;
+   if (numOfRows > 1) {
+      stat = SQLSetStmtAttr(myHstmt, SQL_ATTR_PARAMSET_SIZE, 
+			    (SQLPOINTER)(long)numOfRows, 0);
+      if (stat == SQL_SUCCESS) {
+	 stat = SQLSetStmtAttr(myHstmt, SQL_ATTR_PARAMS_PROCESSED_PTR, 
+			       &rowsProcessed, 0);
+      }
+   }
+   if (stat != SQL_SUCCESS) {
+      /* a single row, or the driver can not do it; go one at a time */
+      if (cacheInx >= 0) {
+	 SQLSetStmtAttr(myHstmt, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER)1, 0);
+	 SQLSetStmtAttr(myHstmt, SQL_ATTR_PARAMS_PROCESSED_PTR, NULL, 0);
+	 releaseCachedStmt(icss, cacheInx, 0);
+      }
+      else {
+	 SQLFreeStmt(myHstmt, SQL_DROP);
+      }
+      result = 0;
+      for (i=0;i<numOfRows;i++) {
+	 for (j=0;j<numOfVars;j++) {
+	    cllBindVars[j] = bindVars[i*numOfVars+j];
+	 }
+	 cllBindVarCount=numOfVars;
+	 status = _cllExecSqlNoResult(icss, sql, 0);
+	 if (status != 0 && status != CAT_SUCCESS_BUT_WITH_NO_INFO) {
+	    return(status);
+	 }
+	 if (status != 0) result = status;
+      }
+      return(result);
+   }
+
+   /* copy each column's values into a contiguous array */
+   paramInd = (SQLLEN *)malloc(sizeof(SQLLEN) * numOfRows);
+   for (i=0;i<numOfRows;i++) paramInd[i] = SQL_NTS;
+   numOfBufs=0;
+   for (j=0;j<numOfVars;j++) {
+      maxLen[j]=1;
+      for (i=0;i<numOfRows;i++) {
+	 len = strlen(bindVars[i*numOfVars+j]);
+	 if (len > maxLen[j]) maxLen[j]=len;
+      }
+      paramBuf[j] = (char *)malloc((maxLen[j]+1) * numOfRows);
+      numOfBufs++;
+      for (i=0;i<numOfRows;i++) {
+	 strcpy(paramBuf[j] + i*(maxLen[j]+1), bindVars[i*numOfVars+j]);
+      }
+      stat = SQLBindParameter(myHstmt, j+1, SQL_PARAM_INPUT, SQL_C_CHAR,
+			      SQL_C_CHAR, maxLen[j], 0, paramBuf[j],
+			      maxLen[j]+1, paramInd);
+      if (stat != SQL_SUCCESS) {
+	 rodsLog(LOG_ERROR, 
+		 "cllExecSqlNoResultArray: SQLBindParameter failed: %d", stat);
+	 break;
+      }
+   }
+
+   if (stat == SQL_SUCCESS) {
+      rodsLogSql(sql);
+      snprintf(tmpStr, TMP_STR_LEN, "rows=%d", numOfRows);
+      rodsLogSql(tmpStr);
+      rowsProcessed=0;
+      stat = SQLExecute(myHstmt);
+      if (stat == SQL_SUCCESS) rodsLogSqlResult("SUCCESS");
+      if (stat == SQL_SUCCESS_WITH_INFO) rodsLogSqlResult("SUCCESS_WITH_INFO");
+      if (stat == SQL_ERROR) rodsLogSqlResult("SQL_ERROR");
+   }
+
+   if (stat == SQL_SUCCESS || stat == SQL_SUCCESS_WITH_INFO) {
+      cllCheckPending(sql, 0, icss->databaseType);
+      noResultRowCount = rowsProcessed;
+      result = 0;
+   }
+   else {
+      rodsLog(LOG_NOTICE,
+	      "cllExecSqlNoResultArray: SQLExecute error: %d rows:%d sql:%s",
+	      stat, numOfRows, sql);
+      result = logPsgError(LOG_NOTICE, icss->environPtr, icss->connectPtr,
+			   myHstmt, icss->databaseType);
+      if (result == 0) result = -1;
+   }
+
+   SQLSetStmtAttr(myHstmt, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER)1, 0);
+   SQLSetStmtAttr(myHstmt, SQL_ATTR_PARAMS_PROCESSED_PTR, NULL, 0);
+   if (cacheInx >= 0) {
+      /* don't keep a statement that failed */
+      releaseCachedStmt(icss, cacheInx, result != 0);
+      if (result != 0) SQLFreeStmt(myHstmt, SQL_DROP);
+   }
+   else {
+      SQLFreeStmt(myHstmt, SQL_DROP);
+   }
+
+   for (i=0;i<numOfBufs;i++) free(paramBuf[i]);
+   free(paramInd);
+   return(result);
+}
+
 /*
  Log the bind variables from the global array (after an error)
 */
@@ -518,6 +693,8 @@ logTheBindVariables(int level)
 
 /*
  Bind variables from the global array.
+ If sql is NULL, the statement has already been prepared (it came from
+ the statement cache) and only the bind is done.
  */
 int
 bindTheVariables(HSTMT myHstmt, char *sql) {
@@ -531,12 +708,14 @@ bindTheVariables(HSTMT myHstmt, char *sql) {
    cllBindVarCount = 0; /* reset for next call */
 
    if (myBindVarCount > 0) {
-      rodsLogSql("SQLPrepare");
-      stat = SQLPrepare(myHstmt,  (unsigned char *)sql, SQL_NTS);
-      if (stat != SQL_SUCCESS) {
-	 rodsLog(LOG_ERROR, "bindTheVariables: SQLPrepare failed: %d",
-		 stat);
-	 return(-1);
+      if (sql != NULL) {
+	 rodsLogSql("SQLPrepare");
+	 stat = SQLPrepare(myHstmt,  (unsigned char *)sql, SQL_NTS);
+	 if (stat != SQL_SUCCESS) {
+	    rodsLog(LOG_ERROR, "bindTheVariables: SQLPrepare failed: %d",
+		    stat);
+	    return(-1);
+	 }
       }
 
       for (i=0;i<myBindVarCount;i++) {
@@ -560,6 +739,150 @@ bindTheVariables(HSTMT myHstmt, char *sql) {
    return(0);
 }
 
+/*
+ The statement cache.  Statements with bind variables are prepared
+ once per connection and kept in icss->cachedStmt, keyed by the SQL
+ text, so the DBMS does not have to parse and plan the same SQL again.
+ When the cache is full, the least recently used idle statement is
+ dropped.  A statement is marked inUse while it is executing or has an
+ open result set (until cllFreeStatement), so nested queries with the
+ same SQL get a second handle.
+ */
+
+/*
+ Get a prepared statement for sql from the cache, preparing and adding
+ it if needed.  Returns the cache index, or -1 if the cache can not be
+ used (in which case the caller allocates and executes directly).
+ */
+static int
+getCachedStmt(icatSessionStruct *icss, char *sql, HSTMT *myHstmt) {
+   RETCODE stat;
+   HSTMT hstmt;
+   icatCachedStmtStrct *cachedStmt;
+   int i, freeInx, lruInx;
+
+   if (icss->cachedStmtOff) return(-1);
+
+   freeInx=-1;
+   lruInx=-1;
+   for (i=0;i<MAX_NUM_OF_CACHED_STMTS;i++) {
+      cachedStmt = &icss->cachedStmt[i];
+      if (cachedStmt->sql == NULL) {
+	 if (freeInx < 0) freeInx=i;
+	 continue;
+      }
+      if (cachedStmt->inUse) continue;
+      if (strcmp(cachedStmt->sql, sql)==0) {
+	 cachedStmt->inUse=1;
+	 cachedStmt->lastUsed = ++icss->cachedStmtClock;
+	 *myHstmt = cachedStmt->stmtPtr;
+	 return(i);
+      }
+      if (lruInx < 0 || 
+	  cachedStmt->lastUsed < icss->cachedStmt[lruInx].lastUsed) {
+	 lruInx=i;
+      }
+   }
+
+   if (freeInx < 0) {
+      if (lruInx < 0) return(-1);  /* all in use */
+      cachedStmt = &icss->cachedStmt[lruInx];
+      stat = SQLFreeStmt(cachedStmt->stmtPtr, SQL_DROP);
+      if (stat != SQL_SUCCESS) {
+	 rodsLog(LOG_ERROR, "getCachedStmt: SQLFreeStmt error: %d", stat);
+      }
+      free(cachedStmt->sql);
+      memset(cachedStmt, 0, sizeof(icatCachedStmtStrct));
+      freeInx=lruInx;
+   }
+
+   stat = SQLAllocStmt(icss->connectPtr, &hstmt); 
+   if (stat != SQL_SUCCESS) {
+      rodsLog(LOG_ERROR, "getCachedStmt: SQLAllocStmt failed: %d", stat);
+      return(-1);
+   }
+   rodsLogSql("SQLPrepare");
+   stat = SQLPrepare(hstmt, (unsigned char *)sql, SQL_NTS);
+   if (stat != SQL_SUCCESS) {
+      /* let the uncached path report the error */
+      SQLFreeStmt(hstmt, SQL_DROP);
+      return(-1);
+   }
+
+   cachedStmt = &icss->cachedStmt[freeInx];
+   cachedStmt->sql = strdup(sql);
+   cachedStmt->stmtPtr = hstmt;
+   cachedStmt->inUse = 1;
+   cachedStmt->lastUsed = ++icss->cachedStmtClock;
+   *myHstmt = hstmt;
+   return(freeInx);
+}
+
+/*
+ Return a statement to the cache when the caller is done with it.
+ If dropIt is set (after an error), the statement is removed from the
+ cache instead; the handle is then freed by the caller.
+ */
+static void
+releaseCachedStmt(icatSessionStruct *icss, int cacheInx, int dropIt) {
+   icatCachedStmtStrct *cachedStmt;
+   HSTMT hstmt;
+
+   if (cacheInx < 0 || cacheInx >= MAX_NUM_OF_CACHED_STMTS) return;
+   cachedStmt = &icss->cachedStmt[cacheInx];
+   hstmt = cachedStmt->stmtPtr;
+
+   if (dropIt) {
+      free(cachedStmt->sql);
+      memset(cachedStmt, 0, sizeof(icatCachedStmtStrct));
+      return;
+   }
+   SQLFreeStmt(hstmt, SQL_CLOSE);
+   SQLFreeStmt(hstmt, SQL_UNBIND);
+   SQLFreeStmt(hstmt, SQL_RESET_PARAMS);
+   cachedStmt->inUse=0;
+}
+
+/*
+ Drop all the cached statements (at disconnect, or when the cache is
+ turned off).
+ */
+static void
+freeCachedStmts(icatSessionStruct *icss) {
+   int i;
+   RETCODE stat;
+
+   for (i=0;i<MAX_NUM_OF_CACHED_STMTS;i++) {
+      if (icss->cachedStmt[i].sql == NULL) continue;
+      if (icss->cachedStmt[i].inUse == 0) {
+	 stat = SQLFreeStmt(icss->cachedStmt[i].stmtPtr, SQL_DROP);
+	 if (stat != SQL_SUCCESS) {
+	    rodsLog(LOG_ERROR, "freeCachedStmts: SQLFreeStmt error: %d",
+		    stat);
+	 }
+      }
+      /* an inUse one is freed by cllFreeStatement as an uncached one */
+      free(icss->cachedStmt[i].sql);
+      memset(&icss->cachedStmt[i], 0, sizeof(icatCachedStmtStrct));
+   }
+}
+
+/*
+ Turn the statement cache on (onOff=1) or off (onOff=0).  It is on by
+ default; test_cll and test_chl turn it off to compare timings.
+ */
+int
+cllSetStmtCache(icatSessionStruct *icss, int onOff) {
+   if (onOff) {
+      icss->cachedStmtOff = 0;
+   }
+   else {
+      freeCachedStmts(icss);
+      icss->cachedStmtOff = 1;
+   }
+   return(0);
+}
+
 /*
    Case-insensitive string comparison, first string can be any case and
    contain leading and trailing spaces, second string must be lowercase, 
@@ -598,6 +921,7 @@ _cllExecSqlNoResult(icatSessionStruct *icss, char *sql,
    int result;
    char *status;
    SQL_INT_OR_LEN rowCount;
+   int cacheInx;
 #ifdef NEW_ODBC
    int i;
 #endif
@@ -606,10 +930,18 @@ _cllExecSqlNoResult(icatSessionStruct *icss, char *sql,
 
    myHdbc = icss->connectPtr;
    rodsLog(LOG_DEBUG1, sql);
-   stat = SQLAllocStmt(myHdbc, &myHstmt); 
-   if (stat != SQL_SUCCESS) {
-      rodsLog(LOG_ERROR, "_cllExecSqlNoResult: SQLAllocStmt failed: %d", stat);
-      return(-1);
+
+   cacheInx=-1;
+   if (option==0 && cllBindVarCount > 0) {
+      cacheInx = getCachedStmt(icss, sql, &myHstmt);
+   }
+   if (cacheInx < 0) {
+      stat = SQLAllocStmt(myHdbc, &myHstmt); 
+      if (stat != SQL_SUCCESS) {
+	 rodsLog(LOG_ERROR, "_cllExecSqlNoResult: SQLAllocStmt failed: %d",
+		 stat);
+	 return(-1);
+      }
    }
 
 #if 0
@@ -624,13 +956,24 @@ _cllExecSqlNoResult(icatSessionStruct *icss, char *sql,
    }
 #endif
 
-   if (option==0) {
+   if (cacheInx >= 0) {
+      if (bindTheVariables(myHstmt, NULL) != 0) {
+	 releaseCachedStmt(icss, cacheInx, 0);
+	 return(-1);
+      }
+   }
+   else if (option==0) {
       if (bindTheVariables(myHstmt, sql) != 0) return(-1);
    }
 
    rodsLogSql(sql);
 
-   stat = SQLExecDirect(myHstmt, (unsigned char *)sql, SQL_NTS);
+   if (cacheInx >= 0) {
+      stat = SQLExecute(myHstmt);
+   }
+   else {
+      stat = SQLExecDirect(myHstmt, (unsigned char *)sql, SQL_NTS);
+   }
    status = "UNKNOWN";
    if (stat == SQL_SUCCESS) status= "SUCCESS";
    if (stat == SQL_SUCCESS_WITH_INFO) status="SUCCESS_WITH_INFO";
@@ -670,17 +1013,124 @@ _cllExecSqlNoResult(icatSessionStruct *icss, char *sql,
 	      stat, sql);
       result = logPsgError(LOG_NOTICE, icss->environPtr, myHdbc, myHstmt,
 			   icss->databaseType);
+      if (cacheInx >= 0) {
+	 /* don't keep a statement that failed */
+	 releaseCachedStmt(icss, cacheInx, 1);
+	 cacheInx=-1;
+      }
    }
 
-   stat = SQLFreeStmt(myHstmt, SQL_DROP);
-   if (stat != SQL_SUCCESS) {
-      rodsLog(LOG_ERROR, "_cllExecSqlNoResult: SQLFreeStmt error: %d", stat);
+   if (cacheInx >= 0) {
+      releaseCachedStmt(icss, cacheInx, 0);
+   }
+   else {
+      stat = SQLFreeStmt(myHstmt, SQL_DROP);
+      if (stat != SQL_SUCCESS) {
+	 rodsLog(LOG_ERROR, "_cllExecSqlNoResult: SQLFreeStmt error: %d",
+		 stat);
+      }
    }
 
    noResultRowCount = rowCount;
    return(result);
 }
 
+/*
+ Turn off the block fetch on a statement handle, so a cached
+ statement does not keep pointing to a freed cllFetchArea.
+ */
+static void
+resetRowArraySize(HSTMT hstmt) {
+   SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)1, 0);
+   SQLSetStmtAttr(hstmt, SQL_ATTR_ROWS_FETCHED_PTR, NULL, 0);
+}
+
+/*
+ Allocate the result buffers of a statement and bind them to its
+ columns; columnLength must have been set for each column.  If
+ fetchRows is more than one (see cllFetchRows), the columns are bound
+ as arrays (column-wise) so one SQLFetch gets a block of rows, which
+ cllGetRow then hands out one at a time.
+ */
+static int
+bindResultColumns(HSTMT hstmt, icatStmtStrct *myStatement, int fetchRows,
+		  char *caller) {
+   RETCODE stat;
+   cllFetchArea *fetchArea;
+   SQLLEN *indPtr;
+   int numColumns, rowArraySize, rowLen;
+   int i;
+
+   numColumns = myStatement->numOfCols;
+   rowLen=0;
+   for (i=0;i<numColumns;i++) {
+      rowLen += columnLength[i];
+      myStatement->resultBlock[i]=NULL;
+   }
+
+   rowArraySize = fetchRows;
+   if (rowArraySize > MAX_ROW_ARRAY_SIZE) rowArraySize = MAX_ROW_ARRAY_SIZE;
+   if (rowLen > 0 && rowArraySize > MAX_ROW_ARRAY_BUF / rowLen) {
+      rowArraySize = MAX_ROW_ARRAY_BUF / rowLen;
+   }
+   if (rowArraySize < 1) rowArraySize = 1;
+
+   fetchArea = NULL;
+   if (rowArraySize > 1) {
+      fetchArea = (cllFetchArea *)malloc(sizeof(cllFetchArea));
+      fetchArea->rowsFetched = 0;
+      fetchArea->ind = (SQLLEN *)malloc(sizeof(SQLLEN) * numColumns *
+					rowArraySize);
+      stat = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_BIND_TYPE, 
+			    (SQLPOINTER)SQL_BIND_BY_COLUMN, 0);
+      if (stat == SQL_SUCCESS) {
+	 stat = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_ARRAY_SIZE, 
+			       (SQLPOINTER)(long)rowArraySize, 0);
+      }
+      if (stat == SQL_SUCCESS) {
+	 stat = SQLSetStmtAttr(hstmt, SQL_ATTR_ROWS_FETCHED_PTR,
+			       &fetchArea->rowsFetched, 0);
+      }
+      if (stat != SQL_SUCCESS) {
+	 /* the driver can not do it, get one row per fetch */
+	 rodsLog(LOG_DEBUG, "%s: block fetch not available: %d",
+		 caller, stat);
+	 resetRowArraySize(hstmt);
+	 free(fetchArea->ind);
+	 free(fetchArea);
+	 fetchArea = NULL;
+	 rowArraySize = 1;
+      }
+   }
+   myStatement->rowArraySize = rowArraySize;
+   myStatement->numOfRows = 0;
+   myStatement->curRow = 0;
+   myStatement->fetchArea = fetchArea;
+
+   for (i=0;i<numColumns;i++) {
+      myStatement->resultLen[i] = columnLength[i];
+      myStatement->resultBlock[i] = (char*)malloc((int)columnLength[i] * 
+						  rowArraySize);
+      myStatement->resultBlock[i][0]='\0';
+      myStatement->resultValue[i] = myStatement->resultBlock[i];
+
+      if (fetchArea != NULL) {
+	 indPtr = &fetchArea->ind[i * rowArraySize];
+      }
+      else {
+	 indPtr = &resultDataSizeArray[i];
+      }
+      stat = SQLBindCol(hstmt, i+1, SQL_C_CHAR, myStatement->resultBlock[i],
+			columnLength[i], indPtr);
+      if (stat != SQL_SUCCESS) {
+	 rodsLog(LOG_ERROR, 
+		 "%s: SQLBindCol failed: %d", caller, stat);
+	 return(-4);
+      }
+   }
+   return(0);
+}
+
 /* 
   Execute a SQL command that returns a result table, and
   and bind the default row.
@@ -700,15 +1150,14 @@ cllExecSqlWithResult(icatSessionStruct *icss, int *stmtNum, char *sql) {
    SQL_UINT_OR_ULEN precision;
    SQLSMALLINT     scale;
    SQL_INT_OR_LEN  displaysize;
-#ifndef NEW_ODBC
-   static SQLINTEGER resultDataSize;
-#endif
 
    icatStmtStrct *myStatement;
 
    int i;
    int statementNumber;
    char *status;
+   int cacheInx;
+   int fetchRows;
 
 /* In 2.2 and some versions before, this would call
    _cllExecSqlNoResult with "begin", similar to how cllExecSqlNoResult
@@ -717,13 +1166,23 @@ cllExecSqlWithResult(icatSessionStruct *icss, int *stmtNum, char *sql) {
    'idle in transaction' state which prevents some operations (such as
    backup).  So this was removed. */
 
+   fetchRows = cllFetchRows;
+   cllFetchRows = 0; /* reset for next call */
+
    myHdbc = icss->connectPtr;
    rodsLog(LOG_DEBUG1, sql);
-   stat = SQLAllocStmt(myHdbc, &hstmt); 
-   if (stat != SQL_SUCCESS) {
-      rodsLog(LOG_ERROR, "cllExecSqlWithResult: SQLAllocStmt failed: %d",
-	      stat);
-      return(-1);
+
+   cacheInx=-1;
+   if (cllBindVarCount > 0) {
+      cacheInx = getCachedStmt(icss, sql, &hstmt);
+   }
+   if (cacheInx < 0) {
+      stat = SQLAllocStmt(myHdbc, &hstmt); 
+      if (stat != SQL_SUCCESS) {
+	 rodsLog(LOG_ERROR, "cllExecSqlWithResult: SQLAllocStmt failed: %d",
+		 stat);
+	 return(-1);
+      }
    }
 
    statementNumber=-1;
@@ -735,6 +1194,7 @@ cllExecSqlWithResult(icatSessionStruct *icss, int *stmtNum, char *sql) {
    if (statementNumber<0) {
       rodsLog(LOG_ERROR, 
 	      "cllExecSqlWithResult: too many concurrent statements");
+      if (cacheInx >= 0) releaseCachedStmt(icss, cacheInx, 0);
       return(-2);
    }
 
@@ -742,12 +1202,24 @@ cllExecSqlWithResult(icatSessionStruct *icss, int *stmtNum, char *sql) {
    icss->stmtPtr[statementNumber]=myStatement;
 
    myStatement->stmtPtr=hstmt;
+   myStatement->cachedStmtInx=cacheInx;
+   myStatement->fetchArea=NULL;
 
-   if (bindTheVariables(hstmt, sql) != 0) return(-1);
+   if (cacheInx >= 0) {
+      if (bindTheVariables(hstmt, NULL) != 0) return(-1);
+   }
+   else {
+      if (bindTheVariables(hstmt, sql) != 0) return(-1);
+   }
 
    rodsLogSql(sql);
 
-   stat = SQLExecDirect(hstmt, (unsigned char *)sql, SQL_NTS);
+   if (cacheInx >= 0) {
+      stat = SQLExecute(hstmt);
+   }
+   else {
+      stat = SQLExecDirect(hstmt, (unsigned char *)sql, SQL_NTS);
+   }
    status = "UNKNOWN";
    if (stat == SQL_SUCCESS) status= "SUCCESS";
    if (stat == SQL_SUCCESS_WITH_INFO) status="SUCCESS_WITH_INFO";
@@ -767,6 +1239,12 @@ cllExecSqlWithResult(icatSessionStruct *icss, int *stmtNum, char *sql) {
 	      stat, sql);
       logPsgError(LOG_NOTICE, icss->environPtr, myHdbc, hstmt,
 		  icss->databaseType);
+      if (cacheInx >= 0) {
+	 /* don't keep a statement that failed; cllFreeStatement will
+	    drop the handle */
+	 releaseCachedStmt(icss, cacheInx, 1);
+	 myStatement->cachedStmtInx=-1;
+      }
       return(-1);
    }
 
@@ -804,41 +1282,15 @@ cllExecSqlWithResult(icatSessionStruct *icss, int *stmtNum, char *sql) {
 	 columnLength[i] = strlen((char *) colName) + 1;
       }
       /*      printf("columnLength[%d]=%d\n",i,columnLength[i]); */
- 
-      myStatement->resultValue[i] = (char*)malloc((int)columnLength[i]);
-
-      strcpy((char *)myStatement->resultValue[i],"");
-
-#if 1
-	  // =-=-=-=-=-=-=-
-	  // JMC :: added static array to catch the result set size.  this was necessary to 
-      stat = SQLBindCol(hstmt, i+1, SQL_C_CHAR, myStatement->resultValue[i], columnLength[i], &resultDataSizeArray[ i ] );
-#else
-	#if NEW_ODBC
-		  stat = SQLBindCol(hstmt, i+1, SQL_C_CHAR, myStatement->resultValue[i], 
-				columnLength[i], NULL);
-		  /* The last argument could be resultDataSize (a SQLINTEGER
-			 location), which will be returned later via the SQLFetch.
-			 Since unused now, passing in NULL tells ODBC to skip it */
-	#else
-		  /* The old ODBC needs a non-NULL value */
-		  stat = SQLBindCol(hstmt, i+1, SQL_C_CHAR, myStatement->resultValue[i], 
-				columnLength[i], &resultDataSize);
-	#endif
-#endif
-
-      if (stat != SQL_SUCCESS) {
-	 rodsLog(LOG_ERROR, 
-		 "cllExecSqlWithResult: SQLColAttributes failed: %d",
-		 stat);
-	 return(-4);
-      }
-
 
       myStatement->resultColName[i] = (char*)malloc((int)columnLength[i]);
       strncpy(myStatement->resultColName[i], (char *)colName, columnLength[i]);
 
    }
+   i = bindResultColumns(hstmt, myStatement, fetchRows,
+			 "cllExecSqlWithResult");
+   if (i != 0) return(i);
+
    *stmtNum = statementNumber;
    return(0);
 }
@@ -885,9 +1337,6 @@ cllExecSqlWithResultBV(icatSessionStruct *icss, int *stmtNum, char *sql,
    SQL_UINT_OR_ULEN precision;
    SQLSMALLINT     scale;
    SQL_INT_OR_LEN  displaysize;
-#ifndef NEW_ODBC
-   static SQLINTEGER resultDataSize;
-#endif
 
    icatStmtStrct *myStatement;
 
@@ -895,14 +1344,29 @@ cllExecSqlWithResultBV(icatSessionStruct *icss, int *stmtNum, char *sql,
    int statementNumber;
    char *status;
    char tmpStr[TMP_STR_LEN+2];
+   int cacheInx;
+   int fetchRows;
+
+   fetchRows = cllFetchRows;
+   cllFetchRows = 0; /* reset for next call */
 
    myHdbc = icss->connectPtr;
    rodsLog(LOG_DEBUG1, sql);
-   stat = SQLAllocStmt(myHdbc, &hstmt); 
-   if (stat != SQL_SUCCESS) {
-      rodsLog(LOG_ERROR, "cllExecSqlWithResultBV: SQLAllocStmt failed: %d",
-	      stat);
-      return(-1);
+
+   cacheInx=-1;
+   if ((bindVar1 != 0 && *bindVar1 != '\0')  ||
+       (bindVar2 != 0 && *bindVar2 != '\0')  ||
+       (bindVar3 != 0 && *bindVar3 != '\0')  ||
+       (bindVar4 != 0 && *bindVar4 != '\0')) {
+      cacheInx = getCachedStmt(icss, sql, &hstmt);
+   }
+   if (cacheInx < 0) {
+      stat = SQLAllocStmt(myHdbc, &hstmt); 
+      if (stat != SQL_SUCCESS) {
+	 rodsLog(LOG_ERROR, "cllExecSqlWithResultBV: SQLAllocStmt failed: %d",
+		 stat);
+	 return(-1);
+      }
    }
 
    statementNumber=-1;
@@ -914,6 +1378,7 @@ cllExecSqlWithResultBV(icatSessionStruct *icss, int *stmtNum, char *sql,
    if (statementNumber<0) {
       rodsLog(LOG_ERROR, 
 	      "cllExecSqlWithResultBV: too many concurrent statements");
+      if (cacheInx >= 0) releaseCachedStmt(icss, cacheInx, 0);
       return(-2);
    }
 
@@ -921,18 +1386,22 @@ cllExecSqlWithResultBV(icatSessionStruct *icss, int *stmtNum, char *sql,
    icss->stmtPtr[statementNumber]=myStatement;
 
    myStatement->stmtPtr=hstmt;
+   myStatement->cachedStmtInx=cacheInx;
+   myStatement->fetchArea=NULL;
 
    if ((bindVar1 != 0 && *bindVar1 != '\0')  ||
        (bindVar2 != 0 && *bindVar2 != '\0')  ||
        (bindVar3 != 0 && *bindVar3 != '\0')  ||
        (bindVar4 != 0 && *bindVar4 != '\0')) {
 
-      rodsLogSql("SQLPrepare");
-      stat = SQLPrepare(hstmt,  (unsigned char *)sql, SQL_NTS);
-      if (stat != SQL_SUCCESS) {
-	 rodsLog(LOG_ERROR, "cllExecSqlNoResult: SQLPrepare failed: %d",
-		 stat);
-	 return(-1);
+      if (cacheInx < 0) {
+	 rodsLogSql("SQLPrepare");
+	 stat = SQLPrepare(hstmt,  (unsigned char *)sql, SQL_NTS);
+	 if (stat != SQL_SUCCESS) {
+	    rodsLog(LOG_ERROR, "cllExecSqlNoResult: SQLPrepare failed: %d",
+		    stat);
+	    return(-1);
+	 }
       }
 
       if (bindVar1 != 0 && *bindVar1 != '\0') {
@@ -1023,6 +1492,10 @@ cllExecSqlWithResultBV(icatSessionStruct *icss, int *stmtNum, char *sql,
 	      stat, sql);
       logPsgError(LOG_NOTICE, icss->environPtr, myHdbc, hstmt,
 		  icss->databaseType);
+      if (cacheInx >= 0) {
+	 releaseCachedStmt(icss, cacheInx, 1);
+	 myStatement->cachedStmtInx=-1;
+      }
       return(-1);
    }
 
@@ -1060,40 +1533,15 @@ cllExecSqlWithResultBV(icatSessionStruct *icss, int *stmtNum, char *sql,
 	 columnLength[i] = strlen((char *) colName) + 1;
       }
       /*      printf("columnLength[%d]=%d\n",i,columnLength[i]); */
- 
-      myStatement->resultValue[i] = (char*)malloc((int)columnLength[i]);
-
-      strcpy((char *)myStatement->resultValue[i],"");
-#if 1
-	  // =-=-=-=-=-=-=-
-	  // JMC :: added static array to catch the result set size.  this was necessary to 
-      stat = SQLBindCol(hstmt, i+1, SQL_C_CHAR, myStatement->resultValue[i], columnLength[i], &resultDataSizeArray[i] );
-#else
-		#ifdef NEW_ODBC
-		  stat = SQLBindCol(hstmt, i+1, SQL_C_CHAR, myStatement->resultValue[i], 
-				columnLength[i], NULL);
-		  /* The last argument could be resultDataSize (a SQLINTEGER
-			 location), which will be returned later via the SQLFetch.
-			 Since unused now, passing in NULL tells ODBC to skip it */
-		#else
-		  /* The old ODBC needs a non-NULL value */
-		  stat = SQLBindCol(hstmt, i+1, SQL_C_CHAR, myStatement->resultValue[i], 
-				columnLength[i], &resultDataSize);
-		#endif
-#endif
-
-      if (stat != SQL_SUCCESS) {
-	 rodsLog(LOG_ERROR, 
-		 "cllExecSqlWithResultBV: SQLColAttributes failed: %d",
-		 stat);
-	 return(-4);
-      }
-
 
       myStatement->resultColName[i] = (char*)malloc((int)columnLength[i]);
       strncpy(myStatement->resultColName[i], (char *)colName, columnLength[i]);
 
    }
+   i = bindResultColumns(hstmt, myStatement, fetchRows,
+			 "cllExecSqlWithResultBV");
+   if (i != 0) return(i);
+
    *stmtNum = statementNumber;
    return(0);
 }
@@ -1105,8 +1553,9 @@ int
 cllGetRow(icatSessionStruct *icss, int statementNumber) {
    HSTMT hstmt;
    RETCODE stat;
-   int nCols, i;
+   int nCols, i, j;
    icatStmtStrct *myStatement;
+   cllFetchArea *fetchArea;
    int logGetRows=0; /* Another handy debug flag.  When set and if
                         spLogSql is set, this function will log each
                         time a row is gotten, the number of columns ,
@@ -1116,9 +1565,22 @@ cllGetRow(icatSessionStruct *icss, int statementNumber) {
    hstmt = myStatement->stmtPtr;
    nCols = myStatement->numOfCols;
 
+   if (myStatement->curRow+1 < myStatement->numOfRows) {
+      /* the next row is already in the block from the last fetch */
+      myStatement->curRow++;
+      for (i=0;i<nCols;i++) {
+	 myStatement->resultValue[i] = myStatement->resultBlock[i] +
+	    myStatement->curRow * myStatement->resultLen[i];
+      }
+      return(0);
+   }
+
    for (i=0;i<nCols;i++) {
+      myStatement->resultValue[i] = myStatement->resultBlock[i];
       strcpy((char *)myStatement->resultValue[i],"");
    }
+   myStatement->numOfRows=0;
+   myStatement->curRow=0;
    stat =  SQLFetch(hstmt);
    if (stat != SQL_SUCCESS && stat != SQL_NO_DATA_FOUND) {
       rodsLog(LOG_ERROR, "cllGetRow: SQLFetch failed: %d", stat);
@@ -1135,6 +1597,22 @@ cllGetRow(icatSessionStruct *icss, int statementNumber) {
       myStatement->numOfCols=0;
    }
    else {
+      if (myStatement->fetchArea != NULL) {
+	 fetchArea = (cllFetchArea *)myStatement->fetchArea;
+	 myStatement->numOfRows = fetchArea->rowsFetched;
+	 /* the driver leaves the buffer alone for a NULL value */
+	 for (i=0;i<nCols;i++) {
+	    for (j=0;j<myStatement->numOfRows;j++) {
+	       if (fetchArea->ind[i * myStatement->rowArraySize + j] ==
+		   SQL_NULL_DATA) {
+		  myStatement->resultBlock[i][j * myStatement->resultLen[i]]='\0';
+	       }
+	    }
+	 }
+      }
+      else {
+	 myStatement->numOfRows = 1;
+      }
       if (logGetRows) {
 	 char tmpstr[210];
 	 snprintf(tmpstr, 200, "cllGetRow statement:%d columns:%d first column: %s", 
@@ -1187,6 +1665,30 @@ cllCurrentValueString(char *itemName, char *outString, int maxSize) {
    return 0;
 }
 
+/*
+ Free the result buffers of a statement and turn off its block fetch.
+ */
+static void
+freeResultColumns(icatStmtStrct *myStatement) {
+   cllFetchArea *fetchArea;
+   int i;
+
+   for (i=0;i<myStatement->numOfCols;i++) {
+      free(myStatement->resultBlock[i]);
+      free(myStatement->resultColName[i]);
+   }
+   myStatement->numOfRows=0;
+   myStatement->curRow=0;
+
+   fetchArea = (cllFetchArea *)myStatement->fetchArea;
+   if (fetchArea != NULL) {
+      resetRowArraySize(myStatement->stmtPtr);
+      free(fetchArea->ind);
+      free(fetchArea);
+      myStatement->fetchArea=NULL;
+   }
+}
+
 /* 
   Free a statement (from a previous cllExecSqlWithResult call) and the
   corresponding resultValue array.
@@ -1205,14 +1707,19 @@ cllFreeStatement(icatSessionStruct *icss, int statementNumber) {
    }
    hstmt = myStatement->stmtPtr;
 
-   for (i=0;i<myStatement->numOfCols;i++) {
-      free(myStatement->resultValue[i]);
-      free(myStatement->resultColName[i]);
-   }
+   freeResultColumns(myStatement);
 
-   stat = SQLFreeStmt(hstmt, SQL_DROP);
-   if (stat != SQL_SUCCESS) {
-      rodsLog(LOG_ERROR, "cllFreeStatement SQLFreeStmt error: %d", stat);
+   i = myStatement->cachedStmtInx;
+   if (i >= 0 && i < MAX_NUM_OF_CACHED_STMTS &&
+       icss->cachedStmt[i].stmtPtr == hstmt) {
+      /* keep the prepared statement for the next call */
+      releaseCachedStmt(icss, i, 0);
+   }
+   else {
+      stat = SQLFreeStmt(hstmt, SQL_DROP);
+      if (stat != SQL_SUCCESS) {
+	 rodsLog(LOG_ERROR, "cllFreeStatement SQLFreeStmt error: %d", stat);
+      }
    }
 
    free(myStatement);
@@ -1228,18 +1735,11 @@ cllFreeStatement(icatSessionStruct *icss, int statementNumber) {
 */
 int
 _cllFreeStatementColumns(icatSessionStruct *icss, int statementNumber) {
-   HSTMT hstmt;
-   int i;
-
    icatStmtStrct *myStatement;
 
    myStatement=icss->stmtPtr[statementNumber];
-   hstmt = myStatement->stmtPtr;
 
-   for (i=0;i<myStatement->numOfCols;i++) {
-      free(myStatement->resultValue[i]);
-      free(myStatement->resultColName[i]);
-   }
+   freeResultColumns(myStatement);
    return (0);
 }
 
@@ -1247,6 +1747,7 @@ _cllFreeStatementColumns(icatSessionStruct *icss, int statementNumber) {
  A few tests to verify basic functionality (including talking with
  the database via ODBC). 
  */
+#define CLL_TEST_TIMING_LOOPS 500
 int cllTest(char *userArg, char *pwArg) {
    int i;
    int j, k;
@@ -1255,11 +1756,13 @@ int cllTest(char *userArg, char *pwArg) {
    int numOfCols;
    char userName[500];
    int ival;
+   struct timeval startTime, endTime;
+   float elapsed[2];
 
    struct passwd *ppasswd;
    icatSessionStruct icss;
 
-   icss.stmtPtr[0]=0;
+   memset(&icss, 0, sizeof(icss));
    icss.databaseType = DB_TYPE_POSTGRES;
 #ifdef MY_ICAT
    icss.databaseType = DB_TYPE_MYSQL;
@@ -1367,6 +1870,32 @@ int cllTest(char *userArg, char *pwArg) {
       }
    }
 
+   /* Compare the time of the same bound select with the prepared
+      statement cache off and on */
+   rodsLogSqlReq(0);
+   for (k=0;k<2;k++) {
+      cllSetStmtCache(&icss, k);
+      (void)gettimeofday(&startTime, (struct timezone *)0);
+      for (j=0;j<CLL_TEST_TIMING_LOOPS;j++) {
+	 cllBindVars[cllBindVarCount++]="2";
+	 i = cllExecSqlWithResult(&icss, &stmt, 
+				  "select * from test where i = ?");
+	 if (i != 0) {
+	    OK=0;
+	    break;
+	 }
+	 i = cllGetRow(&icss, stmt);
+	 if (i != 0 || icss.stmtPtr[stmt]->numOfCols == 0) OK=0;
+	 cllFreeStatement(&icss,stmt);
+      }
+      (void)gettimeofday(&endTime, (struct timezone *)0);
+      elapsed[k] = (endTime.tv_sec - startTime.tv_sec) +
+	 (endTime.tv_usec - startTime.tv_usec) / 1000000.0;
+   }
+   rodsLogSqlReq(1);
+   printf("%d selects, statement cache off: %.3f sec, on: %.3f sec\n",
+	  CLL_TEST_TIMING_LOOPS, elapsed[0], elapsed[1]);
+
    i = cllExecSqlNoResult(&icss,"drop table test;");
    if (i != 0 && i != CAT_SUCCESS_BUT_WITH_NO_INFO) OK=0;
 
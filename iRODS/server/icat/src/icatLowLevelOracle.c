@@ -18,6 +18,8 @@ int _cllFreeStatementColumns(icatSessionStruct *icss, int statementNumber);
 int cllBindVarCount=0;
 char *cllBindVars[MAX_BIND_VARS];
 int cllBindVarCountPrev=0; /* cclBindVarCount earlier in processing */
+int cllFetchRows=0; /* set by a caller that will read many rows, so the
+		       next cllExecSqlWithResult prefetches them */
 
 char bindName[MAX_BIND_VARS*5]="";
 
@@ -98,6 +100,15 @@ cllGetLastErrorMessage(char *msg, int maxChars) {
    return(0);
 }
 
+/*
+ The prepared statement cache is only implemented in the ODBC version
+ (icatLowLevelOdbc.c); this is here so callers can use either.
+ */
+int
+cllSetStmtCache(icatSessionStruct *icss, int onOff) {
+   return(0);
+}
+
 /* 
  Allocate the environment structure for use by the SQL routines.
  */
@@ -634,6 +645,39 @@ cllExecSqlNoResult(icatSessionStruct *icss, char *sqlInput)
 }
 
 
+/*
+ Execute a SQL command with no resulting table once for each of
+ numOfRows sets of bind variables (numOfVars values per row).  The
+ ODBC version binds these as parameter arrays; here the rows are
+ executed one at a time.
+ */
+int
+cllExecSqlNoResultArray(icatSessionStruct *icss, char *sql,
+			char *bindVars[], int numOfVars, int numOfRows)
+{
+   int i, j, status, result;
+
+   if (numOfVars <= 0 || numOfVars > MAX_BIND_VARS) {
+      rodsLog(LOG_ERROR, 
+	      "cllExecSqlNoResultArray: bad number of bind variables: %d",
+	      numOfVars);
+      return(CAT_OCI_ERROR);
+   }
+   result = 0;
+   for (i=0;i<numOfRows;i++) {
+      for (j=0;j<numOfVars;j++) {
+	 cllBindVars[j] = bindVars[i*numOfVars+j];
+      }
+      cllBindVarCount=numOfVars;
+      status = cllExecSqlNoResult(icss, sql);
+      if (status != 0 && status != CAT_SUCCESS_BUT_WITH_NO_INFO) {
+	 return(status);
+      }
+      if (status != 0) result = status;
+   }
+   return(result);
+}
+
 /*
   Return a row from a previous cllExecSqlWithResult call.
  */
@@ -695,6 +739,10 @@ cllExecSqlWithResult(icatSessionStruct *icss, int *stmtNum, char *sql) {
 
    static int columnLength[MAX_TOKEN]; 
    static sb2 indicator[MAX_TOKEN]; 
+   ub4 prefetchRows;
+
+   prefetchRows = cllFetchRows;
+   cllFetchRows = 0; /* reset for next call */
 
    p_svc = (OCISvcCtx *)icss->connectPtr;
    p_env = (OCIEnv *)icss->environPtr;
@@ -753,6 +801,12 @@ cllExecSqlWithResult(icatSessionStruct *icss, int *stmtNum, char *sql) {
    logTheBindVariables(0);
    rodsLogSql(sqlConverted);
 
+   if (prefetchRows > 1) {
+      /* have OCI get the rows in blocks, fewer round trips */
+      OCIAttrSet((dvoid *)p_statement, OCI_HTYPE_STMT, (dvoid *)&prefetchRows,
+		 (ub4) 0, OCI_ATTR_PREFETCH_ROWS, p_err);
+   }
+
    /* Execute statement */
    stat = OCIStmtExecute(p_svc, p_statement, p_err, (ub4) 0, (ub4) 0,
 		       (CONST OCISnapshot *) NULL, (OCISnapshot *) NULL,
@@ -30,6 +30,8 @@ int auditEnabled=0;  /* Set this to 2 and rebuild to enable iRODS
                         permanently enabled).  We plan to change this
                         sometime to have better control. */
 
+static void discardSeqValBlock();
+
 int checkObjIdByTicket(char *dataId, char *accessLevel, 
 			   char *ticketStr, char *ticketHost,
 			   char *userName, char *userZone,
@@ -88,6 +90,8 @@ int cmlClose( icatSessionStruct *icss) {
    if (pending==1) return(0); /* avoid hang if stuck doing this */
    pending=1;
 
+   discardSeqValBlock();
+
    status = cllDisconnect(icss);
 
    stat2 = cllCloseEnv(icss);
@@ -117,6 +121,27 @@ int cmlExecuteNoAnswerSql( char *sql,
 
 }
 
+/*
+ Execute sql once for each of numOfRows rows of bind variables
+ (numOfVars per row, in bindVars) as one array-bound statement.
+ */
+int cmlExecuteNoAnswerSqlArray( char *sql, 
+				char *bindVars[],
+				int numOfVars,
+				int numOfRows,
+				icatSessionStruct *icss)
+{
+  int i;
+  
+  i = cllExecSqlNoResultArray(icss, sql, bindVars, numOfVars, numOfRows);
+  if (i) { 
+     if (i <= CAT_ENV_ERR) return(i); /* already an iRODS error code */
+     return(CAT_SQL_ERR);
+  }
+  return(0);
+
+}
+
 int cmlGetOneRowFromSqlBV (char *sql, 
 		   char *cVal[], 
 		   int cValSize[], 
@@ -416,6 +441,7 @@ int cmlGetMultiRowStringValuesFromSql (char *sql,
     
     if (maxNumberOfStringsToGet <= 0) return(CAT_INVALID_ARGUMENT);
 
+    cllFetchRows = maxNumberOfStringsToGet; /* at most, get them in blocks */
     i = cllExecSqlWithResultBV(icss, &stmtNum, sql,
 				 bindVar1,bindVar2,0,0,0,0);
     if (i != 0) {
@@ -546,9 +572,30 @@ int cmlModifySingleTable (char *tableName,
 
 }
 
+/*
+ Object ids reserved by cmlGetNextSeqVal.  Rather than a query per
+ id, a block of ids is taken from the sequence with one query and
+ handed out from here.  The block size starts at 1 and doubles (up to
+ MAX_SEQ_VAL_BLOCK) each time an agent uses up a block, so an agent
+ that registers one object does not take many ids.  The sequence is
+ unchanged and other agents just get values past the block; ids left
+ unused (at cmlClose) are dropped, which only leaves a gap.
+ */
+static rodsLong_t seqValBlock[MAX_SEQ_VAL_BLOCK];
+static int seqValBlockCnt=0;	/* ids in seqValBlock */
+static int seqValBlockNext=0;	/* next one to hand out */
+static int seqValBlockSize=0;	/* size of the next block to get */
+
+static void
+discardSeqValBlock() {
+   seqValBlockCnt=0;
+   seqValBlockNext=0;
+   seqValBlockSize=0;
+}
+
 #define STR_LEN 100
-rodsLong_t
-cmlGetNextSeqVal(icatSessionStruct *icss) {
+static rodsLong_t
+_cmlGetNextSeqVal(icatSessionStruct *icss) {
    char nextStr[STR_LEN];
    char sql[STR_LEN];
    int status;
@@ -579,6 +626,36 @@ cmlGetNextSeqVal(icatSessionStruct *icss) {
    return(iVal);
 }
 
+rodsLong_t
+cmlGetNextSeqVal(icatSessionStruct *icss) {
+   int status;
+
+   if (seqValBlockNext < seqValBlockCnt) {
+      return(seqValBlock[seqValBlockNext++]);
+   }
+
+   seqValBlockSize *= 2;
+   if (seqValBlockSize < 1) seqValBlockSize=1;
+   if (seqValBlockSize > MAX_SEQ_VAL_BLOCK) seqValBlockSize=MAX_SEQ_VAL_BLOCK;
+#ifdef MY_ICAT
+   seqValBlockSize=1; /* no way to get a block in one query */
+#endif
+
+   if (seqValBlockSize == 1) {
+      return(_cmlGetNextSeqVal(icss));
+   }
+
+   seqValBlockCnt=0;
+   seqValBlockNext=0;
+   status = cmlGetNextSeqVals(seqValBlockSize, seqValBlock, icss);
+   if (status < 0) {
+      discardSeqValBlock();
+      return(status);
+   }
+   seqValBlockCnt = seqValBlockSize;
+   return(seqValBlock[seqValBlockNext++]);
+}
+
 rodsLong_t
 cmlGetCurrentSeqVal(icatSessionStruct *icss) {
    char nextStr[STR_LEN];
@@ -612,6 +689,58 @@ cmlGetCurrentSeqVal(icatSessionStruct *icss) {
    return(iVal);
 }
 
+/*
+ Get numOfVals new values from the object id sequence with one query
+ (for bulk registration).  The values are returned in seqVals.
+ */
+int
+cmlGetNextSeqVals(int numOfVals, rodsLong_t seqVals[], 
+		  icatSessionStruct *icss) {
+   char nextStr[STR_LEN];
+   char sql[STR_LEN];
+   int status, stmtNum, i;
+
+   if (logSQL_CML!=0) rodsLog(LOG_SQL, "cmlGetNextSeqVals SQL 1 ");
+
+   if (numOfVals <= 0) return(CAT_INVALID_ARGUMENT);
+
+   nextStr[0]='\0';
+   cllNextValueString("R_ObjectID", nextStr, STR_LEN);
+
+#if defined(MY_ICAT)
+   /* MySQL has no row generator, get them one by one */
+   for (i=0;i<numOfVals;i++) {
+      seqVals[i] = _cmlGetNextSeqVal(icss);
+      if (seqVals[i] < 0) return((int)seqVals[i]);
+   }
+   return(0);
+#elif defined(ORA_ICAT)
+   snprintf(sql, STR_LEN, "select %s from DUAL connect by level <= %d",
+	    nextStr, numOfVals);
+#else
+   snprintf(sql, STR_LEN, "select %s from generate_series(1, %d)", 
+	    nextStr, numOfVals);
+#endif
+
+   cllFetchRows = numOfVals;
+   status = cmlGetFirstRowFromSql(sql, &stmtNum, 0, icss);
+   for (i=0;status==0 && i<numOfVals;i++) {
+      seqVals[i] = strtoll(icss->stmtPtr[stmtNum]->resultValue[0], 0, 0);
+      if (i+1 < numOfVals) {
+	 status = cmlGetNextRowFromStatement(stmtNum, icss);
+      }
+   }
+   if (status == 0) {
+      cllFreeStatement(icss, stmtNum);
+   }
+   if (status < 0) {
+      rodsLog(LOG_NOTICE, 
+	      "cmlGetNextSeqVals failure %d after %d values", status, i);
+      return(status);
+   }
+   return(0);
+}
+
 int 
 cmlGetNextSeqStr(char *seqStr, int maxSeqStrLen, icatSessionStruct *icss) {
    char nextStr[STR_LEN];
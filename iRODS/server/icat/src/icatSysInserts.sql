@@ -215,6 +215,7 @@ insert into R_USER_GROUP values (9002,9002,'1170000000','1170000000');
 insert into R_USER_PASSWORD values (9002,'RODS','9999-12-31-23.59.00','1170000000','1170000000');
 
 insert into R_COLL_MAIN values (9003,'/','/','rods','tempZone',0,'','','','','','','1170000000','1170000000');
+insert into R_COLL_ANCESTRY values (9003,9003);
 
 insert into R_OBJT_ACCESS values (9003,9001,1130,'1170000000','1170000000');
 insert into R_OBJT_ACCESS values (9003,9002,1200,'1170000000','1170000000');
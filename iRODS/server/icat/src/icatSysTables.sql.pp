@@ -452,6 +452,17 @@ create table R_QUOTA_USAGE
    modify_ts varchar(32)
 );
 
+/*
+  Changes in usage not yet folded into R_QUOTA_USAGE.
+*/
+create table R_QUOTA_DELTA
+(
+   user_id INT64TYPE,
+   resc_id INT64TYPE,
+   quota_delta INT64TYPE,
+   modify_ts varchar(32)
+);
+
 create table R_SPECIFIC_QUERY
 (
    alias varchar(1000),
@@ -520,6 +531,18 @@ create table R_OBJT_FILESYSTEM_META
    modify_ts varchar(32)
 );
 
+/*
+  The collection tree, so the collections under a collection can be
+  found by id instead of by a prefix match on coll_name.  There is a
+  row for each collection and each of its ancestors, including one
+  with the collection as its own ancestor.
+*/
+create table R_COLL_ANCESTRY
+ (
+   ancestor_id         INT64TYPE not null,
+   coll_id             INT64TYPE not null
+ );
+
 
 #ifdef mysql
 
@@ -609,3 +632,5 @@ create unique index idx_ticket_user on R_TICKET_ALLOWED_USERS (ticket_id, user_n
 create unique index idx_ticket_group on R_TICKET_ALLOWED_GROUPS (ticket_id, group_name);
 
 create unique index idx_obj_filesystem_meta1 on R_OBJT_FILESYSTEM_META (object_id);
+create unique index idx_coll_ancestry1 on R_COLL_ANCESTRY (ancestor_id,coll_id);
+create index idx_coll_ancestry2 on R_COLL_ANCESTRY (coll_id);
@@ -15,6 +15,7 @@
 #include "dataObjOpr.h"
 #include "resource.h"
 #include "physPath.h"
+#include "tranThrTune.h"
 
 
 /**
@@ -766,7 +767,10 @@ ruleExecInfo_t *rei)
  * \param[in] xsizePerThrInMbStr - The number of threads is computed
  *    using: numThreads = fileSizeInMb / sizePerThrInMb + 1 where sizePerThrInMb
  *    is an integer value in MBytes. It also accepts the word "default" which sets
- *    sizePerThrInMb to a default value of 32.
+ *    sizePerThrInMb to a default value of 32, and the word "adaptive" which
+ *    starts with the default and then picks the number of threads (up to
+ *    maxNumThr) with the best throughput measured so far for the resource
+ *    and the client subnet.
  * \param[in] xmaxNumThrStr - The maximum number of threads to use. It accepts integer
  *    value up to 16. It also accepts the word "default" which sets maxNumThr to a default value of 4.
  * \param[in] xwindowSizeStr - The TCP window size in Bytes for the parallel transfer. A value of 0 or "dafault" means a default size of 1,048,576 Bytes.
@@ -797,6 +801,7 @@ msParam_t *xwindowSizeStr, ruleExecInfo_t *rei)
     char *sizePerThrInMbStr;
     char *maxNumThrStr;
     char *windowSizeStr;
+    int adaptive = 0;
 
     sizePerThrInMbStr = (char *) xsizePerThrInMbStr->inOutStruct;
     maxNumThrStr = (char *) xmaxNumThrStr->inOutStruct;
@@ -813,6 +818,9 @@ msParam_t *xwindowSizeStr, ruleExecInfo_t *rei)
 
     if (strcmp (sizePerThrInMbStr, "default") == 0) { 
 	sizePerThr = SZ_PER_TRAN_THR;
+    } else if (strcmp (sizePerThrInMbStr, "adaptive") == 0) {
+	sizePerThr = SZ_PER_TRAN_THR;
+	adaptive = 1;
     } else {
 	sizePerThr = atoi (sizePerThrInMbStr) * (1024*1024);
         if (sizePerThr <= 0) {
@@ -861,6 +869,13 @@ msParam_t *xwindowSizeStr, ruleExecInfo_t *rei)
     if (numThr > maxNumThr)
         numThr = maxNumThr;
 
+    /* the client did not ask for a number. Go by the measured throughput */
+    if (adaptive && doinp->numThreads <= 0 && rei->rgi != NULL &&
+      rei->rgi->rescInfo != NULL) {
+	numThr = getTunedNumThreads (rei->rsComm, rei->rgi->rescInfo->rescName,
+	  doinp->dataSize, numThr, maxNumThr);
+    }
+
     rei->status = numThr;
     return (rei->status);
 
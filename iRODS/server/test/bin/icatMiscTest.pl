@@ -102,6 +102,10 @@ runCmd(2, "test_genq gen8 abc 0 10");
 runCmd(0, "test_genq gen7 i 0 8 10"); # test totalRowCount
 runCmd(0, "test_genq gen15 i 0 8"); # test AUTO_CLOSE
 
+# GenQuery stream over the agent, more than one page, and a cancel
+runCmd(0, "test_genqstream 5");
+runCmd(0, "test_genqstream 20");
+
 # GenQuery options to check access; exercise cmlCheckDirId
 runCmd(0, "test_genq gen10 $USER $myZone $ACCESS_GOOD $HOME");
 runCmd(0, "test_genq gen10 $USER $myZone $ACCESS_BAD $HOME");
@@ -335,6 +339,18 @@ runCmd(0, $testCmd);
 $testCmd="test_chl sql \"select user_name||'#'||zone_name from R_USER_MAIN, R_USER_GROUP where R_USER_GROUP.user_id=R_USER_MAIN.user_id and R_USER_GROUP.group_user_id=(select user_id from R_USER_MAIN where user_name=" . "?)" . "\" g1 1";
 runCmd(1, $testCmd);
 
+# Check the collection tree (R_COLL_ANCESTRY) of a collection made by
+# the admin (chlRegCollByAdmin) and one made under it by chlRegColl:
+# both need to be found as descendants of their grandparents.
+$ANC1="$HOME/testAncestry1";
+runCmd(1, "irm -rf $ANC1");
+runCmd(0, "iadmin mkdir $ANC1");
+runCmd(0, "imkdir $ANC1/child1");
+runCmd(0, "iquest \"%s\" \"select COLL_NAME where COLL_NAME descendant_of '/$myZone/home'\" | grep '^$ANC1\$'");
+runCmd(0, "iquest \"%s\" \"select COLL_NAME where COLL_NAME descendant_of '/$myZone'\" | grep '^$ANC1/child1\$'");
+runCmd(0, "iquest \"%s\" \"select COLL_NAME where COLL_NAME descendant_of '$HOME'\" | grep '^$ANC1/child1\$'");
+runCmd(0, "irm -rf $ANC1");
+
 # Exercise the chlGetLocalZone for coverage
 runCmd(0, "test_chl getlocalzone $myZone");
 
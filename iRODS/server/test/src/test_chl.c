@@ -12,8 +12,10 @@
 
 #include "icatHighLevelRoutines.h"
 #include "icatMidLevelRoutines.h"
+#include "icatLowLevel.h"
 
 #include <string.h>
+#include <sys/time.h>
 
 extern icatSessionStruct *chlGetRcs();
 
@@ -456,6 +458,51 @@ int testRegDataMulti(rsComm_t *rsComm, char *count,
    return(status);
 }
 
+/*
+ Like regmulti but registers the data-objects with one
+ chlRegDataObjBulk call (as bulk put does), and prints the time taken.
+
+Example:
+bin/test_chl regbulk 1000 /newZone/home/rods/ws2/f1 generic /tmp/vault/f1
+ */
+int testRegDataBulk(rsComm_t *rsComm, char *count, 
+		    char *nameBase,  char *dataType, char *filePath) {
+   dataObjInfo_t *dataObjInfo;
+   struct timeval startTime, endTime;
+   int status;
+   int myCount;
+   int i;
+
+   myCount = atoi(count);
+   if (myCount <=0) {
+      printf("Invalid input: count\n");
+      return(USER_INPUT_OPTION_ERR);
+   }
+
+   dataObjInfo = (dataObjInfo_t *)calloc(myCount, sizeof(dataObjInfo_t));
+   for (i=0;i<myCount;i++) {
+      snprintf (dataObjInfo[i].objPath, MAX_NAME_LEN, "%s.%d", nameBase, i);
+      dataObjInfo[i].replNum=1;
+      strcpy(dataObjInfo[i].version, "12");
+      rstrcpy(dataObjInfo[i].dataType, dataType, NAME_LEN);
+      dataObjInfo[i].dataSize=42;
+      strcpy(dataObjInfo[i].rescName, "demoResc");
+      snprintf (dataObjInfo[i].filePath, MAX_NAME_LEN, "%s.%d", filePath, i);
+      dataObjInfo[i].replStatus=5;
+   }
+
+   gettimeofday(&startTime, NULL);
+   status = chlRegDataObjBulk(rsComm, dataObjInfo, myCount);
+   if (status == 0) status = chlCommit(rsComm);
+   gettimeofday(&endTime, NULL);
+
+   printf("registered %d objects in %.3f sec, status %d\n", myCount,
+	  (endTime.tv_sec - startTime.tv_sec) + 
+	  (endTime.tv_usec - startTime.tv_usec) / 1000000.0, status);
+   free(dataObjInfo);
+   return(status);
+}
+
 int testModDataObjMeta(rsComm_t *rsComm, char *name, 
 		       char *dataType, char *filePath) {
    dataObjInfo_t dataObjInfo;
@@ -881,6 +928,91 @@ testGetPamPw(rsComm_t *rsComm, char *username, char *testTime) {
    return(0);
 }
 
+/*
+ Time a typical bound query done count times with the prepared
+ statement cache of the low level off and then on.
+Example:
+bin/test_chl stmtcache 1000
+ */
+int
+testStmtCache(rsComm_t *rsComm, char *count) {
+   icatSessionStruct *icss;
+   rodsLong_t iVal;
+   struct timeval startTime, endTime;
+   float elapsed[2];
+   int myCount;
+   int i, k;
+   int status;
+
+   icss = chlGetRcs();
+   if (icss==NULL) return(CAT_NOT_OPEN);
+
+   myCount = 1000;
+   if (count != NULL && atoi(count) > 0) myCount = atoi(count);
+
+   rodsLogSqlReq(0);
+   for (k=0;k<2;k++) {
+      cllSetStmtCache(icss, k);
+      (void)gettimeofday(&startTime, (struct timezone *)0);
+      for (i=0;i<myCount;i++) {
+	 status = cmlGetIntegerValueFromSql(
+	    "select user_id from R_USER_MAIN where user_name=? and zone_name=?",
+	    &iVal, rsComm->clientUser.userName, rsComm->clientUser.rodsZone,
+	    0, 0, 0, icss);
+	 if (status != 0) {
+	    rodsLogSqlReq(1);
+	    return(status);
+	 }
+      }
+      (void)gettimeofday(&endTime, (struct timezone *)0);
+      elapsed[k] = (endTime.tv_sec - startTime.tv_sec) +
+	 (endTime.tv_usec - startTime.tv_usec) / 1000000.0;
+   }
+   rodsLogSqlReq(1);
+   printf("%d queries, statement cache off: %.3f sec, on: %.3f sec\n",
+	  myCount, elapsed[0], elapsed[1]);
+   return(0);
+}
+
+/*
+ Get count object ids with cmlGetNextSeqVal (which reserves them in
+ blocks), check that each is larger than the last and print the time.
+
+Example:
+bin/test_chl seqvals 1000
+ */
+int
+testSeqVals(rsComm_t *rsComm, char *count) {
+   icatSessionStruct *icss;
+   rodsLong_t iVal, prevVal;
+   struct timeval startTime, endTime;
+   int myCount;
+   int i;
+
+   icss = chlGetRcs();
+   if (icss==NULL) return(CAT_NOT_OPEN);
+
+   myCount = 1000;
+   if (count != NULL && atoi(count) > 0) myCount = atoi(count);
+
+   prevVal = 0;
+   (void)gettimeofday(&startTime, (struct timezone *)0);
+   for (i=0;i<myCount;i++) {
+      iVal = cmlGetNextSeqVal(icss);
+      if (iVal < 0) return((int)iVal);
+      if (iVal <= prevVal) {
+	 printf("id %lld after %lld\n", iVal, prevVal);
+	 return(CAT_SQL_ERR);
+      }
+      prevVal = iVal;
+   }
+   (void)gettimeofday(&endTime, (struct timezone *)0);
+   printf("%d ids in %.3f sec\n", myCount,
+	  (endTime.tv_sec - startTime.tv_sec) +
+	  (endTime.tv_usec - startTime.tv_usec) / 1000000.0);
+   return(0);
+}
+
 
 int
 main(int argc, char **argv) {
@@ -953,6 +1085,10 @@ main(int argc, char **argv) {
       status = testRegDataMulti(Comm, argv[2], argv[3], argv[4], argv[5]);
       didOne=1;
    }
+   if (strcmp(argv[1],"regbulk")==0) {
+      status = testRegDataBulk(Comm, argv[2], argv[3], argv[4], argv[5]);
+      didOne=1;
+   }
 
    if (strcmp(argv[1],"mod")==0) {
       status = testModDataObjMeta(Comm, argv[2], argv[3], argv[4]);
@@ -1191,6 +1327,14 @@ main(int argc, char **argv) {
       status = testGetPamPw(Comm, argv[2], argv[3]);
       didOne=1;
    }
+   if (strcmp(argv[1],"stmtcache")==0) {
+      status = testStmtCache(Comm, argv[2]);
+      didOne=1;
+   }
+   if (strcmp(argv[1],"seqvals")==0) {
+      status = testSeqVals(Comm, argv[2]);
+      didOne=1;
+   }
 
    if (status != 0) {
       /*
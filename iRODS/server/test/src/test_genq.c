@@ -8,10 +8,18 @@
 #include "readServerConfig.h"
 
 #include "icatHighLevelRoutines.h"
+#include "icatLowLevel.h"
+
+#include <sys/time.h>
 
 int sTest(int i1, int i2);
 int sTest2(int i1, int i2, int i3);
 int findCycles(int startTable);
+int generateSQL(genQueryInp_t genQueryInp, char *resultingSQL,
+		char *resultingCountSQL);
+extern icatSessionStruct *chlGetRcs();
+extern int genqPlanHits;
+extern int genqPlanMisses;
 
 #define BIG_STR 200
 int doLs()
@@ -805,6 +813,99 @@ doTest15(char *testString, char *testString2, char *testString3) {
     return(status);
 }
 
+/*
+ Time the GenQuery plan cache.  First generateSQL alone, with the plan
+ cache off and on (the planning in the agent), then whole queries with
+ the plan cache and the statement cache of the ODBC layer (the parse
+ and plan in the DBMS) off and on.  The collection name changes from
+ query to query, as it would in an ls of several collections, so only
+ the shape repeats.
+ bin/test_genq plancache 1000 /tempZone/home/rods
+ */
+int
+doTest16(char *count, char *collection) {
+   genQueryInp_t genQueryInp;
+   genQueryOut_t genQueryOut;
+   char condStr[MAX_NAME_LEN];
+   char combinedSQL[MAX_SQL_SIZE_GENERAL_QUERY];
+   char countSQL[MAX_SQL_SIZE_GENERAL_QUERY];
+   struct timeval startTime, endTime;
+   float elapsed;
+   icatSessionStruct *icss;
+   int myCount;
+   int i, j, k, k2;
+   int status;
+
+   icss = chlGetRcs();
+   if (icss==NULL) return(CAT_NOT_OPEN);
+
+   myCount = 1000;
+   if (count != NULL && atoi(count) > 0) myCount = atoi(count);
+   if (collection == NULL || *collection=='\0') collection="/tempZone";
+
+   memset (&genQueryInp, 0, sizeof (genQueryInp));
+   addInxIval (&genQueryInp.selectInp, COL_DATA_NAME, 1);
+   addInxIval (&genQueryInp.selectInp, COL_D_DATA_ID, 1);
+   addInxIval (&genQueryInp.selectInp, COL_DATA_SIZE, 1);
+   addInxIval (&genQueryInp.selectInp, COL_D_OWNER_NAME, 1);
+   addInxIval (&genQueryInp.selectInp, COL_D_MODIFY_TIME, 1);
+   snprintf (condStr, MAX_NAME_LEN, "= '%s'", collection);
+   addInxVal (&genQueryInp.sqlCondInp, COL_COLL_NAME, condStr);
+   /* point at condStr, which is changed from query to query */
+   free (genQueryInp.sqlCondInp.value[0]);
+   genQueryInp.sqlCondInp.value[0] = condStr;
+   genQueryInp.options = AUTO_CLOSE;
+   genQueryInp.maxRows = 10;
+
+   rodsLogSqlReq(0);
+   for (k=0;k<2;k++) {
+      chlGenQueryPlanCache(k);
+      genqPlanHits=0;
+      genqPlanMisses=0;
+      (void)gettimeofday(&startTime, (struct timezone *)0);
+      for (i=0;i<myCount;i++) {
+	 snprintf (condStr, MAX_NAME_LEN, "= '%s/c%d'", collection, i%10);
+	 status = generateSQL(genQueryInp, combinedSQL, countSQL);
+	 cllBindVarCount=0;
+	 if (status != 0) {
+	    rodsLogSqlReq(1);
+	    return(status);
+	 }
+      }
+      (void)gettimeofday(&endTime, (struct timezone *)0);
+      elapsed = (endTime.tv_sec - startTime.tv_sec) +
+	 (endTime.tv_usec - startTime.tv_usec) / 1000000.0;
+      printf("%d generateSQL, plan cache %s: %.3f sec (%d hits, %d misses)\n",
+	     myCount, k ? "on" : "off", elapsed, genqPlanHits, genqPlanMisses);
+   }
+
+   for (j=0;j<2;j++) {
+      cllSetStmtCache(icss, j);
+      for (k=0;k<2;k++) {
+	 chlGenQueryPlanCache(k);
+	 (void)gettimeofday(&startTime, (struct timezone *)0);
+	 for (i=0;i<myCount;i++) {
+	    snprintf (condStr, MAX_NAME_LEN, "= '%s/c%d'", collection, i%10);
+	    memset (&genQueryOut, 0, sizeof (genQueryOut));
+	    status = chlGenQuery(genQueryInp, &genQueryOut);
+	    for (k2=0;k2<genQueryOut.attriCnt;k2++) {
+	       free(genQueryOut.sqlResult[k2].value);
+	    }
+	    if (status != 0 && status != CAT_NO_ROWS_FOUND) {
+	       rodsLogSqlReq(1);
+	       return(status);
+	    }
+	 }
+	 (void)gettimeofday(&endTime, (struct timezone *)0);
+	 elapsed = (endTime.tv_sec - startTime.tv_sec) +
+	    (endTime.tv_usec - startTime.tv_usec) / 1000000.0;
+	 printf("%d queries, statement cache %s, plan cache %s: %.3f sec\n",
+		myCount, j ? "on" : "off", k ? "on" : "off", elapsed);
+      }
+   }
+   rodsLogSqlReq(1);
+   return(0);
+}
 
 int
 main(int argc, char **argv) {
@@ -846,6 +947,7 @@ main(int argc, char **argv) {
       if (strcmp(argv[1],"gen13")==0) mode=14;
       if (strcmp(argv[1],"lsr")==0) mode=15;
       if (strcmp(argv[1],"gen15")==0) mode=16;
+      if (strcmp(argv[1],"plancache")==0) mode=17;
    }
 
    if (argc ==3 && mode==0) {
@@ -1034,6 +1136,11 @@ main(int argc, char **argv) {
 	 if (status <0) exit(2);
 	 exit(0);
       }
+      if (mode==17) {
+	 status = doTest16(argv[2], argv[3]);
+	 if (status <0) exit(2);
+	 exit(0);
+      }
 
       genQueryInp.maxRows=2;
       i = chlGenQuery(genQueryInp, &result);
@@ -0,0 +1,217 @@
+/*** Copyright (c), The Regents of the University of California            ***
+ *** For more information please refer to files in the COPYRIGHT directory ***/
+/*
+  Test program for the GenQuery stream (genQueryStream.h).  It connects
+  to the server in the environment, reads the tokens a few rows a page
+  with paged rcGenQuery calls, then streams the same query and checks
+  that the rows come back the same, over more than one page.  It then
+  cancels a stream after its first page and checks that the connection
+  is still in sync.
+*/
+
+#include "rodsClient.h"
+
+/*
+Example command line:
+./test_genqstream 5
+streams the tokens 5 rows a page.
+ */
+
+#define MAX_TEST_ROWS	10000
+
+char *Rows[MAX_TEST_ROWS];
+int RowCnt = 0;
+
+void
+setTokenQuery(genQueryInp_t *genQueryInp, int pageRows) {
+   memset (genQueryInp, 0, sizeof (genQueryInp_t));
+   addInxIval (&genQueryInp->selectInp, COL_TOKEN_ID, ORDER_BY);
+   addInxIval (&genQueryInp->selectInp, COL_TOKEN_NAME, 1);
+   genQueryInp->maxRows = pageRows;
+}
+
+/* the row i of genQueryOut as one string, in rowStr */
+void
+getRowStr(genQueryOut_t *genQueryOut, int i, char *rowStr) {
+   snprintf(rowStr, MAX_NAME_LEN, "%s:%s",
+	    genQueryOut->sqlResult[0].value + i*genQueryOut->sqlResult[0].len,
+	    genQueryOut->sqlResult[1].value + i*genQueryOut->sqlResult[1].len);
+}
+
+/* read the rows with paged rcGenQuery calls, into Rows */
+int
+readPaged(rcComm_t *Conn, int pageRows) {
+   genQueryInp_t genQueryInp;
+   genQueryOut_t *genQueryOut = NULL;
+   char rowStr[MAX_NAME_LEN];
+   int i, status;
+
+   setTokenQuery(&genQueryInp, pageRows);
+   while ((status = rcGenQuery (Conn, &genQueryInp, &genQueryOut)) >= 0) {
+      for (i=0;i<genQueryOut->rowCnt && RowCnt<MAX_TEST_ROWS;i++) {
+	 getRowStr(genQueryOut, i, rowStr);
+	 Rows[RowCnt++] = strdup(rowStr);
+      }
+      genQueryInp.continueInx = genQueryOut->continueInx;
+      freeGenQueryOut (&genQueryOut);
+      if (genQueryInp.continueInx <= 0) break;
+   }
+   clearGenQueryInp (&genQueryInp);
+   if (status < 0 && status != CAT_NO_ROWS_FOUND) {
+      printf("rcGenQuery error %d\n", status);
+      return(status);
+   }
+   return(0);
+}
+
+/* stream the rows and check them against Rows */
+int
+readStream(rcComm_t *Conn, int pageRows) {
+   genQueryInp_t genQueryInp;
+   genQueryOut_t *genQueryOut = NULL;
+   genQueryStream_t genQueryStream;
+   char rowStr[MAX_NAME_LEN];
+   int i, status;
+   int pageCnt = 0;
+   int rowCnt = 0;
+
+   setTokenQuery(&genQueryInp, pageRows);
+   status = rcGenQueryStreamOpen (Conn, &genQueryInp, 0, &genQueryStream);
+   if (status < 0) {
+      printf("rcGenQueryStreamOpen error %d\n", status);
+      return(status);
+   }
+   while ((status = rcGenQueryStreamNext (&genQueryStream,
+					  &genQueryOut)) >= 0) {
+      pageCnt++;
+      if (genQueryOut->rowCnt > pageRows) {
+	 printf("page %d has %d rows, more than %d\n", pageCnt,
+		genQueryOut->rowCnt, pageRows);
+	 status = -1;
+	 break;
+      }
+      for (i=0;i<genQueryOut->rowCnt;i++,rowCnt++) {
+	 getRowStr(genQueryOut, i, rowStr);
+	 if (rowCnt >= RowCnt || strcmp(rowStr, Rows[rowCnt]) != 0) {
+	    printf("row %d is %s, paged row is %s\n", rowCnt, rowStr,
+		   rowCnt < RowCnt ? Rows[rowCnt] : "none");
+	    status = -1;
+	    break;
+	 }
+      }
+      freeGenQueryOut (&genQueryOut);
+      if (status < 0) break;
+   }
+   freeGenQueryOut (&genQueryOut);
+   rcGenQueryStreamClose (&genQueryStream);
+   clearGenQueryInp (&genQueryInp);
+   if (status < 0 && status != CAT_NO_ROWS_FOUND) {
+      printf("rcGenQueryStreamNext error %d\n", status);
+      return(status);
+   }
+   if (rowCnt != RowCnt || pageCnt < 2) {
+      printf("streamed %d rows in %d pages, %d rows paged\n", rowCnt,
+	     pageCnt, RowCnt);
+      return(-1);
+   }
+   printf("streamed %d rows in %d pages\n", rowCnt, pageCnt);
+   return(0);
+}
+
+/* cancel a stream after its first page, then make another call on the
+ * connection */
+int
+cancelStream(rcComm_t *Conn, int pageRows) {
+   genQueryInp_t genQueryInp;
+   genQueryOut_t *genQueryOut = NULL;
+   genQueryStream_t genQueryStream;
+   int status;
+
+   setTokenQuery(&genQueryInp, pageRows);
+   status = rcGenQueryStreamOpen (Conn, &genQueryInp, 0, &genQueryStream);
+   if (status == 0)
+      status = rcGenQueryStreamNext (&genQueryStream, &genQueryOut);
+   freeGenQueryOut (&genQueryOut);
+   if (status < 0) {
+      printf("first page error %d\n", status);
+      rcGenQueryStreamClose (&genQueryStream);
+      clearGenQueryInp (&genQueryInp);
+      return(status);
+   }
+   status = rcGenQueryStreamClose (&genQueryStream);
+   clearGenQueryInp (&genQueryInp);
+   if (status < 0) {
+      printf("rcGenQueryStreamClose error %d\n", status);
+      return(status);
+   }
+
+   setTokenQuery(&genQueryInp, 1);
+   status = rcGenQuery (Conn, &genQueryInp, &genQueryOut);
+   if (status >= 0 && genQueryOut->rowCnt == 1 && RowCnt > 0) {
+      char rowStr[MAX_NAME_LEN];
+      getRowStr(genQueryOut, 0, rowStr);
+      if (strcmp(rowStr, Rows[0]) != 0) {
+	 printf("row after the cancel is %s, not %s\n", rowStr, Rows[0]);
+	 status = -1;
+      }
+   }
+   else if (status >= 0) {
+      status = -1;
+   }
+   if (genQueryOut != NULL && genQueryOut->continueInx > 0) {
+      /* close out the statement */
+      genQueryInp.continueInx = genQueryOut->continueInx;
+      genQueryInp.maxRows = 0;
+      freeGenQueryOut (&genQueryOut);
+      rcGenQuery (Conn, &genQueryInp, &genQueryOut);
+   }
+   freeGenQueryOut (&genQueryOut);
+   clearGenQueryInp (&genQueryInp);
+   if (status < 0) {
+      printf("rcGenQuery after the cancel error %d\n", status);
+      return(status);
+   }
+   return(0);
+}
+
+int
+main(int argc, char **argv) {
+   rcComm_t *Conn;
+   rErrMsg_t errMsg;
+   rodsEnv myEnv;
+   int pageRows = 5;
+   int status;
+
+   if (argc > 1 && atoi(argv[1]) > 0) pageRows = atoi(argv[1]);
+
+   status = getRodsEnv (&myEnv);
+   if (status < 0) {
+      printf("getRodsEnv error %d\n", status);
+      exit(1);
+   }
+   Conn = rcConnect (myEnv.rodsHost, myEnv.rodsPort, myEnv.rodsUserName,
+		     myEnv.rodsZone, 0, &errMsg);
+   if (Conn == NULL) {
+      printf("rcConnect failure");
+      exit(1);
+   }
+   status = clientLogin(Conn);
+
+   if (status == 0) status = readPaged(Conn, pageRows);
+   if (status == 0 && RowCnt <= 2 * pageRows) {
+      printf("only %d rows, not enough for %d row pages\n", RowCnt,
+	     pageRows);
+      status = -1;
+   }
+   if (status == 0) status = readStream(Conn, pageRows);
+   if (status == 0) status = cancelStream(Conn, pageRows);
+
+   rcDisconnect(Conn);
+
+   if (status != 0) {
+      printf("Failed\n");
+      exit(1);
+   }
+   printf("Completed successfully\n");
+   exit(0);
+}
@@ -0,0 +1,112 @@
+/*** Copyright (c), The Regents of the University of California            ***
+ *** For more information please refer to files in the COPYRIGHT directory ***/
+/*
+  Test program for the thread count tuner (tranThrTune.c).  It uses its
+  own shared memory table (named by the pid) and removes it at the end.
+*/
+
+#include "rodsClient.h"
+#include "tranThrTune.h"
+#include <sys/mman.h>
+
+/*
+Example command line:
+./test_tranthr 4 10
+runs 10 explore rounds, with a trial every 4th transfer.
+ */
+
+#define TEST_RESC	"testResc"
+#define TEST_SIZE	(100*1024*1024)		/* a medium size file */
+#define TEST_MAX_THR	16
+
+/* pick a count for each transfer of explore rounds. The trials are not
+ * measured, as for a transfer that does not go through a portal. Check
+ * that the trials come every explore'th pick, are not 1, and that the
+ * other picks are the best count */
+int
+testUnmeasured(rsComm_t *rsComm, int explore, int rounds, int best) {
+   int i, numThr;
+
+   for (i=0;i<explore*rounds;i++) {
+      numThr = getTunedNumThreads (rsComm, TEST_RESC, TEST_SIZE,
+				   8, TEST_MAX_THR);
+      if (i % explore == explore - 1) {
+	 if (numThr == best || numThr <= 1) {
+	    printf("pick %d: trial of %d with best %d\n", i, numThr, best);
+	    return(-1);
+	 }
+      }
+      else if (numThr != best) {
+	 printf("pick %d: %d instead of best %d\n", i, numThr, best);
+	 return(-1);
+      }
+   }
+   return(0);
+}
+
+/* measure each trial, with a better rate for more threads, and check
+ * that the best count goes up */
+int
+testMeasured(rsComm_t *rsComm, int explore, int rounds, int best) {
+   int i, numThr;
+   int newBest = best;
+
+   for (i=0;i<explore*rounds;i++) {
+      numThr = getTunedNumThreads (rsComm, TEST_RESC, TEST_SIZE,
+				   8, TEST_MAX_THR);
+      if (numThr <= 1 || numThr > TEST_MAX_THR) {
+	 printf("pick %d: %d out of range\n", i, numThr);
+	 return(-1);
+      }
+      /* 1 sec for the best count, and faster with more threads */
+      recordTranThrRate (rsComm, TEST_RESC, TEST_SIZE, numThr,
+			 (rodsLong_t) 1000000 * best / numThr);
+      if (numThr > newBest) newBest = numThr;
+   }
+   numThr = getTunedNumThreads (rsComm, TEST_RESC, TEST_SIZE,
+				8, TEST_MAX_THR);
+   if (newBest == best || numThr != newBest) {
+      printf("best is %d after trials up to %d, started at %d\n",
+	     numThr, newBest, best);
+      return(-1);
+   }
+   return(0);
+}
+
+int
+main(int argc, char **argv) {
+   rsComm_t *Comm;
+   char envStr[NAME_LEN];
+   char shmName[NAME_LEN];
+   int explore = 4;
+   int rounds = 10;
+   int status;
+
+   if (argc > 1 && atoi(argv[1]) > 1) explore = atoi(argv[1]);
+   if (argc > 2 && atoi(argv[2]) > 0) rounds = atoi(argv[2]);
+
+   snprintf(envStr, NAME_LEN, "%s=%d", TRAN_THR_EXPLORE_KW, explore);
+   putenv(envStr);
+
+   Comm = (rsComm_t*)malloc (sizeof (rsComm_t));
+   memset (Comm, 0, sizeof (rsComm_t));
+   rstrcpy (Comm->clientAddr, "10.1.2.3", NAME_LEN);
+   Comm->myEnv.rodsPort = getpid();
+   snprintf(shmName, NAME_LEN, "%s.%d", TRAN_THR_TUNE_NAME,
+	    Comm->myEnv.rodsPort);
+
+   /* the best count is 2, so a trial of best-1 or best/2 would be 1 */
+   status = recordTranThrRate (Comm, TEST_RESC, TEST_SIZE, 2, 1000000);
+   if (status == 0) status = testUnmeasured(Comm, explore, rounds, 2);
+   if (status == 0) status = testMeasured(Comm, explore, rounds, 2);
+
+   shm_unlink(shmName);
+   free(Comm);
+
+   if (status != 0) {
+      printf("Failed\n");
+      exit(1);
+   }
+   printf("Completed successfully\n");
+   exit(0);
+}